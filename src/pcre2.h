@@ -146,12 +146,16 @@ D   is inspected during pcre2_dfa_match() execution
 #define PCRE2_EXTRA_BAD_ESCAPE_IS_LITERAL    0x00000002u  /* C */
 #define PCRE2_EXTRA_MATCH_WORD               0x00000004u  /* C */
 #define PCRE2_EXTRA_MATCH_LINE               0x00000008u  /* C */
+#define PCRE2_EXTRA_ALWAYS_CHECK_LASTCU      0x00000010u  /* C */
+#define PCRE2_EXTRA_BIT_PARALLEL             0x00000020u  /* C */
+#define PCRE2_EXTRA_LINEAR                   0x00000040u  /* C */
 
 /* These are for pcre2_jit_compile(). */
 
 #define PCRE2_JIT_COMPLETE        0x00000001u  /* For full matching */
 #define PCRE2_JIT_PARTIAL_SOFT    0x00000002u
 #define PCRE2_JIT_PARTIAL_HARD    0x00000004u
+#define PCRE2_JIT_DFA             0x00000008u  /* For pcre2_dfa_match() */
 
 /* These are for pcre2_match(), pcre2_dfa_match(), and pcre2_jit_match(). Note
 that PCRE2_ANCHORED and PCRE2_NO_UTF_CHECK can also be passed to these
@@ -179,11 +183,15 @@ through to pcre2_match(). */
 #define PCRE2_SUBSTITUTE_UNKNOWN_UNSET    0x00000800u
 #define PCRE2_SUBSTITUTE_OVERFLOW_LENGTH  0x00001000u
 
-/* A further option for pcre2_match(), not allowed for pcre2_dfa_match(),
-ignored for pcre2_jit_match(). */
+/* A further option for pcre2_match() and pcre2_dfa_match(), ignored for
+pcre2_jit_match(). */
 
 #define PCRE2_NO_JIT              0x00002000u
 
+/* A further option for pcre2_dfa_match(), not allowed for pcre2_match(). */
+
+#define PCRE2_DFA_LAZY            0x00004000u
+
 /* Options for pcre2_pattern_convert(). */
 
 #define PCRE2_CONVERT_UTF                    0x00000001u
@@ -323,6 +331,32 @@ numbers must not be changed. */
 #define PCRE2_INFO_HASBACKSLASHC        23
 #define PCRE2_INFO_FRAMESIZE            24
 #define PCRE2_INFO_HEAPLIMIT            25
+#define PCRE2_INFO_BITPARALLEL          26
+
+/* Request types for pcre2_jit_stack_pool_info() */
+
+#define PCRE2_POOLINFO_STACKS            0
+#define PCRE2_POOLINFO_INUSE             1
+#define PCRE2_POOLINFO_PEAKINUSE         2
+#define PCRE2_POOLINFO_PEAKSIZE          3
+
+/* Request types for pcre2_jit_memory_info() */
+
+#define PCRE2_JITMEMINFO_ARENAS          0
+#define PCRE2_JITMEMINFO_HOTARENAS       1
+#define PCRE2_JITMEMINFO_HUGEARENAS      2
+#define PCRE2_JITMEMINFO_MAPPED          3
+#define PCRE2_JITMEMINFO_USED            4
+#define PCRE2_JITMEMINFO_FREE            5
+#define PCRE2_JITMEMINFO_FREEBLOCKS      6
+#define PCRE2_JITMEMINFO_LARGESTFREE     7
+
+/* Request types for pcre2_jit_code_cache_info() */
+
+#define PCRE2_CODECACHEINFO_SIZE         0
+#define PCRE2_CODECACHEINFO_USED         1
+#define PCRE2_CODECACHEINFO_HUGE         2
+#define PCRE2_CODECACHEINFO_SEALED       3
 
 /* Request types for pcre2_config(). */
 
@@ -383,9 +417,27 @@ typedef struct pcre2_real_code pcre2_code; \
 struct pcre2_real_match_data; \
 typedef struct pcre2_real_match_data pcre2_match_data; \
 \
+struct pcre2_real_pattern_set; \
+typedef struct pcre2_real_pattern_set pcre2_pattern_set; \
+\
+struct pcre2_real_parallel_match; \
+typedef struct pcre2_real_parallel_match pcre2_parallel_match; \
+\
+struct pcre2_real_dfa_workspace; \
+typedef struct pcre2_real_dfa_workspace pcre2_dfa_workspace; \
+\
+struct pcre2_real_dfa_stream; \
+typedef struct pcre2_real_dfa_stream pcre2_dfa_stream; \
+\
 struct pcre2_real_jit_stack; \
 typedef struct pcre2_real_jit_stack pcre2_jit_stack; \
 \
+struct pcre2_real_jit_stack_pool; \
+typedef struct pcre2_real_jit_stack_pool pcre2_jit_stack_pool; \
+\
+struct pcre2_real_jit_code_cache; \
+typedef struct pcre2_real_jit_code_cache pcre2_jit_code_cache; \
+\
 typedef pcre2_jit_stack *(*pcre2_jit_callback)(void *);
 
 
@@ -542,19 +594,94 @@ PCRE2_EXP_DECL pcre2_match_data PCRE2_CALL_CONVENTION \
 PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
   pcre2_dfa_match(const pcre2_code *, PCRE2_SPTR, PCRE2_SIZE, PCRE2_SIZE, \
     uint32_t, pcre2_match_data *, pcre2_match_context *, int *, PCRE2_SIZE); \
+PCRE2_EXP_DECL pcre2_dfa_workspace PCRE2_CALL_CONVENTION \
+  *pcre2_dfa_workspace_create(PCRE2_SIZE, PCRE2_SIZE, \
+    pcre2_general_context *); \
+PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
+  pcre2_dfa_workspace_assign(pcre2_match_context *, pcre2_dfa_workspace *); \
+PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
+  pcre2_dfa_workspace_free(pcre2_dfa_workspace *); \
+PCRE2_EXP_DECL PCRE2_SIZE PCRE2_CALL_CONVENTION \
+  pcre2_dfa_workspace_peak(pcre2_dfa_workspace *); \
+PCRE2_EXP_DECL PCRE2_SIZE PCRE2_CALL_CONVENTION \
+  pcre2_dfa_workspace_size(pcre2_dfa_workspace *); \
 PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
   pcre2_match(const pcre2_code *, PCRE2_SPTR, PCRE2_SIZE, PCRE2_SIZE, \
     uint32_t, pcre2_match_data *, pcre2_match_context *); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_match_batch(const pcre2_code *, const PCRE2_SPTR *, \
+    const PCRE2_SIZE *, uint32_t, uint32_t, pcre2_match_data **, \
+    pcre2_match_context *, int *); \
 PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
   pcre2_match_data_free(pcre2_match_data *); \
 PCRE2_EXP_DECL PCRE2_SPTR PCRE2_CALL_CONVENTION \
   pcre2_get_mark(pcre2_match_data *); \
+PCRE2_EXP_DECL PCRE2_SIZE PCRE2_CALL_CONVENTION \
+  pcre2_get_match_data_heapframes_size(pcre2_match_data *); \
 PCRE2_EXP_DECL uint32_t PCRE2_CALL_CONVENTION \
   pcre2_get_ovector_count(pcre2_match_data *); \
 PCRE2_EXP_DECL PCRE2_SIZE PCRE2_CALL_CONVENTION \
   *pcre2_get_ovector_pointer(pcre2_match_data *); \
 PCRE2_EXP_DECL PCRE2_SIZE PCRE2_CALL_CONVENTION \
-  pcre2_get_startchar(pcre2_match_data *);
+  pcre2_get_startchar(pcre2_match_data *); \
+PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
+  pcre2_shrink_match_data_heapframes(pcre2_match_data *, PCRE2_SIZE);
+
+
+/* Functions for matching a subject against a set of patterns. */
+
+#define PCRE2_PATTERN_SET_FUNCTIONS \
+PCRE2_EXP_DECL pcre2_pattern_set PCRE2_CALL_CONVENTION \
+  *pcre2_pattern_set_create(const pcre2_code **, uint32_t, \
+    pcre2_general_context *); \
+PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
+  pcre2_pattern_set_free(pcre2_pattern_set *); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_pattern_set_match(const pcre2_pattern_set *, PCRE2_SPTR, PCRE2_SIZE, \
+    PCRE2_SIZE, uint32_t, pcre2_match_data *, pcre2_match_context *, \
+    uint32_t *, uint32_t);
+
+
+/* Functions for finding all the matches in a subject that is divided into
+chunks, which may be searched in parallel. */
+
+#define PCRE2_PARALLEL_MATCH_FUNCTIONS \
+PCRE2_EXP_DECL pcre2_parallel_match PCRE2_CALL_CONVENTION \
+  *pcre2_parallel_match_create(const pcre2_code *, pcre2_general_context *); \
+PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
+  pcre2_parallel_match_free(pcre2_parallel_match *); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_parallel_match_split(pcre2_parallel_match *, PCRE2_SPTR, PCRE2_SIZE, \
+    uint32_t, PCRE2_SIZE); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_parallel_match_run(pcre2_parallel_match *, uint32_t, \
+    pcre2_match_context *); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_parallel_match_merge(pcre2_parallel_match *, pcre2_match_context *); \
+PCRE2_EXP_DECL PCRE2_SIZE PCRE2_CALL_CONVENTION \
+  pcre2_parallel_match_count(pcre2_parallel_match *); \
+PCRE2_EXP_DECL PCRE2_SIZE PCRE2_CALL_CONVENTION \
+  *pcre2_parallel_match_ovector(pcre2_parallel_match *);
+
+
+/* Functions for DFA matching of a subject that arrives in pieces, without
+keeping the whole of it. */
+
+#define PCRE2_DFA_STREAM_FUNCTIONS \
+PCRE2_EXP_DECL pcre2_dfa_stream PCRE2_CALL_CONVENTION \
+  *pcre2_dfa_stream_create(const pcre2_code *, uint32_t, PCRE2_SIZE, \
+    pcre2_general_context *); \
+PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
+  pcre2_dfa_stream_free(pcre2_dfa_stream *); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_dfa_stream_scan(pcre2_dfa_stream *, PCRE2_SPTR, PCRE2_SIZE, \
+    pcre2_match_context *); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_dfa_stream_end(pcre2_dfa_stream *, pcre2_match_context *); \
+PCRE2_EXP_DECL PCRE2_SIZE PCRE2_CALL_CONVENTION \
+  pcre2_dfa_stream_count(pcre2_dfa_stream *); \
+PCRE2_EXP_DECL uint64_t PCRE2_CALL_CONVENTION \
+  *pcre2_dfa_stream_ovector(pcre2_dfa_stream *);
 
 
 /* Convenience functions for handling matched substrings. */
@@ -625,19 +752,56 @@ PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
 /* Functions for JIT processing */
 
 #define PCRE2_JIT_FUNCTIONS \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_jit_code_cache_compile(pcre2_jit_code_cache *, pcre2_code *, \
+    uint32_t); \
+PCRE2_EXP_DECL pcre2_jit_code_cache PCRE2_CALL_CONVENTION \
+  *pcre2_jit_code_cache_create(PCRE2_SIZE, pcre2_general_context *); \
+PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
+  pcre2_jit_code_cache_free(pcre2_jit_code_cache *); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_jit_code_cache_info(pcre2_jit_code_cache *, uint32_t, void *); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_jit_code_cache_seal(pcre2_jit_code_cache *); \
 PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
   pcre2_jit_compile(pcre2_code *, uint32_t); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_jit_compile_async(pcre2_code *, uint32_t); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_jit_compile_lazy(pcre2_code *, uint32_t, uint32_t, PCRE2_SIZE); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_jit_compile_wait(pcre2_code *); \
 PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
   pcre2_jit_match(const pcre2_code *, PCRE2_SPTR, PCRE2_SIZE, PCRE2_SIZE, \
     uint32_t, pcre2_match_data *, pcre2_match_context *); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_jit_match_batch(const pcre2_code *, const PCRE2_SPTR *, \
+    const PCRE2_SIZE *, uint32_t, uint32_t, pcre2_match_data **, \
+    pcre2_match_context *, int *); \
 PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
   pcre2_jit_free_unused_memory(pcre2_general_context *); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_jit_memory_info(uint32_t, void *); \
+PCRE2_EXP_DECL int32_t PCRE2_CALL_CONVENTION \
+  pcre2_jit_serialize_encode(const pcre2_code *, uint8_t **, PCRE2_SIZE *, \
+    pcre2_general_context *); \
+PCRE2_EXP_DECL int32_t PCRE2_CALL_CONVENTION \
+  pcre2_jit_serialize_decode(pcre2_code *, const uint8_t *, PCRE2_SIZE); \
 PCRE2_EXP_DECL pcre2_jit_stack PCRE2_CALL_CONVENTION \
   *pcre2_jit_stack_create(PCRE2_SIZE, PCRE2_SIZE, pcre2_general_context *); \
 PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
   pcre2_jit_stack_assign(pcre2_match_context *, pcre2_jit_callback, void *); \
 PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
-  pcre2_jit_stack_free(pcre2_jit_stack *);
+  pcre2_jit_stack_free(pcre2_jit_stack *); \
+PCRE2_EXP_DECL pcre2_jit_stack_pool PCRE2_CALL_CONVENTION \
+  *pcre2_jit_stack_pool_create(PCRE2_SIZE, PCRE2_SIZE, \
+    pcre2_general_context *); \
+PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
+  pcre2_jit_stack_pool_assign(pcre2_match_context *, pcre2_jit_stack_pool *); \
+PCRE2_EXP_DECL int PCRE2_CALL_CONVENTION \
+  pcre2_jit_stack_pool_info(pcre2_jit_stack_pool *, uint32_t, void *); \
+PCRE2_EXP_DECL void PCRE2_CALL_CONVENTION \
+  pcre2_jit_stack_pool_free(pcre2_jit_stack_pool *);
 
 
 /* Other miscellaneous functions. */
@@ -667,16 +831,26 @@ pcre2_compile are called by application code. */
 #define PCRE2_SPTR                  PCRE2_SUFFIX(PCRE2_SPTR)
 
 #define pcre2_code                  PCRE2_SUFFIX(pcre2_code_)
+#define pcre2_dfa_stream            PCRE2_SUFFIX(pcre2_dfa_stream_)
+#define pcre2_dfa_workspace         PCRE2_SUFFIX(pcre2_dfa_workspace_)
 #define pcre2_jit_callback          PCRE2_SUFFIX(pcre2_jit_callback_)
+#define pcre2_jit_code_cache        PCRE2_SUFFIX(pcre2_jit_code_cache_)
 #define pcre2_jit_stack             PCRE2_SUFFIX(pcre2_jit_stack_)
+#define pcre2_jit_stack_pool        PCRE2_SUFFIX(pcre2_jit_stack_pool_)
 
 #define pcre2_real_code             PCRE2_SUFFIX(pcre2_real_code_)
+#define pcre2_real_dfa_stream       PCRE2_SUFFIX(pcre2_real_dfa_stream_)
+#define pcre2_real_dfa_workspace    PCRE2_SUFFIX(pcre2_real_dfa_workspace_)
 #define pcre2_real_general_context  PCRE2_SUFFIX(pcre2_real_general_context_)
 #define pcre2_real_compile_context  PCRE2_SUFFIX(pcre2_real_compile_context_)
 #define pcre2_real_convert_context  PCRE2_SUFFIX(pcre2_real_convert_context_)
 #define pcre2_real_match_context    PCRE2_SUFFIX(pcre2_real_match_context_)
+#define pcre2_real_jit_code_cache   PCRE2_SUFFIX(pcre2_real_jit_code_cache_)
 #define pcre2_real_jit_stack        PCRE2_SUFFIX(pcre2_real_jit_stack_)
+#define pcre2_real_jit_stack_pool   PCRE2_SUFFIX(pcre2_real_jit_stack_pool_)
 #define pcre2_real_match_data       PCRE2_SUFFIX(pcre2_real_match_data_)
+#define pcre2_real_pattern_set      PCRE2_SUFFIX(pcre2_real_pattern_set_)
+#define pcre2_real_parallel_match   PCRE2_SUFFIX(pcre2_real_parallel_match_)
 
 
 /* Data blocks */
@@ -688,6 +862,8 @@ pcre2_compile are called by application code. */
 #define pcre2_convert_context          PCRE2_SUFFIX(pcre2_convert_context_)
 #define pcre2_match_context            PCRE2_SUFFIX(pcre2_match_context_)
 #define pcre2_match_data               PCRE2_SUFFIX(pcre2_match_data_)
+#define pcre2_parallel_match           PCRE2_SUFFIX(pcre2_parallel_match_)
+#define pcre2_pattern_set              PCRE2_SUFFIX(pcre2_pattern_set_)
 
 
 /* Functions: the complete list in alphabetical order */
@@ -706,30 +882,69 @@ pcre2_compile are called by application code. */
 #define pcre2_convert_context_free            PCRE2_SUFFIX(pcre2_convert_context_free_)
 #define pcre2_converted_pattern_free          PCRE2_SUFFIX(pcre2_converted_pattern_free_)
 #define pcre2_dfa_match                       PCRE2_SUFFIX(pcre2_dfa_match_)
+#define pcre2_dfa_stream_count                PCRE2_SUFFIX(pcre2_dfa_stream_count_)
+#define pcre2_dfa_stream_create               PCRE2_SUFFIX(pcre2_dfa_stream_create_)
+#define pcre2_dfa_stream_end                  PCRE2_SUFFIX(pcre2_dfa_stream_end_)
+#define pcre2_dfa_stream_free                 PCRE2_SUFFIX(pcre2_dfa_stream_free_)
+#define pcre2_dfa_stream_ovector              PCRE2_SUFFIX(pcre2_dfa_stream_ovector_)
+#define pcre2_dfa_stream_scan                 PCRE2_SUFFIX(pcre2_dfa_stream_scan_)
+#define pcre2_dfa_workspace_assign            PCRE2_SUFFIX(pcre2_dfa_workspace_assign_)
+#define pcre2_dfa_workspace_create            PCRE2_SUFFIX(pcre2_dfa_workspace_create_)
+#define pcre2_dfa_workspace_free              PCRE2_SUFFIX(pcre2_dfa_workspace_free_)
+#define pcre2_dfa_workspace_peak              PCRE2_SUFFIX(pcre2_dfa_workspace_peak_)
+#define pcre2_dfa_workspace_size              PCRE2_SUFFIX(pcre2_dfa_workspace_size_)
 #define pcre2_general_context_copy            PCRE2_SUFFIX(pcre2_general_context_copy_)
 #define pcre2_general_context_create          PCRE2_SUFFIX(pcre2_general_context_create_)
 #define pcre2_general_context_free            PCRE2_SUFFIX(pcre2_general_context_free_)
 #define pcre2_get_error_message               PCRE2_SUFFIX(pcre2_get_error_message_)
 #define pcre2_get_mark                        PCRE2_SUFFIX(pcre2_get_mark_)
+#define pcre2_get_match_data_heapframes_size  PCRE2_SUFFIX(pcre2_get_match_data_heapframes_size_)
 #define pcre2_get_ovector_pointer             PCRE2_SUFFIX(pcre2_get_ovector_pointer_)
 #define pcre2_get_ovector_count               PCRE2_SUFFIX(pcre2_get_ovector_count_)
 #define pcre2_get_startchar                   PCRE2_SUFFIX(pcre2_get_startchar_)
+#define pcre2_jit_code_cache_compile          PCRE2_SUFFIX(pcre2_jit_code_cache_compile_)
+#define pcre2_jit_code_cache_create           PCRE2_SUFFIX(pcre2_jit_code_cache_create_)
+#define pcre2_jit_code_cache_free             PCRE2_SUFFIX(pcre2_jit_code_cache_free_)
+#define pcre2_jit_code_cache_info             PCRE2_SUFFIX(pcre2_jit_code_cache_info_)
+#define pcre2_jit_code_cache_seal             PCRE2_SUFFIX(pcre2_jit_code_cache_seal_)
 #define pcre2_jit_compile                     PCRE2_SUFFIX(pcre2_jit_compile_)
+#define pcre2_jit_compile_async               PCRE2_SUFFIX(pcre2_jit_compile_async_)
+#define pcre2_jit_compile_lazy                PCRE2_SUFFIX(pcre2_jit_compile_lazy_)
+#define pcre2_jit_compile_wait                PCRE2_SUFFIX(pcre2_jit_compile_wait_)
 #define pcre2_jit_match                       PCRE2_SUFFIX(pcre2_jit_match_)
+#define pcre2_jit_match_batch                 PCRE2_SUFFIX(pcre2_jit_match_batch_)
 #define pcre2_jit_free_unused_memory          PCRE2_SUFFIX(pcre2_jit_free_unused_memory_)
+#define pcre2_jit_memory_info                 PCRE2_SUFFIX(pcre2_jit_memory_info_)
+#define pcre2_jit_serialize_decode            PCRE2_SUFFIX(pcre2_jit_serialize_decode_)
+#define pcre2_jit_serialize_encode            PCRE2_SUFFIX(pcre2_jit_serialize_encode_)
 #define pcre2_jit_stack_assign                PCRE2_SUFFIX(pcre2_jit_stack_assign_)
 #define pcre2_jit_stack_create                PCRE2_SUFFIX(pcre2_jit_stack_create_)
 #define pcre2_jit_stack_free                  PCRE2_SUFFIX(pcre2_jit_stack_free_)
+#define pcre2_jit_stack_pool_assign           PCRE2_SUFFIX(pcre2_jit_stack_pool_assign_)
+#define pcre2_jit_stack_pool_create           PCRE2_SUFFIX(pcre2_jit_stack_pool_create_)
+#define pcre2_jit_stack_pool_free             PCRE2_SUFFIX(pcre2_jit_stack_pool_free_)
+#define pcre2_jit_stack_pool_info             PCRE2_SUFFIX(pcre2_jit_stack_pool_info_)
 #define pcre2_maketables                      PCRE2_SUFFIX(pcre2_maketables_)
 #define pcre2_match                           PCRE2_SUFFIX(pcre2_match_)
+#define pcre2_match_batch                     PCRE2_SUFFIX(pcre2_match_batch_)
 #define pcre2_match_context_copy              PCRE2_SUFFIX(pcre2_match_context_copy_)
 #define pcre2_match_context_create            PCRE2_SUFFIX(pcre2_match_context_create_)
 #define pcre2_match_context_free              PCRE2_SUFFIX(pcre2_match_context_free_)
 #define pcre2_match_data_create               PCRE2_SUFFIX(pcre2_match_data_create_)
 #define pcre2_match_data_create_from_pattern  PCRE2_SUFFIX(pcre2_match_data_create_from_pattern_)
 #define pcre2_match_data_free                 PCRE2_SUFFIX(pcre2_match_data_free_)
+#define pcre2_parallel_match_count            PCRE2_SUFFIX(pcre2_parallel_match_count_)
+#define pcre2_parallel_match_create           PCRE2_SUFFIX(pcre2_parallel_match_create_)
+#define pcre2_parallel_match_free             PCRE2_SUFFIX(pcre2_parallel_match_free_)
+#define pcre2_parallel_match_merge            PCRE2_SUFFIX(pcre2_parallel_match_merge_)
+#define pcre2_parallel_match_ovector          PCRE2_SUFFIX(pcre2_parallel_match_ovector_)
+#define pcre2_parallel_match_run              PCRE2_SUFFIX(pcre2_parallel_match_run_)
+#define pcre2_parallel_match_split            PCRE2_SUFFIX(pcre2_parallel_match_split_)
 #define pcre2_pattern_convert                 PCRE2_SUFFIX(pcre2_pattern_convert_)
 #define pcre2_pattern_info                    PCRE2_SUFFIX(pcre2_pattern_info_)
+#define pcre2_pattern_set_create              PCRE2_SUFFIX(pcre2_pattern_set_create_)
+#define pcre2_pattern_set_free                PCRE2_SUFFIX(pcre2_pattern_set_free_)
+#define pcre2_pattern_set_match               PCRE2_SUFFIX(pcre2_pattern_set_match_)
 #define pcre2_serialize_decode                PCRE2_SUFFIX(pcre2_serialize_decode_)
 #define pcre2_serialize_encode                PCRE2_SUFFIX(pcre2_serialize_encode_)
 #define pcre2_serialize_free                  PCRE2_SUFFIX(pcre2_serialize_free_)
@@ -748,6 +963,7 @@ pcre2_compile are called by application code. */
 #define pcre2_set_newline                     PCRE2_SUFFIX(pcre2_set_newline_)
 #define pcre2_set_parens_nest_limit           PCRE2_SUFFIX(pcre2_set_parens_nest_limit_)
 #define pcre2_set_offset_limit                PCRE2_SUFFIX(pcre2_set_offset_limit_)
+#define pcre2_shrink_match_data_heapframes    PCRE2_SUFFIX(pcre2_shrink_match_data_heapframes_)
 #define pcre2_substitute                      PCRE2_SUFFIX(pcre2_substitute_)
 #define pcre2_substring_copy_byname           PCRE2_SUFFIX(pcre2_substring_copy_byname_)
 #define pcre2_substring_copy_bynumber         PCRE2_SUFFIX(pcre2_substring_copy_bynumber_)
@@ -782,6 +998,9 @@ PCRE2_MATCH_CONTEXT_FUNCTIONS \
 PCRE2_COMPILE_FUNCTIONS \
 PCRE2_PATTERN_INFO_FUNCTIONS \
 PCRE2_MATCH_FUNCTIONS \
+PCRE2_PATTERN_SET_FUNCTIONS \
+PCRE2_PARALLEL_MATCH_FUNCTIONS \
+PCRE2_DFA_STREAM_FUNCTIONS \
 PCRE2_SUBSTRING_FUNCTIONS \
 PCRE2_SERIALIZE_FUNCTIONS \
 PCRE2_SUBSTITUTE_FUNCTION \
@@ -812,6 +1031,9 @@ PCRE2_TYPES_STRUCTURES_AND_FUNCTIONS
 #undef PCRE2_COMPILE_FUNCTIONS
 #undef PCRE2_PATTERN_INFO_FUNCTIONS
 #undef PCRE2_MATCH_FUNCTIONS
+#undef PCRE2_PATTERN_SET_FUNCTIONS
+#undef PCRE2_PARALLEL_MATCH_FUNCTIONS
+#undef PCRE2_DFA_STREAM_FUNCTIONS
 #undef PCRE2_SUBSTRING_FUNCTIONS
 #undef PCRE2_SERIALIZE_FUNCTIONS
 #undef PCRE2_SUBSTITUTE_FUNCTION
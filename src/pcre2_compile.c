@@ -708,11 +708,13 @@ are allowed. */
    PCRE2_NO_DOTSTAR_ANCHOR|PCRE2_UCP|PCRE2_UNGREEDY)
 
 #define PUBLIC_LITERAL_COMPILE_EXTRA_OPTIONS \
-   (PCRE2_EXTRA_MATCH_LINE|PCRE2_EXTRA_MATCH_WORD)
+   (PCRE2_EXTRA_MATCH_LINE|PCRE2_EXTRA_MATCH_WORD|PCRE2_EXTRA_BIT_PARALLEL| \
+    PCRE2_EXTRA_LINEAR)
 
 #define PUBLIC_COMPILE_EXTRA_OPTIONS \
    (PUBLIC_LITERAL_COMPILE_EXTRA_OPTIONS| \
-    PCRE2_EXTRA_ALLOW_SURROGATE_ESCAPES|PCRE2_EXTRA_BAD_ESCAPE_IS_LITERAL)
+    PCRE2_EXTRA_ALLOW_SURROGATE_ESCAPES|PCRE2_EXTRA_BAD_ESCAPE_IS_LITERAL| \
+    PCRE2_EXTRA_ALWAYS_CHECK_LASTCU)
 
 /* Compile time error code numbers. They are given names so that they can more
 easily be tracked. When a new number is added, the tables called eint1 and
@@ -729,7 +731,7 @@ enum { ERR0 = COMPILE_ERROR_BASE,
        ERR61, ERR62, ERR63, ERR64, ERR65, ERR66, ERR67, ERR68, ERR69, ERR70,
        ERR71, ERR72, ERR73, ERR74, ERR75, ERR76, ERR77, ERR78, ERR79, ERR80,
        ERR81, ERR82, ERR83, ERR84, ERR85, ERR86, ERR87, ERR88, ERR89, ERR90,
-       ERR91, ERR92};
+       ERR91, ERR92, ERR93, ERR94};
 
 /* This is a table of start-of-pattern options such as (*UTF) and settings such
 as (*LIMIT_MATCH=nnnn) and (*CRLF). For completeness and backward
@@ -1101,7 +1103,9 @@ return;
 *************************************************/
 
 /* Compiled JIT code cannot be copied, so the new compiled block has no
-associated JIT data. */
+associated JIT data. A bit-parallel automaton, a one-pass program, a literal
+set automaton or string, an inner literal automaton, or a linear-time program
+is built again for the copy. */
 
 PCRE2_EXP_DEFN pcre2_code * PCRE2_CALL_CONVENTION
 pcre2_code_copy(const pcre2_code *code)
@@ -1114,6 +1118,11 @@ newcode = code->memctl.malloc(code->blocksize, code->memctl.memory_data);
 if (newcode == NULL) return NULL;
 memcpy(newcode, code, code->blocksize);
 newcode->executable_jit = NULL;
+if ((code->flags & PCRE2_BITPARALLEL) != 0) PRIV(glushkov_attach)(newcode);
+if ((code->flags & PCRE2_ONEPASS) != 0) PRIV(onepass_attach)(newcode);
+if ((code->flags & PCRE2_LITSET) != 0) PRIV(litset_attach)(newcode);
+if ((code->flags & PCRE2_LITSTRING) != 0) PRIV(literal_attach)(newcode);
+if ((code->flags & PCRE2_INNERLIT) != 0) PRIV(inner_attach)(newcode);
 
 /* If the code is one that has been deserialized, increment the reference count
 in the decoded tables. */
@@ -1124,6 +1133,16 @@ if ((code->flags & PCRE2_DEREF_TABLES) != 0)
   (*ref_count)++;
   }
 
+/* A linear-time program must be built again, because pcre2_match() cannot use
+the interpreter instead. */
+
+if ((code->flags & PCRE2_LINEAR) != 0 &&
+    PRIV(pikevm_attach)(newcode) != PIKEVM_OK)
+  {
+  pcre2_code_free(newcode);
+  return NULL;
+  }
+
 return newcode;
 }
 
@@ -1134,8 +1153,9 @@ return newcode;
 *************************************************/
 
 /* Compiled JIT code cannot be copied, so the new compiled block has no
-associated JIT data. This version of code_copy also makes a separate copy of
-the character tables. */
+associated JIT data. The other matching structures are built again for the
+copy, as in pcre2_code_copy(). This version of code_copy also makes a separate copy of the
+character tables. */
 
 PCRE2_EXP_DEFN pcre2_code * PCRE2_CALL_CONVENTION
 pcre2_code_copy_with_tables(const pcre2_code *code)
@@ -1163,6 +1183,17 @@ ref_count = (PCRE2_SIZE *)(newtables + tables_length);
 
 newcode->tables = newtables;
 newcode->flags |= PCRE2_DEREF_TABLES;
+if ((code->flags & PCRE2_BITPARALLEL) != 0) PRIV(glushkov_attach)(newcode);
+if ((code->flags & PCRE2_ONEPASS) != 0) PRIV(onepass_attach)(newcode);
+if ((code->flags & PCRE2_LITSET) != 0) PRIV(litset_attach)(newcode);
+if ((code->flags & PCRE2_LITSTRING) != 0) PRIV(literal_attach)(newcode);
+if ((code->flags & PCRE2_INNERLIT) != 0) PRIV(inner_attach)(newcode);
+if ((code->flags & PCRE2_LINEAR) != 0 &&
+    PRIV(pikevm_attach)(newcode) != PIKEVM_OK)
+  {
+  pcre2_code_free(newcode);
+  return NULL;
+  }
 return newcode;
 }
 
@@ -1182,6 +1213,24 @@ if (code != NULL)
   if (code->executable_jit != NULL)
     PRIV(jit_free)(code->executable_jit, &code->memctl);
 
+  if (code->glushkov != NULL)
+    code->memctl.free(code->glushkov, code->memctl.memory_data);
+
+  if (code->onepass != NULL)
+    code->memctl.free(code->onepass, code->memctl.memory_data);
+
+  if (code->pikevm != NULL)
+    code->memctl.free(code->pikevm, code->memctl.memory_data);
+
+  if (code->litset != NULL)
+    code->memctl.free(code->litset, code->memctl.memory_data);
+
+  if (code->literal != NULL)
+    code->memctl.free(code->literal, code->memctl.memory_data);
+
+  if (code->inner != NULL)
+    code->memctl.free(code->inner, code->memctl.memory_data);
+
   if ((code->flags & PCRE2_DEREF_TABLES) != 0)
     {
     /* Decoded tables belong to the codes after deserialization, and they must
@@ -5598,11 +5647,21 @@ for (;; pptr++)
     if (firstcuflags == REQ_UNSET) firstcuflags = REQ_NONE;
     break;
 
-    case META_PRUNE:
+    /* (*SKIP) and (*COMMIT) change where the next match attempt starts, so
+    the result of a match can depend on the starting offset. This is recorded
+    for pcre2_parallel_match_split(). */
+
     case META_SKIP:
-    cb->had_pruneorskip = TRUE;
+    cb->external_flags |= PCRE2_STARTDEP;
     /* Fall through */
+    case META_PRUNE:
+    cb->had_pruneorskip = TRUE;
+    *code++ = verbops[(meta - META_MARK) >> 16];
+    break;
+
     case META_COMMIT:
+    cb->external_flags |= PCRE2_STARTDEP;
+    /* Fall through */
     case META_FAIL:
     *code++ = verbops[(meta - META_MARK) >> 16];
     break;
@@ -5623,8 +5682,10 @@ for (;; pptr++)
     cb->external_flags |= PCRE2_HASTHEN;
     goto VERB_ARG;
 
-    case META_PRUNE_ARG:
     case META_SKIP_ARG:
+    cb->external_flags |= PCRE2_STARTDEP;
+    /* Fall through */
+    case META_PRUNE_ARG:
     cb->had_pruneorskip = TRUE;
     /* Fall through */
     case META_MARK:
@@ -7228,6 +7289,7 @@ for (;; pptr++)
     do a one-character lookbehind, and \A also behaves as if it does. */
 
     if (meta_arg == ESC_C) cb->external_flags |= PCRE2_HASBKC; /* Record */
+    if (meta_arg == ESC_G) cb->external_flags |= PCRE2_STARTDEP;
     if ((meta_arg == ESC_b || meta_arg == ESC_B || meta_arg == ESC_A) &&
          cb->max_lookbehind == 0)
       cb->max_lookbehind = 1;
@@ -7943,7 +8005,7 @@ for (;;)
   zero; the actual length is stored in the compiled code. */
 
   if (c == OP_XCLASS) code += GET(code, 1);
-    else if (c == OP_CALLOUT_STR) code += GET(code, 1 + 2*LINK_SIZE);
+  else if (c == OP_CALLOUT_STR) code += GET(code, 1 + 2*LINK_SIZE);
 
   /* Otherwise, we can get the item's length from the table, except that for
   repeated character types, we have to test for \p and \P, which have an extra
@@ -8155,6 +8217,164 @@ return c;
 
 
 
+/*************************************************
+*       Find a literal required in a match       *
+*************************************************/
+
+/* This is called after a successful compile for a pattern that has only one
+top-level alternative. It scans the items in that alternative for runs of
+caseful literal characters, each of which must appear in any matching string,
+and saves the longest one that is at least two code units long (truncated to
+REQ_LITERAL_MAX code units) so that the matchers can reject a subject that does
+not contain it. Groups of all kinds, including assertions, are skipped as a
+whole, because they may be optional, may have alternatives, or may look behind
+the start of the match. A character that is repeated one or more times ends a
+run after its first occurrence.
+
+Arguments:
+  code       points to the start of the compiled pattern
+  utf        TRUE in UTF mode
+  re         the compiled pattern block, where the literal is saved
+
+Returns:     nothing
+*/
+
+static void
+find_reqliteral(PCRE2_SPTR code, BOOL utf, pcre2_real_code *re)
+{
+PCRE2_UCHAR run[REQ_LITERAL_MAX];
+uint32_t runlength = 0;
+uint32_t count, len, i;
+BOOL endrun;
+
+#ifndef MAYBE_UTF_MULTI
+(void)(utf);  /* Keep compiler happy by referencing function argument */
+#endif
+
+if (*code != OP_BRA || code[GET(code, 1)] != OP_KET) return;
+code += 1 + LINK_SIZE;
+
+for (;;)
+  {
+  PCRE2_UCHAR c = *code;
+  PCRE2_SPTR cc = NULL;  /* Start of a literal character */
+
+  count = 1;
+  endrun = TRUE;
+
+  switch(c)
+    {
+    case OP_CHAR:
+    cc = code + 1;
+    endrun = FALSE;
+    break;
+
+    case OP_EXACT:
+    count = GET2(code, 1);
+    cc = code + 1 + IMM2_SIZE;
+    endrun = FALSE;
+    break;
+
+    case OP_PLUS:
+    case OP_MINPLUS:
+    case OP_POSPLUS:
+    cc = code + 1;
+    break;
+
+    default:
+    break;
+    }
+
+  /* Add a literal character to the current run. In UTF mode it may occupy
+  more than one code unit; the run is simply truncated if it gets too long. */
+
+  if (cc != NULL)
+    {
+    len = 1;
+#ifdef MAYBE_UTF_MULTI
+    if (utf && HAS_EXTRALEN(cc[0])) len += GET_EXTRALEN(cc[0]);
+#endif
+    while (count-- > 0)
+      for (i = 0; i < len && runlength < REQ_LITERAL_MAX; i++)
+        run[runlength++] = cc[i];
+    code = cc + len;
+    }
+
+  if (endrun || c == OP_KET || c == OP_END)
+    {
+    if (runlength > 1 && runlength > re->req_literal_length)
+      {
+      memcpy(re->req_literal, run, CU2BYTES(runlength));
+      re->req_literal_length = runlength;
+      }
+    runlength = 0;
+    }
+
+  if (cc != NULL) continue;
+  if (c == OP_KET || c == OP_END) break;
+
+  /* Skip over a group of any kind, including its alternatives. */
+
+  if (c >= OP_ASSERT && c <= OP_SCOND)
+    {
+    do code += GET(code, 1); while (*code == OP_ALT);
+    code += PRIV(OP_lengths)[*code];
+    continue;
+    }
+
+  /* Skip any other item. As in PRIV(find_bracket)(), some items have lengths
+  that are not in the table. */
+
+  if (c == OP_XCLASS) code += GET(code, 1);
+  else if (c == OP_CALLOUT_STR) code += GET(code, 1 + 2*LINK_SIZE);
+  else
+    {
+    switch(c)
+      {
+      case OP_TYPESTAR:
+      case OP_TYPEMINSTAR:
+      case OP_TYPEPLUS:
+      case OP_TYPEMINPLUS:
+      case OP_TYPEQUERY:
+      case OP_TYPEMINQUERY:
+      case OP_TYPEPOSSTAR:
+      case OP_TYPEPOSPLUS:
+      case OP_TYPEPOSQUERY:
+      if (code[1] == OP_PROP || code[1] == OP_NOTPROP) code += 2;
+      break;
+
+      case OP_TYPEUPTO:
+      case OP_TYPEMINUPTO:
+      case OP_TYPEEXACT:
+      case OP_TYPEPOSUPTO:
+      if (code[1 + IMM2_SIZE] == OP_PROP || code[1 + IMM2_SIZE] == OP_NOTPROP)
+        code += 2;
+      break;
+
+      case OP_MARK:
+      case OP_PRUNE_ARG:
+      case OP_SKIP_ARG:
+      case OP_THEN_ARG:
+      code += code[1];
+      break;
+      }
+
+    code += PRIV(OP_lengths)[c];
+
+    /* The opcodes from OP_CHARI to OP_NOTPOSUPTOI all end with a character,
+    which may be followed by more code units in UTF mode. */
+
+#ifdef MAYBE_UTF_MULTI
+    if (utf && c >= OP_CHARI && c <= OP_NOTPOSUPTOI &&
+        HAS_EXTRALEN(code[-1]))
+      code += GET_EXTRALEN(code[-1]);
+#endif
+    }
+  }
+}
+
+
+
 /*************************************************
 *     Add an entry to the name/number table      *
 *************************************************/
@@ -9452,6 +9672,12 @@ memset((char *)re + sizeof(pcre2_real_code) - 8, 0, 8);
 re->memctl = ccontext->memctl;
 re->tables = tables;
 re->executable_jit = NULL;
+re->glushkov = NULL;
+re->onepass = NULL;
+re->pikevm = NULL;
+re->litset = NULL;
+re->literal = NULL;
+re->inner = NULL;
 memset(re->start_bitmap, 0, 32 * sizeof(uint8_t));
 re->blocksize = re_blocksize;
 re->magic_number = MAGIC_NUMBER;
@@ -9471,6 +9697,7 @@ re->top_bracket = 0;
 re->top_backref = 0;
 re->name_entry_size = cb.name_entry_size;
 re->name_count = cb.names_found;
+re->req_literal_length = 0;
 
 /* The basic block is immediately followed by the name table, and the compiled
 code follows after that. */
@@ -9610,9 +9837,11 @@ auto-possessified. The function overwrites the appropriate opcode values, so
 the type of the pointer must be cast. NOTE: the intermediate variable "temp" is
 used in this code because at least one compiler gives a warning about loss of
 "const" attribute if the cast (PCRE2_UCHAR *)codestart is used directly in the
-function call. */
+function call. It is not done for PCRE2_EXTRA_LINEAR, because the linear-time
+program cannot handle possessive quantifiers. */
 
-if (errorcode == 0 && (re->overall_options & PCRE2_NO_AUTO_POSSESS) == 0)
+if (errorcode == 0 && (re->overall_options & PCRE2_NO_AUTO_POSSESS) == 0 &&
+    (ccontext->extra_options & PCRE2_EXTRA_LINEAR) == 0)
   {
   PCRE2_UCHAR *temp = (PCRE2_UCHAR *)codestart;
   if (PRIV(auto_possessify)(temp, utf, &cb) != 0) errorcode = ERR80;
@@ -9708,6 +9937,17 @@ if (reqcuflags >= 0 &&
     }
   }
 
+/* Look for the longest literal string that must be present in any match.
+This is not possible if (*ACCEPT) is used, because it can end a match early. */
+
+if (!cb.had_accept) find_reqliteral(codestart, utf, re);
+
+/* The caller may ask for the required code unit and literal string always to
+be searched for, however long the subject is. */
+
+if ((ccontext->extra_options & PCRE2_EXTRA_ALWAYS_CHECK_LASTCU) != 0)
+  re->flags |= PCRE2_LASTCHECKALL;
+
 /* Finally, unless PCRE2_NO_START_OPTIMIZE is set, study the compiled pattern
 to set up information such as a bitmap of starting code units and a minimum
 matching length. */
@@ -9719,6 +9959,80 @@ if ((re->overall_options & PCRE2_NO_START_OPTIMIZE) == 0 &&
   goto HAD_CB_ERROR;
   }
 
+/* If requested, try to build a bit-parallel automaton for the pattern. It is
+held outside the compiled block, so the flag tells pcre2_code_copy() and the
+deserializing function to build it again for a new copy. */
+
+if ((ccontext->extra_options & PCRE2_EXTRA_BIT_PARALLEL) != 0)
+  {
+  PRIV(glushkov_attach)(re);
+  if (re->glushkov != NULL) re->flags |= PCRE2_BITPARALLEL;
+  }
+
+/* An anchored pattern that can be matched in a single forward scan is given a
+one-pass program, which pcre2_match() uses instead of the interpreter. This is
+done automatically, because it is cheap. The flag works as for the automaton. */
+
+if ((re->overall_options & PCRE2_ANCHORED) != 0)
+  {
+  PRIV(onepass_attach)(re);
+  if (re->onepass != NULL) re->flags |= PCRE2_ONEPASS;
+  }
+
+/* A pattern that is just an alternation of literal strings is given an
+Aho-Corasick automaton, which pcre2_match() uses to find all the strings in a
+single scan. This is also done automatically, and the flag works in the same
+way. */
+
+PRIV(litset_attach)(re);
+if (re->litset != NULL) re->flags |= PCRE2_LITSET;
+
+/* Similarly, a pattern that is a single literal string, possibly anchored at
+either end, is matched by pcre2_match() with a substring search. */
+
+PRIV(literal_attach)(re);
+if (re->literal != NULL) re->flags |= PCRE2_LITSTRING;
+
+/* When every match of an unanchored pattern must contain a literal string that
+follows some single-character items, an automaton for those items in reverse
+order lets the matchers find the literal first, and then work back to the
+earliest place where a match could start. */
+
+PRIV(inner_attach)(re);
+if (re->inner != NULL) re->flags |= PCRE2_INNERLIT;
+
+/* A pattern compiled with PCRE2_EXTRA_LINEAR must be given a linear-time
+program, because pcre2_match() never uses the interpreter for it. The compile
+fails if the pattern contains an item that needs backtracking, or if the
+program would be too large. */
+
+if ((ccontext->extra_options & PCRE2_EXTRA_LINEAR) != 0)
+  {
+  switch(PRIV(pikevm_attach)(re))
+    {
+    case PIKEVM_OK:
+    re->flags |= PCRE2_LINEAR;
+    break;
+
+    case PIKEVM_UNSUPPORTED:
+    errorcode = ERR93;
+    break;
+
+    case PIKEVM_TOO_LARGE:
+    errorcode = ERR94;
+    break;
+
+    default:
+    errorcode = ERR21;
+    break;
+    }
+  if (errorcode != 0)
+    {
+    cb.erroroffset = 0;
+    goto HAD_CB_ERROR;
+    }
+  }
+
 /* Control ends up here in all cases. When running under valgrind, make a
 pattern's terminating zero defined again. If memory was obtained for the parsed
 version of the pattern, free it before returning. Also free the list of named
@@ -165,9 +165,11 @@ const pcre2_match_context PRIV(default_match_context) = {
 #ifdef SUPPORT_JIT
   NULL,
   NULL,
+  NULL,
 #endif
   NULL,
   NULL,
+  NULL,          /* DFA workspace */
   PCRE2_UNSET,   /* Offset limit */
   HEAP_LIMIT,
   MATCH_LIMIT,
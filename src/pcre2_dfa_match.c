@@ -85,7 +85,17 @@ in others, so I abandoned this code. */
 #define PUBLIC_DFA_MATCH_OPTIONS \
   (PCRE2_ANCHORED|PCRE2_ENDANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY| \
    PCRE2_NOTEMPTY_ATSTART|PCRE2_NO_UTF_CHECK|PCRE2_PARTIAL_HARD| \
-   PCRE2_PARTIAL_SOFT|PCRE2_DFA_SHORTEST|PCRE2_DFA_RESTART)
+   PCRE2_PARTIAL_SOFT|PCRE2_DFA_SHORTEST|PCRE2_DFA_RESTART|PCRE2_DFA_LAZY| \
+   PCRE2_NO_JIT)
+
+/* Sizes for the lazy DFA cache. A cached state's set of state blocks must fit
+in the scratch area, and the sets of all the states must fit in the pool; when
+either the states or the pool are used up, the cache is flushed. */
+
+#define LAZY_MAX_STATES   256
+#define LAZY_HASH_SIZE    512     /* Must be a power of two */
+#define LAZY_POOL_SIZE    (LAZY_MAX_STATES * 16 * INTS_PER_STATEBLOCK)
+#define LAZY_MAX_SET      1000    /* In state blocks */
 
 
 /*************************************************
@@ -3043,7 +3053,17 @@ for (;;)
   case we don't want to give a partial match.
 
   The "could_continue" variable is true if a state could have continued but
-  for the fact that the end of the subject was reached. */
+  for the fact that the end of the subject was reached.
+
+  When a workspace object is in use, the amount of the vector that the top
+  level has needed is recorded for its peak usage statistic. */
+
+  if (rlevel == 1 && mb->ws_peak != NULL)
+    {
+    int used = (active_count > new_count)? active_count : new_count;
+    PCRE2_SIZE needed = 2 + (PCRE2_SIZE)used * 2 * INTS_PER_STATEBLOCK;
+    if (needed > *(mb->ws_peak)) *(mb->ws_peak) = needed;
+    }
 
   if (new_count <= 0)
     {
@@ -3085,6 +3105,709 @@ return match_count;
 
 
 
+/*************************************************
+*     Lazy DFA: check a pattern's opcodes        *
+*************************************************/
+
+/* The lazy DFA feeds one character at a time to internal_dfa_match(), so it
+can be used only for patterns whose items look at nothing but the current
+character. Assertions of all kinds (including ^, $, and \b), back references,
+recursion, callouts, atomic groups and conditionals, and items that match more
+than one character, are not supported. A dot is supported only when the newline
+is a single fixed character, because otherwise recognizing a newline may need
+the following character.
+
+Arguments:
+  code        points to the start of the compiled pattern
+  utf         TRUE in UTF mode
+  mb          the match block, for the newline settings
+
+Returns:      TRUE if the lazy DFA can be used
+*/
+
+static BOOL
+lazy_eligible(PCRE2_SPTR code, BOOL utf, dfa_match_block *mb)
+{
+BOOL fixednl = mb->nltype == NLTYPE_FIXED && mb->nllen == 1;
+
+for (;;)
+  {
+  PCRE2_UCHAR c = *code;
+  PCRE2_UCHAR d;
+
+  switch(c)
+    {
+    case OP_END:
+    return TRUE;
+
+    case OP_XCLASS:
+    code += GET(code, 1);
+    continue;
+
+    case OP_ANY:
+    if (!fixednl) return FALSE;
+    break;
+
+    case OP_TYPESTAR:
+    case OP_TYPEMINSTAR:
+    case OP_TYPEPLUS:
+    case OP_TYPEMINPLUS:
+    case OP_TYPEQUERY:
+    case OP_TYPEMINQUERY:
+    case OP_TYPEPOSSTAR:
+    case OP_TYPEPOSPLUS:
+    case OP_TYPEPOSQUERY:
+    case OP_TYPEUPTO:
+    case OP_TYPEMINUPTO:
+    case OP_TYPEEXACT:
+    case OP_TYPEPOSUPTO:
+    d = code[(c >= OP_TYPEUPTO && c <= OP_TYPEEXACT) || c == OP_TYPEPOSUPTO?
+      1 + IMM2_SIZE : 1];
+    if (d == OP_ANYNL || d == OP_EXTUNI || d == OP_ANYBYTE) return FALSE;
+    if (d == OP_ANY && !fixednl) return FALSE;
+    if (d == OP_PROP || d == OP_NOTPROP) code += 2;
+    break;
+
+    case OP_NOT_DIGIT:
+    case OP_DIGIT:
+    case OP_NOT_WHITESPACE:
+    case OP_WHITESPACE:
+    case OP_NOT_WORDCHAR:
+    case OP_WORDCHAR:
+    case OP_ALLANY:
+    case OP_NOTPROP:
+    case OP_PROP:
+    case OP_NOT_HSPACE:
+    case OP_HSPACE:
+    case OP_NOT_VSPACE:
+    case OP_VSPACE:
+    case OP_CLASS:
+    case OP_NCLASS:
+    case OP_ALT:
+    case OP_KET:
+    case OP_KETRMAX:
+    case OP_KETRMIN:
+    case OP_BRA:
+    case OP_CBRA:
+    case OP_SBRA:
+    case OP_SCBRA:
+    case OP_BRAZERO:
+    case OP_BRAMINZERO:
+    case OP_SKIPZERO:
+    case OP_FAIL:
+    break;
+
+    default:
+    if (c >= OP_CRSTAR && c <= OP_CRPOSRANGE) break;
+    if (c < OP_CHAR || c > OP_NOTPOSUPTOI) return FALSE;
+
+    /* Characters and their repeats may be followed by a multi-unit character
+    in UTF-8 and UTF-16 modes. */
+
+    code += PRIV(OP_lengths)[c];
+#ifdef MAYBE_UTF_MULTI
+    if (utf && HAS_EXTRALEN(code[-1])) code += GET_EXTRALEN(code[-1]);
+#else
+    (void)(utf);
+#endif
+    continue;
+    }
+
+  code += PRIV(OP_lengths)[c];
+  }
+}
+
+
+
+/*************************************************
+*     Lazy DFA: find or add a cached state       *
+*************************************************/
+
+/* The set of state blocks in the cache's scratch area is put into a canonical
+form by sorting it and removing duplicates. The data field is meaningful only
+for states with negative offsets, so it is zeroed for the others. The set is
+then looked up in the hash table, and added as a new state if it is not there.
+When either the state vector or the pool is full, the whole cache is flushed
+before adding the new state.
+
+Arguments:
+  cache       the lazy DFA cache
+  count       number of state blocks in the scratch area
+  flushed     set TRUE if the cache was flushed
+
+Returns:      the index of the state, or -1 if the set is too big to cache
+*/
+
+static int
+lazy_find_state(dfa_lazy_cache *cache, int count, BOOL *flushed)
+{
+stateblock *sb = (stateblock *)cache->scratch;
+dfa_lazy_state *ds;
+uint32_t hash = 0;
+int i, j, n, size;
+
+for (i = 0; i < count; i++) if (sb[i].offset >= 0) sb[i].data = 0;
+
+for (i = 1; i < count; i++)
+  {
+  stateblock temp = sb[i];
+  for (j = i; j > 0; j--)
+    {
+    stateblock *prev = sb + j - 1;
+    if (prev->offset < temp.offset ||
+       (prev->offset == temp.offset && (prev->count < temp.count ||
+       (prev->count == temp.count && prev->data <= temp.data))))
+      break;
+    sb[j] = *prev;
+    }
+  sb[j] = temp;
+  }
+
+for (i = n = 0; i < count; i++)
+  {
+  if (n > 0 && sb[i].offset == sb[n-1].offset &&
+      sb[i].count == sb[n-1].count && sb[i].data == sb[n-1].data)
+    continue;
+  sb[n++] = sb[i];
+  }
+
+size = n * INTS_PER_STATEBLOCK;
+for (i = 0; i < size; i++)
+  hash = (hash ^ (uint32_t)cache->scratch[i]) * 16777619u;
+
+i = cache->hash[hash & (LAZY_HASH_SIZE - 1)];
+while (i >= 0)
+  {
+  ds = cache->states + i;
+  if (ds->hash == hash && ds->count == n &&
+      memcmp(cache->pool + ds->set, cache->scratch, size * sizeof(int)) == 0)
+    return i;
+  i = ds->next;
+  }
+
+if (size > LAZY_POOL_SIZE) return -1;
+if (cache->state_count >= LAZY_MAX_STATES ||
+    cache->pool_used + size > LAZY_POOL_SIZE)
+  {
+  cache->state_count = 0;
+  cache->pool_used = 0;
+  for (i = 0; i < LAZY_HASH_SIZE; i++) cache->hash[i] = -1;
+  *flushed = TRUE;
+  }
+
+i = cache->state_count++;
+ds = cache->states + i;
+ds->set = cache->pool_used;
+ds->count = n;
+ds->hash = hash;
+ds->next = cache->hash[hash & (LAZY_HASH_SIZE - 1)];
+cache->hash[hash & (LAZY_HASH_SIZE - 1)] = i;
+for (j = 0; j < 256; j++) ds->trans[j] = -1;
+memcpy(cache->pool + ds->set, cache->scratch, size * sizeof(int));
+cache->pool_used += size;
+return i;
+}
+
+
+
+/*************************************************
+*     Lazy DFA: add the starting state           *
+*************************************************/
+
+/* The starting state has one state block for each top-level alternative, as
+set up by internal_dfa_match() when it is not restarting. It is added to the
+cache when the cache is new, and again whenever it is flushed, so that it is
+always present.
+
+Arguments:
+  mb          the match block
+  cache       the lazy DFA cache
+
+Returns:      TRUE if the starting state has been added
+*/
+
+static BOOL
+lazy_add_start(dfa_match_block *mb, dfa_lazy_cache *cache)
+{
+PCRE2_SPTR code = mb->start_code;
+stateblock *sb = (stateblock *)cache->scratch;
+int length = 1 + LINK_SIZE + ((*code == OP_CBRA)? IMM2_SIZE : 0);
+int count = 0;
+BOOL flushed = FALSE;
+
+do
+  {
+  if (count >= LAZY_MAX_SET) return FALSE;
+  sb[count].offset = (int)(code - mb->start_code + length);
+  sb[count].count = 0;
+  sb[count++].data = 0;
+  code += GET(code, 1);
+  length = 1 + LINK_SIZE;
+  }
+while (*code == OP_ALT);
+
+cache->start_state = lazy_find_state(cache, count, &flushed);
+return cache->start_state >= 0;
+}
+
+
+
+/*************************************************
+*     Lazy DFA: compute a transition             *
+*************************************************/
+
+/* The states of a cached DFA state are placed in the workspace as if they had
+been saved after a partial match, and internal_dfa_match() is called with
+PCRE2_DFA_RESTART on a subject that is just the next character. Its loop
+processes the states for the character, and then, at the end of the subject,
+for the empty string that follows, recording a match if one ends after the
+character. The states that it had at the start of that second step, which are
+those for the next character, are left in the workspace. If the loop stopped
+after the first step, there are none. The starting states are added to the new
+set when matching is unanchored and a match may start after the character.
+
+Arguments:
+  mb          the match block
+  cache       the lazy DFA cache
+  from        the index of the current state
+  ptr         points to the character
+  clen        the length of the character
+  inject      TRUE if the starting states are to be added
+  workspace   the caller's workspace vector
+  wscount     size of same
+  next        where to return the (next << 1 | matched) transition value
+  flushed     set TRUE if the cache was flushed
+
+Returns:      0 on success, or an error code; PCRE2_ERROR_DFA_WSSIZE means
+                that the set of states is too big
+*/
+
+static int
+lazy_transition(dfa_match_block *mb, dfa_lazy_cache *cache, int from,
+  PCRE2_SPTR ptr, int clen, BOOL inject, int *workspace, int wscount,
+  int32_t *next, BOOL *flushed)
+{
+dfa_lazy_state *ds = cache->states + from;
+dfa_lazy_state *ss;
+PCRE2_SIZE offsets[2];
+int half = (wscount - 2) / (2 * INTS_PER_STATEBLOCK);
+int count = 0;
+int rc, n;
+
+if (ds->count > half) return PCRE2_ERROR_DFA_WSSIZE;
+memcpy(workspace + 2, cache->pool + ds->set,
+  ds->count * INTS_PER_STATEBLOCK * sizeof(int));
+workspace[0] = 0;
+workspace[1] = ds->count;
+
+mb->start_subject = ptr;
+mb->end_subject = ptr + clen;
+mb->start_used_ptr = mb->last_used_ptr = ptr;
+mb->moptions = PCRE2_DFA_RESTART;
+mb->recursive = NULL;
+
+rc = internal_dfa_match(mb, mb->start_code, ptr, 0, offsets, 2, workspace,
+  wscount, 0);
+if (rc < PCRE2_ERROR_NOMATCH) return rc;
+
+if (workspace[0] == 0)
+  {
+  count = workspace[1];
+  if (count > LAZY_MAX_SET) return PCRE2_ERROR_DFA_WSSIZE;
+  memcpy(cache->scratch, workspace + 2,
+    count * INTS_PER_STATEBLOCK * sizeof(int));
+  }
+
+if (inject)
+  {
+  ss = cache->states + cache->start_state;
+  if (count + ss->count > LAZY_MAX_SET) return PCRE2_ERROR_DFA_WSSIZE;
+  memcpy(cache->scratch + count * INTS_PER_STATEBLOCK, cache->pool + ss->set,
+    ss->count * INTS_PER_STATEBLOCK * sizeof(int));
+  count += ss->count;
+  }
+
+/* After a flush, the new state is the first one in the cache, and the
+starting state is added again after it. */
+
+n = lazy_find_state(cache, count, flushed);
+if (n < 0) return PCRE2_ERROR_DFA_WSSIZE;
+if (*flushed && !lazy_add_start(mb, cache)) return PCRE2_ERROR_DFA_WSSIZE;
+
+*next = (int32_t)((n << 1) |
+  ((rc >= 0 && offsets[1] == (PCRE2_SIZE)clen)? 1 : 0));
+return 0;
+}
+
+
+
+/*************************************************
+*     Lazy DFA: check for a match                *
+*************************************************/
+
+/* This function is called by pcre2_dfa_match() when PCRE2_DFA_LAZY is set. It
+scans the subject once, whether or not the match is anchored, following a DFA
+whose states are sets of the interpreter's states. The DFA is built lazily, a
+state and a transition at a time, and kept in the match data block so that
+later calls with the same pattern can use it. Only the existence of a match is
+determined, so the scan stops as soon as any match ends. The first ovector pair
+is set from the starting point to the end of that match.
+
+If the pattern is not suitable, or a set of states is too big to handle, FALSE
+is returned so that the normal matching can be done. The fields in the match
+block that are changed are restored in that case.
+
+Arguments:
+  mb              the match block
+  re              the compiled pattern
+  match_data      the match data block
+  start_match     the first place a match may start
+  anchored        TRUE for an anchored match
+  bumpalong_limit the last place a match may start
+  workspace       the caller's workspace vector
+  wscount         size of same
+  yield           where to put the return code
+
+Returns:          TRUE if matching was done, FALSE if not
+*/
+
+static BOOL
+lazy_dfa_match(dfa_match_block *mb, const pcre2_real_code *re,
+  pcre2_match_data *match_data, PCRE2_SPTR start_match, BOOL anchored,
+  PCRE2_SPTR bumpalong_limit, int *workspace, int wscount, int *yield)
+{
+dfa_lazy_cache *cache = match_data->dfa_cache;
+PCRE2_SPTR subject = mb->start_subject;
+PCRE2_SPTR end_subject = mb->end_subject;
+PCRE2_SPTR ptr = start_match;
+PCRE2_SIZE code_size = re->blocksize;
+PCRE2_SIZE size;
+uint32_t moptions = mb->moptions;
+BOOL endanchored = ((moptions | re->overall_options) & PCRE2_ENDANCHORED) != 0;
+BOOL crlf = (re->flags & PCRE2_HASCRORLF) == 0 &&
+  (mb->nltype != NLTYPE_FIXED || mb->nllen == 2);
+BOOL utf = (re->overall_options & PCRE2_UTF) != 0;
+BOOL eligible;
+int cur;
+int rc = PCRE2_ERROR_NOMATCH;
+int matched = -1;
+
+/* Use the cached DFA if it was made for this pattern in the same mode. */
+
+if (cache == NULL || cache->code_size != code_size ||
+    memcmp(cache->code_copy, re, code_size) != 0)
+  {
+  eligible = lazy_eligible(mb->start_code, utf, mb);
+  size = sizeof(dfa_lazy_cache) + code_size;
+  if (eligible) size += LAZY_MAX_STATES * sizeof(dfa_lazy_state) +
+    (LAZY_HASH_SIZE + LAZY_POOL_SIZE + LAZY_MAX_SET * INTS_PER_STATEBLOCK) *
+    sizeof(int);
+
+  if (cache == NULL || cache->size != size)
+    {
+    if (cache != NULL)
+      match_data->memctl.free(cache, match_data->memctl.memory_data);
+    cache = match_data->dfa_cache =
+      match_data->memctl.malloc(size, match_data->memctl.memory_data);
+    if (cache == NULL)
+      {
+      *yield = PCRE2_ERROR_NOMEMORY;
+      return TRUE;
+      }
+    cache->size = size;
+    }
+
+  cache->code_size = code_size;
+  cache->eligible = eligible;
+  cache->states = (dfa_lazy_state *)(cache + 1);
+  cache->hash = (int *)(cache->states + (eligible? LAZY_MAX_STATES : 0));
+  cache->pool = cache->hash + (eligible? LAZY_HASH_SIZE : 0);
+  cache->scratch = cache->pool + (eligible? LAZY_POOL_SIZE : 0);
+  cache->code_copy = (uint8_t *)(cache->scratch +
+    (eligible? LAZY_MAX_SET * INTS_PER_STATEBLOCK : 0));
+  memcpy(cache->code_copy, re, code_size);
+  cache->state_count = 0;
+  }
+
+if (!cache->eligible) return FALSE;
+
+if (cache->state_count == 0 || cache->anchored != anchored)
+  {
+  int i;
+  cache->anchored = anchored;
+  cache->state_count = 0;
+  cache->pool_used = 0;
+  cache->start_empty = -1;
+  for (i = 0; i < LAZY_HASH_SIZE; i++) cache->hash[i] = -1;
+  if (!lazy_add_start(mb, cache)) return FALSE;
+  }
+
+/* Find out once whether the starting states match an empty string. As no
+supported item depends on its context, this is the same at any position. */
+
+if (cache->start_empty < 0)
+  {
+  PCRE2_SIZE offsets[2];
+  mb->start_subject = mb->end_subject = mb->start_used_ptr =
+    mb->last_used_ptr = ptr;
+  mb->moptions = 0;
+  mb->recursive = NULL;
+  rc = internal_dfa_match(mb, mb->start_code, ptr, 0, offsets, 2, workspace,
+    wscount, 0);
+  if (rc < PCRE2_ERROR_NOMATCH) goto RETURN_RC;
+  cache->start_empty = (rc >= 0)? 1 : 0;
+  rc = PCRE2_ERROR_NOMATCH;
+  }
+
+if (cache->start_empty && (!endanchored || ptr == end_subject))
+  {
+  matched = (int)(ptr - subject);
+  goto RETURN_RC;
+  }
+
+/* Scan the subject a character at a time. The starting states are added at
+each position unless the match is anchored, the position is beyond the offset
+limit, or it is between CR and LF and the bumpalong in pcre2_dfa_match() would
+skip it. Only transitions for the default case are cached. */
+
+cur = cache->start_state;
+while (ptr < end_subject)
+  {
+  PCRE2_SPTR next_ptr;
+  uint32_t c;
+  int clen = 1;
+  int32_t t = -1;
+  BOOL inject;
+
+#ifdef SUPPORT_UNICODE
+  if (utf) { GETCHARLEN(c, ptr, clen); } else
+#endif
+  c = *ptr;
+
+  next_ptr = ptr + clen;
+  inject = !anchored && next_ptr <= bumpalong_limit && !(crlf &&
+    c == CHAR_CR && next_ptr < end_subject && UCHAR21TEST(next_ptr) == CHAR_NL);
+
+  if (c < 256 && inject != anchored) t = cache->states[cur].trans[c];
+  if (t < 0)
+    {
+    BOOL flushed = FALSE;
+    int trc = lazy_transition(mb, cache, cur, ptr, clen, inject, workspace,
+      wscount, &t, &flushed);
+    if (trc == PCRE2_ERROR_DFA_WSSIZE) goto FALL_BACK;
+    if (trc != 0)
+      {
+      rc = trc;
+      goto RETURN_RC;
+      }
+    if (c < 256 && inject != anchored && !flushed)
+      cache->states[cur].trans[c] = t;
+    }
+
+  cur = t >> 1;
+  ptr = next_ptr;
+
+  if (((t & 1) != 0 || (inject && cache->start_empty)) &&
+      (!endanchored || ptr == end_subject))
+    {
+    matched = (int)(ptr - subject);
+    break;
+    }
+  if (cache->states[cur].count == 0 && (anchored || ptr >= bumpalong_limit))
+    break;
+  }
+
+/* Restore the match block and set up the result. */
+
+RETURN_RC:
+mb->start_subject = subject;
+mb->end_subject = end_subject;
+mb->moptions = moptions;
+if (matched >= 0)
+  {
+  rc = 0;
+  if (match_data->oveccount > 0)
+    {
+    rc = 1;
+    match_data->ovector[0] = (PCRE2_SIZE)(start_match - subject);
+    match_data->ovector[1] = (PCRE2_SIZE)matched;
+    }
+  }
+match_data->leftchar = (PCRE2_SIZE)(start_match - subject);
+match_data->rightchar = (PCRE2_SIZE)(ptr - subject);
+match_data->startchar = (PCRE2_SIZE)(start_match - subject);
+match_data->rc = rc;
+*yield = rc;
+return TRUE;
+
+FALL_BACK:
+mb->start_subject = subject;
+mb->end_subject = end_subject;
+mb->moptions = moptions;
+mb->match_call_count = 0;
+return FALSE;
+}
+
+
+
+/*************************************************
+*     Match using a bit-parallel automaton       *
+*************************************************/
+
+/* This function is called by pcre2_dfa_match() when the pattern has a
+bit-parallel automaton, either because it was compiled with
+PCRE2_EXTRA_BIT_PARALLEL or because it was JIT-compiled with PCRE2_JIT_DFA.
+The results are the same as the interpreter's. For an unanchored match, the
+subject is first scanned once to find the earliest end of any match. No match
+can start beyond that point. Then each starting point is tried in turn, until
+one gives at least one match. The scanning loop runs until a match may end;
+that is then checked exactly, as are the assertions where a match starts.
+
+Arguments:
+  mb              the match block
+  machine         the automaton
+  match_data      the match data block
+  start_match     the first place a match may start
+  anchored        TRUE for an anchored match
+
+Returns:          as for pcre2_dfa_match()
+*/
+
+static int
+glushkov_dfa_match(dfa_match_block *mb, const glushkov_machine *machine,
+  pcre2_match_data *match_data, PCRE2_SPTR start_match, BOOL anchored)
+{
+PCRE2_SPTR subject = mb->start_subject;
+PCRE2_SPTR end_subject = mb->end_subject;
+PCRE2_SPTR start_offset_ptr = subject + mb->start_offset;
+PCRE2_SPTR last_start = start_match;
+PCRE2_SPTR ptr;
+PCRE2_SIZE *offsets = match_data->ovector;
+uint32_t offsetcount = (uint32_t)match_data->oveccount * 2;
+BOOL notempty = (mb->moptions & PCRE2_NOTEMPTY) != 0;
+BOOL notempty_atstart = (mb->moptions & PCRE2_NOTEMPTY_ATSTART) != 0;
+glushkov_context cx;
+glushkov_scan scan;
+uint64_t state;
+
+cx.start_subject = subject;
+cx.end_subject = end_subject;
+cx.start_offset = mb->start_offset;
+cx.moptions = mb->moptions;
+cx.poptions = mb->poptions;
+
+if (!anchored)
+  {
+  last_start = PRIV(glushkov_first_end)(machine, &cx, start_match);
+  if (last_start == NULL) return PCRE2_ERROR_NOMATCH;
+  }
+
+/* Try each starting point in turn. The matches are saved as the interpreter
+saves them, with the longest first. */
+
+scan.end = end_subject;
+scan.inject = 0;
+
+for (; start_match <= last_start; start_match++)
+  {
+  int match_count = -1;
+  BOOL empty_allowed = !notempty &&
+    (!notempty_atstart || start_match != start_offset_ptr);
+
+  ptr = start_match;
+  state = 1;
+
+  for (;;)
+    {
+    if (PRIV(glushkov_ends)(machine, &cx, state, ptr, empty_allowed))
+      {
+      int count;
+      if (match_count < 0) match_count = (offsetcount >= 2)? 1 : 0;
+        else if (match_count > 0 && ++match_count * 2 > (int)offsetcount)
+          match_count = 0;
+      count = ((match_count == 0)? (int)offsetcount : match_count * 2) - 2;
+      if (count > 0) memmove(offsets + 2, offsets,
+        (size_t)count * sizeof(PCRE2_SIZE));
+      if (offsetcount >= 2)
+        {
+        offsets[0] = (PCRE2_SIZE)(start_match - subject);
+        offsets[1] = (PCRE2_SIZE)(ptr - subject);
+        }
+      if ((mb->moptions & PCRE2_DFA_SHORTEST) != 0) break;
+      }
+
+    if (ptr >= end_subject) break;
+    state = PRIV(glushkov_step)(machine, &cx, state, ptr++);
+    if (state == 0) break;
+
+    scan.ptr = ptr;
+    scan.state = state;
+    PRIV(glushkov_scan)(machine, &scan);
+    ptr = scan.ptr;
+    state = scan.state;
+    if (state == 0) break;
+    }
+
+  if (match_count >= 0)
+    {
+    match_data->leftchar = (PCRE2_SIZE)(start_match - subject);
+    match_data->rightchar = (PCRE2_SIZE)(ptr - subject) +
+      ((ptr < end_subject)? 1 : 0);
+    match_data->startchar = (PCRE2_SIZE)(start_match - subject);
+    match_data->rc = match_count;
+    return match_count;
+    }
+  }
+
+return PCRE2_ERROR_NOMATCH;
+}
+
+
+
+/*************************************************
+*        Enlarge a DFA workspace object          *
+*************************************************/
+
+/* This function is called when matching with a workspace object has failed
+because the workspace is too small. The size is doubled, up to the maximum. If
+the match is a restart, the saved data from the previous partial match is put
+back at the start of the new vector.
+
+Arguments:
+  ws          the workspace object
+  restart     TRUE if PCRE2_DFA_RESTART is set
+
+Returns:      0 if the workspace has been enlarged, or
+              PCRE2_ERROR_DFA_WSSIZE if it is already at its maximum size, or
+              PCRE2_ERROR_NOMEMORY if memory could not be obtained
+*/
+
+static int
+grow_workspace(pcre2_dfa_workspace *ws, BOOL restart)
+{
+PCRE2_SIZE newsize;
+int *new;
+
+if (ws->size >= ws->maxsize) return PCRE2_ERROR_DFA_WSSIZE;
+newsize = (ws->size > ws->maxsize/2)? ws->maxsize : ws->size * 2;
+new = ws->memctl.malloc(newsize * sizeof(int), ws->memctl.memory_data);
+if (new == NULL) return PCRE2_ERROR_NOMEMORY;
+ws->memctl.free(ws->vector, ws->memctl.memory_data);
+ws->vector = new;
+ws->size = newsize;
+
+if (restart)
+  {
+  new[0] = 0;
+  new[1] = ws->saved[0];
+  memcpy(new + 2, ws->saved + 1,
+    (size_t)ws->saved[0] * INTS_PER_STATEBLOCK * sizeof(int));
+  }
+return 0;
+}
+
+
+
 /*************************************************
 *     Match a pattern using the DFA algorithm    *
 *************************************************/
@@ -3120,8 +3843,14 @@ PCRE2_SPTR start_match;
 PCRE2_SPTR end_subject;
 PCRE2_SPTR bumpalong_limit;
 PCRE2_SPTR req_cu_ptr;
+PCRE2_SPTR req_literal_ptr;
+PCRE2_SPTR inner_ptr;
+
+BOOL utf, anchored, startline, firstline, lazy;
 
-BOOL utf, anchored, startline, firstline;
+const glushkov_machine *glushkov = NULL;
+
+pcre2_dfa_workspace *wsobject = NULL;
 
 BOOL has_first_cu = FALSE;
 BOOL has_req_cu = FALSE;
@@ -3146,8 +3875,21 @@ if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(subject);
 /* Plausibility checks */
 
 if ((options & ~PUBLIC_DFA_MATCH_OPTIONS) != 0) return PCRE2_ERROR_BADOPTION;
-if (re == NULL || subject == NULL || workspace == NULL || match_data == NULL)
+if (re == NULL || subject == NULL || match_data == NULL)
   return PCRE2_ERROR_NULL;
+
+/* A NULL workspace means that the workspace object in the match context is to
+be used. */
+
+if (workspace == NULL)
+  {
+  if (mcontext == NULL || mcontext->dfa_workspace == NULL)
+    return PCRE2_ERROR_NULL;
+  wsobject = mcontext->dfa_workspace;
+  workspace = wsobject->vector;
+  wscount = wsobject->size;
+  }
+
 if (wscount < 20) return PCRE2_ERROR_DFA_WSSIZE;
 if (start_offset > length) return PCRE2_ERROR_BADOFFSET;
 
@@ -3187,13 +3929,35 @@ options |= (re->flags & FF) / ((FF & (~FF+1)) / (OO & (~OO+1)));
 #undef OO
 
 /* If restarting after a partial match, do some sanity checks on the contents
-of the workspace. */
+of the workspace. When a workspace object is in use, the saved states are
+copied, so that they can be restored if the workspace has to be enlarged. */
 
 if ((options & PCRE2_DFA_RESTART) != 0)
   {
   if ((workspace[0] & (-2)) != 0 || workspace[1] < 1 ||
     workspace[1] > (int)((wscount - 2)/INTS_PER_STATEBLOCK))
       return PCRE2_ERROR_DFA_BADRESTART;
+
+  if (wsobject != NULL)
+    {
+    PCRE2_SIZE half = (wscount - 2) / (2 * INTS_PER_STATEBLOCK);
+    PCRE2_SIZE needed = 1 + (PCRE2_SIZE)workspace[1] * INTS_PER_STATEBLOCK;
+    int *states = workspace + 2 +
+      ((workspace[0] == 0)? 0 : half * INTS_PER_STATEBLOCK);
+
+    if (needed > wsobject->saved_size)
+      {
+      int *new = wsobject->memctl.malloc(needed * sizeof(int),
+        wsobject->memctl.memory_data);
+      if (new == NULL) return PCRE2_ERROR_NOMEMORY;
+      if (wsobject->saved != NULL)
+        wsobject->memctl.free(wsobject->saved, wsobject->memctl.memory_data);
+      wsobject->saved = new;
+      wsobject->saved_size = needed;
+      }
+    wsobject->saved[0] = workspace[1];
+    memcpy(wsobject->saved + 1, states, (needed - 1) * sizeof(int));
+    }
   }
 
 /* Set some local values */
@@ -3202,6 +3966,8 @@ utf = (re->overall_options & PCRE2_UTF) != 0;
 start_match = subject + start_offset;
 end_subject = subject + length;
 req_cu_ptr = start_match - 1;
+req_literal_ptr = start_match - 1;
+inner_ptr = start_match - 1;
 anchored = (options & (PCRE2_ANCHORED|PCRE2_DFA_RESTART)) != 0 ||
   (re->overall_options & PCRE2_ANCHORED) != 0;
 
@@ -3253,6 +4019,7 @@ mb->start_offset = start_offset;
 mb->moptions = options;
 mb->poptions = re->overall_options;
 mb->match_call_count = 0;
+mb->ws_peak = (wsobject == NULL)? NULL : &(wsobject->peak);
 
 /* Process the \R and newline settings. */
 
@@ -3390,6 +4157,47 @@ match_data->subject = subject;
 match_data->mark = NULL;
 match_data->matchedby = PCRE2_MATCHEDBY_DFA_INTERPRETER;
 
+/* The lazy DFA is used if only the existence of a match is wanted, but not
+for partial matching, when restarting, when empty matches are restricted, or
+for a first line match. */
+
+lazy = (options & PCRE2_DFA_LAZY) != 0 && !firstline &&
+  (options & (PCRE2_PARTIAL_HARD|PCRE2_PARTIAL_SOFT|PCRE2_DFA_RESTART|
+    PCRE2_NOTEMPTY|PCRE2_NOTEMPTY_ATSTART)) == 0;
+
+/* If the pattern has been JIT-compiled with PCRE2_JIT_DFA and was suitable,
+the JIT-compiled bit-parallel automaton is used; otherwise one that was built
+when the pattern was compiled is used. This is not done for partial matching,
+when restarting, for a first line match or with an offset limit, when
+PCRE2_ENDANCHORED is set, or when PCRE2_NO_JIT is set. Nor is it done when
+PCRE2_DOLLAR_ENDONLY is set, because the automaton checks a multiline $ as
+pcre2_match() does, and this function does not ignore PCRE2_DOLLAR_ENDONLY for
+it. A pattern that pcre2_jit_compile_lazy() has set up counts the match first,
+so the automaton may be compiled by this call. */
+
+if (!firstline && bumpalong_limit == end_subject &&
+    (options & (PCRE2_PARTIAL_HARD|PCRE2_PARTIAL_SOFT|PCRE2_DFA_RESTART|
+      PCRE2_NO_JIT)) == 0 &&
+    ((re->overall_options | options) &
+      (PCRE2_ENDANCHORED|PCRE2_DOLLAR_ENDONLY)) == 0)
+  {
+  void *executable_jit = JIT_FETCH(re->executable_jit);
+  if (executable_jit != NULL)
+    {
+    PRIV(jit_lazy)(re, 1, length - start_offset);
+    glushkov = PRIV(jit_glushkov)(executable_jit);
+    }
+  if (glushkov == NULL) glushkov = re->glushkov;
+  }
+
+/* For a partial match, the second pair of offsets is used for the longest
+complete match that was found on the way, if any, so it is unset to begin
+with. */
+
+if ((options & (PCRE2_PARTIAL_HARD|PCRE2_PARTIAL_SOFT)) != 0 &&
+    match_data->oveccount > 1)
+  match_data->ovector[0] = match_data->ovector[1] = PCRE2_UNSET;
+
 /* Call the main matching function, looping for a non-anchored regex after a
 failed match. If not restarting, perform certain optimizations at the start of
 a match. */
@@ -3439,14 +4247,11 @@ for (;;)
 
     if (has_first_cu)
       {
-      PCRE2_UCHAR smc;
       if (first_cu != first_cu2)
-        while (start_match < end_subject &&
-          (smc = UCHAR21TEST(start_match)) != first_cu && smc != first_cu2)
-          start_match++;
+        start_match = PRIV(find_cu2)(start_match, end_subject, first_cu,
+          first_cu2);
       else
-        while (start_match < end_subject && UCHAR21TEST(start_match) != first_cu)
-          start_match++;
+        start_match = PRIV(find_cu)(start_match, end_subject, first_cu);
       }
 
     /* Or to just after a linebreak for a multiline match */
@@ -3487,23 +4292,14 @@ for (;;)
     code units greater than 254 set the 255 bit. */
 
     else if (start_bits != NULL)
-      {
-      while (start_match < end_subject)
-        {
-        uint32_t c = UCHAR21TEST(start_match);
-#if PCRE2_CODE_UNIT_WIDTH != 8
-        if (c > 255) c = 255;
-#endif
-        if ((start_bits[c/8] & (1 << (c&7))) != 0) break;
-        start_match++;
-        }
-      }
+      start_match = PRIV(find_bitmap)(start_match, end_subject, start_bits,
+        re->start_tables);
 
     /* Restore fudged end_subject */
 
     end_subject = save_end_subject;
 
-    /* The following two optimizations are disabled for partial matching. */
+    /* The following optimizations are disabled for partial matching. */
 
     if ((mb->moptions & (PCRE2_PARTIAL_HARD|PCRE2_PARTIAL_SOFT)) == 0)
       {
@@ -3518,17 +4314,20 @@ for (;;)
       subject for the match to succeed. If the first code unit is set, req_cu
       must be later in the subject; otherwise the test starts at the match
       point. This optimization can save a huge amount of backtracking in
-      patterns with nested unlimited repeats that aren't going to match.
-      Writing separate code for cased/caseless versions makes it go faster, as
-      does using an autoincrement and backing off on a match.
+      patterns with nested unlimited repeats that aren't going to match. The
+      search functions use vector instructions where they are available.
 
       HOWEVER: when the subject string is very, very long, searching to its end
       can take a long time, and give bad performance on quite ordinary
       patterns. This showed up when somebody was matching something like
-      /^\d+C/ on a 32-megabyte string... so we don't do this when the string is
-      sufficiently long. */
-
-      if (has_req_cu && end_subject - start_match < REQ_CU_MAX)
+      /^\d+C/ on a 32-megabyte string... so we don't do this for an anchored
+      match when the string is sufficiently long, unless the pattern was
+      compiled with PCRE2_EXTRA_ALWAYS_CHECK_LASTCU. An unanchored match always
+      does it, because the search result is remembered across the bumpalong
+      loop, so it cannot cost more than the bumpalong itself. */
+
+      if (has_req_cu && (!anchored || (re->flags & PCRE2_LASTCHECKALL) != 0 ||
+          end_subject - start_match < REQ_CU_MAX))
         {
         PCRE2_SPTR p = start_match + (has_first_cu? 1:0);
 
@@ -3537,20 +4336,12 @@ for (;;)
 
         if (p > req_cu_ptr)
           {
-          if (req_cu != req_cu2)
-            {
-            while (p < end_subject)
-              {
-              uint32_t pp = UCHAR21INCTEST(p);
-              if (pp == req_cu || pp == req_cu2) { p--; break; }
-              }
-            }
-          else
+          if (p < end_subject)
             {
-            while (p < end_subject)
-              {
-              if (UCHAR21INCTEST(p) == req_cu) { p--; break; }
-              }
+            if (req_cu != req_cu2)
+              p = PRIV(find_cu2)(p, end_subject, req_cu, req_cu2);
+            else
+              p = PRIV(find_cu)(p, end_subject, req_cu);
             }
 
           /* If we can't find the required code unit, break the matching loop,
@@ -3565,6 +4356,31 @@ for (;;)
           req_cu_ptr = p;
           }
         }
+
+      /* In the same way, if there is a literal string that must be present
+      in every match, search for it, unless the start has not yet passed the
+      place where it was found last time. */
+
+      if (re->req_literal_length != 0 && start_match > req_literal_ptr &&
+          (!anchored || (re->flags & PCRE2_LASTCHECKALL) != 0 ||
+           end_subject - start_match < REQ_CU_MAX))
+        {
+        req_literal_ptr = PRIV(find_literal)(start_match, end_subject,
+          re->req_literal, re->req_literal_length);
+        if (req_literal_ptr >= end_subject) break;
+        }
+
+      /* Then, if the pattern has an inner literal automaton, move on to the
+      earliest place where a match could start, as in pcre2_match(). */
+
+      if (re->inner != NULL && !anchored && !firstline &&
+          start_match > inner_ptr)
+        {
+        PCRE2_SPTR p = PRIV(inner_start)(re->inner, start_match, end_subject,
+          &inner_ptr);
+        if (p == NULL) break;
+        start_match = p;
+        }
       }
     }
 
@@ -3574,22 +4390,53 @@ for (;;)
 
   if (start_match > bumpalong_limit) break;
 
-  /* OK, now we can do the business */
+  /* For the lazy DFA, the rest of the subject is scanned just once, from the
+  first possible starting point. It gives up if the pattern contains items
+  that it does not support, and the normal matching is then done. */
 
-  mb->start_used_ptr = start_match;
-  mb->last_used_ptr = start_match;
-  mb->recursive = NULL;
+  if (lazy)
+    {
+    if (lazy_dfa_match(mb, re, match_data, start_match, anchored,
+        bumpalong_limit, workspace, (int)wscount, &rc))
+      return rc;
+    lazy = FALSE;
+    }
 
-  rc = internal_dfa_match(
-    mb,                           /* fixed match data */
-    mb->start_code,               /* this subexpression's code */
-    start_match,                  /* where we currently are */
-    start_offset,                 /* start offset in subject */
-    match_data->ovector,          /* offset vector */
-    (uint32_t)match_data->oveccount * 2,  /* actual size of same */
-    workspace,                    /* workspace vector */
-    (int)wscount,                 /* size of same */
-    0);                           /* function recurse level */
+  /* The bit-parallel automaton likewise finds the first match from here. */
+
+  if (glushkov != NULL)
+    {
+    rc = glushkov_dfa_match(mb, glushkov, match_data, start_match, anchored);
+    if (rc == PCRE2_ERROR_NOMATCH) break;
+    return rc;
+    }
+
+  /* OK, now we can do the business. If the workspace is too small and it
+  belongs to a workspace object, enlarge it and try again. */
+
+  for (;;)
+    {
+    mb->start_used_ptr = start_match;
+    mb->last_used_ptr = start_match;
+    mb->recursive = NULL;
+
+    rc = internal_dfa_match(
+      mb,                           /* fixed match data */
+      mb->start_code,               /* this subexpression's code */
+      start_match,                  /* where we currently are */
+      start_offset,                 /* start offset in subject */
+      match_data->ovector,          /* offset vector */
+      (uint32_t)match_data->oveccount * 2,  /* actual size of same */
+      workspace,                    /* workspace vector */
+      (int)wscount,                 /* size of same */
+      0);                           /* function recurse level */
+
+    if (rc != PCRE2_ERROR_DFA_WSSIZE || wsobject == NULL) break;
+    rc = grow_workspace(wsobject, (options & PCRE2_DFA_RESTART) != 0);
+    if (rc != 0) break;
+    workspace = wsobject->vector;
+    wscount = wsobject->size;
+    }
 
   /* Anything other than "no match" means we are done, always; otherwise, carry
   on only if not anchored. */
@@ -3598,6 +4445,11 @@ for (;;)
     {
     if (rc == PCRE2_ERROR_PARTIAL && match_data->oveccount > 0)
       {
+      if (match_data->oveccount > 1)
+        {
+        match_data->ovector[2] = match_data->ovector[0];
+        match_data->ovector[3] = match_data->ovector[1];
+        }
       match_data->ovector[0] = (PCRE2_SIZE)(start_match - subject);
       match_data->ovector[1] = (PCRE2_SIZE)(end_subject - subject);
       }
@@ -3641,4 +4493,116 @@ for (;;)
 return PCRE2_ERROR_NOMATCH;
 }
 
+
+
+/*************************************************
+*        Create a DFA workspace object           *
+*************************************************/
+
+/* A workspace object holds a workspace vector for pcre2_dfa_match() that is
+enlarged automatically when a match needs more, up to a maximum size, and keeps
+its size from one match to the next. Sizes are in ints, as for the workspace
+argument of pcre2_dfa_match().
+
+Arguments:
+  startsize   the initial size
+  maxsize     the maximum size
+  gcontext    a general context, for memory handling, or NULL
+
+Returns:      pointer to the new object, or NULL if no memory
+*/
+
+PCRE2_EXP_DEFN pcre2_dfa_workspace * PCRE2_CALL_CONVENTION
+pcre2_dfa_workspace_create(PCRE2_SIZE startsize, PCRE2_SIZE maxsize,
+  pcre2_general_context *gcontext)
+{
+pcre2_dfa_workspace *ws;
+
+if (maxsize > INT_MAX) maxsize = INT_MAX;
+if (maxsize < 20) maxsize = 20;
+if (startsize < 20) startsize = 20;
+if (startsize > maxsize) startsize = maxsize;
+
+ws = PRIV(memctl_malloc)(sizeof(pcre2_real_dfa_workspace),
+  (pcre2_memctl *)gcontext);
+if (ws == NULL) return NULL;
+ws->vector = ws->memctl.malloc(startsize * sizeof(int),
+  ws->memctl.memory_data);
+if (ws->vector == NULL)
+  {
+  ws->memctl.free(ws, ws->memctl.memory_data);
+  return NULL;
+  }
+ws->vector[0] = -1;  /* Catches a restart before any match */
+ws->saved = NULL;
+ws->size = startsize;
+ws->maxsize = maxsize;
+ws->peak = 0;
+ws->saved_size = 0;
+return ws;
+}
+
+
+
+/*************************************************
+*   Assign a DFA workspace object to a context   *
+*************************************************/
+
+/* When a workspace object is assigned to a match context, pcre2_dfa_match()
+uses it if its workspace argument is NULL. A NULL object removes the
+assignment.
+
+Arguments:
+  mcontext    the match context
+  ws          the workspace object, or NULL
+
+Returns:      nothing
+*/
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_dfa_workspace_assign(pcre2_match_context *mcontext,
+  pcre2_dfa_workspace *ws)
+{
+mcontext->dfa_workspace = ws;
+}
+
+
+
+/*************************************************
+*       Get DFA workspace object statistics      *
+*************************************************/
+
+/* The peak is the largest size of workspace, in ints, that any match using
+the object has needed at the top level. */
+
+PCRE2_EXP_DEFN PCRE2_SIZE PCRE2_CALL_CONVENTION
+pcre2_dfa_workspace_peak(pcre2_dfa_workspace *ws)
+{
+return ws->peak;
+}
+
+
+PCRE2_EXP_DEFN PCRE2_SIZE PCRE2_CALL_CONVENTION
+pcre2_dfa_workspace_size(pcre2_dfa_workspace *ws)
+{
+return ws->size;
+}
+
+
+
+/*************************************************
+*         Free a DFA workspace object            *
+*************************************************/
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_dfa_workspace_free(pcre2_dfa_workspace *ws)
+{
+if (ws != NULL)
+  {
+  if (ws->saved != NULL) ws->memctl.free(ws->saved, ws->memctl.memory_data);
+  ws->memctl.free(ws->vector, ws->memctl.memory_data);
+  ws->memctl.free(ws, ws->memctl.memory_data);
+  }
+}
+
 /* End of pcre2_dfa_match.c */
@@ -0,0 +1,650 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2017 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+/* This module contains functions for matching a pattern with the alternative
+(DFA) algorithm against a subject that is passed in pieces, such as data that
+is arriving from a network. Only a small amount of the subject is kept from one
+piece to the next, and matches are reported as 64-bit offsets from the start of
+the stream. The matching itself is done by pcre2_dfa_match(), using partial
+matching and restarts. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* The options that may be passed to pcre2_dfa_stream_create(). Other options
+either make no sense for a stream or are used internally. */
+
+#define PUBLIC_DFA_STREAM_OPTIONS \
+  (PCRE2_ANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY|PCRE2_NO_UTF_CHECK)
+
+/* The options that are added when a search is retried at the same point after
+an empty match, as is done by Perl's /g option. */
+
+#define RETRY_OPTIONS (PCRE2_NOTEMPTY_ATSTART|PCRE2_ANCHORED)
+
+/* Bits in the flags field of a stream. */
+
+#define STREAM_RETRY     0x0001u  /* Retry after an empty match at next */
+#define STREAM_RESTART   0x0002u  /* A long match is continued by restarting */
+#define STREAM_FALLBACK  0x0004u  /* The fallback_end field is set */
+#define STREAM_SKIPLF    0x0008u  /* Do not start a match at an LF at next */
+#define STREAM_DONE      0x0010u  /* An anchored search has ended */
+
+/* The number of characters that are kept before the point where searching
+continues, in addition to the pattern's longest lookbehind. They cover the
+characters that \b, \B, ^, and $ inspect, including a CRLF pair. */
+
+#define EXTRA_CONTEXT 2
+
+/* Initial sizes for the buffer (in code units), the vector of matches (in
+pairs), and the DFA workspace (in ints), and the maximum workspace size. */
+
+#define START_BUFFER        256
+#define START_MATCHES       64
+#define START_WORKSPACE     1000
+#define MAX_WORKSPACE       1000000
+
+
+
+/*************************************************
+*           Record a match in a stream           *
+*************************************************/
+
+/* The vector of matches is doubled in size when it is full.
+
+Arguments:
+  stream      points to the stream block
+  start       the stream offset of the start of the match
+  end         the stream offset of the end of the match
+
+Returns:      TRUE if all is well, FALSE if memory could not be obtained
+*/
+
+static BOOL
+add_match(pcre2_real_dfa_stream *stream, uint64_t start, uint64_t end)
+{
+if (stream->matches_count >= stream->matches_size)
+  {
+  PCRE2_SIZE newsize = (stream->matches_size == 0)?
+    START_MATCHES : 2 * stream->matches_size;
+  uint64_t *newvector;
+
+  if (newsize > PCRE2_SIZE_MAX / (2 * sizeof(uint64_t))) return FALSE;
+  newvector = stream->memctl.malloc(newsize * 2 * sizeof(uint64_t),
+    stream->memctl.memory_data);
+  if (newvector == NULL) return FALSE;
+  if (stream->matches != NULL)
+    {
+    memcpy(newvector, stream->matches,
+      stream->matches_count * 2 * sizeof(uint64_t));
+    stream->memctl.free(stream->matches, stream->memctl.memory_data);
+    }
+  stream->matches = newvector;
+  stream->matches_size = newsize;
+  }
+
+stream->matches[2*stream->matches_count] = start;
+stream->matches[2*stream->matches_count+1] = end;
+stream->matches_count++;
+return TRUE;
+}
+
+
+
+/*************************************************
+*      Search the unsearched part of a buffer    *
+*************************************************/
+
+/* This function searches from the point recorded in the stream up to the
+given end, in the manner of a global search. Unless this is the end of the
+stream, hard partial matching is used, so that a match that might continue in
+the next piece is not reported too soon. When such a match is found, searching
+stops at its start; the text from there on is kept and searched again when the
+next piece arrives. If the match is already longer than the retention limit,
+pcre2_dfa_match()'s restart facility is used instead, so that its text need
+not be kept. In that case, the longest complete match found so far, which
+pcre2_dfa_match() returns in the second pair of offsets, is noted, because a
+restarted match that fails must report it.
+
+Arguments:
+  stream      points to the stream block
+  end         the end of the text to search
+  final       TRUE at the end of the stream
+  mcontext    points to the match context to use
+
+Returns:      0 if all is well, or a negative error code
+*/
+
+static int
+search_buffer(pcre2_real_dfa_stream *stream, PCRE2_SIZE end, BOOL final,
+  pcre2_match_context *mcontext)
+{
+const pcre2_real_code *re = stream->code;
+const pcre2_code *code = (const pcre2_code *)re;
+PCRE2_SPTR buffer = stream->buffer;
+PCRE2_SIZE *ovector = stream->match_data->ovector;
+uint32_t options = stream->options | PCRE2_NO_UTF_CHECK;
+uint32_t partial = final? 0 : PCRE2_PARTIAL_HARD;
+uint16_t nl = re->newline_convention;
+BOOL anchored = ((options | re->overall_options) & PCRE2_ANCHORED) != 0;
+BOOL crlf = nl == PCRE2_NEWLINE_CRLF || nl == PCRE2_NEWLINE_ANY ||
+  nl == PCRE2_NEWLINE_ANYCRLF;
+#ifdef SUPPORT_UNICODE
+BOOL utf = (re->overall_options & PCRE2_UTF) != 0;
+#endif
+int rc;
+
+/* Continue a match whose start is no longer in the buffer. If it is still
+going at the end of the new text, note any longer complete match, in case the
+continuation eventually fails. */
+
+if ((stream->flags & STREAM_RESTART) != 0)
+  {
+  if (!final && end == stream->next) return 0;   /* No new text */
+
+  mcontext->dfa_workspace = stream->workspace;
+  rc = pcre2_dfa_match(code, buffer, end, stream->next,
+    options | partial | PCRE2_DFA_RESTART, stream->match_data, mcontext,
+    NULL, 0);
+
+  if (rc == PCRE2_ERROR_PARTIAL)
+    {
+    if (ovector[2] != PCRE2_UNSET)
+      {
+      stream->fallback_end = stream->base + ovector[3];
+      stream->flags |= STREAM_FALLBACK;
+      }
+    stream->next = end;
+    return 0;
+    }
+
+  /* If the continuation has failed, the search carries on at the start of the
+  new text, because the earlier text is no longer available. */
+
+  if (rc >= 0)
+    {
+    if (!add_match(stream, stream->restart_start, stream->base + ovector[1]))
+      return PCRE2_ERROR_NOMEMORY;
+    stream->next = ovector[1];
+    }
+  else if (rc == PCRE2_ERROR_NOMATCH)
+    {
+    if ((stream->flags & STREAM_FALLBACK) != 0 &&
+        !add_match(stream, stream->restart_start, stream->fallback_end))
+      return PCRE2_ERROR_NOMEMORY;
+    if (anchored) stream->flags |= STREAM_DONE;
+    }
+  else return rc;
+
+  stream->flags &= ~(STREAM_RESTART|STREAM_FALLBACK);
+  }
+
+/* Now search in the manner of a global match. */
+
+while ((stream->flags & STREAM_DONE) == 0)
+  {
+  PCRE2_SIZE next = stream->next;
+  uint32_t retry = ((stream->flags & STREAM_RETRY) != 0)? RETRY_OPTIONS : 0;
+
+  /* After a search that failed at the end of a piece that ended with CR, an
+  LF at the start of the next piece is not a starting point, just as it would
+  not be if the subject were all in one piece. */
+
+  if ((stream->flags & STREAM_SKIPLF) != 0)
+    {
+    if (next >= end && !final) break;
+    stream->flags &= ~STREAM_SKIPLF;
+    if (next < end && buffer[next] == CHAR_NL) stream->next = ++next;
+    }
+
+  mcontext->dfa_workspace = stream->workspace;
+  rc = pcre2_dfa_match(code, buffer, end, next, options | partial | retry,
+    stream->match_data, mcontext, NULL, 0);
+
+  /* Failing to match a non-empty string at the same point as an empty match
+  is not the end; the search continues one character further on. Deciding
+  whether a CR is followed by LF may need the next piece. */
+
+  if (rc == PCRE2_ERROR_NOMATCH)
+    {
+    if (retry != 0)
+      {
+      if (next >= end) break;
+      if (crlf && buffer[next] == CHAR_CR && next + 1 >= end && !final) break;
+      if (crlf && buffer[next] == CHAR_CR && next + 1 < end &&
+          buffer[next + 1] == CHAR_NL)
+        next += 2;
+      else
+        {
+        next++;
+#ifdef SUPPORT_UNICODE
+        if (utf) while (next < end && NOT_FIRSTCU(buffer[next])) next++;
+#endif
+        }
+      stream->next = next;
+      stream->flags &= ~STREAM_RETRY;
+      continue;
+      }
+
+    if (anchored)
+      {
+      if (next < end || final) stream->flags |= STREAM_DONE;
+      break;
+      }
+    if (!final && end > next && crlf && (re->flags & PCRE2_HASCRORLF) == 0 &&
+        buffer[end - 1] == CHAR_CR)
+      stream->flags |= STREAM_SKIPLF;
+    stream->next = end;
+    break;
+    }
+
+  /* A match that might continue into the next piece. */
+
+  if (rc == PCRE2_ERROR_PARTIAL)
+    {
+    PCRE2_SIZE start = ovector[0];
+    if (start != next) stream->flags &= ~STREAM_RETRY;
+    stream->next = start;
+    if (end - start <= stream->maxretain) break;
+
+    if (ovector[2] != PCRE2_UNSET)
+      {
+      stream->fallback_end = stream->base + ovector[3];
+      stream->flags |= STREAM_FALLBACK;
+      }
+    stream->restart_start = stream->base + start;
+    stream->flags = (stream->flags & ~STREAM_RETRY) | STREAM_RESTART;
+    stream->next = end;
+    break;
+    }
+
+  if (rc < 0) return rc;
+
+  /* An empty match at the end of a piece is not reported yet, because a
+  non-empty match at the same point may be possible when more text arrives. */
+
+  if (ovector[0] == ovector[1] && ovector[1] == end && !final)
+    {
+    if (ovector[0] != next) stream->flags &= ~STREAM_RETRY;
+    stream->next = end;
+    break;
+    }
+
+  if (!add_match(stream, stream->base + ovector[0], stream->base + ovector[1]))
+    return PCRE2_ERROR_NOMEMORY;
+  if (ovector[0] == ovector[1]) stream->flags |= STREAM_RETRY;
+    else stream->flags &= ~STREAM_RETRY;
+  stream->next = ovector[1];
+  }
+
+return 0;
+}
+
+
+
+/*************************************************
+*      Discard text that is no longer needed     *
+*************************************************/
+
+/* The text from the point where searching continues is kept, together with
+enough characters before it for lookbehinds and other assertions.
+
+Argument:   points to the stream block
+Returns:    nothing
+*/
+
+static void
+trim_buffer(pcre2_real_dfa_stream *stream)
+{
+PCRE2_SIZE keep = stream->next;
+uint32_t i;
+
+for (i = stream->code->max_lookbehind + EXTRA_CONTEXT; i > 0 && keep > 0; i--)
+  {
+  keep--;
+#ifdef SUPPORT_UNICODE
+  if ((stream->code->overall_options & PCRE2_UTF) != 0)
+    while (keep > 0 && NOT_FIRSTCU(stream->buffer[keep])) keep--;
+#endif
+  }
+
+if (keep == 0) return;
+memmove(stream->buffer, stream->buffer + keep,
+  CU2BYTES(stream->length - keep));
+stream->length -= keep;
+stream->next -= keep;
+stream->checked -= keep;
+stream->base += keep;
+}
+
+
+
+/*************************************************
+*       Return a stream to its initial state     *
+*************************************************/
+
+static void
+reset_stream(pcre2_real_dfa_stream *stream)
+{
+stream->length = 0;
+stream->next = 0;
+stream->checked = 0;
+stream->base = 0;
+stream->flags = 0;
+}
+
+
+
+/*************************************************
+*         Create a block for DFA streaming       *
+*************************************************/
+
+/* The pattern is not copied, so it must not be freed while the block is in
+use. If no context is supplied, the memory allocator from the pattern is used.
+Patterns and options for which a match could depend on the end of the subject
+or the first line (PCRE2_ENDANCHORED and PCRE2_FIRSTLINE) are not supported.
+
+Arguments:
+  code        points to the compiled pattern
+  options     option bits
+  maxretain   the longest unfinished match whose text is kept
+  gcontext    points to a general context, for memory management, or is NULL
+
+Returns:      pointer to the new block, or NULL on error (NULL, invalid, or
+                unsupported pattern, bad options, or failure to get memory)
+*/
+
+PCRE2_EXP_DEFN pcre2_dfa_stream * PCRE2_CALL_CONVENTION
+pcre2_dfa_stream_create(const pcre2_code *code, uint32_t options,
+  PCRE2_SIZE maxretain, pcre2_general_context *gcontext)
+{
+const pcre2_real_code *re = (const pcre2_real_code *)code;
+pcre2_dfa_stream *stream;
+
+if (re == NULL || re->magic_number != MAGIC_NUMBER ||
+    (re->flags & PCRE2_MODE_MASK) != PCRE2_CODE_UNIT_WIDTH/8 ||
+    (options & ~PUBLIC_DFA_STREAM_OPTIONS) != 0 ||
+    (re->overall_options & (PCRE2_ENDANCHORED|PCRE2_FIRSTLINE)) != 0)
+  return NULL;
+
+if (gcontext == NULL) gcontext = (pcre2_general_context *)code;
+stream = PRIV(memctl_malloc)(sizeof(pcre2_dfa_stream),
+  (pcre2_memctl *)gcontext);
+if (stream == NULL) return NULL;
+
+stream->code = re;
+stream->options = options;
+stream->maxretain = maxretain;
+stream->buffer_size = START_BUFFER;
+stream->matches = NULL;
+stream->matches_size = stream->matches_count = 0;
+reset_stream(stream);
+
+/* The other blocks use the stream's memory management functions. */
+
+stream->match_data = pcre2_match_data_create(2,
+  (pcre2_general_context *)stream);
+stream->workspace = pcre2_dfa_workspace_create(START_WORKSPACE,
+  MAX_WORKSPACE, (pcre2_general_context *)stream);
+stream->buffer = stream->memctl.malloc(CU2BYTES(START_BUFFER),
+  stream->memctl.memory_data);
+
+if (stream->match_data == NULL || stream->workspace == NULL ||
+    stream->buffer == NULL)
+  {
+  pcre2_dfa_stream_free(stream);
+  return NULL;
+  }
+
+return stream;
+}
+
+
+
+/*************************************************
+*        Free a block for DFA streaming          *
+*************************************************/
+
+/* The pattern is not freed.
+
+Argument:  the block to be freed (may be NULL)
+Returns:   nothing
+*/
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_dfa_stream_free(pcre2_dfa_stream *stream)
+{
+if (stream != NULL)
+  {
+  pcre2_match_data_free(stream->match_data);
+  pcre2_dfa_workspace_free(stream->workspace);
+  if (stream->buffer != NULL)
+    stream->memctl.free(stream->buffer, stream->memctl.memory_data);
+  if (stream->matches != NULL)
+    stream->memctl.free(stream->matches, stream->memctl.memory_data);
+  stream->memctl.free(stream, stream->memctl.memory_data);
+  }
+}
+
+
+
+/*************************************************
+*        Search the next piece of a stream       *
+*************************************************/
+
+/* The piece is added to the text that has been kept from earlier pieces, and
+the matches that can now be determined are recorded; they are available from
+pcre2_dfa_stream_count() and pcre2_dfa_stream_ovector() until the next call.
+In UTF mode, a character may be split between pieces. After an error, the
+stream should be ended or freed.
+
+Arguments:
+  stream      points to the stream block
+  piece       points to the next piece of the subject
+  length      length of the piece
+  mcontext    points to a match context, or is NULL
+
+Returns:      0 if all is well, or a negative error code, which may be any
+                error from pcre2_dfa_match()
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_dfa_stream_scan(pcre2_dfa_stream *stream, PCRE2_SPTR piece,
+  PCRE2_SIZE length, pcre2_match_context *mcontext)
+{
+pcre2_match_context mc;
+PCRE2_SIZE end;
+int rc;
+
+if (stream == NULL || (piece == NULL && length != 0)) return PCRE2_ERROR_NULL;
+if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(piece);
+stream->matches_count = 0;
+
+/* Once an anchored search has ended, there is nothing more to do. */
+
+if ((stream->flags & STREAM_DONE) != 0)
+  {
+  stream->base += stream->length + length;
+  stream->length = stream->next = stream->checked = 0;
+  return 0;
+  }
+
+/* Add the piece to the buffer, enlarging it if necessary. */
+
+if (length > stream->buffer_size - stream->length)
+  {
+  PCRE2_SIZE newsize = 2 * stream->buffer_size;
+  PCRE2_UCHAR *newbuffer;
+
+  if (length > PCRE2_SIZE_MAX/2 - stream->length) return PCRE2_ERROR_NOMEMORY;
+  if (newsize < stream->length + length) newsize = stream->length + length;
+  newbuffer = stream->memctl.malloc(CU2BYTES(newsize),
+    stream->memctl.memory_data);
+  if (newbuffer == NULL) return PCRE2_ERROR_NOMEMORY;
+  memcpy(newbuffer, stream->buffer, CU2BYTES(stream->length));
+  stream->memctl.free(stream->buffer, stream->memctl.memory_data);
+  stream->buffer = newbuffer;
+  stream->buffer_size = newsize;
+  }
+
+if (length > 0)
+  memcpy(stream->buffer + stream->length, piece, CU2BYTES(length));
+stream->length += length;
+end = stream->length;
+
+/* In UTF mode, an incomplete character at the end is not searched until the
+rest of it arrives. The new complete characters are checked just once. */
+
+#ifdef SUPPORT_UNICODE
+if ((stream->code->overall_options & PCRE2_UTF) != 0)
+  {
+  PCRE2_SIZE lead = end;
+  while (lead > stream->checked && end - lead < 4)
+    {
+    lead--;
+    if (!NOT_FIRSTCU(stream->buffer[lead])) break;
+    }
+  if (lead < end && HAS_EXTRALEN(stream->buffer[lead]) &&
+      end - lead <= GET_EXTRALEN(stream->buffer[lead]))
+    end = lead;
+
+  if ((stream->options & PCRE2_NO_UTF_CHECK) == 0 && end > stream->checked)
+    {
+    PCRE2_SIZE erroroffset;
+    rc = PRIV(valid_utf)(stream->buffer + stream->checked,
+      end - stream->checked, &erroroffset);
+    if (rc != 0) return rc;
+    }
+  }
+#endif
+stream->checked = end;
+
+mc = (mcontext == NULL)? PRIV(default_match_context) : *mcontext;
+mc.offset_limit = PCRE2_UNSET;
+
+rc = search_buffer(stream, end, FALSE, &mc);
+if (rc < 0) return rc;
+trim_buffer(stream);
+return 0;
+}
+
+
+
+/*************************************************
+*           Finish searching a stream            *
+*************************************************/
+
+/* The text that has been kept is searched as the end of the subject, and the
+remaining matches are recorded. The stream is then ready to be used for a new
+subject, whether or not there is an error.
+
+Arguments:
+  stream      points to the stream block
+  mcontext    points to a match context, or is NULL
+
+Returns:      0 if all is well, or a negative error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_dfa_stream_end(pcre2_dfa_stream *stream, pcre2_match_context *mcontext)
+{
+pcre2_match_context mc;
+int rc = 0;
+
+if (stream == NULL) return PCRE2_ERROR_NULL;
+stream->matches_count = 0;
+
+/* An incomplete character at the end is an error. */
+
+#ifdef SUPPORT_UNICODE
+if ((stream->code->overall_options & PCRE2_UTF) != 0 &&
+    (stream->options & PCRE2_NO_UTF_CHECK) == 0 &&
+    stream->length > stream->checked)
+  {
+  PCRE2_SIZE erroroffset;
+  rc = PRIV(valid_utf)(stream->buffer + stream->checked,
+    stream->length - stream->checked, &erroroffset);
+  }
+#endif
+
+if (rc == 0 && (stream->flags & STREAM_DONE) == 0)
+  {
+  mc = (mcontext == NULL)? PRIV(default_match_context) : *mcontext;
+  mc.offset_limit = PCRE2_UNSET;
+  rc = search_buffer(stream, stream->length, TRUE, &mc);
+  }
+
+reset_stream(stream);
+return rc;
+}
+
+
+
+/*************************************************
+*     Get the number of matches from a piece     *
+*************************************************/
+
+PCRE2_EXP_DEFN PCRE2_SIZE PCRE2_CALL_CONVENTION
+pcre2_dfa_stream_count(pcre2_dfa_stream *stream)
+{
+return stream->matches_count;
+}
+
+
+
+/*************************************************
+*     Get a pointer to the matches from a piece  *
+*************************************************/
+
+/* The vector contains a pair of offsets for each match that was found by the
+last call of pcre2_dfa_stream_scan() or pcre2_dfa_stream_end(). The offsets are
+in code units from the start of the stream. */
+
+PCRE2_EXP_DEFN uint64_t * PCRE2_CALL_CONVENTION
+pcre2_dfa_stream_ovector(pcre2_dfa_stream *stream)
+{
+return stream->matches;
+}
+
+/* End of pcre2_dfa_stream.c */
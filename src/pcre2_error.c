@@ -177,7 +177,9 @@ static const unsigned char compile_error_texts[] =
   /* 90 */
   "internal error: bad code value in parsed_skip()\0"
   "PCRE2_EXTRA_ALLOW_SURROGATE_ESCAPES is not allowed in UTF-16 mode\0"
-  "invalid option bits with PCRE2_LITERAL\0"  
+  "invalid option bits with PCRE2_LITERAL\0"
+  "pattern contains an item that is not supported with PCRE2_EXTRA_LINEAR\0"
+  "pattern is too large for PCRE2_EXTRA_LINEAR\0"
   ;
 
 /* Match-time and UTF error texts are in the same format. */
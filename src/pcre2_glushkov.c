@@ -0,0 +1,1778 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2017 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+/* This module contains the functions that turn a small compiled pattern into
+a bit-parallel position automaton (a Glushkov automaton), and a loop that runs
+such an automaton over a subject. The automaton can be used instead of the
+alternative matching algorithm for patterns that contain only single-character
+items, character classes, groups, alternatives, repeats, and simple assertions
+that are not in the middle of a match. A pattern may have no more than 63
+positions, that is, items that consume a character, counting each copy of a
+repeated item.
+
+The same construction is used for a reversed prefix of single-character items
+that comes before a literal in every match. Running that automaton backwards
+from where the literal is found gives the leftmost place where a match could
+start, so that the matchers need not try any earlier starting point. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* Groups may not be nested more deeply than this. */
+
+#define MAX_BUILD_DEPTH 16
+
+/* A set of characters; one bit is used for all characters greater than 255,
+because in non-UTF mode without Unicode properties, the items that are handled
+treat them all alike. */
+
+typedef struct char_set {
+  uint8_t  bits[32];
+  BOOL     high;
+} char_set;
+
+/* A fragment of the automaton that corresponds to part of the pattern: the
+positions that can be entered first, those that can be left last, and the
+guards under which the fragment can match an empty string. */
+
+typedef struct fragment {
+  uint32_t first_count;
+  uint32_t last_count;
+  uint32_t empty_count;
+  glushkov_entry first[GLUSHKOV_MAX_ENTRIES];
+  glushkov_entry last[GLUSHKOV_MAX_ENTRIES];
+  uint8_t  empty[GLUSHKOV_MAX_GUARDS];
+} fragment;
+
+/* Data that is passed around while the automaton is being built */
+
+typedef struct build_block {
+  glushkov_machine *machine;      /* The machine; it holds the guards */
+  const uint8_t *tables;          /* Character tables */
+  uint32_t nl;                    /* The newline character */
+  uint32_t depth;                 /* Group nesting depth */
+  uint32_t position_count;        /* Positions so far */
+  char_set chars[GLUSHKOV_MAX_POSITIONS + 1];   /* Characters by position */
+  uint64_t follow[GLUSHKOV_MAX_POSITIONS + 1];  /* Follow sets by position */
+} build_block;
+
+
+
+/*************************************************
+*            Character set utilities             *
+*************************************************/
+
+static void
+set_add(char_set *cs, uint32_t c)
+{
+cs->bits[c/8] |= (uint8_t)(1u << (c%8));
+}
+
+static BOOL
+set_has(const char_set *cs, uint32_t c)
+{
+if (c > 255) return cs->high;
+return (cs->bits[c/8] & (1u << (c%8))) != 0;
+}
+
+static void
+set_invert(char_set *cs)
+{
+int i;
+for (i = 0; i < 32; i++) cs->bits[i] = ~cs->bits[i];
+cs->high = !cs->high;
+}
+
+/* There are no characters greater than 255 in the 8-bit library, so the high
+bit is kept clear there. Otherwise sets that differ only in this respect would
+not compare as equal. */
+
+static void
+set_tidy(char_set *cs)
+{
+#if PCRE2_CODE_UNIT_WIDTH == 8
+cs->high = FALSE;
+#else
+cs->high = cs->high != FALSE;
+#endif
+}
+
+
+
+/*************************************************
+*                Guard utilities                 *
+*************************************************/
+
+/* Guards are held in the machine, where entry 0 is the guard that is always
+satisfied. An identical guard is shared.
+
+Arguments:
+  bb          the build block
+  bits        characters that must not come next
+  high        TRUE if characters greater than 255 must not come next
+  asserts     assertions that must hold
+
+Returns:      the guard's index, or -1 if there are too many
+*/
+
+static int
+add_guard(build_block *bb, const uint8_t *bits, BOOL high, uint32_t asserts)
+{
+glushkov_machine *m = bb->machine;
+uint32_t i;
+
+for (i = 0; i < m->guard_count; i++)
+  {
+  glushkov_guard *g = m->guards + i;
+  if ((BOOL)g->high == high && g->asserts == asserts &&
+      memcmp(g->bits, bits, 32) == 0)
+    return (int)i;
+  }
+
+if (m->guard_count >= GLUSHKOV_MAX_GUARDS) return -1;
+memcpy(m->guards[i].bits, bits, 32);
+m->guards[i].high = high;
+m->guards[i].asserts = asserts;
+m->guard_count++;
+return (int)i;
+}
+
+
+/* Make a guard that requires both of two others. */
+
+static int
+conjoin(build_block *bb, int g1, int g2)
+{
+glushkov_guard *a, *b;
+uint8_t bits[32];
+int i;
+
+if (g1 < 0 || g2 < 0) return -1;
+if (g1 == g2 || g2 == 0) return g1;
+if (g1 == 0) return g2;
+a = bb->machine->guards + g1;
+b = bb->machine->guards + g2;
+for (i = 0; i < 32; i++) bits[i] = a->bits[i] | b->bits[i];
+return add_guard(bb, bits, a->high || b->high, a->asserts | b->asserts);
+}
+
+
+/* Add a transition from one position to another under a guard. Position 0 is
+the start of a match. Assertions cannot be checked in the middle of a match,
+and the characters that are forbidden must either be none or all of those that
+the target position matches. Otherwise the automaton cannot be built.
+
+Arguments:
+  bb          the build block
+  from        the first position
+  to          the second position
+  guard       the guard's index
+
+Returns:      TRUE if OK
+*/
+
+static BOOL
+add_edge(build_block *bb, uint32_t from, uint32_t to, int guard)
+{
+const glushkov_guard *g;
+const char_set *cs = bb->chars + to;
+BOOL overlap, subset;
+int i;
+
+if (guard < 0) return FALSE;
+g = bb->machine->guards + guard;
+if (g->asserts != 0) return FALSE;
+
+overlap = cs->high && g->high;
+subset = !cs->high || g->high;
+for (i = 0; i < 32; i++)
+  {
+  if ((cs->bits[i] & g->bits[i]) != 0) overlap = TRUE;
+  if ((cs->bits[i] & ~g->bits[i]) != 0) subset = FALSE;
+  }
+
+if (!overlap) bb->follow[from] |= (uint64_t)1 << to;
+  else if (!subset) return FALSE;
+return TRUE;
+}
+
+
+
+/*************************************************
+*               Fragment utilities               *
+*************************************************/
+
+/* Add an entry to a list of first or last positions, unless it is already
+there. */
+
+static BOOL
+add_entry(glushkov_entry *list, uint32_t *count, uint32_t position, int guard)
+{
+uint32_t i;
+if (guard < 0) return FALSE;
+for (i = 0; i < *count; i++)
+  if (list[i].position == position && list[i].guard == guard) return TRUE;
+if (*count >= GLUSHKOV_MAX_ENTRIES) return FALSE;
+list[i].position = (uint8_t)position;
+list[i].guard = (uint8_t)guard;
+(*count)++;
+return TRUE;
+}
+
+
+/* Add a guard to the empty list of a fragment, unless it is already there. */
+
+static BOOL
+add_empty(fragment *f, int guard)
+{
+uint32_t i;
+if (guard < 0) return FALSE;
+for (i = 0; i < f->empty_count; i++) if (f->empty[i] == guard) return TRUE;
+if (f->empty_count >= GLUSHKOV_MAX_GUARDS) return FALSE;
+f->empty[f->empty_count++] = (uint8_t)guard;
+return TRUE;
+}
+
+
+/* Set a fragment that matches only an empty string under a guard. */
+
+static void
+set_empty(fragment *f, int guard)
+{
+f->first_count = f->last_count = 0;
+f->empty_count = 1;
+f->empty[0] = (uint8_t)guard;
+}
+
+
+/* Follow one fragment with another. The result replaces the first fragment.
+Each position that can be left last in the first is linked to each one that can
+be entered first in the second. Where one of the two fragments can match an
+empty string, the other's first or last entries are carried through, with the
+empty match's guard added, because they both apply at the same point.
+
+Arguments:
+  bb          the build block
+  a           the first fragment, updated
+  b           the second fragment
+
+Returns:      TRUE if OK
+*/
+
+static BOOL
+concatenate(build_block *bb, fragment *a, const fragment *b)
+{
+fragment r;
+uint32_t i, j;
+
+for (i = 0; i < a->last_count; i++)
+  for (j = 0; j < b->first_count; j++)
+    if (!add_edge(bb, a->last[i].position, b->first[j].position,
+        conjoin(bb, a->last[i].guard, b->first[j].guard)))
+      return FALSE;
+
+r.first_count = r.last_count = r.empty_count = 0;
+
+for (i = 0; i < a->first_count; i++)
+  if (!add_entry(r.first, &r.first_count, a->first[i].position,
+      a->first[i].guard)) return FALSE;
+for (i = 0; i < a->empty_count; i++)
+  for (j = 0; j < b->first_count; j++)
+    if (!add_entry(r.first, &r.first_count, b->first[j].position,
+        conjoin(bb, a->empty[i], b->first[j].guard))) return FALSE;
+
+for (i = 0; i < b->last_count; i++)
+  if (!add_entry(r.last, &r.last_count, b->last[i].position,
+      b->last[i].guard)) return FALSE;
+for (i = 0; i < a->last_count; i++)
+  for (j = 0; j < b->empty_count; j++)
+    if (!add_entry(r.last, &r.last_count, a->last[i].position,
+        conjoin(bb, a->last[i].guard, b->empty[j]))) return FALSE;
+
+for (i = 0; i < a->empty_count; i++)
+  for (j = 0; j < b->empty_count; j++)
+    if (!add_empty(&r, conjoin(bb, a->empty[i], b->empty[j]))) return FALSE;
+
+*a = r;
+return TRUE;
+}
+
+
+/* Merge an alternative into a fragment. */
+
+static BOOL
+alternate(fragment *a, const fragment *b)
+{
+uint32_t i;
+for (i = 0; i < b->first_count; i++)
+  if (!add_entry(a->first, &a->first_count, b->first[i].position,
+      b->first[i].guard)) return FALSE;
+for (i = 0; i < b->last_count; i++)
+  if (!add_entry(a->last, &a->last_count, b->last[i].position,
+      b->last[i].guard)) return FALSE;
+for (i = 0; i < b->empty_count; i++)
+  if (!add_empty(a, b->empty[i])) return FALSE;
+return TRUE;
+}
+
+
+/* Let a fragment repeat indefinitely by linking its last positions back to
+its first ones. */
+
+static BOOL
+loop_back(build_block *bb, const fragment *f)
+{
+uint32_t i, j;
+for (i = 0; i < f->last_count; i++)
+  for (j = 0; j < f->first_count; j++)
+    if (!add_edge(bb, f->last[i].position, f->first[j].position,
+        conjoin(bb, f->last[i].guard, f->first[j].guard)))
+      return FALSE;
+return TRUE;
+}
+
+
+/* Create a new position for a set of characters. */
+
+static BOOL
+new_position(build_block *bb, const char_set *cs, uint32_t *pposition)
+{
+if (bb->position_count >= GLUSHKOV_MAX_POSITIONS) return FALSE;
+*pposition = ++bb->position_count;
+bb->chars[*pposition] = *cs;
+return TRUE;
+}
+
+
+/* Create a new position and append it to a fragment. */
+
+static BOOL
+append_position(build_block *bb, fragment *f, const char_set *cs,
+  uint32_t *pposition)
+{
+fragment p;
+
+if (!new_position(bb, cs, pposition)) return FALSE;
+p.first_count = p.last_count = 1;
+p.empty_count = 0;
+p.first[0].position = p.last[0].position = (uint8_t)(*pposition);
+p.first[0].guard = p.last[0].guard = 0;
+return concatenate(bb, f, &p);
+}
+
+
+
+/*************************************************
+*            Build a repeated item               *
+*************************************************/
+
+/* The mandatory repeats of an item are a chain of positions. An unlimited
+repeat loops on the last of them, or on a new position if there are none. A
+limited number of optional repeats is a chain in which every position may be
+the last. For a possessive repeat, the item may not be left while the next
+character matches it. This becomes a guard on the exits, except the one from
+the final position of a limited repeat, which has no choice.
+
+Arguments:
+  bb          the build block
+  f           where to put the fragment
+  cs          the characters that the item matches
+  min         the minimum number of repeats
+  max         the maximum, or GLUSHKOV_UNLIMITED
+  possessive  TRUE for a possessive repeat
+
+Returns:      TRUE if OK
+*/
+
+static BOOL
+build_repeat(build_block *bb, fragment *f, const char_set *cs, uint32_t min,
+  uint32_t max, BOOL possessive)
+{
+fragment opt;
+int xguard = 0;
+uint32_t i, position = 0;
+
+if (possessive)
+  {
+  xguard = add_guard(bb, cs->bits, cs->high, 0);
+  if (xguard < 0) return FALSE;
+  }
+
+set_empty(f, 0);
+for (i = 0; i < min; i++)
+  if (!append_position(bb, f, cs, &position)) return FALSE;
+
+if (max == GLUSHKOV_UNLIMITED)
+  {
+  if (min == 0)
+    {
+    if (!new_position(bb, cs, &position)) return FALSE;
+    opt.first_count = opt.last_count = opt.empty_count = 1;
+    opt.first[0].position = opt.last[0].position = (uint8_t)position;
+    opt.first[0].guard = 0;
+    opt.last[0].guard = (uint8_t)xguard;
+    opt.empty[0] = (uint8_t)xguard;
+    if (!concatenate(bb, f, &opt)) return FALSE;
+    }
+  else for (i = 0; i < f->last_count; i++) f->last[i].guard = (uint8_t)xguard;
+  bb->follow[position] |= (uint64_t)1 << position;
+  }
+
+else if (max > min)
+  {
+  uint32_t count = max - min;
+  if (count > GLUSHKOV_MAX_POSITIONS) return FALSE;
+
+  opt.first_count = opt.empty_count = 1;
+  opt.last_count = 0;
+  opt.empty[0] = (uint8_t)xguard;
+  for (i = 0; i < count; i++)
+    {
+    if (!new_position(bb, cs, &position)) return FALSE;
+    if (i == 0) opt.first[0].position = (uint8_t)position;
+      else bb->follow[position - 1] |= (uint64_t)1 << position;
+    opt.last[i].position = (uint8_t)position;
+    opt.last[i].guard = (uint8_t)((i == count - 1)? 0 : xguard);
+    opt.last_count++;
+    }
+  opt.first[0].guard = 0;
+  if (!concatenate(bb, f, &opt)) return FALSE;
+  }
+
+return TRUE;
+}
+
+
+
+/*************************************************
+*      Get the characters for a type item        *
+*************************************************/
+
+/* Only types whose treatment of characters greater than 255 is uniform are
+handled.
+
+Arguments:
+  ctypes      the character types table
+  nl          the newline character
+  type        the opcode for the type
+  cs          where to put the characters
+
+Returns:      TRUE if OK
+*/
+
+static BOOL
+type_chars(const uint8_t *ctypes, uint32_t nl, uint32_t type, char_set *cs)
+{
+uint32_t c, bit;
+BOOL negated = FALSE;
+
+memset(cs, 0, sizeof(char_set));
+
+switch(type)
+  {
+  case OP_NOT_DIGIT:
+  negated = TRUE;
+  /* Fall through */
+  case OP_DIGIT:
+  bit = ctype_digit;
+  break;
+
+  case OP_NOT_WHITESPACE:
+  negated = TRUE;
+  /* Fall through */
+  case OP_WHITESPACE:
+  bit = ctype_space;
+  break;
+
+  case OP_NOT_WORDCHAR:
+  negated = TRUE;
+  /* Fall through */
+  case OP_WORDCHAR:
+  bit = ctype_word;
+  break;
+
+  case OP_ANY:
+  set_add(cs, nl);
+  set_invert(cs);
+  return TRUE;
+
+  case OP_ALLANY:
+  set_invert(cs);
+  return TRUE;
+
+#if PCRE2_CODE_UNIT_WIDTH == 8
+  case OP_NOT_HSPACE:
+  case OP_HSPACE:
+  for (c = 0; c < 256; c++)
+    {
+    switch(c)
+      {
+      HSPACE_BYTE_CASES: set_add(cs, c); break;
+      default: break;
+      }
+    }
+  if (type == OP_NOT_HSPACE) set_invert(cs);
+  return TRUE;
+
+  case OP_NOT_VSPACE:
+  case OP_VSPACE:
+  for (c = 0; c < 256; c++)
+    {
+    switch(c)
+      {
+      VSPACE_BYTE_CASES: set_add(cs, c); break;
+      default: break;
+      }
+    }
+  if (type == OP_NOT_VSPACE) set_invert(cs);
+  return TRUE;
+#endif
+
+  default:
+  return FALSE;
+  }
+
+for (c = 0; c < 256; c++) if ((ctypes[c] & bit) != 0) set_add(cs, c);
+if (negated) set_invert(cs);
+return TRUE;
+}
+
+
+
+/*************************************************
+*       Decode a single-character item           *
+*************************************************/
+
+/* This function handles the opcodes for single characters, types, and
+classes, with or without a repeat. It is also used by the one-pass matcher.
+
+Arguments:
+  tables      the character tables
+  nl          the newline character
+  code        points to the opcode
+  result      where to put the characters and the repeat
+
+Returns:      pointer after the item, or NULL if it is not handled
+*/
+
+PCRE2_SPTR
+PRIV(glushkov_item)(const uint8_t *tables, uint32_t nl, PCRE2_SPTR code,
+  glushkov_item *result)
+{
+char_set cs;
+const uint8_t *fcc = tables + fcc_offset;
+const uint8_t *ctypes = tables + ctypes_offset;
+PCRE2_UCHAR op = *code;
+PCRE2_SPTR next = code + PRIV(OP_lengths)[op];
+uint32_t c, min, max, kind;
+BOOL possessive;
+BOOL lazy = FALSE;
+
+memset(&cs, 0, sizeof(char_set));
+
+/* Single types without a repeat, and single characters, with or without a
+repeat. The repeat opcodes come in blocks of 13 in the same order for characters, caseless characters, negated
+characters, caseless negated characters, and types. */
+
+if (op < OP_CHAR)
+  {
+  if (!type_chars(ctypes, nl, op, &cs)) return NULL;
+  min = max = 1;
+  possessive = FALSE;
+  }
+
+else if (op <= OP_TYPEPOSUPTO)
+  {
+  uint32_t base;
+  BOOL caseless = FALSE;
+  BOOL negated = FALSE;
+  PCRE2_SPTR item = code + 1;
+
+  if (op >= OP_CHAR && op <= OP_NOTI)
+    {
+    kind = 0xff;   /* Not a repeat */
+    caseless = op == OP_CHARI || op == OP_NOTI;
+    negated = op == OP_NOT || op == OP_NOTI;
+    base = OP_CHAR;
+    }
+  else
+    {
+    if (op >= OP_TYPESTAR) base = OP_TYPESTAR;
+    else if (op >= OP_NOTSTARI) { base = OP_NOTSTARI; negated = caseless = TRUE; }
+    else if (op >= OP_NOTSTAR) { base = OP_NOTSTAR; negated = TRUE; }
+    else if (op >= OP_STARI) { base = OP_STARI; caseless = TRUE; }
+    else base = OP_STAR;
+    kind = op - base;
+    if (kind == OP_UPTO - OP_STAR || kind == OP_MINUPTO - OP_STAR ||
+        kind == OP_EXACT - OP_STAR || kind == OP_POSUPTO - OP_STAR)
+      item += IMM2_SIZE;
+    }
+
+  if (base == OP_TYPESTAR)
+    {
+    if (!type_chars(ctypes, nl, *item, &cs)) return NULL;
+    }
+  else
+    {
+    c = *item;
+    if (c > 255) return NULL;
+    set_add(&cs, c);
+    if (caseless) set_add(&cs, fcc[c]);
+    if (negated) set_invert(&cs);
+    }
+
+  possessive = FALSE;
+  switch(kind)
+    {
+    case 0xff:
+    min = max = 1;
+    break;
+
+    case OP_POSSTAR - OP_STAR:
+    possessive = TRUE;
+    /* Fall through */
+    case OP_MINSTAR - OP_STAR:
+    lazy = kind == OP_MINSTAR - OP_STAR;
+    /* Fall through */
+    case OP_STAR - OP_STAR:
+    min = 0;
+    max = GLUSHKOV_UNLIMITED;
+    break;
+
+    case OP_POSPLUS - OP_STAR:
+    possessive = TRUE;
+    /* Fall through */
+    case OP_MINPLUS - OP_STAR:
+    lazy = kind == OP_MINPLUS - OP_STAR;
+    /* Fall through */
+    case OP_PLUS - OP_STAR:
+    min = 1;
+    max = GLUSHKOV_UNLIMITED;
+    break;
+
+    case OP_POSQUERY - OP_STAR:
+    possessive = TRUE;
+    /* Fall through */
+    case OP_MINQUERY - OP_STAR:
+    lazy = kind == OP_MINQUERY - OP_STAR;
+    /* Fall through */
+    case OP_QUERY - OP_STAR:
+    min = 0;
+    max = 1;
+    break;
+
+    case OP_POSUPTO - OP_STAR:
+    possessive = TRUE;
+    /* Fall through */
+    case OP_MINUPTO - OP_STAR:
+    lazy = kind == OP_MINUPTO - OP_STAR;
+    /* Fall through */
+    case OP_UPTO - OP_STAR:
+    min = 0;
+    max = GET2(code, 1);
+    break;
+
+    case OP_EXACT - OP_STAR:
+    min = max = GET2(code, 1);
+    break;
+
+    default:
+    return NULL;
+    }
+  }
+
+/* Classes, with or without a repeat. When code units are wider than 8 bits,
+characters greater than 255 are in a negated class only. */
+
+else if (op == OP_CLASS || op == OP_NCLASS)
+  {
+  memcpy(cs.bits, code + 1, 32);
+  cs.high = op == OP_NCLASS;
+  next = code + 1 + 32 / sizeof(PCRE2_UCHAR);
+  op = *next;
+  possessive = FALSE;
+  min = max = 1;
+
+  switch(op)
+    {
+    case OP_CRPOSSTAR:
+    possessive = TRUE;
+    /* Fall through */
+    case OP_CRMINSTAR:
+    lazy = op == OP_CRMINSTAR;
+    /* Fall through */
+    case OP_CRSTAR:
+    min = 0;
+    max = GLUSHKOV_UNLIMITED;
+    break;
+
+    case OP_CRPOSPLUS:
+    possessive = TRUE;
+    /* Fall through */
+    case OP_CRMINPLUS:
+    lazy = op == OP_CRMINPLUS;
+    /* Fall through */
+    case OP_CRPLUS:
+    min = 1;
+    max = GLUSHKOV_UNLIMITED;
+    break;
+
+    case OP_CRPOSQUERY:
+    possessive = TRUE;
+    /* Fall through */
+    case OP_CRMINQUERY:
+    lazy = op == OP_CRMINQUERY;
+    /* Fall through */
+    case OP_CRQUERY:
+    min = 0;
+    max = 1;
+    break;
+
+    case OP_CRPOSRANGE:
+    possessive = TRUE;
+    /* Fall through */
+    case OP_CRMINRANGE:
+    lazy = op == OP_CRMINRANGE;
+    /* Fall through */
+    case OP_CRRANGE:
+    min = GET2(next, 1);
+    max = GET2(next, 1 + IMM2_SIZE);
+    if (max == 0) max = GLUSHKOV_UNLIMITED;
+    break;
+
+    default:
+    op = OP_END;   /* No repeat */
+    break;
+    }
+  if (op != OP_END) next += PRIV(OP_lengths)[op];
+  }
+
+else return NULL;
+
+set_tidy(&cs);
+memcpy(result->bits, cs.bits, 32);
+result->high = cs.high;
+result->min = min;
+result->max = max;
+result->kind = possessive? GLUSHKOV_POSSESSIVE :
+  lazy? GLUSHKOV_LAZY : GLUSHKOV_GREEDY;
+return next;
+}
+
+
+
+/*************************************************
+*        Build a single-character item           *
+*************************************************/
+
+/* The item is decoded and turned into positions.
+
+Arguments:
+  bb          the build block
+  code        points to the opcode
+  f           where to put the fragment
+
+Returns:      pointer after the item, or NULL if it is not handled
+*/
+
+static PCRE2_SPTR
+build_item(build_block *bb, PCRE2_SPTR code, fragment *f)
+{
+glushkov_item item;
+char_set cs;
+
+code = PRIV(glushkov_item)(bb->tables, bb->nl, code, &item);
+if (code == NULL || item.min > GLUSHKOV_MAX_POSITIONS) return NULL;
+memcpy(cs.bits, item.bits, 32);
+cs.high = item.high;
+if (!build_repeat(bb, f, &cs, item.min, item.max,
+    item.kind == GLUSHKOV_POSSESSIVE)) return NULL;
+return code;
+}
+
+
+
+/*************************************************
+*          Build a sequence of items             *
+*************************************************/
+
+/* A sequence ends at OP_ALT or at the end of the group.
+
+Arguments:
+  bb          the build block
+  code        points to the first item
+  f           where to put the fragment
+
+Returns:      pointer to the end of the sequence, or NULL if not handled
+*/
+
+static PCRE2_SPTR build_group(build_block *, PCRE2_SPTR, fragment *);
+
+static PCRE2_SPTR
+build_sequence(build_block *bb, PCRE2_SPTR code, fragment *f)
+{
+set_empty(f, 0);
+
+for (;;)
+  {
+  fragment item;
+  uint32_t asserts = 0;
+
+  switch(*code)
+    {
+    case OP_ALT:
+    case OP_KET:
+    case OP_KETRMAX:
+    case OP_KETRMIN:
+    return code;
+
+    case OP_BRA:
+    case OP_CBRA:
+    case OP_SBRA:
+    case OP_SCBRA:
+    code = build_group(bb, code, &item);
+    break;
+
+    case OP_BRAZERO:
+    case OP_BRAMINZERO:
+    code = build_group(bb, code + 1, &item);
+    if (code != NULL && !add_empty(&item, 0)) return NULL;
+    break;
+
+    /* A group that is repeated zero times is skipped. */
+
+    case OP_SKIPZERO:
+    code++;
+    do code += GET(code, 1); while (*code == OP_ALT);
+    code += 1 + LINK_SIZE;
+    continue;
+
+    case OP_FAIL:
+    item.first_count = item.last_count = item.empty_count = 0;
+    code++;
+    break;
+
+    case OP_SOD: asserts = GLUSHKOV_A_SOD; break;
+    case OP_SOM: asserts = GLUSHKOV_A_SOM; break;
+    case OP_CIRC: asserts = GLUSHKOV_A_CIRC; break;
+    case OP_CIRCM: asserts = GLUSHKOV_A_CIRCM; break;
+    case OP_EOD: asserts = GLUSHKOV_A_EOD; break;
+    case OP_EODN: asserts = GLUSHKOV_A_EODN; break;
+    case OP_DOLL: asserts = GLUSHKOV_A_DOLL; break;
+    case OP_DOLLM: asserts = GLUSHKOV_A_DOLLM; break;
+
+    default:
+    code = build_item(bb, code, &item);
+    break;
+    }
+
+  if (asserts != 0)
+    {
+    uint8_t nobits[32];
+    memset(nobits, 0, 32);
+    int guard = add_guard(bb, nobits, FALSE, asserts);
+    if (guard < 0) return NULL;
+    set_empty(&item, guard);
+    code++;
+    }
+  if (code == NULL) return NULL;
+  if (!concatenate(bb, f, &item)) return NULL;
+  }
+}
+
+
+
+/*************************************************
+*                Build a group                   *
+*************************************************/
+
+/* The alternatives of a group are merged. A group that repeats indefinitely
+is looped back on itself.
+
+Arguments:
+  bb          the build block
+  code        points to the opening bracket
+  f           where to put the fragment
+
+Returns:      pointer after the group, or NULL if it is not handled
+*/
+
+static PCRE2_SPTR
+build_group(build_block *bb, PCRE2_SPTR code, fragment *f)
+{
+PCRE2_UCHAR op = *code;
+
+if (op != OP_BRA && op != OP_CBRA && op != OP_SBRA && op != OP_SCBRA)
+  return NULL;
+if (++bb->depth > MAX_BUILD_DEPTH) return NULL;
+
+f->first_count = f->last_count = f->empty_count = 0;
+do
+  {
+  fragment branch;
+  code = build_sequence(bb, code + PRIV(OP_lengths)[*code], &branch);
+  if (code == NULL || !alternate(f, &branch)) return NULL;
+  }
+while (*code == OP_ALT);
+
+if ((*code == OP_KETRMAX || *code == OP_KETRMIN) && !loop_back(bb, f))
+  return NULL;
+
+bb->depth--;
+return code + 1 + LINK_SIZE;
+}
+
+
+
+/*************************************************
+*        Check whether a match may end           *
+*************************************************/
+
+/* This is used to decide whether the scanning loop must stop before a given
+character, so that a possible end of match can be checked exactly. A guard
+that forbids the character, or an assertion that needs the end of the subject
+or a newline, cannot hold there.
+
+Arguments:
+  bb          the build block
+  guard       the guard's index
+  c           the character, or 256 for all characters greater than 255
+
+Returns:      TRUE if the guard may hold
+*/
+
+static BOOL
+may_end(build_block *bb, uint32_t guard, uint32_t c)
+{
+const glushkov_guard *g = bb->machine->guards + guard;
+
+if (c > 255)
+  {
+  if (g->high) return FALSE;
+  }
+else if ((g->bits[c/8] & (1u << (c%8))) != 0) return FALSE;
+
+if ((g->asserts & GLUSHKOV_A_EOD) != 0) return FALSE;
+if ((g->asserts & (GLUSHKOV_A_EODN|GLUSHKOV_A_DOLL|GLUSHKOV_A_DOLLM)) != 0 &&
+    c != bb->nl)
+  return FALSE;
+return TRUE;
+}
+
+
+
+/*************************************************
+*          Build a Glushkov automaton            *
+*************************************************/
+
+/* The pattern must not be in UTF or UCP mode, and the newline must be a
+single character. Entries to a match that have assertions can only be at the
+start of the subject or the starting offset; they are checked by the caller
+when a match is started. All other entries are in the follow set of the start
+position.
+
+Arguments:
+  re          the compiled pattern
+  machine     where to build the automaton
+
+Returns:      TRUE if the automaton was built
+*/
+
+BOOL
+PRIV(glushkov_build)(const pcre2_real_code *re, glushkov_machine *machine)
+{
+build_block bb;
+fragment top;
+PCRE2_SPTR code = (PCRE2_SPTR)((const uint8_t *)re + sizeof(pcre2_real_code)) +
+  re->name_count * re->name_entry_size;
+uint32_t i, c, t;
+
+if ((re->overall_options & (PCRE2_UTF|PCRE2_UCP)) != 0) return FALSE;
+
+switch(re->newline_convention)
+  {
+  case PCRE2_NEWLINE_CR: bb.nl = CHAR_CR; break;
+  case PCRE2_NEWLINE_LF: bb.nl = CHAR_NL; break;
+  case PCRE2_NEWLINE_NUL: bb.nl = CHAR_NUL; break;
+  default: return FALSE;
+  }
+
+memset(machine, 0, sizeof(glushkov_machine));
+machine->guard_count = 1;
+
+bb.machine = machine;
+bb.tables = re->tables;
+bb.depth = 0;
+bb.position_count = 0;
+memset(bb.follow, 0, sizeof(bb.follow));
+
+code = build_group(&bb, code, &top);
+if (code == NULL || *code != OP_END) return FALSE;
+
+for (i = 0; i < top.first_count; i++)
+  {
+  glushkov_entry *e = top.first + i;
+  uint32_t asserts = machine->guards[e->guard].asserts;
+  if (asserts == 0)
+    {
+    if (!add_edge(&bb, 0, e->position, e->guard)) return FALSE;
+    }
+  else if ((asserts &
+      ~(GLUSHKOV_A_SOD|GLUSHKOV_A_SOM|GLUSHKOV_A_CIRC)) != 0) return FALSE;
+  else machine->first[machine->first_count++] = *e;
+  }
+
+memcpy(machine->last, top.last, top.last_count * sizeof(glushkov_entry));
+machine->last_count = top.last_count;
+memcpy(machine->empty, top.empty, top.empty_count);
+machine->empty_count = top.empty_count;
+machine->position_count = bb.position_count;
+machine->newline = bb.nl;
+machine->follow_tables = bb.position_count/8 + 1;
+
+for (c = 0; c <= 256; c++)
+  {
+  glushkov_record *r = machine->records + c;
+  for (i = 1; i <= bb.position_count; i++)
+    if (set_has(bb.chars + i, c)) r->chars |= (uint64_t)1 << i;
+  for (i = 0; i < top.empty_count; i++)
+    if (may_end(&bb, top.empty[i], c)) r->accept |= 1;
+  for (i = 0; i < top.last_count; i++)
+    if (may_end(&bb, top.last[i].guard, c))
+      r->accept |= (uint64_t)1 << top.last[i].position;
+  }
+
+for (t = 0; t < machine->follow_tables; t++)
+  {
+  for (c = 0; c < 256; c++)
+    {
+    uint64_t follow = 0;
+    for (i = 0; i < 8; i++)
+      if ((c & (1u << i)) != 0 && 8*t + i <= bb.position_count)
+        follow |= bb.follow[8*t + i];
+    machine->follow[t][c] = follow;
+    }
+  }
+
+return TRUE;
+}
+
+
+
+/*************************************************
+*        Run a Glushkov automaton                *
+*************************************************/
+
+/* This is the scanning loop. If it has been JIT-compiled, the JIT code, which
+does exactly the same, is run instead. The scan stops at the end of the
+subject, when no states are left, or before a character at which a match may
+end. On return, the state set is the one that applies before that character,
+with the inject bits included.
+
+Arguments:
+  machine     the automaton
+  scan        the scan block, updated
+
+Returns:      nothing
+*/
+
+void
+PRIV(glushkov_scan)(const glushkov_machine *machine, glushkov_scan *scan)
+{
+PCRE2_SPTR ptr = scan->ptr;
+PCRE2_SPTR end = scan->end;
+uint64_t state = scan->state;
+uint64_t inject = scan->inject;
+uint32_t tables = machine->follow_tables;
+
+if (machine->jit_scan != NULL)
+  {
+  PRIV(jit_glushkov_scan)(machine, scan);
+  return;
+  }
+
+for (;;)
+  {
+  const glushkov_record *r;
+  uint64_t next;
+  uint32_t c, t;
+
+  state |= inject;
+  if (ptr >= end || state == 0) break;
+  c = *ptr;
+#if PCRE2_CODE_UNIT_WIDTH != 8
+  if (c > 255) c = 256;
+#endif
+  r = machine->records + c;
+  if ((state & r->accept) != 0) break;
+  next = 0;
+  for (t = 0; t < tables; t++)
+    next |= machine->follow[t][(state >> (8*t)) & 0xff];
+  state = next & r->chars;
+  ptr++;
+  }
+
+scan->ptr = ptr;
+scan->state = state;
+}
+
+
+
+/*************************************************
+*              Check assertions                  *
+*************************************************/
+
+/* The assertions are checked exactly as pcre2_match() checks them. The
+newline is always a single character. This function is also used by the
+one-pass matcher.
+
+Arguments:
+  cx          the subject and options
+  nl          the newline character
+  asserts     the assertion bits
+  ptr         the current position
+
+Returns:      TRUE if all the assertions hold
+*/
+
+BOOL
+PRIV(glushkov_asserts)(const glushkov_context *cx, uint32_t nl,
+  uint32_t asserts, PCRE2_SPTR ptr)
+{
+PCRE2_SPTR start_subject = cx->start_subject;
+PCRE2_SPTR end_subject = cx->end_subject;
+BOOL notbol = (cx->moptions & PCRE2_NOTBOL) != 0;
+BOOL noteol = (cx->moptions & PCRE2_NOTEOL) != 0;
+BOOL endonly = (cx->poptions & PCRE2_DOLLAR_ENDONLY) != 0;
+BOOL at_nl = ptr < end_subject && *ptr == nl;
+
+if ((asserts & GLUSHKOV_A_SOD) != 0 && ptr != start_subject) return FALSE;
+
+if ((asserts & GLUSHKOV_A_SOM) != 0 &&
+    ptr != start_subject + cx->start_offset) return FALSE;
+
+if ((asserts & GLUSHKOV_A_CIRC) != 0 &&
+    (ptr != start_subject || notbol)) return FALSE;
+
+if ((asserts & GLUSHKOV_A_CIRCM) != 0 &&
+    (ptr != start_subject || notbol) &&
+    ((ptr == end_subject && (cx->poptions & PCRE2_ALT_CIRCUMFLEX) == 0) ||
+      ptr == start_subject || ptr[-1] != nl)) return FALSE;
+
+if ((asserts & GLUSHKOV_A_EOD) != 0 && ptr < end_subject) return FALSE;
+
+if ((asserts & GLUSHKOV_A_EODN) != 0 && ptr < end_subject &&
+    (!at_nl || ptr != end_subject - 1)) return FALSE;
+
+if ((asserts & GLUSHKOV_A_DOLL) != 0 && (noteol ||
+    (ptr < end_subject && (endonly || !at_nl || ptr != end_subject - 1))))
+  return FALSE;
+
+if ((asserts & GLUSHKOV_A_DOLLM) != 0 &&
+    (ptr < end_subject? !at_nl : noteol)) return FALSE;
+
+return TRUE;
+}
+
+
+
+/*************************************************
+*                Check a guard                   *
+*************************************************/
+
+static BOOL
+check_guard(const glushkov_machine *machine, const glushkov_context *cx,
+  uint32_t guard, PCRE2_SPTR ptr)
+{
+const glushkov_guard *g = machine->guards + guard;
+
+if (ptr < cx->end_subject)
+  {
+  uint32_t c = *ptr;
+  if (c > 255)
+    {
+    if (g->high) return FALSE;
+    }
+  else if ((g->bits[c/8] & (1u << (c%8))) != 0) return FALSE;
+  }
+
+return g->asserts == 0 ||
+  PRIV(glushkov_asserts)(cx, machine->newline, g->asserts, ptr);
+}
+
+
+
+/*************************************************
+*          Check whether a match ends            *
+*************************************************/
+
+/* Bit 0 of the state set is present when a match may start at the current
+position; it matches an empty string if one of the empty guards holds.
+
+Arguments:
+  machine       the automaton
+  cx            the subject and options
+  state         the state set before the current position
+  ptr           the current position
+  empty_allowed TRUE if an empty match is allowed here
+
+Returns:        TRUE if a match ends here
+*/
+
+BOOL
+PRIV(glushkov_ends)(const glushkov_machine *machine,
+  const glushkov_context *cx, uint64_t state, PCRE2_SPTR ptr,
+  BOOL empty_allowed)
+{
+uint32_t i;
+
+if ((state & 1) != 0 && empty_allowed)
+  {
+  for (i = 0; i < machine->empty_count; i++)
+    if (check_guard(machine, cx, machine->empty[i], ptr)) return TRUE;
+  }
+
+for (i = 0; i < machine->last_count; i++)
+  {
+  if ((state & ((uint64_t)1 << machine->last[i].position)) != 0 &&
+      check_guard(machine, cx, machine->last[i].guard, ptr))
+    return TRUE;
+  }
+
+return FALSE;
+}
+
+
+
+/*************************************************
+*          Advance over one character            *
+*************************************************/
+
+/* This is the step of the scanning loop, with the addition of the entries to
+a match whose guards have assertions. It must not be called at the end of the
+subject.
+
+Arguments:
+  machine     the automaton
+  cx          the subject and options
+  state       the state set before the current position
+  ptr         the current position
+
+Returns:      the state set after the current character
+*/
+
+uint64_t
+PRIV(glushkov_step)(const glushkov_machine *machine,
+  const glushkov_context *cx, uint64_t state, PCRE2_SPTR ptr)
+{
+const glushkov_record *r;
+uint64_t next = 0;
+uint32_t c = *ptr;
+uint32_t i;
+
+#if PCRE2_CODE_UNIT_WIDTH != 8
+if (c > 255) c = 256;
+#endif
+r = machine->records + c;
+
+for (i = 0; i < machine->follow_tables; i++)
+  next |= machine->follow[i][(state >> (8*i)) & 0xff];
+next &= r->chars;
+
+if ((state & 1) != 0)
+  {
+  for (i = 0; i < machine->first_count; i++)
+    {
+    uint64_t bit = (uint64_t)1 << machine->first[i].position;
+    if ((r->chars & bit) != 0 &&
+        check_guard(machine, cx, machine->first[i].guard, ptr))
+      next |= bit;
+    }
+  }
+
+return next;
+}
+
+
+
+/*************************************************
+*   Check whether an empty match is allowed      *
+*************************************************/
+
+static BOOL
+empty_allowed(const glushkov_context *cx, PCRE2_SPTR ptr)
+{
+if ((cx->moptions & PCRE2_NOTEMPTY) != 0) return FALSE;
+return (cx->moptions & PCRE2_NOTEMPTY_ATSTART) == 0 ||
+  ptr != cx->start_subject + cx->start_offset;
+}
+
+
+
+/*************************************************
+*      Find the earliest end of any match        *
+*************************************************/
+
+/* The subject is scanned once, with a match allowed to start at every
+position from the given one, by adding bit 0 to the state set before each
+character. No match can start beyond the point that is found.
+
+Arguments:
+  machine     the automaton
+  cx          the subject and options
+  ptr         the first place a match may start
+
+Returns:      the earliest end of a match, or NULL if there is no match
+*/
+
+PCRE2_SPTR
+PRIV(glushkov_first_end)(const glushkov_machine *machine,
+  const glushkov_context *cx, PCRE2_SPTR ptr)
+{
+glushkov_scan scan;
+uint64_t state = 1;
+
+scan.end = cx->end_subject;
+scan.inject = 1;
+
+for (;;)
+  {
+  if (PRIV(glushkov_ends)(machine, cx, state, ptr, empty_allowed(cx, ptr)))
+    return ptr;
+  if (ptr >= cx->end_subject) return NULL;
+  scan.state = PRIV(glushkov_step)(machine, cx, state, ptr);
+  scan.ptr = ptr + 1;
+  PRIV(glushkov_scan)(machine, &scan);
+  ptr = scan.ptr;
+  state = scan.state;
+  }
+}
+
+
+
+/*************************************************
+*  Check whether a match starts at a position    *
+*************************************************/
+
+/* The automaton is run from the given position until a match ends or no
+states are left.
+
+Arguments:
+  machine     the automaton
+  cx          the subject and options
+  start       the starting position
+
+Returns:      TRUE if there is a match that starts at the given position
+*/
+
+BOOL
+PRIV(glushkov_match_at)(const glushkov_machine *machine,
+  const glushkov_context *cx, PCRE2_SPTR start)
+{
+glushkov_scan scan;
+PCRE2_SPTR ptr = start;
+uint64_t state = 1;
+
+if (PRIV(glushkov_ends)(machine, cx, state, ptr, empty_allowed(cx, ptr)))
+  return TRUE;
+
+scan.end = cx->end_subject;
+scan.inject = 0;
+
+while (ptr < cx->end_subject)
+  {
+  scan.state = PRIV(glushkov_step)(machine, cx, state, ptr);
+  if (scan.state == 0) return FALSE;
+  scan.ptr = ptr + 1;
+  PRIV(glushkov_scan)(machine, &scan);
+  ptr = scan.ptr;
+  state = scan.state;
+  if (state == 0) return FALSE;
+  if (PRIV(glushkov_ends)(machine, cx, state, ptr, FALSE)) return TRUE;
+  }
+
+return FALSE;
+}
+
+
+
+/*************************************************
+*     Attach an automaton to a compiled pattern  *
+*************************************************/
+
+/* This is called by pcre2_compile() when PCRE2_EXTRA_BIT_PARALLEL is set, and
+when a pattern that has an automaton is copied or deserialized, because the
+automaton is held outside the compiled block. If the pattern is not suitable,
+or there is no memory, the pattern is left without an automaton; it is only an
+optimization.
+
+Argument:   the compiled pattern
+Returns:    nothing
+*/
+
+void
+PRIV(glushkov_attach)(pcre2_real_code *re)
+{
+glushkov_machine *machine = re->memctl.malloc(sizeof(glushkov_machine),
+  re->memctl.memory_data);
+
+re->glushkov = NULL;
+if (machine == NULL) return;
+if (!PRIV(glushkov_build)(re, machine))
+  {
+  re->memctl.free(machine, re->memctl.memory_data);
+  return;
+  }
+re->glushkov = machine;
+}
+
+/*************************************************
+*       Find an inner literal and its prefix     *
+*************************************************/
+
+/* The single top-level alternative of a pattern is scanned for runs of
+literal characters, in the same way as for the required literal (see
+find_reqliteral() in pcre2_compile.c). Groups that have one alternative and
+are not repeated are entered, because they make no difference to the
+characters that are matched. The scan stops at the first item that is not a
+single character, type, or class. A run is a candidate if it comes after at
+least one item, and none of the items before it can match its first code unit.
+A match that starts before an occurrence of the literal can then not contain
+that occurrence in its prefix, so every match that starts at or before the
+first occurrence from a given point uses that occurrence. The longest
+candidate is chosen.
+
+Arguments:
+  re          the compiled pattern
+  nl          the newline character
+  items       where to put the items of the prefix
+  pcount      where to put the number of items in the prefix
+  inner       where to put the literal and its length
+
+Returns:      TRUE if a literal was found
+*/
+
+static BOOL
+find_inner(const pcre2_real_code *re, uint32_t nl, glushkov_item *items,
+  uint32_t *pcount, inner_literal *inner)
+{
+PCRE2_UCHAR run[REQ_LITERAL_MAX];
+PCRE2_SPTR code = (PCRE2_SPTR)((const uint8_t *)re + sizeof(pcre2_real_code)) +
+  re->name_count * re->name_entry_size;
+uint32_t runlength = 0;
+uint32_t runstart = 0;
+uint32_t count = 0;
+
+inner->length = 0;
+if (*code != OP_BRA || code[GET(code, 1)] != OP_KET) return FALSE;
+code += 1 + LINK_SIZE;
+
+for (;;)
+  {
+  PCRE2_UCHAR op = *code;
+  PCRE2_SPTR next = NULL;
+  glushkov_item item;
+  uint32_t c = 0;
+  uint32_t n = 0;
+  BOOL endrun = TRUE;
+
+  if ((op == OP_BRA || op == OP_CBRA) && code[GET(code, 1)] == OP_KET)
+    {
+    code += PRIV(OP_lengths)[op];
+    continue;
+    }
+
+  if (op == OP_KET)
+    {
+    code += 1 + LINK_SIZE;
+    if (*code != OP_END) continue;
+    }
+
+  switch(op)
+    {
+    case OP_CHAR:
+    c = code[1];
+    n = 1;
+    endrun = FALSE;
+    break;
+
+    case OP_EXACT:
+    c = code[1 + IMM2_SIZE];
+    n = GET2(code, 1);
+    endrun = FALSE;
+    break;
+
+    case OP_PLUS:
+    case OP_MINPLUS:
+    case OP_POSPLUS:
+    c = code[1];
+    n = 1;
+    break;
+
+    default:
+    break;
+    }
+
+  if (n > 0 && runlength == 0) runstart = count;
+  while (n-- > 0 && runlength < REQ_LITERAL_MAX) run[runlength++] = c;
+
+  /* Decode the item as part of the prefix for a later run. */
+
+  if (op != OP_KET && count < GLUSHKOV_MAX_POSITIONS)
+    next = PRIV(glushkov_item)(re->tables, nl, code, &item);
+  if (next == NULL) endrun = TRUE;
+
+  /* Keep a run that is longer than any earlier candidate if no item before it
+  can match its first code unit. */
+
+  if (endrun && runlength > inner->length && runstart > 0)
+    {
+    uint32_t i;
+    c = run[0];
+    for (i = 0; i < runstart; i++)
+      {
+      if (c > 255)
+        {
+        if (items[i].high) break;
+        }
+      else if ((items[i].bits[c/8] & (1u << (c%8))) != 0) break;
+      }
+    if (i >= runstart)
+      {
+      memcpy(inner->literal, run, CU2BYTES(runlength));
+      inner->length = runlength;
+      *pcount = runstart;
+      }
+    }
+  if (endrun) runlength = 0;
+
+  if (next == NULL) break;
+  items[count++] = item;
+  code = next;
+  }
+
+return inner->length > 0;
+}
+
+
+
+/*************************************************
+*  Attach an inner literal automaton to a pattern *
+*************************************************/
+
+/* This is called by pcre2_compile() for every pattern that is not anchored,
+and when a pattern that has an inner literal automaton is copied or
+deserialized. The automaton is built for the prefix in reverse order, with
+possessive repeats treated as greedy ones, so that it finds every place where
+a match could start, and perhaps some more. As for the bit-parallel automaton,
+the pattern must not be in UTF or UCP mode, and the newline must be a single
+character. If the pattern is not suitable, or there is no memory, it is left
+without an automaton.
+
+Argument:   the compiled pattern
+Returns:    nothing
+*/
+
+void
+PRIV(inner_attach)(pcre2_real_code *re)
+{
+build_block bb;
+fragment f;
+glushkov_item items[GLUSHKOV_MAX_POSITIONS];
+inner_literal found;
+inner_literal *inner;
+glushkov_machine *machine;
+uint32_t count, i, c, t, tables;
+BOOL ok = TRUE;
+
+re->inner = NULL;
+if ((re->overall_options &
+    (PCRE2_UTF|PCRE2_UCP|PCRE2_ANCHORED|PCRE2_NO_START_OPTIMIZE)) != 0)
+  return;
+
+switch(re->newline_convention)
+  {
+  case PCRE2_NEWLINE_CR: bb.nl = CHAR_CR; break;
+  case PCRE2_NEWLINE_LF: bb.nl = CHAR_NL; break;
+  case PCRE2_NEWLINE_NUL: bb.nl = CHAR_NUL; break;
+  default: return;
+  }
+
+if (!find_inner(re, bb.nl, items, &count, &found)) return;
+
+/* The machine is needed only for its guards, of which only the first, which
+is always satisfied, is used. */
+
+machine = re->memctl.malloc(sizeof(glushkov_machine), re->memctl.memory_data);
+if (machine == NULL) return;
+memset(machine, 0, sizeof(glushkov_machine));
+machine->guard_count = 1;
+
+bb.machine = machine;
+bb.tables = re->tables;
+bb.depth = 0;
+bb.position_count = 0;
+memset(bb.follow, 0, sizeof(bb.follow));
+
+set_empty(&f, 0);
+for (i = count; ok && i > 0; i--)
+  {
+  const glushkov_item *item = items + i - 1;
+  fragment r;
+  char_set cs;
+
+  memcpy(cs.bits, item->bits, 32);
+  cs.high = item->high;
+  ok = item->min <= GLUSHKOV_MAX_POSITIONS &&
+    build_repeat(&bb, &r, &cs, item->min, item->max, FALSE) &&
+    concatenate(&bb, &f, &r);
+  }
+
+for (i = 0; ok && i < f.first_count; i++)
+  ok = add_edge(&bb, 0, f.first[i].position, f.first[i].guard);
+
+re->memctl.free(machine, re->memctl.memory_data);
+if (!ok) return;
+
+tables = bb.position_count/8 + 1;
+inner = re->memctl.malloc(offsetof(inner_literal, follow) +
+  tables * sizeof(inner->follow[0]), re->memctl.memory_data);
+if (inner == NULL) return;
+
+inner->length = found.length;
+memcpy(inner->literal, found.literal, CU2BYTES(found.length));
+inner->follow_tables = tables;
+inner->empty = f.empty_count > 0;
+inner->last = 0;
+for (i = 0; i < f.last_count; i++)
+  inner->last |= (uint64_t)1 << f.last[i].position;
+
+for (c = 0; c <= 256; c++)
+  {
+  uint64_t chars = 0;
+  for (i = 1; i <= bb.position_count; i++)
+    if (set_has(bb.chars + i, c)) chars |= (uint64_t)1 << i;
+  inner->chars[c] = chars;
+  }
+
+for (t = 0; t < tables; t++)
+  {
+  for (c = 0; c < 256; c++)
+    {
+    uint64_t follow = 0;
+    for (i = 0; i < 8; i++)
+      if ((c & (1u << i)) != 0 && 8*t + i <= bb.position_count)
+        follow |= bb.follow[8*t + i];
+    inner->follow[t][c] = follow;
+    }
+  }
+
+re->inner = inner;
+}
+
+
+
+/*************************************************
+*    Find where a match could start              *
+*************************************************/
+
+/* The literal is searched for from the given point. At each occurrence, the
+automaton for the reversed prefix is run backwards from the literal, but not
+before the given point, and the earliest place at which the prefix could start
+is remembered. If there is none, no match can start at or before the
+occurrence, so the search continues after it. Each code unit is therefore
+looked at only once by the automaton.
+
+Arguments:
+  inner       the inner literal automaton
+  start       the first place a match may start
+  end         the end of the subject
+  plit        where to put the occurrence of the literal that was used
+
+Returns:      the earliest place a match could start, or NULL if none
+*/
+
+PCRE2_SPTR
+PRIV(inner_start)(const inner_literal *inner, PCRE2_SPTR start,
+  PCRE2_SPTR end, PCRE2_SPTR *plit)
+{
+uint32_t tables = inner->follow_tables;
+
+for (;;)
+  {
+  PCRE2_SPTR lit = PRIV(find_literal)(start, end, inner->literal,
+    inner->length);
+  PCRE2_SPTR ptr = lit;
+  PCRE2_SPTR found = NULL;
+  uint64_t state = 1;
+
+  if (lit >= end) return NULL;
+  if (inner->empty) found = lit;
+
+  while (ptr > start)
+    {
+    uint64_t next = 0;
+    uint32_t c, t;
+
+    c = *(--ptr);
+#if PCRE2_CODE_UNIT_WIDTH != 8
+    if (c > 255) c = 256;
+#endif
+    for (t = 0; t < tables; t++)
+      next |= inner->follow[t][(state >> (8*t)) & 0xff];
+    state = next & inner->chars[c];
+    if (state == 0) break;
+    if ((state & inner->last) != 0) found = ptr;
+    }
+
+  if (found != NULL)
+    {
+    *plit = lit;
+    return found;
+    }
+  start = lit + 1;
+  }
+}
+
+/* End of pcre2_glushkov.c */
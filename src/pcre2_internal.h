@@ -543,6 +543,14 @@ bytes in a code unit in that mode. */
 #define PCRE2_HASBKPORX     0x00100000  /* contains \P, \p, or \X */
 #define PCRE2_DUPCAPUSED    0x00200000  /* contains (?| */
 #define PCRE2_HASBKC        0x00400000  /* contains \C */
+#define PCRE2_LASTCHECKALL  0x00800000  /* always search for last code unit */
+#define PCRE2_STARTDEP      0x01000000  /* contains \G, (*COMMIT), or (*SKIP) */
+#define PCRE2_BITPARALLEL   0x02000000  /* has a bit-parallel automaton */
+#define PCRE2_ONEPASS       0x04000000  /* has a one-pass program */
+#define PCRE2_LINEAR        0x08000000  /* has a linear-time program */
+#define PCRE2_LITSET        0x10000000  /* has a literal set automaton */
+#define PCRE2_LITSTRING     0x20000000  /* has a literal string */
+#define PCRE2_INNERLIT      0x40000000  /* has an inner literal automaton */
 
 #define PCRE2_MODE_MASK     (PCRE2_MODE8 | PCRE2_MODE16 | PCRE2_MODE32)
 
@@ -552,15 +560,121 @@ enum { PCRE2_MATCHEDBY_INTERPRETER,     /* pcre2_match() */
        PCRE2_MATCHEDBY_DFA_INTERPRETER, /* pcre2_dfa_match() */
        PCRE2_MATCHEDBY_JIT };           /* pcre2_jit_match() */
 
+/* Values for the type field in a pattern set entry, indicating how the
+subject is checked before the pattern is run. */
+
+enum { PSET_ALWAYS,      /* No check: the pattern is always run */
+       PSET_FIRSTCU,     /* Single caseful first code unit */
+       PSET_BITMAP };    /* Bitmap of possible first code units */
+
 /* Magic number to provide a small check against being handed junk. */
 
 #define MAGIC_NUMBER  0x50435245UL   /* 'PCRE' */
 
+/* JIT code can be compiled by one thread while others are matching with the
+same pattern (see pcre2_jit_compile_lazy() and pcre2_jit_compile_async()).
+Pointers to it, including executable_jit in the pattern, are therefore made
+visible by a single store with release semantics, and read with acquire
+semantics; on x86 both are ordinary moves. JIT_PUBLISH() and JIT_FETCH() are
+for pointers, and JIT_PUBLISH_OPTIONS() and JIT_FETCH_OPTIONS() for a 32-bit
+word of option bits. JIT_COUNT() adds to a 32-bit or word-sized counter that
+need not be exact, and yields the new value. If the compiler provides no
+atomic operations, JIT_NO_ATOMICS is defined, and JIT code is never compiled
+while other threads may be matching. */
+
+#if defined __ATOMIC_RELEASE
+#define JIT_PUBLISH(dst, value) __atomic_store_n(&(dst), (value), __ATOMIC_RELEASE)
+#define JIT_FETCH(src) __atomic_load_n(&(src), __ATOMIC_ACQUIRE)
+#define JIT_PUBLISH_OPTIONS(dst, value) JIT_PUBLISH(dst, value)
+#define JIT_FETCH_OPTIONS(src) JIT_FETCH(src)
+#define JIT_COUNT(dst, value) __atomic_add_fetch(&(dst), (value), __ATOMIC_RELAXED)
+
+#elif defined _MSC_VER
+#include <intrin.h>
+
+/* Volatile accesses are not ordered with other memory accesses by the
+processor on ARM, so a barrier instruction is needed there. On x86 only the
+compiler must be stopped from moving accesses. */
+
+#if defined _M_ARM64
+#define JIT_FENCE() __dmb(_ARM64_BARRIER_ISH)
+#elif defined _M_ARM
+#define JIT_FENCE() __dmb(_ARM_BARRIER_ISH)
+#else
+#define JIT_FENCE() _ReadWriteBarrier()
+#endif
+
+static __forceinline void jit_publish(void *volatile *dst, void *value)
+{
+JIT_FENCE();
+*dst = value;
+}
+
+static __forceinline void *jit_fetch(void *const volatile *src)
+{
+void *value = *src;
+JIT_FENCE();
+return value;
+}
+
+static __forceinline void jit_publish_options(volatile uint32_t *dst,
+  uint32_t value)
+{
+JIT_FENCE();
+*dst = value;
+}
+
+static __forceinline uint32_t jit_fetch_options(const volatile uint32_t *src)
+{
+uint32_t value = *src;
+JIT_FENCE();
+return value;
+}
+
+#define JIT_PUBLISH(dst, value) \
+  jit_publish((void *volatile *)&(dst), (void *)(value))
+#define JIT_FETCH(src) jit_fetch((void *const volatile *)&(src))
+#define JIT_PUBLISH_OPTIONS(dst, value) jit_publish_options(&(dst), (value))
+#define JIT_FETCH_OPTIONS(src) jit_fetch_options(&(src))
+
+#ifdef _WIN64
+#define JIT_COUNT(dst, value) ((sizeof(dst) == sizeof(long))? \
+  (size_t)(unsigned long)(_InterlockedExchangeAdd((volatile long *)&(dst), \
+    (long)(value)) + (long)(value)) : \
+  (size_t)(_InterlockedExchangeAdd64((volatile __int64 *)&(dst), \
+    (__int64)(value)) + (__int64)(value)))
+#else
+#define JIT_COUNT(dst, value) \
+  (size_t)(unsigned long)(_InterlockedExchangeAdd((volatile long *)&(dst), \
+    (long)(value)) + (long)(value))
+#endif
+
+#else
+#define JIT_NO_ATOMICS
+#define JIT_PUBLISH(dst, value) ((dst) = (value))
+#define JIT_FETCH(src) (src)
+#define JIT_PUBLISH_OPTIONS(dst, value) ((dst) = (value))
+#define JIT_FETCH_OPTIONS(src) (src)
+#define JIT_COUNT(dst, value) ((dst) += (value))
+#endif
+
 /* The maximum remaining length of subject we are prepared to search for a
-req_unit match. */
+req_unit match when the match is anchored. Unanchored matches always search,
+as does any match when PCRE2_EXTRA_ALWAYS_CHECK_LASTCU was used at compile
+time. */
 
 #define REQ_CU_MAX 1000
 
+/* The maximum length, in code units, of the literal string that must be
+present in every match. A longer literal string is truncated. */
+
+#define REQ_LITERAL_MAX 32
+
+/* The size of the tables that PRIV(bitmap_tables)() derives from a 256-bit map
+of code units, for the vector search in PRIV(find_bitmap)(). */
+
+#define BITMAP_TABLES_SIZE 32
+
 /* Offsets for the bitmap tables in the cbits set of tables. Each table
 contains a set of bits for a class map. Some classes are built by combining
 these tables. */
@@ -1909,7 +2023,9 @@ private structures. */
 #define compile_block                PCRE2_SUFFIX(compile_block_)
 #define dfa_match_block              PCRE2_SUFFIX(dfa_match_block_)
 #define match_block                  PCRE2_SUFFIX(match_block_)
+#define match_setup                  PCRE2_SUFFIX(match_setup_)
 #define named_group                  PCRE2_SUFFIX(named_group_)
+#define pattern_set_entry            PCRE2_SUFFIX(pattern_set_entry_)
 
 #include "pcre2_intmodedep.h"
 
@@ -1920,15 +2036,43 @@ not referenced from pcre2test, and must not be defined when no code unit width
 is available. */
 
 #define _pcre2_auto_possessify       PCRE2_SUFFIX(_pcre2_auto_possessify_)
+#define _pcre2_bitmap_tables         PCRE2_SUFFIX(_pcre2_bitmap_tables_)
 #define _pcre2_check_escape          PCRE2_SUFFIX(_pcre2_check_escape_)
+#define _pcre2_find_bitmap           PCRE2_SUFFIX(_pcre2_find_bitmap_)
 #define _pcre2_find_bracket          PCRE2_SUFFIX(_pcre2_find_bracket_)
+#define _pcre2_find_cu               PCRE2_SUFFIX(_pcre2_find_cu_)
+#define _pcre2_find_cu2              PCRE2_SUFFIX(_pcre2_find_cu2_)
+#define _pcre2_find_literal          PCRE2_SUFFIX(_pcre2_find_literal_)
+#define _pcre2_glushkov_asserts      PCRE2_SUFFIX(_pcre2_glushkov_asserts_)
+#define _pcre2_glushkov_attach       PCRE2_SUFFIX(_pcre2_glushkov_attach_)
+#define _pcre2_glushkov_build        PCRE2_SUFFIX(_pcre2_glushkov_build_)
+#define _pcre2_glushkov_ends         PCRE2_SUFFIX(_pcre2_glushkov_ends_)
+#define _pcre2_glushkov_first_end    PCRE2_SUFFIX(_pcre2_glushkov_first_end_)
+#define _pcre2_glushkov_item         PCRE2_SUFFIX(_pcre2_glushkov_item_)
+#define _pcre2_glushkov_match_at     PCRE2_SUFFIX(_pcre2_glushkov_match_at_)
+#define _pcre2_glushkov_scan         PCRE2_SUFFIX(_pcre2_glushkov_scan_)
+#define _pcre2_glushkov_step         PCRE2_SUFFIX(_pcre2_glushkov_step_)
+#define _pcre2_inner_attach          PCRE2_SUFFIX(_pcre2_inner_attach_)
+#define _pcre2_inner_start           PCRE2_SUFFIX(_pcre2_inner_start_)
 #define _pcre2_is_newline            PCRE2_SUFFIX(_pcre2_is_newline_)
 #define _pcre2_jit_free_rodata       PCRE2_SUFFIX(_pcre2_jit_free_rodata_)
 #define _pcre2_jit_free              PCRE2_SUFFIX(_pcre2_jit_free_)
 #define _pcre2_jit_get_size          PCRE2_SUFFIX(_pcre2_jit_get_size_)
 #define _pcre2_jit_get_target        PCRE2_SUFFIX(_pcre2_jit_get_target_)
+#define _pcre2_jit_glushkov          PCRE2_SUFFIX(_pcre2_jit_glushkov_)
+#define _pcre2_jit_glushkov_scan     PCRE2_SUFFIX(_pcre2_jit_glushkov_scan_)
+#define _pcre2_jit_lazy              PCRE2_SUFFIX(_pcre2_jit_lazy_)
+#define _pcre2_literal_attach        PCRE2_SUFFIX(_pcre2_literal_attach_)
+#define _pcre2_literal_match         PCRE2_SUFFIX(_pcre2_literal_match_)
+#define _pcre2_litset_attach         PCRE2_SUFFIX(_pcre2_litset_attach_)
+#define _pcre2_litset_match          PCRE2_SUFFIX(_pcre2_litset_match_)
+#define _pcre2_match_limited         PCRE2_SUFFIX(_pcre2_match_limited_)
 #define _pcre2_memctl_malloc         PCRE2_SUFFIX(_pcre2_memctl_malloc_)
+#define _pcre2_onepass_attach        PCRE2_SUFFIX(_pcre2_onepass_attach_)
+#define _pcre2_onepass_match         PCRE2_SUFFIX(_pcre2_onepass_match_)
 #define _pcre2_ord2utf               PCRE2_SUFFIX(_pcre2_ord2utf_)
+#define _pcre2_pikevm_attach         PCRE2_SUFFIX(_pcre2_pikevm_attach_)
+#define _pcre2_pikevm_match          PCRE2_SUFFIX(_pcre2_pikevm_match_)
 #define _pcre2_strcmp                PCRE2_SUFFIX(_pcre2_strcmp_)
 #define _pcre2_strcmp_c8             PCRE2_SUFFIX(_pcre2_strcmp_c8_)
 #define _pcre2_strcpy_c8             PCRE2_SUFFIX(_pcre2_strcpy_c8_)
@@ -1942,17 +2086,67 @@ is available. */
 
 extern int          _pcre2_auto_possessify(PCRE2_UCHAR *, BOOL,
                       const compile_block *);
+extern void         _pcre2_bitmap_tables(const uint8_t *, uint8_t *);
 extern int          _pcre2_check_escape(PCRE2_SPTR *, PCRE2_SPTR, uint32_t *,
                       int *, uint32_t, BOOL, compile_block *);
+extern PCRE2_SPTR   _pcre2_find_bitmap(PCRE2_SPTR, PCRE2_SPTR,
+                      const uint8_t *, const uint8_t *);
 extern PCRE2_SPTR   _pcre2_find_bracket(PCRE2_SPTR, BOOL, int);
+extern PCRE2_SPTR   _pcre2_find_cu(PCRE2_SPTR, PCRE2_SPTR, uint32_t);
+extern PCRE2_SPTR   _pcre2_find_cu2(PCRE2_SPTR, PCRE2_SPTR, uint32_t,
+                      uint32_t);
+extern PCRE2_SPTR   _pcre2_find_literal(PCRE2_SPTR, PCRE2_SPTR, PCRE2_SPTR,
+                      uint32_t);
+extern BOOL         _pcre2_glushkov_asserts(const glushkov_context *,
+                      uint32_t, uint32_t, PCRE2_SPTR);
+extern void         _pcre2_glushkov_attach(pcre2_real_code *);
+extern BOOL         _pcre2_glushkov_build(const pcre2_real_code *,
+                      glushkov_machine *);
+extern BOOL         _pcre2_glushkov_ends(const glushkov_machine *,
+                      const glushkov_context *, uint64_t, PCRE2_SPTR, BOOL);
+extern PCRE2_SPTR   _pcre2_glushkov_first_end(const glushkov_machine *,
+                      const glushkov_context *, PCRE2_SPTR);
+extern PCRE2_SPTR   _pcre2_glushkov_item(const uint8_t *, uint32_t,
+                      PCRE2_SPTR, glushkov_item *);
+extern BOOL         _pcre2_glushkov_match_at(const glushkov_machine *,
+                      const glushkov_context *, PCRE2_SPTR);
+extern void         _pcre2_glushkov_scan(const glushkov_machine *,
+                      glushkov_scan *);
+extern uint64_t     _pcre2_glushkov_step(const glushkov_machine *,
+                      const glushkov_context *, uint64_t, PCRE2_SPTR);
+extern void         _pcre2_inner_attach(pcre2_real_code *);
+extern PCRE2_SPTR   _pcre2_inner_start(const inner_literal *, PCRE2_SPTR,
+                      PCRE2_SPTR, PCRE2_SPTR *);
 extern BOOL         _pcre2_is_newline(PCRE2_SPTR, uint32_t, PCRE2_SPTR,
                       uint32_t *, BOOL);
 extern void         _pcre2_jit_free_rodata(void *, void *);
 extern void         _pcre2_jit_free(void *, pcre2_memctl *);
 extern size_t       _pcre2_jit_get_size(void *);
 const char *        _pcre2_jit_get_target(void);
+extern const glushkov_machine *_pcre2_jit_glushkov(const void *);
+extern void         _pcre2_jit_glushkov_scan(const glushkov_machine *,
+                      glushkov_scan *);
+extern void         _pcre2_jit_lazy(const pcre2_real_code *, uint32_t,
+                      PCRE2_SIZE);
+extern void         _pcre2_literal_attach(pcre2_real_code *);
+extern BOOL         _pcre2_literal_match(const pcre2_real_code *, PCRE2_SPTR,
+                      PCRE2_SIZE, PCRE2_SIZE, uint32_t, PCRE2_SIZE *);
+extern void         _pcre2_litset_attach(pcre2_real_code *);
+extern BOOL         _pcre2_litset_match(const litset_automaton *, PCRE2_SPTR,
+                      PCRE2_SPTR, PCRE2_SPTR *, PCRE2_SPTR *);
+extern int          _pcre2_match_limited(const pcre2_code *, PCRE2_SPTR,
+                      PCRE2_SIZE, PCRE2_SIZE, uint32_t, pcre2_match_data *,
+                      pcre2_match_context *, PCRE2_SIZE);
 extern void *       _pcre2_memctl_malloc(size_t, pcre2_memctl *);
+extern void         _pcre2_onepass_attach(pcre2_real_code *);
+extern BOOL         _pcre2_onepass_match(const onepass_program *,
+                      const glushkov_context *, PCRE2_SPTR, uint32_t,
+                      PCRE2_SIZE *, uint32_t, PCRE2_SPTR *, PCRE2_SIZE *);
 extern unsigned int _pcre2_ord2utf(uint32_t, PCRE2_UCHAR *);
+extern int          _pcre2_pikevm_attach(pcre2_real_code *);
+extern int          _pcre2_pikevm_match(const match_setup *, match_block *,
+                      PCRE2_SPTR, PCRE2_SPTR, pcre2_match_data *,
+                      PCRE2_SPTR *);
 extern int          _pcre2_strcmp(PCRE2_SPTR, PCRE2_SPTR);
 extern int          _pcre2_strcmp_c8(PCRE2_SPTR, const char *);
 extern PCRE2_SIZE   _pcre2_strcpy_c8(PCRE2_UCHAR *, const char *);
@@ -582,9 +582,11 @@ typedef struct pcre2_real_match_context {
 #ifdef SUPPORT_JIT
   pcre2_jit_callback jit_callback;
   void *jit_callback_data;
+  pcre2_jit_stack_pool *jit_stack_pool;
 #endif
   int    (*callout)(pcre2_callout_block *, void *);
   void    *callout_data;
+  pcre2_dfa_workspace *dfa_workspace;
   PCRE2_SIZE offset_limit;
   uint32_t heap_limit;
   uint32_t match_limit;
@@ -618,7 +620,14 @@ typedef struct pcre2_real_code {
   pcre2_memctl memctl;            /* Memory control fields */
   const uint8_t *tables;          /* The character tables */
   void    *executable_jit;        /* Pointer to JIT code */
+  struct glushkov_machine *glushkov; /* Bit-parallel automaton, or NULL */
+  struct onepass_program *onepass;   /* One-pass program, or NULL */
+  struct pikevm_program *pikevm;     /* Linear-time program, or NULL */
+  struct litset_automaton *litset;   /* Literal set automaton, or NULL */
+  struct literal_string *literal;    /* Literal string, or NULL */
+  struct inner_literal *inner;       /* Inner literal automaton, or NULL */
   uint8_t  start_bitmap[32];      /* Bitmap for starting code unit < 256 */
+  uint8_t  start_tables[BITMAP_TABLES_SIZE]; /* Search tables for it */
   CODE_BLOCKSIZE_TYPE blocksize;  /* Total (bytes) that was malloc-ed */
   uint32_t magic_number;          /* Paranoid and endianness check */
   uint32_t compile_options;       /* Options passed to pcre2_compile() */
@@ -637,6 +646,8 @@ typedef struct pcre2_real_code {
   uint16_t top_backref;           /* Highest numbered back reference */
   uint16_t name_entry_size;       /* Size (code units) of table entries */
   uint16_t name_count;            /* Number of name entries in the table */
+  uint16_t req_literal_length;    /* Length of req_literal, or zero */
+  PCRE2_UCHAR req_literal[REQ_LITERAL_MAX]; /* Must be in every match */
 } pcre2_real_code;
 
 /* The real match data structure. Define ovector large so that array bound
@@ -650,6 +661,9 @@ typedef struct pcre2_real_match_data {
   const pcre2_real_code *code;    /* The pattern used for the match */
   PCRE2_SPTR       subject;       /* The subject that was matched */
   PCRE2_SPTR       mark;          /* Pointer to last mark */
+  struct heapframe *heapframes;   /* Backtracking frame vector on the heap */
+  PCRE2_SIZE       heapframes_size; /* Size of the heap frame vector */
+  struct dfa_lazy_cache *dfa_cache; /* Lazy DFA state cache, or NULL */
   PCRE2_SIZE       leftchar;      /* Offset to leftmost code unit */
   PCRE2_SIZE       rightchar;     /* Offset to rightmost code unit */
   PCRE2_SIZE       startchar;     /* Offset to starting code unit */
@@ -750,6 +764,66 @@ typedef struct compile_block {
   BOOL dupnames;                   /* Duplicate names exist */
 } compile_block;
 
+/* The real pattern set structure. There is one entry for each pattern in the
+set, containing the information that is used to decide whether the pattern
+needs to be run. Memory for the entries and the vectors of pattern IDs is
+obtained in the same block as the structure itself. */
+
+typedef struct pattern_set_entry {
+  const pcre2_real_code *code;    /* The pattern */
+  uint32_t type;                  /* PSET_xxx type of filtering */
+  uint32_t req_cu;                /* Required code unit */
+  uint32_t req_cu2;               /* Other case of required code unit */
+  BOOL     has_req_cu;            /* TRUE if req_cu is set */
+  uint8_t  start_bitmap[32];      /* Possible starting code units */
+} pattern_set_entry;
+
+typedef struct pcre2_real_pattern_set {
+  pcre2_memctl memctl;            /* Memory control fields */
+  pattern_set_entry *entries;     /* One entry per pattern, in ID order */
+  uint32_t *bucket_ids;           /* IDs listed by single first code unit */
+  uint32_t *bitmap_ids;           /* IDs of patterns with a start bitmap */
+  uint32_t *always_ids;           /* IDs of patterns that are always run */
+  uint32_t  bucket_start[257];    /* Offsets of the buckets in bucket_ids */
+  uint32_t  count;                /* Number of patterns in the set */
+  uint32_t  bitmap_count;         /* Number of bitmap_ids */
+  uint32_t  always_count;         /* Number of always_ids */
+  uint8_t   start_bitmap[32];     /* Union of all the starting code units */
+} pcre2_real_pattern_set;
+
+/* The real parallel match structure. The subject is divided into chunks, each
+of which records the matches that start within it when matching begins at the
+chunk's start. The merged list of matches is built from these. */
+
+typedef struct parallel_chunk {
+  pcre2_match_data *match_data;   /* Match data for this chunk's searches */
+  PCRE2_SIZE *matches;            /* Vector of start/end/next offset triples */
+  PCRE2_SIZE  size;               /* Number of triples that fit in matches */
+  PCRE2_SIZE  count;              /* Number of triples in matches */
+  PCRE2_SIZE  start;              /* Offset of the start of the chunk */
+  PCRE2_SIZE  limit;              /* Last offset at which a match may start */
+  PCRE2_SIZE  next;               /* Where searching continues afterwards */
+  uint32_t    flags;              /* Options for the continued search */
+  int         rc;                 /* 1 before the chunk is run, then 0 or error */
+} parallel_chunk;
+
+typedef struct pcre2_real_parallel_match {
+  pcre2_memctl memctl;            /* Memory control fields */
+  const pcre2_real_code *code;    /* The pattern */
+  PCRE2_SPTR  start_subject;      /* Start of the subject string */
+  PCRE2_SPTR  end_subject;        /* End of the subject string */
+  PCRE2_SIZE  length;             /* Length of the subject */
+  parallel_chunk *chunks;         /* Vector of chunks */
+  uint32_t    chunk_count;        /* Number of chunks */
+  uint32_t    options;            /* Match options */
+  PCRE2_SIZE *results;            /* Merged vector of start/end offset pairs */
+  PCRE2_SIZE  results_size;       /* Number of pairs that fit in results */
+  PCRE2_SIZE  results_count;      /* Number of pairs in results */
+  uint32_t    nltype;             /* Newline type */
+  uint32_t    nllen;              /* Newline string length */
+  PCRE2_UCHAR nl[4];              /* Newline string when fixed */
+} pcre2_real_parallel_match;
+
 /* Structure for keeping the properties of the in-memory stack used
 by the JIT matcher. */
 
@@ -758,6 +832,75 @@ typedef struct pcre2_real_jit_stack {
   void* stack;
 } pcre2_real_jit_stack;
 
+/* Structure for a cache of JIT code that is shared by processes that are forked
+after the code is compiled. The region is a struct sljit_exec_region. */
+
+typedef struct pcre2_real_jit_code_cache {
+  pcre2_memctl memctl;
+  void      *region;              /* The shared executable memory */
+} pcre2_real_jit_code_cache;
+
+/* Structure for a pool of JIT stacks. A stack is taken from the pool for each
+JIT match and returned afterwards, so each thread that is matching at the same
+time has its own stack, and stacks are created only when all the existing ones
+are in use. */
+
+typedef struct pcre2_real_jit_stack_pool {
+  pcre2_memctl memctl;
+  PCRE2_SIZE startsize;           /* Starting size of each stack */
+  PCRE2_SIZE maxsize;             /* Size to which each stack may grow */
+  pcre2_jit_stack **idle;         /* Vector of stacks that are not in use */
+  uint32_t   idle_count;          /* Number of stacks in the vector */
+  uint32_t   idle_size;           /* Number of stacks that fit in the vector */
+  uint32_t   stacks;              /* Number of stacks created */
+  uint32_t   in_use;              /* Number of stacks in use */
+  uint32_t   peak_in_use;         /* Highest number in use at once */
+  PCRE2_SIZE peak_size;           /* Largest size any stack has grown to */
+} pcre2_real_jit_stack_pool;
+
+/* The structure for a DFA workspace that grows as needed. Sizes are numbers of
+ints, as for the workspace argument of pcre2_dfa_match(). The saved vector is
+used to keep the data for a restart while the workspace is being enlarged. */
+
+typedef struct pcre2_real_dfa_workspace {
+  pcre2_memctl memctl;
+  int       *vector;              /* The current workspace */
+  int       *saved;               /* Saved restart data, or NULL */
+  PCRE2_SIZE size;                /* Size of the current workspace */
+  PCRE2_SIZE maxsize;             /* Size to which it may grow */
+  PCRE2_SIZE peak;                /* Largest amount that has been used */
+  PCRE2_SIZE saved_size;          /* Size of the saved vector */
+} pcre2_real_dfa_workspace;
+
+/* The structure for DFA matching of a subject that arrives in pieces. The
+buffer holds the text that is still needed: a few characters of context before
+the point where searching continues, any text from there onwards that has not
+yet been searched to a conclusion, and any incomplete UTF character at the end.
+When a match in progress outgrows the retention limit, its states are kept in
+the workspace instead, and only the end of its longest complete match so far is
+remembered. */
+
+typedef struct pcre2_real_dfa_stream {
+  pcre2_memctl memctl;
+  const pcre2_real_code *code;    /* The pattern */
+  pcre2_match_data *match_data;   /* For two pairs of offsets */
+  pcre2_dfa_workspace *workspace; /* Workspace, holding any restart data */
+  PCRE2_UCHAR *buffer;            /* Retained text followed by a new piece */
+  PCRE2_SIZE  buffer_size;        /* Size of the buffer in code units */
+  PCRE2_SIZE  length;             /* Code units in the buffer */
+  PCRE2_SIZE  next;               /* Where searching continues in the buffer */
+  PCRE2_SIZE  checked;            /* End of the UTF-checked part of the buffer */
+  PCRE2_SIZE  maxretain;          /* Limit on retained unsearched text */
+  uint64_t    base;               /* Stream offset of the buffer's start */
+  uint64_t    restart_start;      /* Stream offset of a match being continued */
+  uint64_t    fallback_end;       /* End of its longest complete match so far */
+  uint64_t   *matches;            /* Vector of start/end offset pairs */
+  PCRE2_SIZE  matches_size;       /* Number of pairs that fit in matches */
+  PCRE2_SIZE  matches_count;      /* Number of pairs in matches */
+  uint32_t    options;            /* Match options */
+  uint32_t    flags;              /* State of the search */
+} pcre2_real_dfa_stream;
+
 /* Structure for items in a linked list that represents an explicit recursive
 call within the pattern when running pcre_dfa_match(). */
 
@@ -822,7 +965,7 @@ typedef char check_heapframe_size[
 doing traditional NFA matching (pcre2_match() and friends). */
 
 typedef struct match_block {
-  pcre2_memctl memctl;            /* For general use */
+  pcre2_match_data *match_data;   /* Owns the frame vector if on the heap */
   PCRE2_SIZE frame_vector_size;   /* Size of a backtracking frame */
   heapframe *match_frames;        /* Points to vector of frames */
   heapframe *match_frames_top;    /* Points after the end of the vector */
@@ -865,6 +1008,30 @@ typedef struct match_block {
   int (*callout)(pcre2_callout_block *,void *);  /* Callout function or NULL */
 } match_block;
 
+/* Structure for holding the values that pcre2_match() works out before it
+looks at a subject string. They depend only on the pattern, the options, and
+the match context, so pcre2_match_batch() computes them once for all its
+subjects. */
+
+typedef struct match_setup {
+  const pcre2_real_code *re;      /* The compiled pattern */
+  const uint8_t *start_bits;      /* Starting code unit bitmap or NULL */
+  PCRE2_SIZE frame_size;          /* Size of each backtracking frame */
+  PCRE2_SIZE offset_limit;        /* From the match context */
+  uint32_t options;               /* Match options, with pattern flags added */
+  uint16_t partial;               /* PARTIAL options */
+  BOOL anchored;                  /* Pattern or options force anchoring */
+  BOOL firstline;                 /* PCRE2_FIRSTLINE is set */
+  BOOL startline;                 /* Pattern must match at a line start */
+  BOOL utf;                       /* UTF mode */
+  BOOL has_first_cu;              /* first_cu and first_cu2 are valid */
+  BOOL has_req_cu;                /* req_cu and req_cu2 are valid */
+  PCRE2_UCHAR first_cu;           /* First code unit */
+  PCRE2_UCHAR first_cu2;          /* Its other case */
+  PCRE2_UCHAR req_cu;             /* Last required code unit */
+  PCRE2_UCHAR req_cu2;            /* Its other case */
+} match_setup;
+
 /* A similar structure is used for the same purpose by the DFA matching
 functions. */
 
@@ -889,8 +1056,326 @@ typedef struct dfa_match_block {
   void *callout_data;             /* To pass back to callouts */
   int (*callout)(pcre2_callout_block *,void *);  /* Callout function or NULL */
   dfa_recursion_info *recursive;  /* Linked list of recursion data */
+  PCRE2_SIZE *ws_peak;            /* For recording workspace use, or NULL */
 } dfa_match_block;
 
+/* Structures for the lazy DFA that pcre2_dfa_match() uses when PCRE2_DFA_LAZY
+is set. Each cached state is a canonical set of the interpreter's state blocks,
+held in a pool of ints, with a table of transitions for characters less than
+256. A transition is the index of the next state shifted left one bit, with the
+bottom bit set if a match ends after the character, or -1 if it has not yet
+been computed. The cache is one memory block, kept in the match data, with a
+copy of the compiled pattern that it was built for at the end. */
+
+typedef struct dfa_lazy_state {
+  int      set;                   /* Offset of the state set in the pool */
+  int      count;                 /* Number of state blocks in the set */
+  int      next;                  /* Next state in the hash chain, or -1 */
+  uint32_t hash;                  /* Hash value of the set */
+  int32_t  trans[256];            /* Transitions for small characters */
+} dfa_lazy_state;
+
+typedef struct dfa_lazy_cache {
+  PCRE2_SIZE size;                /* Size of the whole block */
+  PCRE2_SIZE code_size;           /* Size of the pattern copy */
+  BOOL     eligible;              /* The pattern can use the lazy DFA */
+  BOOL     anchored;              /* Transitions are for anchored matching */
+  int      start_empty;           /* Start matches empty: 1 yes, 0 no, -1 ? */
+  int      start_state;           /* Index of the starting state */
+  int      state_count;           /* Number of states in use */
+  int      pool_used;             /* Number of ints used in the pool */
+  dfa_lazy_state *states;         /* The states */
+  int     *hash;                  /* Heads of the hash chains */
+  int     *pool;                  /* Pool of state sets */
+  int     *scratch;               /* Working space for building a set */
+  uint8_t *code_copy;             /* Copy of the compiled pattern */
+} dfa_lazy_cache;
+
+/* Structures for the bit-parallel position automaton (Glushkov automaton) that
+pcre2_dfa_match() can use instead of the interpreter for a small pattern, and
+that pcre2_match() can use to skip starting points where there is no match. Each
+position of the pattern that consumes a character has one bit in a 64-bit state
+set. Bit 0 stands for the start of a match; its follow set is the positions
+that may be entered first. The exit from a possessive repeat is allowed only
+when the next character does not match the repeated item, and a simple
+assertion may have to hold where an item is passed. These conditions are held
+as guards. Guards on entering a match and at its end are checked exactly; those
+on the transitions in between must be redundant or the pattern is not
+handled. The per-character records (the last one is for all characters greater
+than 255) and the follow tables, which are indexed by each byte of a state set,
+are laid out for the scanning loop. */
+
+#define GLUSHKOV_MAX_POSITIONS   63
+#define GLUSHKOV_MAX_ENTRIES     64
+#define GLUSHKOV_MAX_GUARDS      32
+#define GLUSHKOV_FOLLOW_TABLES    8
+
+#define GLUSHKOV_A_SOD        0x0001u  /* \A */
+#define GLUSHKOV_A_SOM        0x0002u  /* \G */
+#define GLUSHKOV_A_CIRC       0x0004u  /* ^ */
+#define GLUSHKOV_A_CIRCM      0x0008u  /* ^ multiline */
+#define GLUSHKOV_A_EOD        0x0010u  /* \z */
+#define GLUSHKOV_A_EODN       0x0020u  /* \Z */
+#define GLUSHKOV_A_DOLL       0x0040u  /* $ */
+#define GLUSHKOV_A_DOLLM      0x0080u  /* $ multiline */
+
+#define GLUSHKOV_UNLIMITED    0xffffffffu  /* Unlimited maximum repeat */
+
+#define GLUSHKOV_GREEDY       0        /* Kinds of repeat */
+#define GLUSHKOV_LAZY         1
+#define GLUSHKOV_POSSESSIVE   2
+
+/* A single-character item with its repeat, as decoded from the compiled
+pattern for the automaton and for the one-pass matcher. */
+
+typedef struct glushkov_item {
+  uint8_t  bits[32];              /* Characters < 256 that match */
+  uint32_t high;                  /* TRUE if larger characters match */
+  uint32_t min;                   /* Minimum repeat */
+  uint32_t max;                   /* Maximum repeat, or GLUSHKOV_UNLIMITED */
+  uint32_t kind;                  /* Greedy, lazy, or possessive */
+} glushkov_item;
+
+typedef struct glushkov_guard {
+  uint8_t  bits[32];              /* Characters < 256 that must not come next */
+  uint32_t high;                  /* TRUE if larger characters must not */
+  uint32_t asserts;               /* Assertions that must hold */
+} glushkov_guard;
+
+typedef struct glushkov_entry {
+  uint8_t  position;              /* Bit number of the position */
+  uint8_t  guard;                 /* Index of its guard */
+} glushkov_entry;
+
+typedef struct glushkov_record {
+  uint64_t accept;                /* States in which a match may end before c */
+  uint64_t chars;                 /* Positions that match c */
+} glushkov_record;
+
+typedef struct glushkov_machine {
+  glushkov_record records[257];   /* By character; the last is for > 255 */
+  uint64_t follow[GLUSHKOV_FOLLOW_TABLES][256];  /* By byte of a state set */
+  uint32_t follow_tables;         /* Number of follow tables in use */
+  uint32_t position_count;        /* Number of positions */
+  uint32_t first_count;           /* Number of first entries with assertions */
+  uint32_t last_count;            /* Number of last entries */
+  uint32_t empty_count;           /* Number of guards for an empty match */
+  uint32_t guard_count;           /* Number of guards */
+  uint32_t newline;               /* The newline character */
+  glushkov_entry first[GLUSHKOV_MAX_ENTRIES];  /* Guarded by assertions */
+  glushkov_entry last[GLUSHKOV_MAX_ENTRIES];   /* Positions that may end */
+  uint8_t  empty[GLUSHKOV_MAX_GUARDS];         /* Guards for an empty match */
+  glushkov_guard guards[GLUSHKOV_MAX_GUARDS];  /* Guard 0 is always empty */
+  void    *jit_scan;              /* JIT scanning loop, or NULL */
+  size_t   jit_scan_size;         /* Size of the JIT code */
+} glushkov_machine;
+
+/* The block that is passed to a scanning loop. The inject bits are added to
+the state set before each character. The block is updated to where the scan
+stopped, which is at the end of the subject, when the state set is empty, or
+before a character where a match may end. The state set is then the one that
+applies before that character. */
+
+typedef struct glushkov_scan {
+  PCRE2_SPTR ptr;                 /* Current position */
+  PCRE2_SPTR end;                 /* End of the subject */
+  uint64_t   state;               /* Current state set */
+  uint64_t   inject;              /* Bits added before each character */
+} glushkov_scan;
+
+/* The subject and options against which guards with assertions are checked.
+The field names are the same as in the match blocks. */
+
+typedef struct glushkov_context {
+  PCRE2_SPTR start_subject;       /* Start of the subject */
+  PCRE2_SPTR end_subject;         /* End of the subject */
+  PCRE2_SIZE start_offset;        /* The starting offset */
+  uint32_t   moptions;            /* Match options */
+  uint32_t   poptions;            /* Pattern options */
+} glushkov_context;
+
+/* Structures for the one-pass matcher, which pcre2_match() uses instead of
+the interpreter for a small anchored pattern in which, wherever the interpreter
+would have a choice, the next character decides which way to go. The pattern
+is held as a tree of nodes, each of which is a single-character item or a
+group, with its repeat. The branches of a group, and the nodes of a branch,
+are linked lists. Node 0 is the whole pattern. Each branch has a predict set:
+the characters that can be matched first if it is chosen, and whether the
+match can end without any more characters. A node's exit set is the same for
+leaving it. Each group also has a row of the choice table, which gives the
+branch, or leaving the group, for each character (the last entry is for all
+characters greater than 255). It is used when no option can end the match. */
+
+#define ONEPASS_MAX_NODES      128
+#define ONEPASS_MAX_BRANCHES    64
+#define ONEPASS_MAX_GROUPS      32
+#define ONEPASS_MAX_DEPTH       16
+#define ONEPASS_MAX_CAPTURES    32
+
+#define ONEPASS_NONE       0xffffu     /* End of a list */
+
+#define ONEPASS_ITEM           0       /* Node types */
+#define ONEPASS_GROUP          1
+
+#define ONEPASS_CHOOSE_EXIT 0xfeu      /* Choice table entries */
+#define ONEPASS_CHOOSE_NONE 0xffu
+
+typedef struct onepass_set {
+  uint8_t  bits[32];              /* Characters < 256 */
+  uint8_t  high;                  /* TRUE for larger characters */
+  uint8_t  end;                   /* TRUE if the match may end here */
+} onepass_set;
+
+typedef struct onepass_node {
+  onepass_set exit;               /* What may follow the node */
+  uint8_t  chars[32];             /* Item: characters < 256 that match */
+  uint8_t  high;                  /* Item: TRUE if larger characters match */
+  uint8_t  type;                  /* ONEPASS_ITEM or ONEPASS_GROUP */
+  uint8_t  kind;                  /* Greedy, lazy, or possessive */
+  uint8_t  ends;                  /* Group: TRUE if an option may end */
+  uint16_t next;                  /* Next node in the branch */
+  uint16_t number;                /* Group: capture number, or 0 */
+  uint16_t first_branch;          /* Group: first branch */
+  uint16_t choice;                /* Group: row of the choice table */
+  uint32_t min;                   /* Minimum repeat */
+  uint32_t max;                   /* Maximum repeat, or GLUSHKOV_UNLIMITED */
+} onepass_node;
+
+typedef struct onepass_branch {
+  onepass_set predict;            /* What may come first */
+  uint16_t first_node;            /* First node, or ONEPASS_NONE if empty */
+  uint16_t next;                  /* Next branch of the group */
+  uint32_t start_asserts;         /* Top level: assertions at the start */
+  uint32_t end_asserts;           /* Top level: assertions at the end */
+} onepass_branch;
+
+typedef struct onepass_program {
+  onepass_node *nodes;            /* All three vectors follow this block */
+  onepass_branch *branches;
+  uint8_t  *choices;              /* The choice table */
+  uint32_t node_count;            /* Number of nodes */
+  uint32_t branch_count;          /* Number of branches */
+  uint32_t group_count;           /* Number of rows in the choice table */
+  uint32_t newline;               /* The newline character */
+} onepass_program;
+
+/* Structures for the linear-time matcher, which pcre2_match() uses for a
+pattern compiled with PCRE2_EXTRA_LINEAR. The pattern is turned into a vector
+of instructions for a Pike virtual machine, which runs all the threads of a
+match in step, in the order of priority that the interpreter would try them.
+Repeated single-character items are unrolled, so the size of the program is
+limited. Each thread has a vector of slots: the start of the match, the ovector
+highwater mark, the captured substrings, the starts of open capturing groups,
+and the starts of the current iterations of groups that may match an empty
+string. */
+
+#define PIKEVM_MAX_INSTS   10000
+
+#define PIKEVM_OK              0       /* Results of building a program */
+#define PIKEVM_UNSUPPORTED     1
+#define PIKEVM_TOO_LARGE       2
+#define PIKEVM_NOMEMORY        3
+
+typedef struct pikevm_inst {
+  uint8_t  bits[32];              /* Item: characters < 256 that match */
+  uint32_t op;                    /* The instruction */
+  uint32_t next;                  /* The next instruction, or the preferred one */
+  uint32_t alt;                   /* The other instruction of a choice */
+  uint32_t arg;                   /* Opcode of an item or assertion, or slot */
+  uint32_t c;                     /* Item: the character */
+  uint32_t oc;                    /* Item: its other case */
+  uint32_t loop;                  /* Innermost checked group's slot, or 0 */
+  PCRE2_SPTR data;                /* Item: class or property data */
+} pikevm_inst;
+
+typedef struct pikevm_program {
+  pikevm_inst *insts;             /* Both vectors follow this block */
+  uint32_t *loop_parents;         /* Enclosing checked group of each one */
+  uint32_t inst_count;            /* Number of instructions */
+  uint32_t slot_count;            /* Number of slots in each thread */
+  uint32_t top_bracket;           /* Highest capture number */
+  uint32_t loop_base;             /* Slot of the first checked group */
+  uint32_t loop_depth;            /* Deepest nesting of checked groups */
+} pikevm_program;
+
+/* Structures for the Aho-Corasick automaton that is built for a pattern that
+is an alternation of two or more literal strings. The code units that occur in
+the strings are mapped to classes (class 0 is for all the others), and there is
+a row of transitions for each state, with a column for each class. Each state
+records the longest string that ends there, because that one starts earliest;
+its branch number decides between strings that start at the same place. */
+
+#define LITSET_MAX_CELLS          (1u << 20)
+#define LITSET_JIT_MIN_LITERALS   8
+
+typedef struct litset_output {
+  uint32_t length;                /* Longest string that ends here, or 0 */
+  uint32_t branch;                /* Its branch number */
+} litset_output;
+
+typedef struct litset_automaton {
+  uint32_t *delta;                /* All three vectors follow this block */
+  litset_output *outputs;
+  PCRE2_UCHAR *wide_units;        /* Sorted code units > 255 in the strings */
+  uint32_t literal_count;         /* Number of strings */
+  uint32_t state_count;           /* Number of states */
+  uint32_t class_count;           /* Number of classes */
+  uint32_t wide_count;            /* Number of wide code units */
+  uint32_t wide_base;             /* Class of the first wide code unit */
+  uint32_t max_length;            /* Length of the longest string */
+  uint16_t classes[256];          /* Class of each code unit < 256 */
+  uint8_t  first_bitmap[32];      /* Code units that start a string */
+  uint8_t  first_tables[BITMAP_TABLES_SIZE]; /* Search tables for it */
+} litset_automaton;
+
+/* Structure for a pattern that is a single literal string, possibly anchored
+at either end, which pcre2_match() finds by a substring search without using
+the interpreter. The first code unit (in either case) is found by one of the
+vectorized search functions. */
+
+#define LITERAL_FLOAT      0      /* No anchor at the start */
+#define LITERAL_SOD        1      /* \A */
+#define LITERAL_CIRC       2      /* ^ */
+#define LITERAL_SOM        3      /* \G */
+
+#define LITERAL_OPEN       0      /* No anchor at the end */
+#define LITERAL_EOD        1      /* \z */
+#define LITERAL_EODN       2      /* \Z */
+#define LITERAL_DOLL       3      /* $ */
+
+typedef struct literal_string {
+  PCRE2_UCHAR *units;             /* The string, lower cased where caseless */
+  uint8_t *caseless;              /* A flag for each code unit */
+  uint32_t length;                /* Number of code units */
+  uint32_t start_kind;            /* LITERAL_FLOAT etc. */
+  uint32_t end_kind;              /* LITERAL_OPEN etc. */
+  uint32_t nllen;                 /* Length of the newline, for \Z and $ */
+  PCRE2_UCHAR nl[2];              /* The newline */
+  uint32_t first_count;           /* Code units that can start a match */
+  PCRE2_UCHAR first_cu;           /* The first two of them */
+  PCRE2_UCHAR first_cu2;
+  uint8_t  first_bitmap[32];      /* All of them, if there are more */
+  uint8_t  first_tables[BITMAP_TABLES_SIZE]; /* Search tables for it */
+} literal_string;
+
+/* Structure for a pattern whose matches must contain a literal string that
+follows a prefix of single-character items, none of which can match the
+literal's first code unit. The matchers search for the literal, and then run a
+position automaton for the reversed prefix backwards from it, to find the
+leftmost place at which a match could start. Bit 0 of the state set is the
+start, at the literal. Only as many follow tables as the positions need are
+allocated, so they must be last. */
+
+typedef struct inner_literal {
+  uint32_t length;                /* Length of the literal */
+  uint32_t follow_tables;         /* Number of follow tables in use */
+  uint32_t empty;                 /* TRUE if the prefix can be empty */
+  uint64_t last;                  /* Positions at which the prefix may start */
+  PCRE2_UCHAR literal[REQ_LITERAL_MAX];  /* The literal */
+  uint64_t chars[257];            /* Positions that match each character */
+  uint64_t follow[GLUSHKOV_FOLLOW_TABLES][256];  /* By byte of a state set */
+} inner_literal;
+
 #endif  /* PCRE2_PCRE2TEST */
 
 /* End of pcre2_intmodedep.h */
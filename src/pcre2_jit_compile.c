@@ -193,12 +193,42 @@ typedef struct jit_arguments {
 
 #define JIT_NUMBER_OF_COMPILE_MODES 3
 
+/* pcre2_jit_compile_async() uses a thread of the same kind as the locks in
+sljitUtils.c. When sljit is configured for a single thread, or the compiler
+has no atomic operations for publishing the code, it compiles before
+returning. */
+
+#if (defined SLJIT_SINGLE_THREADED && SLJIT_SINGLE_THREADED) || \
+  defined JIT_NO_ATOMICS
+#define JIT_NO_THREADS
+#elif defined _WIN32
+typedef HANDLE jit_thread;
+#else
+typedef pthread_t jit_thread;
+#endif
+
 typedef struct executable_functions {
   void *executable_funcs[JIT_NUMBER_OF_COMPILE_MODES];
   void *read_only_data_heads[JIT_NUMBER_OF_COMPILE_MODES];
   sljit_uw executable_sizes[JIT_NUMBER_OF_COMPILE_MODES];
   sljit_u32 top_bracket;
   sljit_u32 limit_match;
+  glushkov_machine *glushkov;
+  /* For lazy compilation */
+  sljit_u32 lazy_options;      /* Modes still to be compiled, or zero */
+  sljit_u32 lazy_match_limit;  /* Compile after this many matches... */
+  sljit_uw lazy_byte_limit;    /* ...or this many subject code units */
+  sljit_u32 lazy_matches;
+  sljit_uw lazy_bytes;
+  /* Modes that a lazy or background compile has taken on */
+  sljit_u32 claimed_options;
+  /* For background compilation */
+  sljit_u32 async_options;
+  int async_result;
+  BOOL async_running;
+#ifndef JIT_NO_THREADS
+  jit_thread async_thread;
+#endif
 } executable_functions;
 
 typedef struct jump_list {
@@ -218,6 +248,69 @@ typedef struct label_addr_list {
   struct label_addr_list *next;
 } label_addr_list;
 
+/* A relocatable compile, which is used when JIT code is saved by
+pcre2_jit_serialize_encode(), records every absolute address that it puts into
+the code or its read-only data. The code can then be loaded at a different
+address, in another process, by pcre2_jit_serialize_decode(). */
+
+enum reloc_sites {
+  site_const = 0,         /* A constant from sljit_emit_const() */
+  site_jump = 1,          /* A rewritable jump or call */
+  site_rodata = 2         /* A word in a read-only data block */
+};
+
+enum reloc_targets {
+  target_code = 0,        /* The generated code */
+  target_rodata = 1,      /* A read-only data block */
+  target_pattern = 2,     /* The compiled pattern */
+  target_tables = 3,      /* The character tables */
+  target_symbol = 4       /* A table or function in the library */
+};
+
+enum reloc_symbols {
+  symbol_none = 0,
+  symbol_utf8_table4,
+  symbol_ucd_stage1,
+  symbol_ucd_stage2,
+  symbol_ucd_records,
+  symbol_ucp_gbtable,
+  symbol_do_search_mark,
+  symbol_do_search_literal,
+  symbol_do_utf_caselesscmp,
+  symbol_do_callout,
+  symbol_stack_resize,
+  symbol_count
+};
+
+typedef struct jit_reloc {
+  sljit_uw site_offset;   /* Offset of the site in the code or its block */
+  sljit_sw addend;        /* Offset of the address from its target */
+  sljit_u16 site;         /* One of reloc_sites */
+  sljit_u16 target;       /* One of reloc_targets */
+  sljit_u32 site_block;   /* Read-only data block of a site_rodata */
+  sljit_u32 index;        /* Block of a target_rodata, or the symbol */
+} jit_reloc;
+
+typedef struct pending_reloc {
+  void *site;             /* The sljit_const or sljit_jump */
+  sljit_sw address;       /* The address that was emitted */
+  sljit_u16 type;         /* site_const or site_jump */
+  sljit_u16 symbol;       /* One of reloc_symbols */
+} pending_reloc;
+
+typedef struct reloc_state {
+  pending_reloc *pending;
+  sljit_uw pending_count;
+  sljit_uw pending_size;
+  /* The results of the compile. */
+  void *code;
+  sljit_uw code_size;
+  sljit_sw executable_offset;
+  void *read_only_data_head;
+  jit_reloc *relocs;
+  sljit_uw reloc_count;
+} reloc_state;
+
 enum frame_types {
   no_frame = -1,
   no_stack = -2
@@ -376,6 +469,8 @@ typedef struct compiler_common {
   sljit_s32 *private_data_ptrs;
   /* Chain list of read-only data ptrs. */
   void *read_only_data_head;
+  /* Relocation records of a relocatable compile, or NULL. */
+  reloc_state *relocs;
   /* Tells whether the capturing bracket is optimized. */
   sljit_u8 *optimized_cbracket;
   /* Tells whether the starting offset is a target of then. */
@@ -390,6 +485,8 @@ typedef struct compiler_common {
   sljit_s32 start_ptr;
   /* Last known position of the requested byte. */
   sljit_s32 req_char_ptr;
+  /* Last known position of the required literal string. */
+  sljit_s32 req_literal_ptr;
   /* Head of the last recursion. */
   sljit_s32 recursive_head_ptr;
   /* First inspected character for partial matching.
@@ -537,6 +634,8 @@ typedef struct compare_context {
 #define COUNT_MATCH   SLJIT_S3
 #define ARGUMENTS     SLJIT_S4
 #define RETURN_ADDR   SLJIT_R4
+/* Holds the addresses of a relocatable compile. */
+#define RELOC_REG     SLJIT_R5
 
 /* Local space layout. */
 /* These two locals can be used by the current opcode. */
@@ -2668,7 +2767,9 @@ sljit_uw *result;
 if (SLJIT_UNLIKELY(sljit_get_compiler_error(compiler)))
   return NULL;
 
-result = (sljit_uw *)SLJIT_MALLOC(size + sizeof(sljit_uw), compiler->allocator_data);
+/* Each block starts with the chain pointer and the size of the data. */
+
+result = (sljit_uw *)SLJIT_MALLOC(size + 2 * sizeof(sljit_uw), compiler->allocator_data);
 if (SLJIT_UNLIKELY(result == NULL))
   {
   sljit_set_compiler_memory_error(compiler);
@@ -2676,8 +2777,113 @@ if (SLJIT_UNLIKELY(result == NULL))
   }
 
 *(void**)result = common->read_only_data_head;
+result[1] = size;
 common->read_only_data_head = (void *)result;
-return result + 1;
+return result + 2;
+}
+
+static void add_reloc(compiler_common *common, void *site, sljit_u16 type, sljit_sw address, sljit_u16 symbol)
+{
+DEFINE_COMPILER;
+reloc_state *relocs = common->relocs;
+pending_reloc *pending;
+
+if (site == NULL)
+  return;
+
+if (relocs->pending_count >= relocs->pending_size)
+  {
+  sljit_uw size = (relocs->pending_size == 0) ? 64 : relocs->pending_size * 2;
+  pending = (pending_reloc *)SLJIT_MALLOC(size * sizeof(pending_reloc), compiler->allocator_data);
+  if (SLJIT_UNLIKELY(pending == NULL))
+    {
+    sljit_set_compiler_memory_error(compiler);
+    return;
+    }
+  if (relocs->pending != NULL)
+    {
+    memcpy(pending, relocs->pending, relocs->pending_count * sizeof(pending_reloc));
+    SLJIT_FREE(relocs->pending, compiler->allocator_data);
+    }
+  relocs->pending = pending;
+  relocs->pending_size = size;
+  }
+
+pending = relocs->pending + relocs->pending_count++;
+pending->site = site;
+pending->type = type;
+pending->address = address;
+pending->symbol = symbol;
+}
+
+/* Move an absolute address to dst. The symbol identifies the library object
+that the address is in; symbol_none means that it is in the pattern, its
+tables, or the read-only data of the code. */
+
+static void load_address(compiler_common *common, sljit_s32 dst, sljit_sw dstw, sljit_sw address, sljit_u16 symbol)
+{
+DEFINE_COMPILER;
+
+if (common->relocs == NULL)
+  {
+  OP1(SLJIT_MOV, dst, dstw, SLJIT_IMM, address);
+  return;
+  }
+
+add_reloc(common, sljit_emit_const(compiler, dst, dstw, address), site_const, address, symbol);
+}
+
+/* Load dst from a table at an absolute address, indexed by a register. A
+relocatable compile puts the address into RELOC_REG, which is used for nothing
+else, so that no flags and no other registers are changed. */
+
+static void load_table_entry(compiler_common *common, sljit_s32 op, sljit_s32 dst, sljit_s32 index, sljit_sw table, sljit_u16 symbol)
+{
+DEFINE_COMPILER;
+
+if (common->relocs == NULL)
+  {
+  OP1(op, dst, 0, SLJIT_MEM1(index), table);
+  return;
+  }
+
+load_address(common, RELOC_REG, 0, table, symbol);
+OP1(op, dst, 0, SLJIT_MEM2(index, RELOC_REG), 0);
+}
+
+/* Call a library function. */
+
+static void call_function(compiler_common *common, sljit_s32 type, sljit_sw function, sljit_u16 symbol)
+{
+DEFINE_COMPILER;
+struct sljit_jump *jump;
+
+if (common->relocs == NULL)
+  {
+  sljit_emit_ijump(compiler, type, SLJIT_IMM, function);
+  return;
+  }
+
+jump = sljit_emit_jump(compiler, type | SLJIT_REWRITABLE_JUMP);
+if (jump != NULL)
+  sljit_set_target(jump, function);
+add_reloc(common, jump, site_jump, function, symbol);
+}
+
+/* Jump through a table of label addresses in the read-only data. */
+
+static void jump_through_table(compiler_common *common, sljit_s32 index, sljit_uw *table)
+{
+DEFINE_COMPILER;
+
+if (common->relocs == NULL)
+  {
+  sljit_emit_ijump(compiler, SLJIT_JUMP, SLJIT_MEM1(index), (sljit_sw)table);
+  return;
+  }
+
+load_address(common, RELOC_REG, 0, (sljit_sw)table, symbol_none);
+sljit_emit_ijump(compiler, SLJIT_JUMP, SLJIT_MEM2(index, RELOC_REG), 0);
 }
 
 static SLJIT_INLINE void reset_ovector(compiler_common *common, int length)
@@ -3163,12 +3369,12 @@ SLJIT_ASSERT(common->utf);
 OP1(MOV_UCHAR, TMP2, 0, SLJIT_MEM1(STR_PTR), 0);
 OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(1));
 
-OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP2), common->ctypes);
+load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP2, common->ctypes, symbol_none);
 
 if (full_read)
   {
   jump = CMP(SLJIT_LESS, TMP2, 0, SLJIT_IMM, 0xc0);
-  OP1(SLJIT_MOV_U8, TMP2, 0, SLJIT_MEM1(TMP2), (sljit_sw)PRIV(utf8_table4) - 0xc0);
+  load_table_entry(common, SLJIT_MOV_U8, TMP2, TMP2, (sljit_sw)PRIV(utf8_table4) - 0xc0, symbol_utf8_table4);
   OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
   JUMPHERE(jump);
   }
@@ -3207,7 +3413,7 @@ if (common->utf)
     {
     OP2(SLJIT_SUB, TMP2, 0, TMP1, 0, SLJIT_IMM, 0xf0);
     if (update_str_ptr)
-      OP1(SLJIT_MOV_U8, RETURN_ADDR, 0, SLJIT_MEM1(TMP1), (sljit_sw)PRIV(utf8_table4) - 0xc0);
+      load_table_entry(common, SLJIT_MOV_U8, RETURN_ADDR, TMP1, (sljit_sw)PRIV(utf8_table4) - 0xc0, symbol_utf8_table4);
     OP1(MOV_UCHAR, TMP1, 0, SLJIT_MEM1(STR_PTR), IN_UCHARS(0));
     jump2 = CMP(SLJIT_GREATER, TMP2, 0, SLJIT_IMM, 0x7);
     OP2(SLJIT_SHL, TMP2, 0, TMP2, 0, SLJIT_IMM, 6);
@@ -3231,7 +3437,7 @@ if (common->utf)
     {
     OP2(SLJIT_SUB, TMP2, 0, TMP1, 0, SLJIT_IMM, 0xe0);
     if (update_str_ptr)
-      OP1(SLJIT_MOV_U8, RETURN_ADDR, 0, SLJIT_MEM1(TMP1), (sljit_sw)PRIV(utf8_table4) - 0xc0);
+      load_table_entry(common, SLJIT_MOV_U8, RETURN_ADDR, TMP1, (sljit_sw)PRIV(utf8_table4) - 0xc0, symbol_utf8_table4);
     OP1(MOV_UCHAR, TMP1, 0, SLJIT_MEM1(STR_PTR), IN_UCHARS(0));
     jump2 = CMP(SLJIT_GREATER, TMP2, 0, SLJIT_IMM, 0xf);
     OP2(SLJIT_SHL, TMP2, 0, TMP2, 0, SLJIT_IMM, 6);
@@ -3251,7 +3457,7 @@ if (common->utf)
     add_jump(compiler, (max < 0x10000) ? &common->utfreadchar16 : &common->utfreadchar, JUMP(SLJIT_FAST_CALL));
   else if (max < 128)
     {
-    OP1(SLJIT_MOV_U8, TMP2, 0, SLJIT_MEM1(TMP1), (sljit_sw)PRIV(utf8_table4) - 0xc0);
+    load_table_entry(common, SLJIT_MOV_U8, TMP2, TMP1, (sljit_sw)PRIV(utf8_table4) - 0xc0, symbol_utf8_table4);
     OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
     }
   else
@@ -3260,7 +3466,7 @@ if (common->utf)
     if (!update_str_ptr)
       OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(1));
     else
-      OP1(SLJIT_MOV_U8, RETURN_ADDR, 0, SLJIT_MEM1(TMP1), (sljit_sw)PRIV(utf8_table4) - 0xc0);
+      load_table_entry(common, SLJIT_MOV_U8, RETURN_ADDR, TMP1, (sljit_sw)PRIV(utf8_table4) - 0xc0, symbol_utf8_table4);
     OP2(SLJIT_AND, TMP1, 0, TMP1, 0, SLJIT_IMM, 0x3f);
     OP2(SLJIT_SHL, TMP1, 0, TMP1, 0, SLJIT_IMM, 6);
     OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, 0x3f);
@@ -3330,7 +3536,7 @@ if (common->utf)
   {
   /* This can be an extra read in some situations, but hopefully
   it is needed in most cases. */
-  OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP2), common->ctypes);
+  load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP2, common->ctypes, symbol_none);
   jump = CMP(SLJIT_LESS, TMP2, 0, SLJIT_IMM, 0xc0);
   if (!update_str_ptr)
     {
@@ -3342,7 +3548,7 @@ if (common->utf)
     OP2(SLJIT_OR, TMP2, 0, TMP2, 0, TMP1, 0);
     OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, 0);
     jump2 = CMP(SLJIT_GREATER, TMP2, 0, SLJIT_IMM, 255);
-    OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP2), common->ctypes);
+    load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP2, common->ctypes, symbol_none);
     JUMPHERE(jump2);
     }
   else
@@ -3357,7 +3563,7 @@ if (common->utf)
 OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, 0);
 jump = CMP(SLJIT_GREATER, TMP2, 0, SLJIT_IMM, 255);
 #endif
-OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP2), common->ctypes);
+load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP2, common->ctypes, symbol_none);
 #if PCRE2_CODE_UNIT_WIDTH != 8
 JUMPHERE(jump);
 #endif
@@ -3550,7 +3756,7 @@ compare = CMP(SLJIT_GREATER, TMP2, 0, SLJIT_IMM, 0x3);
 OP2(SLJIT_SHL, TMP2, 0, TMP2, 0, SLJIT_IMM, 6);
 OP2(SLJIT_AND, TMP1, 0, TMP1, 0, SLJIT_IMM, 0x3f);
 OP2(SLJIT_OR, TMP2, 0, TMP2, 0, TMP1, 0);
-OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP2), common->ctypes);
+load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP2, common->ctypes, symbol_none);
 sljit_emit_fast_return(compiler, RETURN_ADDR, 0);
 
 JUMPHERE(compare);
@@ -3559,7 +3765,7 @@ sljit_emit_fast_return(compiler, RETURN_ADDR, 0);
 
 /* We only have types for characters less than 256. */
 JUMPHERE(jump);
-OP1(SLJIT_MOV_U8, TMP2, 0, SLJIT_MEM1(TMP2), (sljit_sw)PRIV(utf8_table4) - 0xc0);
+load_table_entry(common, SLJIT_MOV_U8, TMP2, TMP2, (sljit_sw)PRIV(utf8_table4) - 0xc0, symbol_utf8_table4);
 OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, 0);
 OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
 sljit_emit_fast_return(compiler, RETURN_ADDR, 0);
@@ -3601,13 +3807,13 @@ if (!common->utf)
 #endif
 
 OP2(SLJIT_LSHR, TMP2, 0, TMP1, 0, SLJIT_IMM, UCD_BLOCK_SHIFT);
-OP1(SLJIT_MOV_U8, TMP2, 0, SLJIT_MEM1(TMP2), (sljit_sw)PRIV(ucd_stage1));
+load_table_entry(common, SLJIT_MOV_U8, TMP2, TMP2, (sljit_sw)PRIV(ucd_stage1), symbol_ucd_stage1);
 OP2(SLJIT_AND, TMP1, 0, TMP1, 0, SLJIT_IMM, UCD_BLOCK_MASK);
 OP2(SLJIT_SHL, TMP2, 0, TMP2, 0, SLJIT_IMM, UCD_BLOCK_SHIFT);
 OP2(SLJIT_ADD, TMP1, 0, TMP1, 0, TMP2, 0);
-OP1(SLJIT_MOV, TMP2, 0, SLJIT_IMM, (sljit_sw)PRIV(ucd_stage2));
+load_address(common, TMP2, 0, (sljit_sw)PRIV(ucd_stage2), symbol_ucd_stage2);
 OP1(SLJIT_MOV_U16, TMP2, 0, SLJIT_MEM2(TMP2, TMP1), 1);
-OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, chartype));
+load_address(common, TMP1, 0, (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, chartype), symbol_ucd_records);
 OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM2(TMP1, TMP2), 3);
 sljit_emit_fast_return(compiler, RETURN_ADDR, 0);
 }
@@ -3734,7 +3940,7 @@ OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(1));
 if (common->utf)
   {
   singlechar = CMP(SLJIT_LESS, TMP1, 0, SLJIT_IMM, 0xc0);
-  OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP1), (sljit_sw)PRIV(utf8_table4) - 0xc0);
+  load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP1, (sljit_sw)PRIV(utf8_table4) - 0xc0, symbol_utf8_table4);
   OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP1, 0);
   JUMPHERE(singlechar);
   }
@@ -4214,6 +4420,16 @@ CMPTO(SLJIT_EQUAL, reg, 0, SLJIT_IMM, 0xdc00, label);
 }
 #endif
 
+static SLJIT_INLINE BOOL req_char_search_limited(compiler_common *common)
+{
+/* Searching for the required character is skipped for long subjects only if
+the pattern is anchored, because otherwise the search costs no more than the
+bumpalong does. PCRE2_EXTRA_ALWAYS_CHECK_LASTCU disables the limit. */
+
+return (common->re->overall_options & PCRE2_ANCHORED) != 0 &&
+  (common->re->flags & PCRE2_LASTCHECKALL) == 0;
+}
+
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86) && !(defined SUPPORT_VALGRIND)
 
 #if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
@@ -4501,6 +4717,267 @@ if (common->utf && offset > 0)
 #endif
 }
 
+/* AVX2 instructions are VEX encoded. The type argument of emit_vex_op()
+combines the opcode map, the mandatory prefix and the vector length. The
+general purpose register of a memory operand is used as a base register with
+no displacement. */
+
+#define VEX_128    0x000
+#define VEX_256    0x004
+#define VEX_66     0x001
+#define VEX_F3     0x002
+#define VEX_0F     0x100
+#define VEX_0F38   0x200
+#define VEX_0F3A   0x300
+#define VEX_NO_IMM -1
+
+static void emit_vex_op(struct sljit_compiler *compiler, sljit_u32 type, sljit_u8 opcode,
+  sljit_s32 reg, sljit_s32 vreg, sljit_s32 rm, BOOL rm_is_mem, sljit_s32 imm)
+{
+sljit_u8 instruction[8];
+sljit_s32 size;
+sljit_u8 inverted_r = (reg & 0x8) ? 0 : 0x80;
+sljit_u8 inverted_b = (rm & 0x8) ? 0 : 0x20;
+sljit_u8 vvvv_l_pp = (sljit_u8)((((~vreg) & 0xf) << 3) | (type & 0x7));
+
+if ((type & 0x300) == VEX_0F && inverted_b != 0)
+  {
+  /* Two byte VEX prefix. */
+  instruction[0] = 0xc5;
+  instruction[1] = inverted_r | vvvv_l_pp;
+  size = 2;
+  }
+else
+  {
+  /* Three byte VEX prefix: X is not used and W is zero. */
+  instruction[0] = 0xc4;
+  instruction[1] = (sljit_u8)(inverted_r | 0x40 | inverted_b | ((type >> 8) & 0x3));
+  instruction[2] = vvvv_l_pp;
+  size = 3;
+  }
+
+instruction[size++] = opcode;
+
+if (!rm_is_mem)
+  instruction[size++] = (sljit_u8)(0xc0 | ((reg & 0x7) << 3) | (rm & 0x7));
+else if ((rm & 0x7) == 5)
+  {
+  /* The base is ebp/rbp or r13: an 8 bit displacement is required. */
+  instruction[size++] = (sljit_u8)(0x40 | ((reg & 0x7) << 3) | 5);
+  instruction[size++] = 0;
+  }
+else
+  {
+  instruction[size++] = (sljit_u8)(((reg & 0x7) << 3) | (rm & 0x7));
+  /* The base is esp/rsp or r12: a SIB byte is required. */
+  if ((rm & 0x7) == 4)
+    instruction[size++] = 0x24;
+  }
+
+if (imm != VEX_NO_IMM)
+  instruction[size++] = (sljit_u8)imm;
+
+sljit_emit_op_custom(compiler, instruction, size);
+}
+
+static void emit_vzeroupper(struct sljit_compiler *compiler)
+{
+sljit_u8 instruction[3];
+
+/* VZEROUPPER */
+instruction[0] = 0xc5;
+instruction[1] = 0xf8;
+instruction[2] = 0x77;
+sljit_emit_op_custom(compiler, instruction, 3);
+}
+
+static void emit_bsf(struct sljit_compiler *compiler, sljit_s32 reg_ind)
+{
+sljit_u8 instruction[3];
+
+SLJIT_ASSERT(reg_ind < 8);
+
+/* BSF r32, r/m32 */
+instruction[0] = 0x0f;
+instruction[1] = 0xbc;
+instruction[2] = 0xc0 | (reg_ind << 3) | reg_ind;
+sljit_emit_op_custom(compiler, instruction, 3);
+sljit_set_current_flags(compiler, SLJIT_SET_Z);
+}
+
+static void load_char_avx2(struct sljit_compiler *compiler, sljit_s32 dst_ymm_reg, sljit_s32 src_general_reg)
+{
+/* VMOVD xmm, r/m32 */
+emit_vex_op(compiler, VEX_128 | VEX_66 | VEX_0F, 0x6e, dst_ymm_reg, 0, src_general_reg, FALSE, VEX_NO_IMM);
+}
+
+static void broadcast_char_avx2(struct sljit_compiler *compiler, sljit_s32 ymm_reg)
+{
+/* VPBROADCASTD ymm1, xmm2/m32 */
+emit_vex_op(compiler, VEX_256 | VEX_66 | VEX_0F38, 0x58, ymm_reg, 0, ymm_reg, FALSE, VEX_NO_IMM);
+}
+
+static void load_from_mem_avx2(struct sljit_compiler *compiler, sljit_s32 dst_ymm_reg, sljit_s32 src_general_reg, BOOL aligned)
+{
+/* VMOVDQA or VMOVDQU ymm1, ymm2/m256 */
+emit_vex_op(compiler, VEX_256 | (aligned ? VEX_66 : VEX_F3) | VEX_0F, 0x6f, dst_ymm_reg, 0, src_general_reg, TRUE, VEX_NO_IMM);
+}
+
+static void get_mask_avx2(struct sljit_compiler *compiler, sljit_s32 dst_general_reg, sljit_s32 src_ymm_reg)
+{
+/* VPMOVMSKB r32, ymm */
+emit_vex_op(compiler, VEX_256 | VEX_66 | VEX_0F, 0xd7, dst_general_reg, 0, src_ymm_reg, FALSE, VEX_NO_IMM);
+}
+
+static void fast_forward_char_pair_avx2_compare(struct sljit_compiler *compiler, PCRE2_UCHAR char1, PCRE2_UCHAR char2,
+  sljit_u32 bit, sljit_s32 dst_ind, sljit_s32 cmp1_ind, sljit_s32 cmp2_ind, sljit_s32 tmp_ind)
+{
+/* The AVX2 forms take a separate destination, so no copy is needed. */
+if (char1 == char2 || bit != 0)
+  {
+  if (bit != 0)
+    {
+    /* VPOR ymm1, ymm2, ymm3/m256 */
+    emit_vex_op(compiler, VEX_256 | VEX_66 | VEX_0F, 0xeb, dst_ind, dst_ind, cmp2_ind, FALSE, VEX_NO_IMM);
+    }
+
+  /* VPCMPEQB/W/D ymm1, ymm2, ymm3/m256 */
+  emit_vex_op(compiler, VEX_256 | VEX_66 | VEX_0F, 0x74 + SSE2_COMPARE_TYPE_INDEX, dst_ind, dst_ind, cmp1_ind, FALSE, VEX_NO_IMM);
+  }
+else
+  {
+  /* VPCMPEQB/W/D ymm1, ymm2, ymm3/m256 */
+  emit_vex_op(compiler, VEX_256 | VEX_66 | VEX_0F, 0x74 + SSE2_COMPARE_TYPE_INDEX, tmp_ind, dst_ind, cmp2_ind, FALSE, VEX_NO_IMM);
+  emit_vex_op(compiler, VEX_256 | VEX_66 | VEX_0F, 0x74 + SSE2_COMPARE_TYPE_INDEX, dst_ind, dst_ind, cmp1_ind, FALSE, VEX_NO_IMM);
+
+  /* VPOR ymm1, ymm2, ymm3/m256 */
+  emit_vex_op(compiler, VEX_256 | VEX_66 | VEX_0F, 0xeb, dst_ind, dst_ind, tmp_ind, FALSE, VEX_NO_IMM);
+  }
+}
+
+static void fast_forward_first_char2_avx2(compiler_common *common, PCRE2_UCHAR char1, PCRE2_UCHAR char2, sljit_s32 offset)
+{
+DEFINE_COMPILER;
+struct sljit_label *start;
+#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
+struct sljit_label *restart;
+#endif
+struct sljit_jump *quit;
+struct sljit_jump *partial_quit[2];
+sljit_s32 tmp1_ind = sljit_get_register_index(TMP1);
+sljit_s32 str_ptr_ind = sljit_get_register_index(STR_PTR);
+sljit_s32 data_ind = 0;
+sljit_s32 tmp_ind = 1;
+sljit_s32 cmp1_ind = 2;
+sljit_s32 cmp2_ind = 3;
+sljit_u32 bit = 0;
+
+SLJIT_UNUSED_ARG(offset);
+
+if (char1 != char2)
+  {
+  bit = char1 ^ char2;
+  if (!is_powerof2(bit))
+    bit = 0;
+  }
+
+partial_quit[0] = CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0);
+if (common->mode == PCRE2_JIT_COMPLETE)
+  add_jump(compiler, &common->failed_match, partial_quit[0]);
+
+/* First part (unaligned start) */
+
+OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(char1 | bit));
+
+SLJIT_ASSERT(tmp1_ind < 8);
+
+load_char_avx2(compiler, cmp1_ind, tmp1_ind);
+
+if (char1 != char2)
+  {
+  OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(bit != 0 ? bit : char2));
+  load_char_avx2(compiler, cmp2_ind, tmp1_ind);
+  }
+
+OP1(SLJIT_MOV, TMP2, 0, STR_PTR, 0);
+
+/* The upper halves of the registers are cleared by VZEROUPPER, so the
+characters are broadcast again after a restart. */
+
+#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
+restart = LABEL();
+#endif
+
+broadcast_char_avx2(compiler, cmp1_ind);
+if (char1 != char2)
+  broadcast_char_avx2(compiler, cmp2_ind);
+
+OP2(SLJIT_AND, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, ~0x1f);
+OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, 0x1f);
+
+load_from_mem_avx2(compiler, data_ind, str_ptr_ind, TRUE);
+fast_forward_char_pair_avx2_compare(compiler, char1, char2, bit, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
+get_mask_avx2(compiler, tmp1_ind, data_ind);
+
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
+OP2(SLJIT_LSHR, TMP1, 0, TMP1, 0, TMP2, 0);
+
+emit_bsf(compiler, tmp1_ind);
+quit = JUMP(SLJIT_NOT_ZERO);
+
+OP2(SLJIT_SUB, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
+
+start = LABEL();
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, 32);
+
+partial_quit[1] = CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0);
+
+/* Second part (aligned) */
+
+load_from_mem_avx2(compiler, data_ind, str_ptr_ind, TRUE);
+fast_forward_char_pair_avx2_compare(compiler, char1, char2, bit, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
+get_mask_avx2(compiler, tmp1_ind, data_ind);
+
+emit_bsf(compiler, tmp1_ind);
+JUMPTO(SLJIT_ZERO, start);
+
+JUMPHERE(quit);
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP1, 0);
+
+/* Both exits from the vector loop come here, to avoid the AVX-SSE transition
+penalty in the code that follows. */
+
+JUMPHERE(partial_quit[1]);
+emit_vzeroupper(compiler);
+
+if (common->mode != PCRE2_JIT_COMPLETE)
+  {
+  JUMPHERE(partial_quit[0]);
+  OP2(SLJIT_SUB | SLJIT_SET_GREATER, SLJIT_UNUSED, 0, STR_PTR, 0, STR_END, 0);
+  CMOV(SLJIT_GREATER, STR_PTR, STR_END, 0);
+  }
+else
+  add_jump(compiler, &common->failed_match, CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0));
+
+#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
+if (common->utf && offset > 0)
+  {
+  SLJIT_ASSERT(common->mode == PCRE2_JIT_COMPLETE);
+
+  OP1(MOV_UCHAR, TMP1, 0, SLJIT_MEM1(STR_PTR), IN_UCHARS(-offset));
+
+  quit = jump_if_utf_char_start(compiler, TMP1);
+
+  OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(1));
+  add_jump(compiler, &common->failed_match, CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0));
+  OP1(SLJIT_MOV, TMP2, 0, STR_PTR, 0);
+  JUMPTO(SLJIT_JUMP, restart);
+
+  JUMPHERE(quit);
+  }
+#endif
+}
+
 #ifndef _WIN64
 
 static SLJIT_INLINE sljit_u32 max_fast_forward_char_pair_sse2_offset(void)
@@ -4842,25 +5319,224 @@ if (common->match_end_ptr != 0)
   OP1(SLJIT_MOV, STR_END, 0, TMP3, 0);
 }
 
-static BOOL check_fast_forward_char_pair_sse2(compiler_common *common, fast_forward_char_data *chars, int max)
+static void fast_forward_char_pair_avx2(compiler_common *common, sljit_s32 offs1,
+  PCRE2_UCHAR char1a, PCRE2_UCHAR char1b, sljit_s32 offs2, PCRE2_UCHAR char2a, PCRE2_UCHAR char2b)
 {
-sljit_s32 i, j, priority, count;
-sljit_u32 priorities;
-PCRE2_UCHAR a1, a2, b1, b2;
-
-priorities = 0;
-
-count = 0;
-for (i = 0; i < max; i++)
-  {
-  if (chars[i].last_count > 2)
-    {
-    SLJIT_ASSERT(chars[i].last_count <= 7);
-
-    priorities |= (1 << chars[i].last_count);
-    count++;
-    }
-  }
+DEFINE_COMPILER;
+sljit_u32 bit1 = 0;
+sljit_u32 bit2 = 0;
+sljit_u32 diff = IN_UCHARS(offs1 - offs2);
+sljit_s32 tmp1_ind = sljit_get_register_index(TMP1);
+sljit_s32 tmp2_ind = sljit_get_register_index(TMP2);
+sljit_s32 str_ptr_ind = sljit_get_register_index(STR_PTR);
+sljit_s32 data1_ind = 0;
+sljit_s32 data2_ind = 1;
+sljit_s32 tmp_ind = 2;
+sljit_s32 cmp1a_ind = 3;
+sljit_s32 cmp1b_ind = 4;
+sljit_s32 cmp2a_ind = 5;
+sljit_s32 cmp2b_ind = 6;
+struct sljit_label *start;
+#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
+struct sljit_label *restart;
+#endif
+struct sljit_jump *jump[2];
+struct sljit_jump *quit;
+
+SLJIT_ASSERT(common->mode == PCRE2_JIT_COMPLETE && offs1 > offs2);
+SLJIT_ASSERT(diff <= IN_UCHARS(max_fast_forward_char_pair_sse2_offset()));
+SLJIT_ASSERT(tmp1_ind < 8 && tmp2_ind == 1);
+
+/* Initialize. */
+if (common->match_end_ptr != 0)
+  {
+  OP1(SLJIT_MOV, TMP1, 0, SLJIT_MEM1(SLJIT_SP), common->match_end_ptr);
+  OP1(SLJIT_MOV, TMP3, 0, STR_END, 0);
+  OP2(SLJIT_ADD, TMP1, 0, TMP1, 0, SLJIT_IMM, IN_UCHARS(offs1 + 1));
+
+  OP2(SLJIT_SUB | SLJIT_SET_LESS, SLJIT_UNUSED, 0, TMP1, 0, STR_END, 0);
+  CMOV(SLJIT_LESS, STR_END, TMP1, 0);
+  }
+
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(offs1));
+add_jump(compiler, &common->failed_match, CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0));
+
+if (char1a == char1b)
+  OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(char1a));
+else
+  {
+  bit1 = char1a ^ char1b;
+  if (is_powerof2(bit1))
+    {
+    OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(char1a | bit1));
+    OP1(SLJIT_MOV, TMP2, 0, SLJIT_IMM, character_to_int32(bit1));
+    }
+  else
+    {
+    bit1 = 0;
+    OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(char1a));
+    OP1(SLJIT_MOV, TMP2, 0, SLJIT_IMM, character_to_int32(char1b));
+    }
+  }
+
+load_char_avx2(compiler, cmp1a_ind, tmp1_ind);
+if (char1a != char1b)
+  load_char_avx2(compiler, cmp1b_ind, tmp2_ind);
+
+if (char2a == char2b)
+  OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(char2a));
+else
+  {
+  bit2 = char2a ^ char2b;
+  if (is_powerof2(bit2))
+    {
+    OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(char2a | bit2));
+    OP1(SLJIT_MOV, TMP2, 0, SLJIT_IMM, character_to_int32(bit2));
+    }
+  else
+    {
+    bit2 = 0;
+    OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(char2a));
+    OP1(SLJIT_MOV, TMP2, 0, SLJIT_IMM, character_to_int32(char2b));
+    }
+  }
+
+load_char_avx2(compiler, cmp2a_ind, tmp1_ind);
+if (char2a != char2b)
+  load_char_avx2(compiler, cmp2b_ind, tmp2_ind);
+
+#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
+restart = LABEL();
+#endif
+
+broadcast_char_avx2(compiler, cmp1a_ind);
+if (char1a != char1b)
+  broadcast_char_avx2(compiler, cmp1b_ind);
+broadcast_char_avx2(compiler, cmp2a_ind);
+if (char2a != char2b)
+  broadcast_char_avx2(compiler, cmp2b_ind);
+
+OP2(SLJIT_SUB, TMP1, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(offs1 - offs2));
+OP1(SLJIT_MOV, TMP2, 0, STR_PTR, 0);
+OP2(SLJIT_AND, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, ~0x1f);
+OP2(SLJIT_AND, TMP1, 0, TMP1, 0, SLJIT_IMM, ~0x1f);
+
+load_from_mem_avx2(compiler, data1_ind, str_ptr_ind, TRUE);
+
+jump[0] = CMP(SLJIT_EQUAL, STR_PTR, 0, TMP1, 0);
+
+/* The second character is in the previous block, which is readable. */
+OP2(SLJIT_SUB, TMP1, 0, STR_PTR, 0, SLJIT_IMM, diff);
+load_from_mem_avx2(compiler, data2_ind, tmp1_ind, FALSE);
+
+jump[1] = JUMP(SLJIT_JUMP);
+
+JUMPHERE(jump[0]);
+
+/* Shift the whole block left by diff bytes: VPERM2I128 moves the low lane
+to the high lane and clears the low lane, then VPALIGNR shifts the bytes
+across the lanes. */
+
+/* VPERM2I128 ymm1, ymm2, ymm3/m256, imm8 */
+emit_vex_op(compiler, VEX_256 | VEX_66 | VEX_0F3A, 0x46, tmp_ind, data1_ind, data1_ind, FALSE, 0x08);
+
+/* VPALIGNR ymm1, ymm2, ymm3/m256, imm8 */
+emit_vex_op(compiler, VEX_256 | VEX_66 | VEX_0F3A, 0x0f, data2_ind, data1_ind, tmp_ind, FALSE, 16 - diff);
+
+JUMPHERE(jump[1]);
+
+OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, 0x1f);
+
+fast_forward_char_pair_avx2_compare(compiler, char2a, char2b, bit2, data2_ind, cmp2a_ind, cmp2b_ind, tmp_ind);
+fast_forward_char_pair_avx2_compare(compiler, char1a, char1b, bit1, data1_ind, cmp1a_ind, cmp1b_ind, tmp_ind);
+
+/* VPAND ymm1, ymm2, ymm3/m256 */
+emit_vex_op(compiler, VEX_256 | VEX_66 | VEX_0F, 0xdb, data1_ind, data1_ind, data2_ind, FALSE, VEX_NO_IMM);
+get_mask_avx2(compiler, tmp1_ind, data1_ind);
+
+/* Ignore matches before the first STR_PTR. */
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
+OP2(SLJIT_LSHR, TMP1, 0, TMP1, 0, TMP2, 0);
+
+emit_bsf(compiler, tmp1_ind);
+jump[0] = JUMP(SLJIT_NOT_ZERO);
+
+OP2(SLJIT_SUB, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
+
+/* Main loop. */
+
+start = LABEL();
+
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, 32);
+quit = CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0);
+
+load_from_mem_avx2(compiler, data1_ind, str_ptr_ind, TRUE);
+OP2(SLJIT_SUB, TMP1, 0, STR_PTR, 0, SLJIT_IMM, diff);
+load_from_mem_avx2(compiler, data2_ind, tmp1_ind, FALSE);
+
+fast_forward_char_pair_avx2_compare(compiler, char1a, char1b, bit1, data1_ind, cmp1a_ind, cmp1b_ind, tmp_ind);
+fast_forward_char_pair_avx2_compare(compiler, char2a, char2b, bit2, data2_ind, cmp2a_ind, cmp2b_ind, tmp_ind);
+
+/* VPAND ymm1, ymm2, ymm3/m256 */
+emit_vex_op(compiler, VEX_256 | VEX_66 | VEX_0F, 0xdb, data1_ind, data1_ind, data2_ind, FALSE, VEX_NO_IMM);
+get_mask_avx2(compiler, tmp1_ind, data1_ind);
+
+emit_bsf(compiler, tmp1_ind);
+JUMPTO(SLJIT_ZERO, start);
+
+JUMPHERE(jump[0]);
+
+OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP1, 0);
+
+JUMPHERE(quit);
+emit_vzeroupper(compiler);
+
+add_jump(compiler, &common->failed_match, CMP(SLJIT_GREATER_EQUAL, STR_PTR, 0, STR_END, 0));
+
+if (common->match_end_ptr != 0)
+  OP1(SLJIT_MOV, STR_END, 0, SLJIT_MEM1(SLJIT_SP), common->match_end_ptr);
+
+#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 32
+if (common->utf)
+  {
+  OP1(MOV_UCHAR, TMP1, 0, SLJIT_MEM1(STR_PTR), IN_UCHARS(-offs1));
+
+  jump[0] = jump_if_utf_char_start(compiler, TMP1);
+
+  OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(1));
+  CMPTO(SLJIT_LESS, STR_PTR, 0, STR_END, 0, restart);
+
+  add_jump(compiler, &common->failed_match, JUMP(SLJIT_JUMP));
+
+  JUMPHERE(jump[0]);
+  }
+#endif
+
+OP2(SLJIT_SUB, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(offs1));
+
+if (common->match_end_ptr != 0)
+  OP1(SLJIT_MOV, STR_END, 0, TMP3, 0);
+}
+
+static BOOL check_fast_forward_char_pair_sse2(compiler_common *common, fast_forward_char_data *chars, int max)
+{
+sljit_s32 i, j, priority, count;
+sljit_u32 priorities;
+PCRE2_UCHAR a1, a2, b1, b2;
+
+priorities = 0;
+
+count = 0;
+for (i = 0; i < max; i++)
+  {
+  if (chars[i].last_count > 2)
+    {
+    SLJIT_ASSERT(chars[i].last_count <= 7);
+
+    priorities |= (1 << chars[i].last_count);
+    count++;
+    }
+  }
 
 if (count < 2)
   return FALSE;
@@ -4891,7 +5567,10 @@ for (priority = 7; priority > 2; priority--)
 
           if (a1 != b1 && a1 != b2 && a2 != b1 && a2 != b2)
             {
-            fast_forward_char_pair_sse2(common, i, a1, a2, j, b1, b2);
+            if (sljit_has_cpu_feature(SLJIT_HAS_AVX2))
+              fast_forward_char_pair_avx2(common, i, a1, a2, j, b1, b2);
+            else
+              fast_forward_char_pair_sse2(common, i, a1, a2, j, b1, b2);
             return TRUE;
             }
           }
@@ -4905,6 +5584,112 @@ return FALSE;
 
 #endif
 
+static struct sljit_jump *search_requested_char_avx2(compiler_common *common, PCRE2_UCHAR req_char, PCRE2_UCHAR oc, BOOL has_firstchar)
+{
+DEFINE_COMPILER;
+struct sljit_label *loop;
+struct sljit_jump *toolong = NULL;
+struct sljit_jump *alreadyfound;
+struct sljit_jump *found;
+struct sljit_jump *skip;
+struct sljit_jump *notfound[3];
+sljit_u8 instruction[2];
+sljit_s32 tmp1_ind = sljit_get_register_index(TMP1);
+sljit_s32 tmp2_ind = sljit_get_register_index(TMP2);
+sljit_s32 data_ind = 0;
+sljit_s32 tmp_ind = 1;
+sljit_s32 cmp1_ind = 2;
+sljit_s32 cmp2_ind = 3;
+sljit_u32 bit = 0;
+
+SLJIT_ASSERT(common->req_char_ptr != 0);
+SLJIT_ASSERT(tmp1_ind < 8 && tmp2_ind == 1);
+
+if (req_char != oc)
+  {
+  bit = req_char ^ oc;
+  if (!is_powerof2(bit))
+    bit = 0;
+  }
+
+OP1(SLJIT_MOV, TMP2, 0, SLJIT_MEM1(SLJIT_SP), common->req_char_ptr);
+if (req_char_search_limited(common))
+  {
+  OP2(SLJIT_ADD, TMP1, 0, STR_PTR, 0, SLJIT_IMM, REQ_CU_MAX);
+  toolong = CMP(SLJIT_LESS, TMP1, 0, STR_END, 0);
+  }
+alreadyfound = CMP(SLJIT_LESS, STR_PTR, 0, TMP2, 0);
+
+if (has_firstchar)
+  OP2(SLJIT_ADD, TMP2, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(1));
+else
+  OP1(SLJIT_MOV, TMP2, 0, STR_PTR, 0);
+
+notfound[0] = CMP(SLJIT_GREATER_EQUAL, TMP2, 0, STR_END, 0);
+
+OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(req_char | bit));
+load_char_avx2(compiler, cmp1_ind, tmp1_ind);
+broadcast_char_avx2(compiler, cmp1_ind);
+
+if (req_char != oc)
+  {
+  OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, character_to_int32(bit != 0 ? bit : oc));
+  load_char_avx2(compiler, cmp2_ind, tmp1_ind);
+  broadcast_char_avx2(compiler, cmp2_ind);
+  }
+
+/* First part (unaligned start). The pointer is kept in TMP2 (ecx), so its
+low five bits are the shift count. */
+
+OP2(SLJIT_AND, TMP1, 0, TMP2, 0, SLJIT_IMM, ~0x1f);
+load_from_mem_avx2(compiler, data_ind, tmp1_ind, TRUE);
+fast_forward_char_pair_avx2_compare(compiler, req_char, oc, bit, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
+get_mask_avx2(compiler, tmp1_ind, data_ind);
+
+/* SHR r32, cl */
+instruction[0] = 0xd3;
+instruction[1] = 0xc0 | (5 << 3) | tmp1_ind;
+sljit_emit_op_custom(compiler, instruction, 2);
+
+emit_bsf(compiler, tmp1_ind);
+found = JUMP(SLJIT_NOT_ZERO);
+
+OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, ~0x1f);
+
+/* Second part (aligned) */
+
+loop = LABEL();
+OP2(SLJIT_ADD, TMP2, 0, TMP2, 0, SLJIT_IMM, 32);
+notfound[1] = CMP(SLJIT_GREATER_EQUAL, TMP2, 0, STR_END, 0);
+
+load_from_mem_avx2(compiler, data_ind, tmp2_ind, TRUE);
+fast_forward_char_pair_avx2_compare(compiler, req_char, oc, bit, data_ind, cmp1_ind, cmp2_ind, tmp_ind);
+get_mask_avx2(compiler, tmp1_ind, data_ind);
+
+emit_bsf(compiler, tmp1_ind);
+JUMPTO(SLJIT_ZERO, loop);
+
+JUMPHERE(found);
+emit_vzeroupper(compiler);
+OP2(SLJIT_ADD, TMP1, 0, TMP1, 0, TMP2, 0);
+notfound[2] = CMP(SLJIT_GREATER_EQUAL, TMP1, 0, STR_END, 0);
+
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), common->req_char_ptr, TMP1, 0);
+JUMPHERE(alreadyfound);
+if (toolong != NULL)
+  JUMPHERE(toolong);
+skip = JUMP(SLJIT_JUMP);
+
+JUMPHERE(notfound[1]);
+emit_vzeroupper(compiler);
+JUMPHERE(notfound[0]);
+JUMPHERE(notfound[2]);
+notfound[0] = JUMP(SLJIT_JUMP);
+
+JUMPHERE(skip);
+return notfound[0];
+}
+
 #undef SSE2_COMPARE_TYPE_INDEX
 
 #endif
@@ -4937,11 +5722,14 @@ if (has_match_end)
 
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86) && !(defined SUPPORT_VALGRIND)
 
-/* SSE2 accelerated first character search. */
+/* AVX2 or SSE2 accelerated first character search. */
 
 if (sljit_has_cpu_feature(SLJIT_HAS_SSE2))
   {
-  fast_forward_first_char2_sse2(common, char1, char2, offset);
+  if (sljit_has_cpu_feature(SLJIT_HAS_AVX2))
+    fast_forward_first_char2_avx2(common, char1, char2, offset);
+  else
+    fast_forward_first_char2_sse2(common, char1, char2, offset);
 
   if (offset > 0)
     OP2(SLJIT_SUB, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(offset));
@@ -5144,7 +5932,7 @@ else
 SLJIT_ASSERT(range_right >= 0);
 
 #if !(defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
-OP1(SLJIT_MOV, RETURN_ADDR, 0, SLJIT_IMM, (sljit_sw)update_table);
+load_address(common, RETURN_ADDR, 0, (sljit_sw)update_table, symbol_none);
 #endif
 
 start = LABEL();
@@ -5159,7 +5947,7 @@ OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(STR_PTR), IN_UCHARS(range_right + 1) - 1);
 #if !(defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
 OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM2(RETURN_ADDR, TMP1), 0);
 #else
-OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP1), (sljit_sw)update_table);
+load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP1, (sljit_sw)update_table, symbol_none);
 #endif
 OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP1, 0);
 CMPTO(SLJIT_NOT_EQUAL, TMP1, 0, SLJIT_IMM, 0, start);
@@ -5365,7 +6153,7 @@ if (!optimize_class(common, start_bits, (start_bits[31] & 0x80) != 0, FALSE, &ma
 #endif
   OP2(SLJIT_AND, TMP2, 0, TMP1, 0, SLJIT_IMM, 0x7);
   OP2(SLJIT_LSHR, TMP1, 0, TMP1, 0, SLJIT_IMM, 3);
-  OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP1), (sljit_sw)start_bits);
+  load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP1, (sljit_sw)start_bits, symbol_none);
   if (sljit_get_register_index(TMP3) >= 0)
     {
     OP2(SLJIT_SHL, TMP3, 0, SLJIT_IMM, 1, TMP2, 0);
@@ -5399,7 +6187,7 @@ static SLJIT_INLINE struct sljit_jump *search_requested_char(compiler_common *co
 {
 DEFINE_COMPILER;
 struct sljit_label *loop;
-struct sljit_jump *toolong;
+struct sljit_jump *toolong = NULL;
 struct sljit_jump *alreadyfound;
 struct sljit_jump *found;
 struct sljit_jump *foundoc = NULL;
@@ -5407,9 +6195,32 @@ struct sljit_jump *notfound;
 sljit_u32 oc, bit;
 
 SLJIT_ASSERT(common->req_char_ptr != 0);
+
+oc = req_char;
+if (caseless)
+  {
+  oc = TABLE_GET(req_char, common->fcc, req_char);
+#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 8
+  if (req_char > 127 && common->utf)
+    oc = UCD_OTHERCASE(req_char);
+#endif
+  }
+
+#if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86) && !(defined SUPPORT_VALGRIND)
+
+/* AVX2 accelerated required character search. */
+
+if (sljit_has_cpu_feature(SLJIT_HAS_AVX2))
+  return search_requested_char_avx2(common, req_char, oc, has_firstchar);
+
+#endif
+
 OP1(SLJIT_MOV, TMP2, 0, SLJIT_MEM1(SLJIT_SP), common->req_char_ptr);
-OP2(SLJIT_ADD, TMP1, 0, STR_PTR, 0, SLJIT_IMM, REQ_CU_MAX);
-toolong = CMP(SLJIT_LESS, TMP1, 0, STR_END, 0);
+if (req_char_search_limited(common))
+  {
+  OP2(SLJIT_ADD, TMP1, 0, STR_PTR, 0, SLJIT_IMM, REQ_CU_MAX);
+  toolong = CMP(SLJIT_LESS, TMP1, 0, STR_END, 0);
+  }
 alreadyfound = CMP(SLJIT_LESS, STR_PTR, 0, TMP2, 0);
 
 if (has_firstchar)
@@ -5421,18 +6232,9 @@ loop = LABEL();
 notfound = CMP(SLJIT_GREATER_EQUAL, TMP1, 0, STR_END, 0);
 
 OP1(MOV_UCHAR, TMP2, 0, SLJIT_MEM1(TMP1), 0);
-oc = req_char;
-if (caseless)
-  {
-  oc = TABLE_GET(req_char, common->fcc, req_char);
-#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 8
-  if (req_char > 127 && common->utf)
-    oc = UCD_OTHERCASE(req_char);
-#endif
-  }
-if (req_char == oc)
-  found = CMP(SLJIT_EQUAL, TMP2, 0, SLJIT_IMM, req_char);
-else
+if (req_char == oc)
+  found = CMP(SLJIT_EQUAL, TMP2, 0, SLJIT_IMM, req_char);
+else
   {
   bit = req_char ^ oc;
   if (is_powerof2(bit))
@@ -5454,7 +6256,48 @@ if (foundoc)
   JUMPHERE(foundoc);
 OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), common->req_char_ptr, TMP1, 0);
 JUMPHERE(alreadyfound);
-JUMPHERE(toolong);
+if (toolong != NULL)
+  JUMPHERE(toolong);
+return notfound;
+}
+
+static PCRE2_SPTR SLJIT_CALL do_search_literal(PCRE2_SPTR str_ptr, PCRE2_SPTR str_end, const pcre2_real_code *re)
+{
+/* The vectorized substring search is shared with the interpreters. */
+return PRIV(find_literal)(str_ptr, str_end, re->req_literal, re->req_literal_length);
+}
+
+static SLJIT_INLINE struct sljit_jump *search_requested_literal(compiler_common *common)
+{
+DEFINE_COMPILER;
+struct sljit_jump *toolong = NULL;
+struct sljit_jump *alreadyfound;
+struct sljit_jump *notfound;
+
+SLJIT_ASSERT(common->req_literal_ptr != 0);
+SLJIT_ASSERT(TMP1 == SLJIT_R0 && STACK_TOP == SLJIT_R1 && TMP2 == SLJIT_R2);
+
+if (req_char_search_limited(common))
+  {
+  OP2(SLJIT_ADD, TMP1, 0, STR_PTR, 0, SLJIT_IMM, REQ_CU_MAX);
+  toolong = CMP(SLJIT_LESS, TMP1, 0, STR_END, 0);
+  }
+OP1(SLJIT_MOV, TMP2, 0, SLJIT_MEM1(SLJIT_SP), common->req_literal_ptr);
+alreadyfound = CMP(SLJIT_LESS_EQUAL, STR_PTR, 0, TMP2, 0);
+
+/* Needed to save important temporary registers. */
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LOCALS0, STACK_TOP, 0);
+OP1(SLJIT_MOV, SLJIT_R0, 0, STR_PTR, 0);
+OP1(SLJIT_MOV, SLJIT_R1, 0, STR_END, 0);
+load_address(common, SLJIT_R2, 0, (sljit_sw)common->re, symbol_none);
+call_function(common, SLJIT_CALL3, SLJIT_FUNC_OFFSET(do_search_literal), symbol_do_search_literal);
+OP1(SLJIT_MOV, STACK_TOP, 0, SLJIT_MEM1(SLJIT_SP), LOCALS0);
+
+notfound = CMP(SLJIT_GREATER_EQUAL, SLJIT_RETURN_REG, 0, STR_END, 0);
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), common->req_literal_ptr, SLJIT_RETURN_REG, 0);
+JUMPHERE(alreadyfound);
+if (toolong != NULL)
+  JUMPHERE(toolong);
 return notfound;
 }
 
@@ -5560,7 +6403,7 @@ else
   if (common->utf)
     jump = CMP(SLJIT_GREATER, TMP1, 0, SLJIT_IMM, 255);
 #endif /* PCRE2_CODE_UNIT_WIDTH == 8 */
-  OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP1), common->ctypes);
+  load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP1, common->ctypes, symbol_none);
   OP2(SLJIT_LSHR, TMP1, 0, TMP1, 0, SLJIT_IMM, 4 /* ctype_word */);
   OP2(SLJIT_AND, TMP1, 0, TMP1, 0, SLJIT_IMM, 1);
   OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LOCALS1, TMP1, 0);
@@ -5605,7 +6448,7 @@ else
   if (common->utf)
     jump = CMP(SLJIT_GREATER, TMP1, 0, SLJIT_IMM, 255);
 #endif
-  OP1(SLJIT_MOV_U8, TMP2, 0, SLJIT_MEM1(TMP1), common->ctypes);
+  load_table_entry(common, SLJIT_MOV_U8, TMP2, TMP1, common->ctypes, symbol_none);
   OP2(SLJIT_LSHR, TMP2, 0, TMP2, 0, SLJIT_IMM, 4 /* ctype_word */);
   OP2(SLJIT_AND, TMP2, 0, TMP2, 0, SLJIT_IMM, 1);
 #if PCRE2_CODE_UNIT_WIDTH != 8
@@ -6018,7 +6861,7 @@ OP2(SLJIT_SUB, STR_PTR, 0, STR_PTR, 0, TMP2, 0);
 OP1(SLJIT_MOV, TMP3, 0, LCC_TABLE, 0);
 OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LOCALS0, CHAR1, 0);
 OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LOCALS1, CHAR2, 0);
-OP1(SLJIT_MOV, LCC_TABLE, 0, SLJIT_IMM, common->lcc);
+load_address(common, LCC_TABLE, 0, common->lcc, symbol_none);
 OP2(SLJIT_SUB, TMP1, 0, TMP1, 0, SLJIT_IMM, IN_UCHARS(1));
 OP2(SLJIT_SUB, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(1));
 
@@ -6402,7 +7245,7 @@ if ((cc[-1] & XCL_HASPROP) == 0)
       {
       OP2(SLJIT_AND, TMP2, 0, TMP1, 0, SLJIT_IMM, 0x7);
       OP2(SLJIT_LSHR, TMP1, 0, TMP1, 0, SLJIT_IMM, 3);
-      OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP1), (sljit_sw)cc);
+      load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP1, (sljit_sw)cc, symbol_none);
       OP2(SLJIT_SHL, TMP2, 0, SLJIT_IMM, 1, TMP2, 0);
       OP2(SLJIT_AND | SLJIT_SET_Z, SLJIT_UNUSED, 0, TMP1, 0, TMP2, 0);
       add_jump(compiler, &found, JUMP(SLJIT_NOT_ZERO));
@@ -6435,7 +7278,7 @@ else if ((cc[-1] & XCL_MAP) != 0)
 
     OP2(SLJIT_AND, TMP2, 0, TMP1, 0, SLJIT_IMM, 0x7);
     OP2(SLJIT_LSHR, TMP1, 0, TMP1, 0, SLJIT_IMM, 3);
-    OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP1), (sljit_sw)cc);
+    load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP1, (sljit_sw)cc, symbol_none);
     OP2(SLJIT_SHL, TMP2, 0, SLJIT_IMM, 1, TMP2, 0);
     OP2(SLJIT_AND | SLJIT_SET_Z, SLJIT_UNUSED, 0, TMP1, 0, TMP2, 0);
     add_jump(compiler, list, JUMP(SLJIT_NOT_ZERO));
@@ -6466,17 +7309,17 @@ if (needstype || needsscript)
 #endif
 
   OP2(SLJIT_LSHR, TMP2, 0, TMP1, 0, SLJIT_IMM, UCD_BLOCK_SHIFT);
-  OP1(SLJIT_MOV_U8, TMP2, 0, SLJIT_MEM1(TMP2), (sljit_sw)PRIV(ucd_stage1));
+  load_table_entry(common, SLJIT_MOV_U8, TMP2, TMP2, (sljit_sw)PRIV(ucd_stage1), symbol_ucd_stage1);
   OP2(SLJIT_AND, TMP1, 0, TMP1, 0, SLJIT_IMM, UCD_BLOCK_MASK);
   OP2(SLJIT_SHL, TMP2, 0, TMP2, 0, SLJIT_IMM, UCD_BLOCK_SHIFT);
   OP2(SLJIT_ADD, TMP1, 0, TMP1, 0, TMP2, 0);
-  OP1(SLJIT_MOV, TMP2, 0, SLJIT_IMM, (sljit_sw)PRIV(ucd_stage2));
+  load_address(common, TMP2, 0, (sljit_sw)PRIV(ucd_stage2), symbol_ucd_stage2);
   OP1(SLJIT_MOV_U16, TMP2, 0, SLJIT_MEM2(TMP2, TMP1), 1);
 
   /* Before anything else, we deal with scripts. */
   if (needsscript)
     {
-    OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, script));
+    load_address(common, TMP1, 0, (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, script), symbol_ucd_records);
     OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM2(TMP1, TMP2), 3);
 
     ccbegin = cc;
@@ -6523,13 +7366,13 @@ if (needstype || needsscript)
     {
     if (!needschar)
       {
-      OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, chartype));
+      load_address(common, TMP1, 0, (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, chartype), symbol_ucd_records);
       OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM2(TMP1, TMP2), 3);
       }
     else
       {
       OP2(SLJIT_SHL, TMP2, 0, TMP2, 0, SLJIT_IMM, 3);
-      OP1(SLJIT_MOV_U8, RETURN_ADDR, 0, SLJIT_MEM1(TMP2), (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, chartype));
+      load_table_entry(common, SLJIT_MOV_U8, RETURN_ADDR, TMP2, (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, chartype), symbol_ucd_records);
       typereg = RETURN_ADDR;
       }
     }
@@ -7138,7 +7981,7 @@ switch(type)
 #if PCRE2_CODE_UNIT_WIDTH == 8 || PCRE2_CODE_UNIT_WIDTH == 16
 #if PCRE2_CODE_UNIT_WIDTH == 8
     jump[0] = CMP(SLJIT_LESS, TMP1, 0, SLJIT_IMM, 0xc0);
-    OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP1), (sljit_sw)PRIV(utf8_table4) - 0xc0);
+    load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP1, (sljit_sw)PRIV(utf8_table4) - 0xc0, symbol_utf8_table4);
     OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP1, 0);
 #elif PCRE2_CODE_UNIT_WIDTH == 16
     jump[0] = CMP(SLJIT_LESS, TMP1, 0, SLJIT_IMM, 0xd800);
@@ -7224,7 +8067,7 @@ switch(type)
     detect_partial_match(common, backtracks);
   read_char(common);
   add_jump(compiler, &common->getucd, JUMP(SLJIT_FAST_CALL));
-  OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, gbprop));
+  load_address(common, TMP1, 0, (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, gbprop), symbol_ucd_records);
   /* Optimize register allocation: use a real register. */
   OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LOCALS0, STACK_TOP, 0);
   OP1(SLJIT_MOV_U8, STACK_TOP, 0, SLJIT_MEM2(TMP1, TMP2), 3);
@@ -7234,11 +8077,11 @@ switch(type)
   OP1(SLJIT_MOV, TMP3, 0, STR_PTR, 0);
   read_char(common);
   add_jump(compiler, &common->getucd, JUMP(SLJIT_FAST_CALL));
-  OP1(SLJIT_MOV, TMP1, 0, SLJIT_IMM, (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, gbprop));
+  load_address(common, TMP1, 0, (sljit_sw)PRIV(ucd_records) + SLJIT_OFFSETOF(ucd_record, gbprop), symbol_ucd_records);
   OP1(SLJIT_MOV_U8, TMP2, 0, SLJIT_MEM2(TMP1, TMP2), 3);
 
   OP2(SLJIT_SHL, STACK_TOP, 0, STACK_TOP, 0, SLJIT_IMM, 2);
-  OP1(SLJIT_MOV_U32, TMP1, 0, SLJIT_MEM1(STACK_TOP), (sljit_sw)PRIV(ucp_gbtable));
+  load_table_entry(common, SLJIT_MOV_U32, TMP1, STACK_TOP, (sljit_sw)PRIV(ucp_gbtable), symbol_ucp_gbtable);
   OP1(SLJIT_MOV, STACK_TOP, 0, TMP2, 0);
   OP2(SLJIT_SHL, TMP2, 0, SLJIT_IMM, 1, TMP2, 0);
   OP2(SLJIT_AND | SLJIT_SET_Z, SLJIT_UNUSED, 0, TMP1, 0, TMP2, 0);
@@ -7334,7 +8177,7 @@ switch(type)
       /* Skip the variable-length character. */
       OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, SLJIT_IMM, IN_UCHARS(1));
       jump[0] = CMP(SLJIT_LESS, TMP1, 0, SLJIT_IMM, 0xc0);
-      OP1(MOV_UCHAR, TMP1, 0, SLJIT_MEM1(TMP1), (sljit_sw)PRIV(utf8_table4) - 0xc0);
+      load_table_entry(common, MOV_UCHAR, TMP1, TMP1, (sljit_sw)PRIV(utf8_table4) - 0xc0, symbol_utf8_table4);
       OP2(SLJIT_ADD, STR_PTR, 0, STR_PTR, 0, TMP1, 0);
       JUMPHERE(jump[0]);
       return cc + 1;
@@ -7409,7 +8252,7 @@ switch(type)
 
   OP2(SLJIT_AND, TMP2, 0, TMP1, 0, SLJIT_IMM, 0x7);
   OP2(SLJIT_LSHR, TMP1, 0, TMP1, 0, SLJIT_IMM, 3);
-  OP1(SLJIT_MOV_U8, TMP1, 0, SLJIT_MEM1(TMP1), (sljit_sw)cc);
+  load_table_entry(common, SLJIT_MOV_U8, TMP1, TMP1, (sljit_sw)cc, symbol_none);
   OP2(SLJIT_SHL, TMP2, 0, SLJIT_IMM, 1, TMP2, 0);
   OP2(SLJIT_AND | SLJIT_SET_Z, SLJIT_UNUSED, 0, TMP1, 0, TMP2, 0);
   add_jump(compiler, backtracks, JUMP(SLJIT_ZERO));
@@ -7596,7 +8439,7 @@ if (common->utf && *cc == OP_REFI)
   OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LOCALS0, STACK_TOP, 0);
   OP1(SLJIT_MOV, SLJIT_R1, 0, ARGUMENTS, 0);
   OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_R1), SLJIT_OFFSETOF(jit_arguments, startchar_ptr), STR_PTR, 0);
-  sljit_emit_ijump(compiler, SLJIT_CALL3, SLJIT_IMM, SLJIT_FUNC_OFFSET(do_utf_caselesscmp));
+  call_function(common, SLJIT_CALL3, SLJIT_FUNC_OFFSET(do_utf_caselesscmp), symbol_do_utf_caselesscmp);
   OP1(SLJIT_MOV, STACK_TOP, 0, SLJIT_MEM1(SLJIT_SP), LOCALS0);
   if (common->mode == PCRE2_JIT_COMPLETE)
     add_jump(compiler, backtracks, CMP(SLJIT_LESS_EQUAL, SLJIT_RETURN_REG, 0, SLJIT_IMM, 1));
@@ -8026,7 +8869,10 @@ else
   value3 = (sljit_sw) (GET(cc, 1 + 3*LINK_SIZE));
   }
 
-OP1(SLJIT_MOV, SLJIT_MEM1(STACK_TOP), CALLOUT_ARG_OFFSET(callout_string), SLJIT_IMM, value1);
+if (value1 != 0)
+  load_address(common, SLJIT_MEM1(STACK_TOP), CALLOUT_ARG_OFFSET(callout_string), value1, symbol_none);
+else
+  OP1(SLJIT_MOV, SLJIT_MEM1(STACK_TOP), CALLOUT_ARG_OFFSET(callout_string), SLJIT_IMM, 0);
 OP1(mov_opcode, SLJIT_MEM1(STACK_TOP), CALLOUT_ARG_OFFSET(callout_string_length), SLJIT_IMM, value2);
 OP1(mov_opcode, SLJIT_MEM1(STACK_TOP), CALLOUT_ARG_OFFSET(callout_string_offset), SLJIT_IMM, value3);
 OP1(SLJIT_MOV, SLJIT_MEM1(STACK_TOP), CALLOUT_ARG_OFFSET(mark), (common->mark_ptr != 0) ? TMP2 : SLJIT_IMM, 0);
@@ -8036,7 +8882,7 @@ OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LOCALS0, STACK_TOP, 0);
 /* SLJIT_R0 = arguments */
 OP1(SLJIT_MOV, SLJIT_R1, 0, STACK_TOP, 0);
 GET_LOCAL_BASE(SLJIT_R2, 0, OVECTOR_START);
-sljit_emit_ijump(compiler, SLJIT_CALL3, SLJIT_IMM, SLJIT_FUNC_OFFSET(do_callout));
+call_function(common, SLJIT_CALL3, SLJIT_FUNC_OFFSET(do_callout), symbol_do_callout);
 OP1(SLJIT_MOV_S32, SLJIT_RETURN_REG, 0, SLJIT_RETURN_REG, 0);
 OP1(SLJIT_MOV, STACK_TOP, 0, SLJIT_MEM1(SLJIT_SP), LOCALS0);
 free_stack(common, callout_arg_size);
@@ -10094,7 +10940,7 @@ if (opcode == OP_SKIP)
 if (opcode == OP_PRUNE_ARG || opcode == OP_THEN_ARG)
   {
   OP1(SLJIT_MOV, TMP1, 0, ARGUMENTS, 0);
-  OP1(SLJIT_MOV, TMP2, 0, SLJIT_IMM, (sljit_sw)(cc + 2));
+  load_address(common, TMP2, 0, (sljit_sw)(cc + 2), symbol_none);
   OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), common->mark_ptr, TMP2, 0);
   OP1(SLJIT_MOV, SLJIT_MEM1(TMP1), SLJIT_OFFSETOF(jit_arguments, mark_ptr), TMP2, 0);
   }
@@ -10388,7 +11234,7 @@ while (cc < ccend)
     allocate_stack(common, common->has_skip_arg ? 5 : 1);
     OP1(SLJIT_MOV, TMP1, 0, ARGUMENTS, 0);
     OP1(SLJIT_MOV, SLJIT_MEM1(STACK_TOP), STACK(common->has_skip_arg ? 4 : 0), TMP2, 0);
-    OP1(SLJIT_MOV, TMP2, 0, SLJIT_IMM, (sljit_sw)(cc + 2));
+    load_address(common, TMP2, 0, (sljit_sw)(cc + 2), symbol_none);
     OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), common->mark_ptr, TMP2, 0);
     OP1(SLJIT_MOV, SLJIT_MEM1(TMP1), SLJIT_OFFSETOF(jit_arguments, mark_ptr), TMP2, 0);
     if (common->has_skip_arg)
@@ -10396,7 +11242,7 @@ while (cc < ccend)
       OP1(SLJIT_MOV, TMP1, 0, SLJIT_MEM1(SLJIT_SP), common->control_head_ptr);
       OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), common->control_head_ptr, STACK_TOP, 0);
       OP1(SLJIT_MOV, SLJIT_MEM1(STACK_TOP), STACK(1), SLJIT_IMM, type_mark);
-      OP1(SLJIT_MOV, SLJIT_MEM1(STACK_TOP), STACK(2), SLJIT_IMM, (sljit_sw)(cc + 2));
+      load_address(common, SLJIT_MEM1(STACK_TOP), STACK(2), (sljit_sw)(cc + 2), symbol_none);
       OP1(SLJIT_MOV, SLJIT_MEM1(STACK_TOP), STACK(3), STR_PTR, 0);
       OP1(SLJIT_MOV, SLJIT_MEM1(STACK_TOP), STACK(0), TMP1, 0);
       }
@@ -10888,7 +11734,7 @@ else if (has_alternatives)
     next_update_addr = allocate_read_only_data(common, alt_max * sizeof(sljit_uw));
     if (SLJIT_UNLIKELY(next_update_addr == NULL))
       return;
-    sljit_emit_ijump(compiler, SLJIT_JUMP, SLJIT_MEM1(TMP1), (sljit_sw)next_update_addr);
+    jump_through_table(common, TMP1, next_update_addr);
     add_label_addr(common, next_update_addr++);
     }
   else
@@ -11280,8 +12126,8 @@ if (opcode == OP_SKIP_ARG)
   SLJIT_ASSERT(common->control_head_ptr != 0);
   OP1(SLJIT_MOV, TMP1, 0, SLJIT_MEM1(SLJIT_SP), common->control_head_ptr);
   OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), LOCALS0, STACK_TOP, 0);
-  OP1(SLJIT_MOV, STACK_TOP, 0, SLJIT_IMM, (sljit_sw)(current->cc + 2));
-  sljit_emit_ijump(compiler, SLJIT_CALL2, SLJIT_IMM, SLJIT_FUNC_OFFSET(do_search_mark));
+  load_address(common, STACK_TOP, 0, (sljit_sw)(current->cc + 2), symbol_none);
+  call_function(common, SLJIT_CALL2, SLJIT_FUNC_OFFSET(do_search_mark), symbol_do_search_mark);
   OP1(SLJIT_MOV, STACK_TOP, 0, SLJIT_MEM1(SLJIT_SP), LOCALS0);
 
   OP1(SLJIT_MOV, STR_PTR, 0, TMP1, 0);
@@ -11627,7 +12473,7 @@ while (1)
           next_update_addr = allocate_read_only_data(common, alt_max * sizeof(sljit_uw));
           if (SLJIT_UNLIKELY(next_update_addr == NULL))
             return;
-          sljit_emit_ijump(compiler, SLJIT_JUMP, SLJIT_MEM1(TMP1), (sljit_sw)next_update_addr);
+          jump_through_table(common, TMP1, next_update_addr);
           add_label_addr(common, next_update_addr++);
         }
       else
@@ -11736,7 +12582,161 @@ sljit_emit_fast_return(compiler, TMP2, 0);
 #undef COMPILE_BACKTRACKINGPATH
 #undef CURRENT_AS
 
-static int jit_compile(pcre2_code *code, sljit_u32 mode)
+/* Return the address of a library object that relocatable code uses. */
+
+static sljit_sw symbol_address(sljit_u32 symbol)
+{
+switch(symbol)
+  {
+#ifdef SUPPORT_UNICODE
+#if PCRE2_CODE_UNIT_WIDTH == 8
+  case symbol_utf8_table4: return (sljit_sw)PRIV(utf8_table4);
+#endif
+  case symbol_ucd_stage1: return (sljit_sw)PRIV(ucd_stage1);
+  case symbol_ucd_stage2: return (sljit_sw)PRIV(ucd_stage2);
+  case symbol_ucd_records: return (sljit_sw)PRIV(ucd_records);
+  case symbol_ucp_gbtable: return (sljit_sw)PRIV(ucp_gbtable);
+  case symbol_do_utf_caselesscmp: return SLJIT_FUNC_OFFSET(do_utf_caselesscmp);
+#endif
+  case symbol_do_search_mark: return SLJIT_FUNC_OFFSET(do_search_mark);
+  case symbol_do_search_literal: return SLJIT_FUNC_OFFSET(do_search_literal);
+  case symbol_do_callout: return SLJIT_FUNC_OFFSET(do_callout);
+  case symbol_stack_resize: return SLJIT_FUNC_OFFSET(sljit_stack_resize);
+  default: return 0;
+  }
+}
+
+/* Find the read-only data block that contains an address. The blocks are
+numbered from the head of the chain.
+
+Arguments:
+  head        the head of the chain
+  address     the address
+  offset      where to put the offset of the address in the block
+
+Returns:      the block number, or -1 if no block contains the address
+*/
+
+static int find_rodata_block(void *head, sljit_uw address, sljit_uw *offset)
+{
+int i = 0;
+
+while (head != NULL)
+  {
+  sljit_uw *block = (sljit_uw *)head;
+  sljit_uw data = (sljit_uw)(block + 2);
+
+  if (address >= data && address < data + block[1])
+    {
+    *offset = address - data;
+    return i;
+    }
+  head = *(void **)head;
+  i++;
+  }
+return -1;
+}
+
+/* Turn the addresses that a relocatable compile recorded into relocations,
+once the code has been generated. Each address is made relative to the part of
+the pattern, the tables, the read-only data, or the library object that it is
+in. The label addresses in the read-only data are relocations too.
+
+Arguments:
+  common      the compiler data
+  code        the generated code
+  offset      the executable offset of the code
+
+Returns:      0 or an error code
+*/
+
+static int finish_relocs(compiler_common *common, sljit_u8 *code, sljit_sw offset)
+{
+struct sljit_compiler *compiler = common->compiler;
+reloc_state *relocs = common->relocs;
+pcre2_real_code *re = common->re;
+sljit_uw pattern = (sljit_uw)re;
+sljit_uw tables = (sljit_uw)re->tables;
+sljit_uw code_start = (sljit_uw)code - offset;
+sljit_uw count = relocs->pending_count;
+label_addr_list *label_addr;
+jit_reloc *reloc;
+sljit_uw i;
+int block;
+
+for (label_addr = common->label_addrs; label_addr != NULL; label_addr = label_addr->next)
+  count++;
+
+relocs->relocs = SLJIT_MALLOC((count == 0 ? 1 : count) * sizeof(jit_reloc), compiler->allocator_data);
+if (relocs->relocs == NULL)
+  return PCRE2_ERROR_NOMEMORY;
+relocs->reloc_count = count;
+reloc = relocs->relocs;
+
+for (i = 0; i < relocs->pending_count; i++, reloc++)
+  {
+  pending_reloc *pending = relocs->pending + i;
+  sljit_uw address = (sljit_uw)pending->address;
+  sljit_uw site_offset;
+
+  reloc->site = pending->type;
+  reloc->site_block = 0;
+  reloc->index = 0;
+  reloc->site_offset = ((pending->type == site_const)?
+    sljit_get_const_addr((struct sljit_const *)pending->site) :
+    sljit_get_jump_addr((struct sljit_jump *)pending->site)) - code_start;
+
+  if (pending->symbol != symbol_none)
+    {
+    reloc->target = target_symbol;
+    reloc->index = pending->symbol;
+    reloc->addend = (sljit_sw)(address - (sljit_uw)symbol_address(pending->symbol));
+    }
+  else if (address >= pattern && address < pattern + re->blocksize)
+    {
+    reloc->target = target_pattern;
+    reloc->addend = (sljit_sw)(address - pattern);
+    }
+  else if (address >= tables && address < tables + tables_length)
+    {
+    reloc->target = target_tables;
+    reloc->addend = (sljit_sw)(address - tables);
+    }
+  else
+    {
+    block = find_rodata_block(common->read_only_data_head, address, &site_offset);
+    if (block < 0)
+      return PCRE2_ERROR_INTERNAL;
+    reloc->target = target_rodata;
+    reloc->index = (sljit_u32)block;
+    reloc->addend = (sljit_sw)site_offset;
+    }
+  }
+
+for (label_addr = common->label_addrs; label_addr != NULL; label_addr = label_addr->next, reloc++)
+  {
+  block = find_rodata_block(common->read_only_data_head,
+    (sljit_uw)label_addr->update_addr, &reloc->site_offset);
+  if (block < 0)
+    return PCRE2_ERROR_INTERNAL;
+  reloc->site = site_rodata;
+  reloc->site_block = (sljit_u32)block;
+  reloc->target = target_code;
+  reloc->index = 0;
+  reloc->addend = (sljit_sw)(sljit_get_label_addr(label_addr->label) - (sljit_uw)code);
+  }
+
+return 0;
+}
+
+/* Compile one mode of a pattern. When relocs is not NULL, the compile is
+relocatable, and the code and its relocations are returned in relocs instead of
+being attached to the pattern. The exec_allocator_data value is passed to the
+executable memory allocator: SLJIT_EXEC_HOT for the code of a pattern that is
+known to be used often, otherwise NULL. */
+
+static int jit_compile(pcre2_code *code, sljit_u32 mode,
+  void *exec_allocator_data, reloc_state *relocs)
 {
 pcre2_real_code *re = (pcre2_real_code *)code;
 struct sljit_compiler *compiler;
@@ -11746,6 +12746,7 @@ compiler_common *common = &common_data;
 const sljit_u8 *tables = re->tables;
 void *allocator_data = &re->memctl;
 int private_data_size;
+int result = 0;
 PCRE2_SPTR ccend;
 executable_functions *functions;
 void *executable_func;
@@ -11761,6 +12762,7 @@ struct sljit_label *quit_label;
 struct sljit_jump *jump;
 struct sljit_jump *minlength_check_failed = NULL;
 struct sljit_jump *reqbyte_notfound = NULL;
+struct sljit_jump *literal_notfound = NULL;
 struct sljit_jump *empty_match = NULL;
 struct sljit_jump *end_anchor_failed = NULL;
 
@@ -11769,6 +12771,7 @@ SLJIT_ASSERT(tables);
 memset(&rootbacktrack, 0, sizeof(backtrack_common));
 memset(common, 0, sizeof(compiler_common));
 common->re = re;
+common->relocs = relocs;
 common->name_table = (PCRE2_SPTR)((uint8_t *)re + sizeof(pcre2_real_code));
 rootbacktrack.cc = common->name_table + re->name_count * re->name_entry_size;
 
@@ -11868,6 +12871,11 @@ if (mode == PCRE2_JIT_COMPLETE && (re->flags & PCRE2_LASTSET) != 0 && (re->overa
   common->req_char_ptr = common->ovector_start;
   common->ovector_start += sizeof(sljit_sw);
   }
+if (mode == PCRE2_JIT_COMPLETE && re->req_literal_length != 0 && (re->overall_options & PCRE2_NO_START_OPTIMIZE) == 0)
+  {
+  common->req_literal_ptr = common->ovector_start;
+  common->ovector_start += sizeof(sljit_sw);
+  }
 if (mode != PCRE2_JIT_COMPLETE)
   {
   common->start_used_ptr = common->ovector_start;
@@ -11952,15 +12960,18 @@ if (!compiler)
   SLJIT_FREE(common->private_data_ptrs, allocator_data);
   return PCRE2_ERROR_NOMEMORY;
   }
+sljit_set_exec_allocator_data(compiler, exec_allocator_data);
 common->compiler = compiler;
 
 /* Main pcre_jit_exec entry. */
-sljit_emit_enter(compiler, 0, 1, 5, 5, 0, 0, private_data_size);
+sljit_emit_enter(compiler, 0, 1, (relocs != NULL)? 6 : 5, 5, 0, 0, private_data_size);
 
 /* Register init. */
 reset_ovector(common, (re->top_bracket + 1) * 2);
 if (common->req_char_ptr != 0)
   OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), common->req_char_ptr, SLJIT_R0, 0);
+if (common->req_literal_ptr != 0)
+  OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), common->req_literal_ptr, SLJIT_IMM, 0);
 
 OP1(SLJIT_MOV, ARGUMENTS, 0, SLJIT_S0, 0);
 OP1(SLJIT_MOV, TMP1, 0, SLJIT_S0, 0);
@@ -12012,6 +13023,8 @@ if (mode == PCRE2_JIT_COMPLETE && re->minlength > 0 && (re->overall_options & PC
   }
 if (common->req_char_ptr != 0)
   reqbyte_notfound = search_requested_char(common, (PCRE2_UCHAR)(re->last_codeunit), (re->flags & PCRE2_LASTCASELESS) != 0, (re->flags & PCRE2_FIRSTSET) != 0);
+if (common->req_literal_ptr != 0)
+  literal_notfound = search_requested_literal(common);
 
 /* Store the current STR_PTR in OVECTOR(0). */
 OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), OVECTOR(0), STR_PTR, 0);
@@ -12146,6 +13159,8 @@ if ((re->overall_options & PCRE2_ANCHORED) == 0)
 /* No more remaining characters. */
 if (reqbyte_notfound != NULL)
   JUMPHERE(reqbyte_notfound);
+if (literal_notfound != NULL)
+  JUMPHERE(literal_notfound);
 
 if (mode == PCRE2_JIT_PARTIAL_SOFT)
   CMPTO(SLJIT_NOT_EQUAL, SLJIT_MEM1(SLJIT_SP), common->hit_start, SLJIT_IMM, -1, common->partialmatchlabel);
@@ -12204,7 +13219,7 @@ OP1(SLJIT_MOV, TMP1, 0, SLJIT_MEM1(TMP1), SLJIT_OFFSETOF(jit_arguments, stack));
 OP1(SLJIT_MOV, SLJIT_MEM1(TMP1), SLJIT_OFFSETOF(struct sljit_stack, top), STACK_TOP, 0);
 OP2(SLJIT_SUB, TMP2, 0, SLJIT_MEM1(TMP1), SLJIT_OFFSETOF(struct sljit_stack, limit), SLJIT_IMM, STACK_GROWTH_RATE);
 
-sljit_emit_ijump(compiler, SLJIT_CALL2, SLJIT_IMM, SLJIT_FUNC_OFFSET(sljit_stack_resize));
+call_function(common, SLJIT_CALL2, SLJIT_FUNC_OFFSET(sljit_stack_resize), symbol_stack_resize);
 jump = CMP(SLJIT_NOT_EQUAL, SLJIT_RETURN_REG, 0, SLJIT_IMM, 0);
 OP1(SLJIT_MOV, TMP1, 0, ARGUMENTS, 0);
 OP1(SLJIT_MOV, TMP1, 0, SLJIT_MEM1(TMP1), SLJIT_OFFSETOF(jit_arguments, stack));
@@ -12303,6 +13318,11 @@ while (label_addr != NULL)
   *label_addr->update_addr = sljit_get_label_addr(label_addr->label);
   label_addr = label_addr->next;
   }
+if (relocs != NULL && executable_func != NULL)
+  {
+  relocs->executable_offset = sljit_get_executable_offset(compiler);
+  result = finish_relocs(common, executable_func, relocs->executable_offset);
+  }
 sljit_free_compiler(compiler);
 if (executable_func == NULL)
   {
@@ -12310,6 +13330,20 @@ if (executable_func == NULL)
   return PCRE2_ERROR_NOMEMORY;
   }
 
+if (relocs != NULL)
+  {
+  if (result != 0)
+    {
+    sljit_free_code(executable_func);
+    PRIV(jit_free_rodata)(common->read_only_data_head, allocator_data);
+    return result;
+    }
+  relocs->code = executable_func;
+  relocs->code_size = executable_size;
+  relocs->read_only_data_head = common->read_only_data_head;
+  return 0;
+  }
+
 /* Reuse the function descriptor if possible. */
 if (re->executable_jit != NULL)
   functions = (executable_functions *)re->executable_jit;
@@ -12337,81 +13371,1131 @@ else
   mode = (mode == PCRE2_JIT_PARTIAL_SOFT) ? 1 : 2;
 
 SLJIT_ASSERT(mode < JIT_NUMBER_OF_COMPILE_MODES);
-functions->executable_funcs[mode] = executable_func;
 functions->read_only_data_heads[mode] = common->read_only_data_head;
 functions->executable_sizes[mode] = executable_size;
+JIT_PUBLISH(functions->executable_funcs[mode], executable_func);
 return 0;
 }
 
+/* Build the bit-parallel automaton that pcre2_dfa_match() can use for a small
+pattern, and compile its scanning loop, which does the same as
+PRIV(glushkov_scan)(). The state set is a 64-bit word, so this is done only on
+64-bit architectures. Nothing is done for a pattern that is not suitable. */
+
+static int jit_compile_glushkov(pcre2_code *code, void *exec_allocator_data)
+{
+pcre2_real_code *re = (pcre2_real_code *)code;
+void *allocator_data = &re->memctl;
+#if defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE
+executable_functions *functions;
+glushkov_machine *machine;
+struct sljit_compiler *compiler;
+struct sljit_label *loop;
+struct sljit_jump *at_end;
+struct sljit_jump *no_state;
+struct sljit_jump *may_end;
+#if PCRE2_CODE_UNIT_WIDTH != 8
+struct sljit_jump *jump;
 #endif
+void *scan_func;
+sljit_u32 i;
 
-/*************************************************
-*        JIT compile a Regular Expression        *
-*************************************************/
+SLJIT_COMPILE_ASSERT(sizeof(glushkov_record) == 16, glushkov_record_size_changed);
 
-/* This function used JIT to convert a previously-compiled pattern into machine
-code.
+machine = SLJIT_MALLOC(sizeof(glushkov_machine), allocator_data);
+if (machine == NULL)
+  return PCRE2_ERROR_NOMEMORY;
+if (!PRIV(glushkov_build)(re, machine))
+  {
+  SLJIT_FREE(machine, allocator_data);
+  return 0;
+  }
 
-Arguments:
-  code          a compiled pattern
-  options       JIT option bits
+compiler = sljit_create_compiler(allocator_data);
+if (compiler == NULL)
+  {
+  SLJIT_FREE(machine, allocator_data);
+  return PCRE2_ERROR_NOMEMORY;
+  }
+sljit_set_exec_allocator_data(compiler, exec_allocator_data);
 
-Returns:        0: success or (*NOJIT) was used
-               <0: an error code
-*/
+/* S0 is the scan block, S1 the current position, S2 the end of the subject,
+S3 the state set, and S4 the records. R3 holds the follow tables, R0 the
+current record, and R1 the next state set. */
 
-#define PUBLIC_JIT_COMPILE_OPTIONS \
-  (PCRE2_JIT_COMPLETE|PCRE2_JIT_PARTIAL_SOFT|PCRE2_JIT_PARTIAL_HARD)
+sljit_emit_enter(compiler, 0, 1, 4, 5, 0, 0, 0);
+OP1(SLJIT_MOV, SLJIT_S1, 0, SLJIT_MEM1(SLJIT_S0), SLJIT_OFFSETOF(glushkov_scan, ptr));
+OP1(SLJIT_MOV, SLJIT_S2, 0, SLJIT_MEM1(SLJIT_S0), SLJIT_OFFSETOF(glushkov_scan, end));
+OP1(SLJIT_MOV, SLJIT_S3, 0, SLJIT_MEM1(SLJIT_S0), SLJIT_OFFSETOF(glushkov_scan, state));
+OP1(SLJIT_MOV, SLJIT_S4, 0, SLJIT_IMM, (sljit_sw)machine->records);
+OP1(SLJIT_MOV, SLJIT_R3, 0, SLJIT_IMM, (sljit_sw)machine->follow);
 
-PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
-pcre2_jit_compile(pcre2_code *code, uint32_t options)
-{
-#ifndef SUPPORT_JIT
+loop = LABEL();
+OP2(SLJIT_OR, SLJIT_S3, 0, SLJIT_S3, 0, SLJIT_MEM1(SLJIT_S0), SLJIT_OFFSETOF(glushkov_scan, inject));
+at_end = CMP(SLJIT_GREATER_EQUAL, SLJIT_S1, 0, SLJIT_S2, 0);
+no_state = CMP(SLJIT_EQUAL, SLJIT_S3, 0, SLJIT_IMM, 0);
+OP1(MOV_UCHAR, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_S1), 0);
+#if PCRE2_CODE_UNIT_WIDTH != 8
+jump = CMP(SLJIT_LESS_EQUAL, SLJIT_R0, 0, SLJIT_IMM, 255);
+OP1(SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, 256);
+JUMPHERE(jump);
+#endif
+OP2(SLJIT_SHL, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_IMM, 4);
+OP2(SLJIT_ADD, SLJIT_R0, 0, SLJIT_R0, 0, SLJIT_S4, 0);
+OP2(SLJIT_AND | SLJIT_SET_Z, SLJIT_UNUSED, 0, SLJIT_S3, 0, SLJIT_MEM1(SLJIT_R0), SLJIT_OFFSETOF(glushkov_record, accept));
+may_end = JUMP(SLJIT_NOT_ZERO);
 
-(void)code;
-(void)options;
-return PCRE2_ERROR_JIT_BADOPTION;
+/* The follow tables are indexed by each byte of the state set. */
 
-#else  /* SUPPORT_JIT */
+for (i = 0; i < machine->follow_tables; i++)
+  {
+  if (i == 0)
+    OP2(SLJIT_AND, SLJIT_R2, 0, SLJIT_S3, 0, SLJIT_IMM, 0xff);
+  else
+    {
+    OP2(SLJIT_LSHR, SLJIT_R2, 0, SLJIT_S3, 0, SLJIT_IMM, 8 * i);
+    OP2(SLJIT_AND, SLJIT_R2, 0, SLJIT_R2, 0, SLJIT_IMM, 0xff);
+    OP2(SLJIT_ADD, SLJIT_R2, 0, SLJIT_R2, 0, SLJIT_IMM, 256 * i);
+    }
+  if (i == 0)
+    OP1(SLJIT_MOV, SLJIT_R1, 0, SLJIT_MEM2(SLJIT_R3, SLJIT_R2), 3);
+  else
+    OP2(SLJIT_OR, SLJIT_R1, 0, SLJIT_R1, 0, SLJIT_MEM2(SLJIT_R3, SLJIT_R2), 3);
+  }
 
-pcre2_real_code *re = (pcre2_real_code *)code;
-executable_functions *functions;
-int result;
+OP2(SLJIT_AND, SLJIT_S3, 0, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_R0), SLJIT_OFFSETOF(glushkov_record, chars));
+OP2(SLJIT_ADD, SLJIT_S1, 0, SLJIT_S1, 0, SLJIT_IMM, IN_UCHARS(1));
+JUMPTO(SLJIT_JUMP, loop);
 
-if (code == NULL)
-  return PCRE2_ERROR_NULL;
+JUMPHERE(at_end);
+JUMPHERE(no_state);
+JUMPHERE(may_end);
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), SLJIT_OFFSETOF(glushkov_scan, ptr), SLJIT_S1, 0);
+OP1(SLJIT_MOV, SLJIT_MEM1(SLJIT_S0), SLJIT_OFFSETOF(glushkov_scan, state), SLJIT_S3, 0);
+sljit_emit_return(compiler, SLJIT_UNUSED, 0, 0);
 
-if ((options & ~PUBLIC_JIT_COMPILE_OPTIONS) != 0)
-  return PCRE2_ERROR_JIT_BADOPTION;
+scan_func = sljit_generate_code(compiler);
+machine->jit_scan_size = sljit_get_generated_code_size(compiler);
+sljit_free_compiler(compiler);
+if (scan_func == NULL)
+  {
+  SLJIT_FREE(machine, allocator_data);
+  return PCRE2_ERROR_NOMEMORY;
+  }
+machine->jit_scan = scan_func;
+
+if (re->executable_jit != NULL)
+  functions = (executable_functions *)re->executable_jit;
+else
+  {
+  functions = SLJIT_MALLOC(sizeof(executable_functions), allocator_data);
+  if (functions == NULL)
+    {
+    sljit_free_code(scan_func);
+    SLJIT_FREE(machine, allocator_data);
+    return PCRE2_ERROR_NOMEMORY;
+    }
+  memset(functions, 0, sizeof(executable_functions));
+  functions->top_bracket = re->top_bracket + 1;
+  functions->limit_match = re->limit_match;
+  re->executable_jit = functions;
+  }
 
-if ((re->flags & PCRE2_NOJIT) != 0) return 0;
+JIT_PUBLISH(functions->glushkov, machine);
+return 0;
 
-functions = (executable_functions *)re->executable_jit;
+#else  /* Not a 64-bit architecture */
+SLJIT_UNUSED_ARG(re);
+SLJIT_UNUSED_ARG(allocator_data);
+SLJIT_UNUSED_ARG(exec_allocator_data);
+return 0;
+#endif
+}
+
+/* Compile the modes in the options that the pattern does not already have.
+pcre2_jit_compile() passes NULL as exec_allocator_data; a lazy compile passes
+SLJIT_EXEC_HOT, because it happens only for a pattern that is used often, and
+pcre2_jit_code_cache_compile() passes the shared region of the cache. */
+
+static int jit_compile_modes(pcre2_code *code, uint32_t options,
+  void *exec_allocator_data)
+{
+pcre2_real_code *re = (pcre2_real_code *)code;
+executable_functions *functions = (executable_functions *)re->executable_jit;
+int result;
 
 if ((options & PCRE2_JIT_COMPLETE) != 0 && (functions == NULL
     || functions->executable_funcs[0] == NULL)) {
-  result = jit_compile(code, PCRE2_JIT_COMPLETE);
+  result = jit_compile(code, PCRE2_JIT_COMPLETE, exec_allocator_data, NULL);
   if (result != 0)
     return result;
   }
 
 if ((options & PCRE2_JIT_PARTIAL_SOFT) != 0 && (functions == NULL
     || functions->executable_funcs[1] == NULL)) {
-  result = jit_compile(code, PCRE2_JIT_PARTIAL_SOFT);
+  result = jit_compile(code, PCRE2_JIT_PARTIAL_SOFT, exec_allocator_data, NULL);
   if (result != 0)
     return result;
   }
 
 if ((options & PCRE2_JIT_PARTIAL_HARD) != 0 && (functions == NULL
     || functions->executable_funcs[2] == NULL)) {
-  result = jit_compile(code, PCRE2_JIT_PARTIAL_HARD);
+  result = jit_compile(code, PCRE2_JIT_PARTIAL_HARD, exec_allocator_data, NULL);
+  if (result != 0)
+    return result;
+  }
+
+if ((options & PCRE2_JIT_DFA) != 0 && (functions == NULL
+    || functions->glushkov == NULL)) {
+  result = jit_compile_glushkov(code, exec_allocator_data);
   if (result != 0)
     return result;
   }
 
 return 0;
+}
 
-#endif  /* SUPPORT_JIT */
+/* A shared code cache needs the arena allocator, which can put code into a
+shared executable region. */
+
+#if defined SLJIT_ARENA_EXECUTABLE_ALLOCATOR && SLJIT_ARENA_EXECUTABLE_ALLOCATOR
+#define SUPPORT_JIT_CODE_CACHE
+#endif
+
+/* Saved JIT code is supported only where every absolute address that sljit
+itself generates is made relocatable by the rewritable jumps and constants that
+a relocatable compile uses. At present this is the case for x86-64. */
+
+#if defined SLJIT_CONFIG_X86_64 && SLJIT_CONFIG_X86_64
+#define SUPPORT_JIT_SAVE
+#endif
+
+#ifdef SUPPORT_JIT_SAVE
+
+/* Saved JIT code starts with a header that records what it depends on. The
+code can be loaded only by the same library version and configuration, on the
+same kind of processor, with at least the same features, and for a pattern
+whose compiled form and tables have the same hash. */
+
+#define JIT_SAVED_MAGIC 0x5032534au
+
+#define JIT_SAVED_VERSION \
+  ((PCRE2_MAJOR) | ((PCRE2_MINOR) << 16))
+
+#define JIT_SAVED_CONFIG \
+  (sizeof(PCRE2_UCHAR) | ((sizeof(void*)) << 8) | ((sizeof(PCRE2_SIZE)) << 16) | \
+  (LINK_SIZE << 24))
+
+#define JIT_SAVED_ROUND(n) \
+  (((n) + sizeof(sljit_uw) - 1) & ~(sljit_uw)(sizeof(sljit_uw) - 1))
+
+typedef struct jit_saved_header {
+  uint64_t pattern_hash;  /* Hash of the compiled pattern and tables */
+  uint32_t magic;
+  uint32_t version;
+  uint32_t config;
+  uint32_t features;      /* Processor features that the code uses */
+  uint32_t modes;         /* The PCRE2_JIT_xxx options that were saved */
+  uint32_t reserved;
+  char platform[64];      /* The sljit platform name */
+} jit_saved_header;
+
+/* Each saved mode is followed by its code, its read-only data blocks, each
+preceded by its size, and its relocations. */
+
+typedef struct jit_saved_mode {
+  sljit_uw code_size;
+  sljit_uw rodata_count;
+  sljit_uw reloc_count;
+} jit_saved_mode;
+
+/* The processor features that the code generator may check. */
+
+static const sljit_s32 jit_features[] = {
+  SLJIT_HAS_FPU, SLJIT_HAS_CLZ, SLJIT_HAS_CMOV, SLJIT_HAS_SSE2, SLJIT_HAS_AVX2 };
+
+static uint32_t get_jit_features(void)
+{
+uint32_t features = 0;
+uint32_t i;
+
+for (i = 0; i < sizeof(jit_features) / sizeof(jit_features[0]); i++)
+  if (sljit_has_cpu_feature(jit_features[i])) features |= 1u << i;
+return features;
+}
+
+/* FNV-1a hash of a sequence of bytes. */
+
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t length)
+{
+const uint8_t *p = (const uint8_t *)data;
+
+while (length-- > 0)
+  {
+  hash ^= *p++;
+  hash *= 0x100000001b3ull;
+  }
+return hash;
+}
+
+/* Hash everything in a compiled pattern that the JIT compiler uses, so that
+saved code is not loaded for a different pattern. The pointers, and the flag
+that pcre2_serialize_decode() sets, are left out, so the hash is the same for a
+pattern that was compiled again from its source and for a deserialized one. */
+
+static uint64_t hash_pattern(const pcre2_real_code *re)
+{
+uint64_t hash = 0xcbf29ce484222325ull;
+uint32_t flags = re->flags & ~PCRE2_DEREF_TABLES;
+
+hash = hash_bytes(hash, re->start_bitmap, sizeof(re->start_bitmap));
+hash = hash_bytes(hash, &re->compile_options, sizeof(uint32_t) * 2);
+hash = hash_bytes(hash, &flags, sizeof(flags));
+hash = hash_bytes(hash, &re->limit_heap,
+  (const uint8_t *)(&re->req_literal_length + 1) - (const uint8_t *)&re->limit_heap);
+hash = hash_bytes(hash, re->req_literal, CU2BYTES(re->req_literal_length));
+hash = hash_bytes(hash, (const uint8_t *)re + sizeof(pcre2_real_code),
+  re->blocksize - sizeof(pcre2_real_code));
+return hash_bytes(hash, re->tables, tables_length);
+}
+
+/* Load one saved mode of JIT code: copy the code into executable memory,
+rebuild its read-only data, and apply the relocations.
+
+Arguments:
+  re          the compiled pattern
+  pp          points to the saved mode; updated to point after it
+  end         the end of the saved data
+  codeptr     where to return the executable code
+  sizeptr     where to return the size of the code
+  rodataptr   where to return the read-only data chain
+
+Returns:      0 or an error code
+*/
+
+static int load_jit_mode(pcre2_real_code *re, const uint8_t **pp,
+  const uint8_t *end, void **codeptr, sljit_uw *sizeptr, void **rodataptr)
+{
+void *allocator_data = &re->memctl;
+const uint8_t *p = *pp;
+jit_saved_mode mode;
+const jit_reloc *relocs;
+sljit_u8 *code;
+sljit_sw executable_offset;
+sljit_uw *block;
+void *head = NULL;
+void **link = &head;
+sljit_uw i;
+int rc = PCRE2_ERROR_BADSERIALIZEDDATA;
+
+if ((sljit_uw)(end - p) < sizeof(jit_saved_mode)) return rc;
+memcpy(&mode, p, sizeof(jit_saved_mode));
+p += sizeof(jit_saved_mode);
+if (mode.code_size == 0 || (sljit_uw)(end - p) < JIT_SAVED_ROUND(mode.code_size))
+  return rc;
+
+code = (sljit_u8 *)SLJIT_MALLOC_EXEC(mode.code_size, NULL);
+if (code == NULL) return PCRE2_ERROR_NOMEMORY;
+executable_offset = SLJIT_EXEC_OFFSET(code);
+memcpy(code, p, mode.code_size);
+p += JIT_SAVED_ROUND(mode.code_size);
+
+/* Rebuild the read-only data blocks in the same order. */
+
+for (i = 0; i < mode.rodata_count; i++)
+  {
+  sljit_uw size;
+
+  if ((sljit_uw)(end - p) < sizeof(sljit_uw)) goto FAILED;
+  memcpy(&size, p, sizeof(sljit_uw));
+  p += sizeof(sljit_uw);
+  if ((sljit_uw)(end - p) < JIT_SAVED_ROUND(size)) goto FAILED;
+
+  block = (sljit_uw *)SLJIT_MALLOC(size + 2 * sizeof(sljit_uw), allocator_data);
+  if (block == NULL)
+    {
+    rc = PCRE2_ERROR_NOMEMORY;
+    goto FAILED;
+    }
+  *(void **)block = NULL;
+  block[1] = size;
+  memcpy(block + 2, p, size);
+  p += JIT_SAVED_ROUND(size);
+  *link = block;
+  link = (void **)block;
+  }
+
+if ((sljit_uw)(end - p) / sizeof(jit_reloc) < mode.reloc_count) goto FAILED;
+relocs = (const jit_reloc *)p;
+p += mode.reloc_count * sizeof(jit_reloc);
+
+/* Work out each address from its target, and put it at its site. */
+
+for (i = 0; i < mode.reloc_count; i++)
+  {
+  jit_reloc reloc;
+  sljit_uw base;
+  sljit_uw limit;
+  sljit_uw address;
+
+  memcpy(&reloc, relocs + i, sizeof(jit_reloc));
+
+  switch(reloc.target)
+    {
+    case target_code:
+    base = (sljit_uw)code + executable_offset;
+    limit = mode.code_size;
+    break;
+
+    case target_rodata:
+    for (block = (sljit_uw *)head; block != NULL && reloc.index > 0; reloc.index--)
+      block = *(sljit_uw **)block;
+    if (block == NULL) goto FAILED;
+    base = (sljit_uw)(block + 2);
+    limit = block[1];
+    break;
+
+    case target_pattern:
+    base = (sljit_uw)re;
+    limit = re->blocksize;
+    break;
+
+    case target_tables:
+    base = (sljit_uw)re->tables;
+    limit = tables_length;
+    break;
+
+    case target_symbol:
+    base = (reloc.index < symbol_count)? (sljit_uw)symbol_address(reloc.index) : 0;
+    if (base == 0) goto FAILED;
+    limit = 0;
+    break;
+
+    default:
+    goto FAILED;
+    }
+
+  if (reloc.target != target_symbol && (sljit_uw)reloc.addend >= limit)
+    goto FAILED;
+  address = base + (sljit_uw)reloc.addend;
+
+  if (reloc.site == site_rodata)
+    {
+    for (block = (sljit_uw *)head; block != NULL && reloc.site_block > 0; reloc.site_block--)
+      block = *(sljit_uw **)block;
+    if (block == NULL || block[1] < sizeof(sljit_uw) ||
+        reloc.site_offset > block[1] - sizeof(sljit_uw))
+      goto FAILED;
+    memcpy((sljit_u8 *)(block + 2) + reloc.site_offset, &address, sizeof(sljit_uw));
+    }
+  else
+    {
+    if (mode.code_size < sizeof(sljit_sw) ||
+        reloc.site_offset > mode.code_size - sizeof(sljit_sw))
+      goto FAILED;
+    if (reloc.site == site_const)
+      sljit_set_const((sljit_uw)(code + reloc.site_offset), (sljit_sw)address,
+        executable_offset);
+    else if (reloc.site == site_jump)
+      sljit_set_jump_addr((sljit_uw)(code + reloc.site_offset), address,
+        executable_offset);
+    else goto FAILED;
+    }
+  }
+
+*pp = p;
+*codeptr = code + executable_offset;
+*sizeptr = mode.code_size;
+*rodataptr = head;
+return 0;
+
+FAILED:
+sljit_free_code(code + executable_offset);
+PRIV(jit_free_rodata)(head, allocator_data);
+return rc;
+}
+
+#endif  /* SUPPORT_JIT_SAVE */
+
+#endif  /* SUPPORT_JIT */
+
+/*************************************************
+*        JIT compile a Regular Expression        *
+*************************************************/
+
+/* This function used JIT to convert a previously-compiled pattern into machine
+code.
+
+Arguments:
+  code          a compiled pattern
+  options       JIT option bits
+
+Returns:        0: success or (*NOJIT) was used
+               <0: an error code
+*/
+
+#define PUBLIC_JIT_COMPILE_OPTIONS \
+  (PCRE2_JIT_COMPLETE|PCRE2_JIT_PARTIAL_SOFT|PCRE2_JIT_PARTIAL_HARD| \
+   PCRE2_JIT_DFA)
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_jit_compile(pcre2_code *code, uint32_t options)
+{
+#ifndef SUPPORT_JIT
+
+(void)code;
+(void)options;
+return PCRE2_ERROR_JIT_BADOPTION;
+
+#else  /* SUPPORT_JIT */
+
+pcre2_real_code *re = (pcre2_real_code *)code;
+
+if (code == NULL)
+  return PCRE2_ERROR_NULL;
+
+if ((options & ~PUBLIC_JIT_COMPILE_OPTIONS) != 0)
+  return PCRE2_ERROR_JIT_BADOPTION;
+
+/* A pattern compiled with PCRE2_EXTRA_LINEAR is always matched by its
+linear-time program, so it is treated like (*NOJIT). */
+
+if ((re->flags & (PCRE2_NOJIT|PCRE2_LINEAR)) != 0) return 0;
+
+return jit_compile_modes(code, options, NULL);
+
+#endif  /* SUPPORT_JIT */
+}
+
+
+/*************************************************
+*    JIT compile a pattern into a code cache     *
+*************************************************/
+
+/* This function is like pcre2_jit_compile(), but the machine code goes into a
+shared code cache, so that processes that are forked afterwards all use the
+same copy of it. Modes that the pattern already has code for are not compiled
+again.
+
+Arguments:
+  cache         the code cache
+  code          a compiled pattern
+  options       JIT option bits
+
+Returns:        0: success or (*NOJIT) was used
+               <0: an error code; PCRE2_ERROR_NOMEMORY if the cache is
+                   full or sealed
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_jit_code_cache_compile(pcre2_jit_code_cache *cache, pcre2_code *code,
+  uint32_t options)
+{
+#if !defined SUPPORT_JIT || !defined SUPPORT_JIT_CODE_CACHE
+
+(void)cache;
+(void)code;
+(void)options;
+return PCRE2_ERROR_JIT_BADOPTION;
+
+#else  /* SUPPORT_JIT && SUPPORT_JIT_CODE_CACHE */
+
+pcre2_real_code *re = (pcre2_real_code *)code;
+
+if (cache == NULL || code == NULL)
+  return PCRE2_ERROR_NULL;
+
+if ((options & ~PUBLIC_JIT_COMPILE_OPTIONS) != 0)
+  return PCRE2_ERROR_JIT_BADOPTION;
+
+if ((re->flags & (PCRE2_NOJIT|PCRE2_LINEAR)) != 0) return 0;
+
+return jit_compile_modes(code, options, cache->region);
+
+#endif  /* SUPPORT_JIT && SUPPORT_JIT_CODE_CACHE */
+}
+
+
+#ifdef SUPPORT_JIT
+
+/*************************************************
+*    Get the functions block before matching     *
+*************************************************/
+
+/* Lazy and background compiling need the functions block to exist before
+any match that may see the code, so that a match never has to create it.
+
+Arguments:
+  re            the compiled pattern
+
+Returns:        the functions block, or NULL if there is no memory
+*/
+
+static executable_functions *
+get_functions(pcre2_real_code *re)
+{
+executable_functions *functions = (executable_functions *)re->executable_jit;
+
+if (functions == NULL)
+  {
+  functions = SLJIT_MALLOC(sizeof(executable_functions), &re->memctl);
+  if (functions == NULL) return NULL;
+  memset(functions, 0, sizeof(executable_functions));
+  functions->top_bracket = re->top_bracket + 1;
+  functions->limit_match = re->limit_match;
+  JIT_PUBLISH(re->executable_jit, functions);
+  }
+return functions;
+}
+
+
+
+/*************************************************
+*     Take on modes for compiling while matching *
+*************************************************/
+
+/* A mode may be wanted by a lazy compile, started by a match in any thread,
+and by a background compile. Whichever takes it on first compiles it, so that
+no mode is compiled twice. A mode that is taken on is no longer waiting for a
+lazy compile.
+
+Arguments:
+  functions     the functions block
+  options       the wanted modes
+
+Returns:        the modes that the caller must compile
+*/
+
+static sljit_u32
+claim_modes(executable_functions *functions, sljit_u32 options)
+{
+sljit_grab_lock();
+options &= ~functions->claimed_options;
+functions->claimed_options |= options;
+JIT_PUBLISH_OPTIONS(functions->lazy_options,
+  JIT_FETCH_OPTIONS(functions->lazy_options) & ~options);
+sljit_release_lock();
+return options;
+}
+
+
+
+/*************************************************
+*     Wait for a background compile to finish    *
+*************************************************/
+
+/* This must not be called by more than one thread at once for the same
+pattern; nor may pcre2_jit_compile_async().
+
+Arguments:
+  functions     the functions block
+
+Returns:        nothing
+*/
+
+static void
+join_async(executable_functions *functions)
+{
+if (!functions->async_running) return;
+#if defined JIT_NO_THREADS
+#elif defined _WIN32
+WaitForSingleObject(functions->async_thread, INFINITE);
+CloseHandle(functions->async_thread);
+#else
+pthread_join(functions->async_thread, NULL);
+#endif
+functions->async_running = FALSE;
+}
+
+#endif  /* SUPPORT_JIT */
+
+
+
+/*************************************************
+*     Set up a pattern for lazy JIT compiling    *
+*************************************************/
+
+/* Instead of compiling now, this arranges for pcre2_match() and
+pcre2_dfa_match() to count the matches that are run with the pattern and the
+lengths of their subjects, and for the modes in the options to be compiled as
+if by pcre2_jit_compile() when either count reaches its limit. A zero limit is
+not used; if both are zero, the modes are compiled now. Until then, and if
+compiling fails, the pattern is interpreted.
+
+Arguments:
+  code          a compiled pattern
+  options       JIT option bits
+  match_count   compile after this many matches, or zero
+  byte_count    compile after this many subject code units, or zero
+
+Returns:        0: success or (*NOJIT) was used
+               <0: an error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_jit_compile_lazy(pcre2_code *code, uint32_t options,
+  uint32_t match_count, PCRE2_SIZE byte_count)
+{
+#ifndef SUPPORT_JIT
+
+(void)code;
+(void)options;
+(void)match_count;
+(void)byte_count;
+return PCRE2_ERROR_JIT_BADOPTION;
+
+#else  /* SUPPORT_JIT */
+
+pcre2_real_code *re = (pcre2_real_code *)code;
+#ifndef JIT_NO_ATOMICS
+executable_functions *functions;
+#endif
+
+if (code == NULL)
+  return PCRE2_ERROR_NULL;
+
+if ((options & ~PUBLIC_JIT_COMPILE_OPTIONS) != 0)
+  return PCRE2_ERROR_JIT_BADOPTION;
+
+if ((re->flags & (PCRE2_NOJIT|PCRE2_LINEAR)) != 0) return 0;
+
+/* Without atomic operations, a compile started by a match could not be seen
+safely by matches in other threads, so the pattern is compiled now. */
+
+#ifdef JIT_NO_ATOMICS
+(void)match_count;
+(void)byte_count;
+return pcre2_jit_compile(code, options);
+#else
+
+if (match_count == 0 && byte_count == 0)
+  return pcre2_jit_compile(code, options);
+
+functions = get_functions(re);
+if (functions == NULL) return PCRE2_ERROR_NOMEMORY;
+
+functions->lazy_match_limit = match_count;
+functions->lazy_byte_limit = byte_count;
+functions->lazy_matches = 0;
+functions->lazy_bytes = 0;
+functions->lazy_options |= options;
+return 0;
+#endif  /* JIT_NO_ATOMICS */
+
+#endif  /* SUPPORT_JIT */
+}
+
+
+/*************************************************
+*    Compile a pattern on a background thread    *
+*************************************************/
+
+#ifdef SUPPORT_JIT
+#ifndef JIT_NO_THREADS
+
+/* This is the body of the thread that pcre2_jit_compile_async() starts. */
+
+#ifdef _WIN32
+static DWORD WINAPI
+async_compile(LPVOID arg)
+#else
+static void *
+async_compile(void *arg)
+#endif
+{
+pcre2_real_code *re = (pcre2_real_code *)arg;
+executable_functions *functions = (executable_functions *)re->executable_jit;
+
+functions->async_result = pcre2_jit_compile((pcre2_code *)re,
+  functions->async_options);
+return 0;
+}
+
+#endif  /* JIT_NO_THREADS */
+#endif  /* SUPPORT_JIT */
+
+/* This starts a thread that compiles the modes in the options as
+pcre2_jit_compile() would, and returns at once. Meanwhile, the pattern can be
+matched by any number of threads; they use the interpreter until the code for
+their mode is ready, and then switch to it. If a thread cannot be started, the
+pattern is compiled before returning. A compile that this function started
+before is waited for first, as is one that is still running when the pattern
+is freed.
+
+Arguments:
+  code          a compiled pattern
+  options       JIT option bits
+
+Returns:        0: success or (*NOJIT) was used
+               <0: an error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_jit_compile_async(pcre2_code *code, uint32_t options)
+{
+#ifndef SUPPORT_JIT
+
+(void)code;
+(void)options;
+return PCRE2_ERROR_JIT_BADOPTION;
+
+#else  /* SUPPORT_JIT */
+
+pcre2_real_code *re = (pcre2_real_code *)code;
+executable_functions *functions;
+
+if (code == NULL)
+  return PCRE2_ERROR_NULL;
+
+if ((options & ~PUBLIC_JIT_COMPILE_OPTIONS) != 0)
+  return PCRE2_ERROR_JIT_BADOPTION;
+
+if ((re->flags & (PCRE2_NOJIT|PCRE2_LINEAR)) != 0) return 0;
+
+functions = get_functions(re);
+if (functions == NULL) return PCRE2_ERROR_NOMEMORY;
+
+join_async(functions);
+options = claim_modes(functions, options);
+functions->async_options = options;
+functions->async_result = 0;
+if (options == 0) return 0;
+
+#if defined JIT_NO_THREADS
+functions->async_result = pcre2_jit_compile(code, options);
+#elif defined _WIN32
+functions->async_thread = CreateThread(NULL, 0, async_compile, re, 0, NULL);
+if (functions->async_thread != NULL)
+  functions->async_running = TRUE;
+else
+  functions->async_result = pcre2_jit_compile(code, options);
+#else
+if (pthread_create(&functions->async_thread, NULL, async_compile, re) == 0)
+  functions->async_running = TRUE;
+else
+  functions->async_result = pcre2_jit_compile(code, options);
+#endif
+
+return 0;
+
+#endif  /* SUPPORT_JIT */
+}
+
+
+
+/*************************************************
+*    Wait for a background compile to finish     *
+*************************************************/
+
+/* This waits for the thread that pcre2_jit_compile_async() started for a
+pattern, if it has not already finished, and returns what its compile returned.
+It is not needed before matching, only to find out whether the compile
+succeeded, or to make sure that it has finished.
+
+Arguments:
+  code          a compiled pattern
+
+Returns:        the result of the compile that pcre2_jit_compile_async()
+                  started, or 0 if there was none
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_jit_compile_wait(pcre2_code *code)
+{
+#ifndef SUPPORT_JIT
+
+(void)code;
+return PCRE2_ERROR_JIT_BADOPTION;
+
+#else  /* SUPPORT_JIT */
+
+pcre2_real_code *re = (pcre2_real_code *)code;
+executable_functions *functions;
+
+if (code == NULL)
+  return PCRE2_ERROR_NULL;
+
+functions = (executable_functions *)re->executable_jit;
+if (functions == NULL) return 0;
+join_async(functions);
+return functions->async_result;
+
+#endif  /* SUPPORT_JIT */
+}
+
+
+
+/*************************************************
+*           Save the JIT code of a pattern       *
+*************************************************/
+
+/* The code of each JIT mode that the pattern has is compiled again in
+relocatable form, and saved with its read-only data and its relocations. The
+result is freed by pcre2_serialize_free().
+
+Arguments:
+  code              a compiled pattern
+  serialized_bytes  where to return the saved data
+  serialized_size   where to return the size of the saved data
+  gcontext          a general context, for memory allocation, or NULL
+
+Returns:            0 on success or a negative error code
+*/
+
+PCRE2_EXP_DEFN int32_t PCRE2_CALL_CONVENTION
+pcre2_jit_serialize_encode(const pcre2_code *code, uint8_t **serialized_bytes,
+  PCRE2_SIZE *serialized_size, pcre2_general_context *gcontext)
+{
+#if !defined SUPPORT_JIT || !defined SUPPORT_JIT_SAVE
+
+(void)code;
+(void)serialized_bytes;
+(void)serialized_size;
+(void)gcontext;
+return PCRE2_ERROR_JIT_BADOPTION;
+
+#else  /* SUPPORT_JIT && SUPPORT_JIT_SAVE */
+
+const pcre2_real_code *re = (const pcre2_real_code *)code;
+executable_functions *functions;
+reloc_state states[JIT_NUMBER_OF_COMPILE_MODES];
+jit_saved_header *header;
+uint8_t *bytes;
+uint8_t *p;
+PCRE2_SIZE total_size;
+const char *platform;
+size_t platform_length;
+void *head;
+int rc = 0;
+int i;
+
+const pcre2_memctl *memctl = (gcontext != NULL) ?
+  &gcontext->memctl : &PRIV(default_compile_context).memctl;
+
+if (code == NULL || serialized_bytes == NULL || serialized_size == NULL)
+  return PCRE2_ERROR_NULL;
+if (re->magic_number != MAGIC_NUMBER) return PCRE2_ERROR_BADMAGIC;
+
+memset(states, 0, sizeof(states));
+functions = (executable_functions *)re->executable_jit;
+total_size = sizeof(jit_saved_header);
+
+/* Compile each mode that the pattern has again, in relocatable form. */
+
+for (i = 0; i < JIT_NUMBER_OF_COMPILE_MODES; i++)
+  {
+  reloc_state *state = states + i;
+
+  if (functions == NULL || functions->executable_funcs[i] == NULL) continue;
+  rc = jit_compile((pcre2_code *)code, 1u << i, NULL, state);
+  if (rc != 0) goto EXIT;
+
+  total_size += sizeof(jit_saved_mode) + JIT_SAVED_ROUND(state->code_size) +
+    state->reloc_count * sizeof(jit_reloc);
+  for (head = state->read_only_data_head; head != NULL; head = *(void **)head)
+    total_size += sizeof(sljit_uw) + JIT_SAVED_ROUND(((sljit_uw *)head)[1]);
+  }
+
+bytes = memctl->malloc(total_size + sizeof(pcre2_memctl), memctl->memory_data);
+if (bytes == NULL)
+  {
+  rc = PCRE2_ERROR_NOMEMORY;
+  goto EXIT;
+  }
+
+/* The controller is stored as a hidden parameter. */
+
+memcpy(bytes, memctl, sizeof(pcre2_memctl));
+bytes += sizeof(pcre2_memctl);
+memset(bytes, 0, total_size);
+
+header = (jit_saved_header *)bytes;
+header->pattern_hash = hash_pattern(re);
+header->magic = JIT_SAVED_MAGIC;
+header->version = JIT_SAVED_VERSION;
+header->config = JIT_SAVED_CONFIG;
+header->features = get_jit_features();
+platform = sljit_get_platform_name();
+platform_length = strlen(platform);
+if (platform_length >= sizeof(header->platform))
+  platform_length = sizeof(header->platform) - 1;
+memcpy(header->platform, platform, platform_length);
+if (functions != NULL && functions->glushkov != NULL)
+  header->modes |= PCRE2_JIT_DFA;
+
+p = bytes + sizeof(jit_saved_header);
+for (i = 0; i < JIT_NUMBER_OF_COMPILE_MODES; i++)
+  {
+  reloc_state *state = states + i;
+  jit_saved_mode mode;
+
+  if (state->code == NULL) continue;
+  header->modes |= 1u << i;
+
+  mode.code_size = state->code_size;
+  mode.reloc_count = state->reloc_count;
+  mode.rodata_count = 0;
+  for (head = state->read_only_data_head; head != NULL; head = *(void **)head)
+    mode.rodata_count++;
+  memcpy(p, &mode, sizeof(jit_saved_mode));
+  p += sizeof(jit_saved_mode);
+
+  memcpy(p, (uint8_t *)state->code - state->executable_offset, state->code_size);
+  p += JIT_SAVED_ROUND(state->code_size);
+
+  for (head = state->read_only_data_head; head != NULL; head = *(void **)head)
+    {
+    sljit_uw *block = (sljit_uw *)head;
+    memcpy(p, block + 1, sizeof(sljit_uw));
+    p += sizeof(sljit_uw);
+    memcpy(p, block + 2, block[1]);
+    p += JIT_SAVED_ROUND(block[1]);
+    }
+
+  memcpy(p, state->relocs, state->reloc_count * sizeof(jit_reloc));
+  p += state->reloc_count * sizeof(jit_reloc);
+  }
+
+*serialized_bytes = bytes;
+*serialized_size = total_size;
+
+/* The relocatable code was needed only for saving. */
+
+EXIT:
+for (i = 0; i < JIT_NUMBER_OF_COMPILE_MODES; i++)
+  {
+  reloc_state *state = states + i;
+  void *allocator_data = (void *)&re->memctl;
+
+  if (state->code != NULL) sljit_free_code(state->code);
+  PRIV(jit_free_rodata)(state->read_only_data_head, allocator_data);
+  if (state->pending != NULL) SLJIT_FREE(state->pending, allocator_data);
+  if (state->relocs != NULL) SLJIT_FREE(state->relocs, allocator_data);
+  }
+return rc;
+
+#endif  /* SUPPORT_JIT && SUPPORT_JIT_SAVE */
+}
+
+
+
+/*************************************************
+*          Load saved JIT code for a pattern     *
+*************************************************/
+
+/* Saved code is loaded only if it was made by the same library version and
+configuration, for a processor of the same type that has all the features that
+the code may use, and for the same pattern. A mode that the pattern already has
+JIT code for is skipped. A pattern that pcre2_serialize_decode() has made, or
+that was compiled again from the same source, can load the code.
+
+Arguments:
+  code              a compiled pattern
+  bytes             the saved data
+  size              the size of the saved data
+
+Returns:            0 on success or a negative error code
+*/
+
+PCRE2_EXP_DEFN int32_t PCRE2_CALL_CONVENTION
+pcre2_jit_serialize_decode(pcre2_code *code, const uint8_t *bytes,
+  PCRE2_SIZE size)
+{
+#if !defined SUPPORT_JIT || !defined SUPPORT_JIT_SAVE
+
+(void)code;
+(void)bytes;
+(void)size;
+return PCRE2_ERROR_JIT_BADOPTION;
+
+#else  /* SUPPORT_JIT && SUPPORT_JIT_SAVE */
+
+pcre2_real_code *re = (pcre2_real_code *)code;
+void *allocator_data = &re->memctl;
+executable_functions *functions;
+jit_saved_header header;
+const uint8_t *p;
+const uint8_t *end;
+const char *platform;
+int rc;
+int i;
+
+if (code == NULL || bytes == NULL) return PCRE2_ERROR_NULL;
+if (re->magic_number != MAGIC_NUMBER) return PCRE2_ERROR_BADMAGIC;
+if (size < sizeof(jit_saved_header)) return PCRE2_ERROR_BADSERIALIZEDDATA;
+
+memcpy(&header, bytes, sizeof(jit_saved_header));
+if (header.magic != JIT_SAVED_MAGIC) return PCRE2_ERROR_BADMAGIC;
+
+platform = sljit_get_platform_name();
+if (header.version != JIT_SAVED_VERSION || header.config != JIT_SAVED_CONFIG ||
+    strncmp(header.platform, platform, sizeof(header.platform) - 1) != 0 ||
+    (header.features & ~get_jit_features()) != 0)
+  return PCRE2_ERROR_BADMODE;
+
+if (header.pattern_hash != hash_pattern(re))
+  return PCRE2_ERROR_BADSERIALIZEDDATA;
+
+p = bytes + sizeof(jit_saved_header);
+end = bytes + size;
+
+/* A pattern that is never JIT compiled ignores saved code. */
+
+if ((re->flags & (PCRE2_NOJIT|PCRE2_LINEAR)) != 0) return 0;
+
+for (i = 0; i < JIT_NUMBER_OF_COMPILE_MODES; i++)
+  {
+  void *executable_func;
+  sljit_uw executable_size;
+  void *read_only_data_head;
+
+  if ((header.modes & (1u << i)) == 0) continue;
+
+  rc = load_jit_mode(re, &p, end, &executable_func, &executable_size,
+    &read_only_data_head);
+  if (rc != 0) return rc;
+
+  functions = (executable_functions *)re->executable_jit;
+  if (functions == NULL)
+    {
+    functions = SLJIT_MALLOC(sizeof(executable_functions), allocator_data);
+    if (functions == NULL)
+      {
+      sljit_free_code(executable_func);
+      PRIV(jit_free_rodata)(read_only_data_head, allocator_data);
+      return PCRE2_ERROR_NOMEMORY;
+      }
+    memset(functions, 0, sizeof(executable_functions));
+    functions->top_bracket = re->top_bracket + 1;
+    functions->limit_match = re->limit_match;
+    re->executable_jit = functions;
+    }
+
+  if (functions->executable_funcs[i] != NULL)
+    {
+    sljit_free_code(executable_func);
+    PRIV(jit_free_rodata)(read_only_data_head, allocator_data);
+    continue;
+    }
+
+  functions->executable_funcs[i] = executable_func;
+  functions->read_only_data_heads[i] = read_only_data_head;
+  functions->executable_sizes[i] = executable_size;
+  }
+
+/* The scanning loop for pcre2_dfa_match() is small, so it is compiled again
+rather than saved. */
+
+if ((header.modes & PCRE2_JIT_DFA) != 0)
+  {
+  functions = (executable_functions *)re->executable_jit;
+  if (functions == NULL || functions->glushkov == NULL)
+    return jit_compile_glushkov(code, NULL);
+  }
+
+return 0;
+
+#endif  /* SUPPORT_JIT && SUPPORT_JIT_SAVE */
 }
 
 /* JIT compiler uses an all-in-one approach. This improves security,
@@ -57,6 +57,140 @@ arguments->stack = &local_stack;
 return executable_func(arguments);
 }
 
+
+/*************************************************
+*        Take a JIT stack from a stack pool      *
+*************************************************/
+
+/* An idle stack is used if there is one; otherwise a new stack is created.
+The lock is not held while a stack is being created.
+
+Argument:   points to the stack pool
+Returns:    the JIT stack, or NULL if memory could not be obtained
+*/
+
+static pcre2_jit_stack *
+jit_pool_get(pcre2_jit_stack_pool *pool)
+{
+pcre2_jit_stack *jit_stack = NULL;
+
+sljit_grab_lock();
+if (pool->idle_count > 0)
+  {
+  jit_stack = pool->idle[--pool->idle_count];
+  if (++pool->in_use > pool->peak_in_use) pool->peak_in_use = pool->in_use;
+  }
+sljit_release_lock();
+if (jit_stack != NULL) return jit_stack;
+
+jit_stack = pcre2_jit_stack_create(pool->startsize, pool->maxsize,
+  (pcre2_general_context *)pool);
+if (jit_stack == NULL) return NULL;
+
+/* The idle vector must be able to hold every stack that has been created, so
+that all of them can be returned. */
+
+sljit_grab_lock();
+if (pool->stacks >= pool->idle_size)
+  {
+  uint32_t newsize = (pool->idle_size == 0)? 4 : 2 * pool->idle_size;
+  pcre2_jit_stack **newidle = pool->memctl.malloc(
+    newsize * sizeof(pcre2_jit_stack *), pool->memctl.memory_data);
+  if (newidle == NULL)
+    {
+    sljit_release_lock();
+    pcre2_jit_stack_free(jit_stack);
+    return NULL;
+    }
+  if (pool->idle_count > 0)
+    memcpy(newidle, pool->idle, pool->idle_count * sizeof(pcre2_jit_stack *));
+  if (pool->idle != NULL)
+    pool->memctl.free(pool->idle, pool->memctl.memory_data);
+  pool->idle = newidle;
+  pool->idle_size = newsize;
+  }
+pool->stacks++;
+if (++pool->in_use > pool->peak_in_use) pool->peak_in_use = pool->in_use;
+sljit_release_lock();
+return jit_stack;
+}
+
+
+/*************************************************
+*       Return a JIT stack to a stack pool       *
+*************************************************/
+
+/* The size to which the stack has grown is noted for the statistics.
+
+Arguments:
+  pool        points to the stack pool
+  jit_stack   the stack to return, or NULL if none was obtained
+
+Returns:      nothing
+*/
+
+static void
+jit_pool_put(pcre2_jit_stack_pool *pool, pcre2_jit_stack *jit_stack)
+{
+struct sljit_stack *stack;
+PCRE2_SIZE size;
+
+if (jit_stack == NULL) return;
+stack = (struct sljit_stack *)(jit_stack->stack);
+size = (PCRE2_SIZE)(stack->base - stack->limit);
+
+sljit_grab_lock();
+pool->idle[pool->idle_count++] = jit_stack;
+pool->in_use--;
+if (size > pool->peak_size) pool->peak_size = size;
+sljit_release_lock();
+}
+
+
+/*************************************************
+*     Set up JIT arguments from a match context  *
+*************************************************/
+
+/* This function fills in the fields of a jit_arguments block that come from
+the match context, and finds the JIT stack to use.
+
+Arguments:
+  re              points to the compiled expression
+  mcontext        points to a match context, or is NULL
+  arguments       points to the jit_arguments block
+
+Returns:          the JIT stack, or NULL to use the machine stack; a stack
+                    that comes from a stack pool must be returned to it by
+                    jit_pool_put(), and NULL from a pool means that no
+                    stack could be obtained
+*/
+
+static pcre2_jit_stack *
+set_context_arguments(pcre2_real_code *re, pcre2_match_context *mcontext,
+  jit_arguments *arguments)
+{
+if (mcontext != NULL)
+  {
+  arguments->callout = mcontext->callout;
+  arguments->callout_data = mcontext->callout_data;
+  arguments->offset_limit = mcontext->offset_limit;
+  arguments->limit_match = (mcontext->match_limit < re->limit_match)?
+    mcontext->match_limit : re->limit_match;
+  if (mcontext->jit_stack_pool != NULL)
+    return jit_pool_get(mcontext->jit_stack_pool);
+  if (mcontext->jit_callback != NULL)
+    return mcontext->jit_callback(mcontext->jit_callback_data);
+  return (pcre2_jit_stack *)mcontext->jit_callback_data;
+  }
+
+arguments->callout = NULL;
+arguments->callout_data = NULL;
+arguments->offset_limit = PCRE2_UNSET;
+arguments->limit_match = (MATCH_LIMIT < re->limit_match)?
+  MATCH_LIMIT : re->limit_match;
+return NULL;
+}
+
 #endif
 
 
@@ -101,7 +235,8 @@ return PCRE2_ERROR_JIT_BADOPTION;
 #else  /* SUPPORT_JIT */
 
 pcre2_real_code *re = (pcre2_real_code *)code;
-executable_functions *functions = (executable_functions *)re->executable_jit;
+executable_functions *functions =
+  (executable_functions *)JIT_FETCH(re->executable_jit);
 pcre2_jit_stack *jit_stack;
 uint32_t oveccount = match_data->oveccount;
 uint32_t max_oveccount;
@@ -118,9 +253,46 @@ if ((options & PCRE2_PARTIAL_HARD) != 0)
 else if ((options & PCRE2_PARTIAL_SOFT) != 0)
   index = 1;
 
-if (functions->executable_funcs[index] == NULL)
+convert_executable_func.executable_func =
+  JIT_FETCH(functions->executable_funcs[index]);
+if (convert_executable_func.executable_func == NULL)
   return PCRE2_ERROR_JIT_BADOPTION;
 
+/* A large enough set of literal strings is found more quickly by its
+Aho-Corasick automaton than by the compiled code, which tries each string in
+turn at each starting point. The conditions are as in the interpreter. */
+
+if (re->litset != NULL && index == 0 &&
+    re->litset->literal_count >= LITSET_JIT_MIN_LITERALS &&
+    ((re->overall_options | options) &
+      (PCRE2_ANCHORED|PCRE2_ENDANCHORED)) == 0 &&
+    re->limit_match >= MATCH_LIMIT &&
+    (mcontext == NULL || (mcontext->match_limit >= MATCH_LIMIT &&
+      mcontext->offset_limit == PCRE2_UNSET)))
+  {
+  PCRE2_SPTR mstart, mend;
+  match_data->code = re;
+  match_data->subject = subject;
+  match_data->leftchar = 0;
+  match_data->rightchar = 0;
+  match_data->mark = NULL;
+  match_data->matchedby = PCRE2_MATCHEDBY_JIT;
+  if (!PRIV(litset_match)(re->litset, subject + start_offset,
+      subject + length, &mstart, &mend))
+    {
+    match_data->startchar = 0;
+    match_data->rc = PCRE2_ERROR_NOMATCH;
+    }
+  else
+    {
+    match_data->ovector[0] = mstart - subject;
+    match_data->ovector[1] = mend - subject;
+    match_data->startchar = mstart - subject;
+    match_data->rc = 1;
+    }
+  return match_data->rc;
+  }
+
 /* Sanity checks should be handled by pcre_exec. */
 arguments.str = subject + start_offset;
 arguments.begin = subject;
@@ -130,27 +302,13 @@ arguments.startchar_ptr = subject;
 arguments.mark_ptr = NULL;
 arguments.options = options;
 
-if (mcontext != NULL)
-  {
-  arguments.callout = mcontext->callout;
-  arguments.callout_data = mcontext->callout_data;
-  arguments.offset_limit = mcontext->offset_limit;
-  arguments.limit_match = (mcontext->match_limit < re->limit_match)?
-    mcontext->match_limit : re->limit_match;
-  if (mcontext->jit_callback != NULL)
-    jit_stack = mcontext->jit_callback(mcontext->jit_callback_data);
-  else
-    jit_stack = (pcre2_jit_stack *)mcontext->jit_callback_data;
-  }
-else
-  {
-  arguments.callout = NULL;
-  arguments.callout_data = NULL;
-  arguments.offset_limit = PCRE2_UNSET;
-  arguments.limit_match = (MATCH_LIMIT < re->limit_match)?
-    MATCH_LIMIT : re->limit_match;
-  jit_stack = NULL;
-  }
+jit_stack = set_context_arguments(re, mcontext, &arguments);
+
+/* The machine stack is not used instead of a pool stack, because it is much
+smaller than the application asked for. */
+
+if (jit_stack == NULL && mcontext != NULL && mcontext->jit_stack_pool != NULL)
+  return PCRE2_ERROR_NOMEMORY;
 
 /* JIT only need two offsets for each ovector entry. Hence
    the last 1/3 of the ovector will never be touched. */
@@ -160,8 +318,6 @@ if (oveccount > max_oveccount)
   oveccount = max_oveccount;
 arguments.oveccount = oveccount << 1;
 
-
-convert_executable_func.executable_func = functions->executable_funcs[index];
 if (jit_stack != NULL)
   {
   arguments.stack = (struct sljit_stack *)(jit_stack->stack);
@@ -170,6 +326,9 @@ if (jit_stack != NULL)
 else
   rc = jit_machine_stack_exec(&arguments, convert_executable_func.call_executable_func);
 
+if (mcontext != NULL && mcontext->jit_stack_pool != NULL)
+  jit_pool_put(mcontext->jit_stack_pool, jit_stack);
+
 if (rc > (int)oveccount)
   rc = 0;
 match_data->code = re;
@@ -186,4 +345,135 @@ return match_data->rc;
 #endif  /* SUPPORT_JIT */
 }
 
+
+
+/*************************************************
+*     Do a JIT pattern match on many subjects    *
+*************************************************/
+
+/* This function runs a JIT pattern match on each of a number of subjects,
+starting at the beginning of each one. The JIT arguments and the stack are set
+up only once. As for pcre2_jit_match(), no checks are done on the arguments.
+
+Arguments:
+  code            points to the compiled expression
+  subjects        points to a vector of subject pointers
+  lengths         points to a vector of subject lengths
+  count           number of subjects
+  options         option bits
+  match_data      points to a vector of match_data pointers
+  mcontext        points to a match context
+  results         points to a vector for the return codes
+
+Returns:         >= 0 => the number of subjects that matched; if a stack
+                           could not be obtained from a stack pool, each
+                           result is PCRE2_ERROR_NOMEMORY
+                  < 0 => PCRE2_ERROR_JIT_BADOPTION; nothing has been matched
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_jit_match_batch(const pcre2_code *code, const PCRE2_SPTR *subjects,
+  const PCRE2_SIZE *lengths, uint32_t count, uint32_t options,
+  pcre2_match_data **match_data, pcre2_match_context *mcontext, int *results)
+{
+#ifndef SUPPORT_JIT
+
+(void)code;
+(void)subjects;
+(void)lengths;
+(void)count;
+(void)options;
+(void)match_data;
+(void)mcontext;
+(void)results;
+return PCRE2_ERROR_JIT_BADOPTION;
+
+#else  /* SUPPORT_JIT */
+
+pcre2_real_code *re = (pcre2_real_code *)code;
+executable_functions *functions =
+  (executable_functions *)JIT_FETCH(re->executable_jit);
+pcre2_jit_stack *jit_stack;
+uint32_t max_oveccount = functions->top_bracket;
+uint32_t i;
+union {
+   void *executable_func;
+   jit_function call_executable_func;
+} convert_executable_func;
+jit_arguments arguments;
+int yield = 0;
+int index = 0;
+
+if ((options & PCRE2_PARTIAL_HARD) != 0)
+  index = 2;
+else if ((options & PCRE2_PARTIAL_SOFT) != 0)
+  index = 1;
+
+convert_executable_func.executable_func =
+  JIT_FETCH(functions->executable_funcs[index]);
+if (convert_executable_func.executable_func == NULL)
+  return PCRE2_ERROR_JIT_BADOPTION;
+
+arguments.options = options;
+jit_stack = set_context_arguments(re, mcontext, &arguments);
+
+if (jit_stack == NULL && mcontext != NULL && mcontext->jit_stack_pool != NULL)
+  {
+  for (i = 0; i < count; i++) results[i] = PCRE2_ERROR_NOMEMORY;
+  return 0;
+  }
+
+for (i = 0; i < count; i++)
+  {
+  PCRE2_SPTR subject = subjects[i];
+  PCRE2_SIZE length = lengths[i];
+  pcre2_match_data *md = match_data[i];
+  uint32_t oveccount = md->oveccount;
+  int rc;
+
+  if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(subject);
+
+  arguments.str = subject;
+  arguments.begin = subject;
+  arguments.end = subject + length;
+  arguments.match_data = md;
+  arguments.startchar_ptr = subject;
+  arguments.mark_ptr = NULL;
+
+  if (oveccount > max_oveccount)
+    oveccount = max_oveccount;
+  arguments.oveccount = oveccount << 1;
+
+  if (jit_stack != NULL)
+    {
+    arguments.stack = (struct sljit_stack *)(jit_stack->stack);
+    rc = convert_executable_func.call_executable_func(&arguments);
+    }
+  else
+    rc = jit_machine_stack_exec(&arguments,
+      convert_executable_func.call_executable_func);
+
+  if (rc > (int)oveccount)
+    rc = 0;
+  md->code = re;
+  md->subject = subject;
+  md->rc = rc;
+  md->startchar = arguments.startchar_ptr - subject;
+  md->leftchar = 0;
+  md->rightchar = 0;
+  md->mark = arguments.mark_ptr;
+  md->matchedby = PCRE2_MATCHEDBY_JIT;
+
+  results[i] = rc;
+  if (rc >= 0) yield++;
+  }
+
+if (mcontext != NULL && mcontext->jit_stack_pool != NULL)
+  jit_pool_put(mcontext->jit_stack_pool, jit_stack);
+
+return yield;
+
+#endif  /* SUPPORT_JIT */
+}
+
 /* End of pcre2_jit_match.c */
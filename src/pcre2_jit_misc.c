@@ -86,6 +86,8 @@ executable_functions *functions = (executable_functions *)executable_jit;
 void *allocator_data = memctl;
 int i;
 
+join_async(functions);
+
 for (i = 0; i < JIT_NUMBER_OF_COMPILE_MODES; i++)
   {
   if (functions->executable_funcs[i] != NULL)
@@ -93,6 +95,12 @@ for (i = 0; i < JIT_NUMBER_OF_COMPILE_MODES; i++)
   PRIV(jit_free_rodata)(functions->read_only_data_heads[i], allocator_data);
   }
 
+if (functions->glushkov != NULL)
+  {
+  sljit_free_code(functions->glushkov->jit_scan);
+  SLJIT_FREE(functions->glushkov, allocator_data);
+  }
+
 SLJIT_FREE(functions, allocator_data);
 
 #endif /* SUPPORT_JIT */
@@ -116,6 +124,289 @@ sljit_free_unused_memory_exec();
 
 
 
+/*************************************************
+*     Return statistics for JIT code memory      *
+*************************************************/
+
+/* The statistics are kept by the arena allocator for executable memory, which
+is used only if the library was built with it.
+
+Arguments:
+  what          what information is required
+  where         where to put the information; if NULL, the size of the
+                  information is returned
+
+Returns:        0 when data returned, the size when where is NULL, or
+                a negative error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_jit_memory_info(uint32_t what, void *where)
+{
+#if defined SUPPORT_JIT && defined SLJIT_ARENA_EXECUTABLE_ALLOCATOR && \
+  SLJIT_ARENA_EXECUTABLE_ALLOCATOR
+struct sljit_exec_allocator_stats stats;
+#endif
+
+if (where == NULL)   /* Requests field length */
+  {
+  switch(what)
+    {
+    case PCRE2_JITMEMINFO_ARENAS:
+    case PCRE2_JITMEMINFO_HOTARENAS:
+    case PCRE2_JITMEMINFO_HUGEARENAS:
+    case PCRE2_JITMEMINFO_FREEBLOCKS:
+    return sizeof(uint32_t);
+
+    case PCRE2_JITMEMINFO_MAPPED:
+    case PCRE2_JITMEMINFO_USED:
+    case PCRE2_JITMEMINFO_FREE:
+    case PCRE2_JITMEMINFO_LARGESTFREE:
+    return sizeof(size_t);
+
+    default: return PCRE2_ERROR_BADOPTION;
+    }
+  }
+
+#if !defined SUPPORT_JIT || !defined SLJIT_ARENA_EXECUTABLE_ALLOCATOR || \
+  !SLJIT_ARENA_EXECUTABLE_ALLOCATOR
+return PCRE2_ERROR_JIT_BADOPTION;
+#else  /* SUPPORT_JIT && SLJIT_ARENA_EXECUTABLE_ALLOCATOR */
+
+sljit_get_exec_allocator_stats(&stats);
+switch(what)
+  {
+  case PCRE2_JITMEMINFO_ARENAS:
+  *((uint32_t *)where) = (uint32_t)stats.arenas;
+  break;
+
+  case PCRE2_JITMEMINFO_HOTARENAS:
+  *((uint32_t *)where) = (uint32_t)stats.hot_arenas;
+  break;
+
+  case PCRE2_JITMEMINFO_HUGEARENAS:
+  *((uint32_t *)where) = (uint32_t)stats.huge_arenas;
+  break;
+
+  case PCRE2_JITMEMINFO_FREEBLOCKS:
+  *((uint32_t *)where) = (uint32_t)stats.free_blocks;
+  break;
+
+  case PCRE2_JITMEMINFO_MAPPED:
+  *((size_t *)where) = stats.mapped_size;
+  break;
+
+  case PCRE2_JITMEMINFO_USED:
+  *((size_t *)where) = stats.allocated_size;
+  break;
+
+  case PCRE2_JITMEMINFO_FREE:
+  *((size_t *)where) = stats.free_size;
+  break;
+
+  case PCRE2_JITMEMINFO_LARGESTFREE:
+  *((size_t *)where) = stats.largest_free_block;
+  break;
+
+  default:
+  return PCRE2_ERROR_BADOPTION;
+  }
+return 0;
+
+#endif  /* SUPPORT_JIT && SLJIT_ARENA_EXECUTABLE_ALLOCATOR */
+}
+
+
+
+/*************************************************
+*           Create a shared JIT code cache       *
+*************************************************/
+
+/* The cache is a memory file that is mapped twice, writable for compiling and
+executable for matching. Because the mappings are shared, processes that are
+forked after patterns are compiled into the cache use the same copy of their
+code. The cache needs the arena allocator for executable memory.
+
+Arguments:
+  size          the size of the cache; it is rounded up to a multiple of
+                  2 megabytes
+  gcontext      a general context, for memory allocation, or NULL
+
+Returns:        the cache, or NULL if it could not be created or the
+                  library does not support it
+*/
+
+PCRE2_EXP_DEFN pcre2_jit_code_cache * PCRE2_CALL_CONVENTION
+pcre2_jit_code_cache_create(PCRE2_SIZE size, pcre2_general_context *gcontext)
+{
+#if !defined SUPPORT_JIT || !defined SUPPORT_JIT_CODE_CACHE
+
+(void)size;
+(void)gcontext;
+return NULL;
+
+#else  /* SUPPORT_JIT && SUPPORT_JIT_CODE_CACHE */
+
+pcre2_jit_code_cache *cache;
+struct sljit_exec_region *region;
+
+cache = PRIV(memctl_malloc)(sizeof(pcre2_real_jit_code_cache),
+  (pcre2_memctl *)gcontext);
+if (cache == NULL) return NULL;
+
+region = cache->memctl.malloc(sizeof(struct sljit_exec_region),
+  cache->memctl.memory_data);
+if (region == NULL ||
+    sljit_create_exec_region(region, (sljit_uw)size) != SLJIT_SUCCESS)
+  {
+  if (region != NULL) cache->memctl.free(region, cache->memctl.memory_data);
+  cache->memctl.free(cache, cache->memctl.memory_data);
+  return NULL;
+  }
+
+cache->region = region;
+return cache;
+
+#endif  /* SUPPORT_JIT && SUPPORT_JIT_CODE_CACHE */
+}
+
+
+
+/*************************************************
+*       Seal a shared JIT code cache             *
+*************************************************/
+
+/* The writable mapping is removed, and the system is asked to refuse any new
+one, so that the code in the cache can no longer be modified. Nothing more can
+be compiled into the cache after this. It should be called before the worker
+processes are forked.
+
+Arguments:
+  cache         the code cache
+
+Returns:        0 or a negative error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_jit_code_cache_seal(pcre2_jit_code_cache *cache)
+{
+#if !defined SUPPORT_JIT || !defined SUPPORT_JIT_CODE_CACHE
+(void)cache;
+return PCRE2_ERROR_JIT_BADOPTION;
+#else  /* SUPPORT_JIT && SUPPORT_JIT_CODE_CACHE */
+if (cache == NULL) return PCRE2_ERROR_NULL;
+sljit_seal_exec_region((struct sljit_exec_region *)cache->region);
+return 0;
+#endif  /* SUPPORT_JIT && SUPPORT_JIT_CODE_CACHE */
+}
+
+
+
+/*************************************************
+*   Return information about a JIT code cache    *
+*************************************************/
+
+/*
+Arguments:
+  cache         the code cache
+  what          what information is required
+  where         where to put the information; if NULL, the size of the
+                  information is returned
+
+Returns:        0 when data returned, the size when where is NULL, or
+                a negative error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_jit_code_cache_info(pcre2_jit_code_cache *cache, uint32_t what,
+  void *where)
+{
+#if defined SUPPORT_JIT && defined SUPPORT_JIT_CODE_CACHE
+struct sljit_exec_region *region;
+#endif
+
+if (where == NULL)   /* Requests field length */
+  {
+  switch(what)
+    {
+    case PCRE2_CODECACHEINFO_SIZE:
+    case PCRE2_CODECACHEINFO_USED:
+    return sizeof(size_t);
+
+    case PCRE2_CODECACHEINFO_HUGE:
+    case PCRE2_CODECACHEINFO_SEALED:
+    return sizeof(uint32_t);
+
+    default: return PCRE2_ERROR_BADOPTION;
+    }
+  }
+
+#if !defined SUPPORT_JIT || !defined SUPPORT_JIT_CODE_CACHE
+(void)cache;
+return PCRE2_ERROR_JIT_BADOPTION;
+#else  /* SUPPORT_JIT && SUPPORT_JIT_CODE_CACHE */
+
+if (cache == NULL) return PCRE2_ERROR_NULL;
+region = (struct sljit_exec_region *)cache->region;
+
+switch(what)
+  {
+  case PCRE2_CODECACHEINFO_SIZE:
+  *((size_t *)where) = region->size;
+  break;
+
+  case PCRE2_CODECACHEINFO_USED:
+  *((size_t *)where) = region->allocated_size;
+  break;
+
+  case PCRE2_CODECACHEINFO_HUGE:
+  *((uint32_t *)where) = (uint32_t)region->huge;
+  break;
+
+  case PCRE2_CODECACHEINFO_SEALED:
+  *((uint32_t *)where) = (region->writable == NULL)? 1 : 0;
+  break;
+
+  default:
+  return PCRE2_ERROR_BADOPTION;
+  }
+return 0;
+
+#endif  /* SUPPORT_JIT && SUPPORT_JIT_CODE_CACHE */
+}
+
+
+
+/*************************************************
+*         Free a shared JIT code cache           *
+*************************************************/
+
+/* The code in the cache is unmapped, so every pattern that was compiled into
+it must be freed first, in each process that frees the cache.
+
+Arguments:
+  cache         the code cache
+
+Returns:        nothing
+*/
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_jit_code_cache_free(pcre2_jit_code_cache *cache)
+{
+#if !defined SUPPORT_JIT || !defined SUPPORT_JIT_CODE_CACHE
+(void)cache;
+#else  /* SUPPORT_JIT && SUPPORT_JIT_CODE_CACHE */
+if (cache != NULL)
+  {
+  sljit_free_exec_region((struct sljit_exec_region *)cache->region);
+  cache->memctl.free(cache->region, cache->memctl.memory_data);
+  cache->memctl.free(cache, cache->memctl.memory_data);
+  }
+#endif  /* SUPPORT_JIT && SUPPORT_JIT_CODE_CACHE */
+}
+
+
+
 /*************************************************
 *            Allocate a JIT stack                *
 *************************************************/
@@ -168,6 +459,7 @@ pcre2_jit_stack_assign(pcre2_match_context *mcontext, pcre2_jit_callback callbac
 if (mcontext == NULL) return;
 mcontext->jit_callback = callback;
 mcontext->jit_callback_data = callback_data;
+mcontext->jit_stack_pool = NULL;
 
 #endif  /* SUPPORT_JIT */
 }
@@ -192,6 +484,172 @@ if (jit_stack != NULL)
 }
 
 
+/*************************************************
+*          Create a pool of JIT stacks           *
+*************************************************/
+
+/* No stacks are created until they are needed. Each stack that is created
+starts at startsize and can grow to maxsize. */
+
+PCRE2_EXP_DEFN pcre2_jit_stack_pool * PCRE2_CALL_CONVENTION
+pcre2_jit_stack_pool_create(size_t startsize, size_t maxsize,
+  pcre2_general_context *gcontext)
+{
+#ifndef SUPPORT_JIT
+
+(void)gcontext;
+(void)startsize;
+(void)maxsize;
+return NULL;
+
+#else  /* SUPPORT_JIT */
+
+pcre2_jit_stack_pool *pool;
+
+if (startsize < 1 || maxsize < 1)
+  return NULL;
+if (startsize > maxsize)
+  startsize = maxsize;
+
+pool = PRIV(memctl_malloc)(sizeof(pcre2_real_jit_stack_pool),
+  (pcre2_memctl *)gcontext);
+if (pool == NULL) return NULL;
+pool->startsize = startsize;
+pool->maxsize = maxsize;
+pool->idle = NULL;
+pool->idle_count = 0;
+pool->idle_size = 0;
+pool->stacks = 0;
+pool->in_use = 0;
+pool->peak_in_use = 0;
+pool->peak_size = 0;
+return pool;
+
+#endif
+}
+
+
+/*************************************************
+*      Assign a pool of JIT stacks to matches    *
+*************************************************/
+
+/* The pool replaces any JIT stack or callback that was assigned to the match
+context; similarly, a call of pcre2_jit_stack_assign() removes the pool. */
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_jit_stack_pool_assign(pcre2_match_context *mcontext,
+  pcre2_jit_stack_pool *pool)
+{
+#ifndef SUPPORT_JIT
+(void)mcontext;
+(void)pool;
+#else  /* SUPPORT_JIT */
+
+if (mcontext == NULL) return;
+mcontext->jit_callback = NULL;
+mcontext->jit_callback_data = NULL;
+mcontext->jit_stack_pool = pool;
+
+#endif  /* SUPPORT_JIT */
+}
+
+
+/*************************************************
+*      Return statistics for a JIT stack pool    *
+*************************************************/
+
+/*
+Arguments:
+  pool          points to the stack pool
+  what          what information is required
+  where         where to put the information; if NULL, the size of the
+                  information is returned
+
+Returns:        0 when data returned, the size when where is NULL, or
+                a negative error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_jit_stack_pool_info(pcre2_jit_stack_pool *pool, uint32_t what,
+  void *where)
+{
+if (where == NULL)   /* Requests field length */
+  {
+  switch(what)
+    {
+    case PCRE2_POOLINFO_STACKS:
+    case PCRE2_POOLINFO_INUSE:
+    case PCRE2_POOLINFO_PEAKINUSE:
+    return sizeof(uint32_t);
+
+    case PCRE2_POOLINFO_PEAKSIZE:
+    return sizeof(size_t);
+
+    default: return PCRE2_ERROR_BADOPTION;
+    }
+  }
+
+#ifndef SUPPORT_JIT
+(void)pool;
+return PCRE2_ERROR_NULL;
+#else  /* SUPPORT_JIT */
+
+if (pool == NULL) return PCRE2_ERROR_NULL;
+
+sljit_grab_lock();
+switch(what)
+  {
+  case PCRE2_POOLINFO_STACKS:
+  *((uint32_t *)where) = pool->stacks;
+  break;
+
+  case PCRE2_POOLINFO_INUSE:
+  *((uint32_t *)where) = pool->in_use;
+  break;
+
+  case PCRE2_POOLINFO_PEAKINUSE:
+  *((uint32_t *)where) = pool->peak_in_use;
+  break;
+
+  case PCRE2_POOLINFO_PEAKSIZE:
+  *((size_t *)where) = pool->peak_size;
+  break;
+
+  default:
+  sljit_release_lock();
+  return PCRE2_ERROR_BADOPTION;
+  }
+sljit_release_lock();
+return 0;
+
+#endif  /* SUPPORT_JIT */
+}
+
+
+/*************************************************
+*          Free a pool of JIT stacks             *
+*************************************************/
+
+/* This must not be called while any match that uses the pool is running. */
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_jit_stack_pool_free(pcre2_jit_stack_pool *pool)
+{
+#ifndef SUPPORT_JIT
+(void)pool;
+#else  /* SUPPORT_JIT */
+if (pool != NULL)
+  {
+  uint32_t i;
+  for (i = 0; i < pool->idle_count; i++) pcre2_jit_stack_free(pool->idle[i]);
+  if (pool->idle != NULL)
+    pool->memctl.free(pool->idle, pool->memctl.memory_data);
+  pool->memctl.free(pool, pool->memctl.memory_data);
+  }
+#endif  /* SUPPORT_JIT */
+}
+
+
 /*************************************************
 *               Get target CPU type              *
 *************************************************/
@@ -218,10 +676,123 @@ PRIV(jit_get_size)(void *executable_jit)
 (void)executable_jit;
 return 0;
 #else  /* SUPPORT_JIT */
-sljit_uw *executable_sizes = ((executable_functions *)executable_jit)->executable_sizes;
-SLJIT_COMPILE_ASSERT(JIT_NUMBER_OF_COMPILE_MODES == 3, number_of_compile_modes_changed);
-return executable_sizes[0] + executable_sizes[1] + executable_sizes[2];
+executable_functions *functions = (executable_functions *)executable_jit;
+const glushkov_machine *glushkov = JIT_FETCH(functions->glushkov);
+size_t size = 0;
+int i;
+
+/* A size is counted only when its code has been published, because the code
+may be being compiled by another thread. */
+
+for (i = 0; i < JIT_NUMBER_OF_COMPILE_MODES; i++)
+  if (JIT_FETCH(functions->executable_funcs[i]) != NULL)
+    size += functions->executable_sizes[i];
+if (glushkov != NULL) size += glushkov->jit_scan_size;
+return size;
 #endif
 }
 
+
+
+/*************************************************
+*       Get the automaton for DFA matching       *
+*************************************************/
+
+/* This is the automaton that was built by pcre2_jit_compile() with
+PCRE2_JIT_DFA, if the pattern was suitable.
+
+Arguments:
+  executable_jit   the JIT data for a pattern
+
+Returns:           the automaton, or NULL
+*/
+
+const glushkov_machine *
+PRIV(jit_glushkov)(const void *executable_jit)
+{
+#ifndef SUPPORT_JIT
+(void)executable_jit;
+return NULL;
+#else  /* SUPPORT_JIT */
+return JIT_FETCH(((const executable_functions *)executable_jit)->glushkov);
+#endif  /* SUPPORT_JIT */
+}
+
+
+
+/*************************************************
+*       Count a match for lazy compilation       *
+*************************************************/
+
+/* This is called by pcre2_match() and pcre2_dfa_match() for a pattern that
+has JIT data. If pcre2_jit_compile_lazy() has left modes to be compiled, the
+matches and the lengths of their subjects are counted, and when either count
+reaches its limit, the match that sees it takes on the modes and compiles them.
+Only one thread can take on a mode, so the others carry on with the interpreter
+until the code is published. An error from the compiler is ignored, leaving
+the pattern to be interpreted, as it would have been if pcre2_jit_compile() had
+failed.
+
+Arguments:
+  re          the compiled pattern
+  count       the number of matches
+  length      the total length of their subjects
+
+Returns:      nothing
+*/
+
+void
+PRIV(jit_lazy)(const pcre2_real_code *re, uint32_t count, PCRE2_SIZE length)
+{
+#ifndef SUPPORT_JIT
+(void)re;
+(void)count;
+(void)length;
+#else  /* SUPPORT_JIT */
+executable_functions *functions =
+  (executable_functions *)JIT_FETCH(re->executable_jit);
+sljit_u32 matches;
+sljit_uw bytes;
+sljit_u32 options;
+
+if (JIT_FETCH_OPTIONS(functions->lazy_options) == 0) return;
+
+matches = JIT_COUNT(functions->lazy_matches, count);
+bytes = JIT_COUNT(functions->lazy_bytes, length);
+
+if ((functions->lazy_match_limit == 0 ||
+     matches < functions->lazy_match_limit) &&
+    (functions->lazy_byte_limit == 0 ||
+     bytes < functions->lazy_byte_limit))
+  return;
+
+options = claim_modes(functions, JIT_FETCH_OPTIONS(functions->lazy_options));
+if (options != 0)
+  (void)jit_compile_modes((pcre2_code *)re, options, SLJIT_EXEC_HOT);
+#endif  /* SUPPORT_JIT */
+}
+
+
+
+/*************************************************
+*     Run the JIT scanning loop of an automaton  *
+*************************************************/
+
+void
+PRIV(jit_glushkov_scan)(const glushkov_machine *machine, glushkov_scan *scan)
+{
+#ifndef SUPPORT_JIT
+(void)machine;
+(void)scan;
+#else  /* SUPPORT_JIT */
+union {
+  void *executable_func;
+  void (SLJIT_CALL *call_executable_func)(glushkov_scan *);
+} convert_executable_func;
+
+convert_executable_func.executable_func = machine->jit_scan;
+convert_executable_func.call_executable_func(scan);
+#endif  /* SUPPORT_JIT */
+}
+
 /* End of pcre2_jit_misc.c */
@@ -43,8 +43,16 @@ POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if defined SUPPORT_PCRE2_8 && defined HAVE_UNISTD_H && !defined _WIN32
+#define FORK_TESTS 1
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #define PCRE2_CODE_UNIT_WIDTH 0
 #include "pcre2.h"
 
@@ -93,6 +101,12 @@ POSSIBILITY OF SUCH DAMAGE.
 */
 
 static int regression_tests(void);
+#ifdef SUPPORT_PCRE2_8
+static int stack_pool_tests(void);
+#endif
+#ifdef FORK_TESTS
+static int fork_tests(void);
+#endif
 
 int main(void)
 {
@@ -108,7 +122,17 @@ int main(void)
 		printf("JIT must be enabled to run pcre_jit_test\n");
 		return 1;
 	}
-	return regression_tests();
+	if (regression_tests() != 0)
+		return 1;
+#ifdef SUPPORT_PCRE2_8
+	if (stack_pool_tests() != 0)
+		return 1;
+#endif
+#ifdef FORK_TESTS
+	if (fork_tests() != 0)
+		return 1;
+#endif
+	return 0;
 }
 
 /* --------------------------------------------------------------------------------------- */
@@ -1746,4 +1770,237 @@ static int regression_tests(void)
 	}
 }
 
+#ifdef SUPPORT_PCRE2_8
+
+/* The memory data is the number of further allocations that succeed. */
+
+static void *limited_malloc(size_t size, void *memory_data)
+{
+	int *allowed = (int *)memory_data;
+
+	if (*allowed <= 0)
+		return NULL;
+	(*allowed)--;
+	return malloc(size);
+}
+
+static void limited_free(void *block, void *memory_data)
+{
+	(void)memory_data;
+	free(block);
+}
+
+/* A match must not fall back to the machine stack when a stack pool
+   cannot create a stack. */
+
+static int stack_pool_tests(void)
+{
+	/* The general context and the pool itself. */
+	int allowed = 2;
+	pcre2_general_context_8 *gcontext = pcre2_general_context_create_8(limited_malloc, limited_free, &allowed);
+	pcre2_jit_stack_pool_8 *pool = pcre2_jit_stack_pool_create_8(32 * 1024, 1024 * 1024, gcontext);
+	pcre2_match_context_8 *mcontext = pcre2_match_context_create_8(NULL);
+	pcre2_match_data_8 *mdata = pcre2_match_data_create_8(2, NULL);
+	pcre2_code_8 *re;
+	PCRE2_SPTR8 subjects[2];
+	PCRE2_SIZE lengths[2];
+	pcre2_match_data_8 *mdatas[2];
+	int results[2];
+	int errorcode;
+	PCRE2_SIZE erroroffset;
+	int failed = 1;
+
+	re = pcre2_compile_8((PCRE2_SPTR8)"(a|b)c", PCRE2_ZERO_TERMINATED, 0, &errorcode, &erroroffset, NULL);
+	if (re && pool && mcontext && mdata && pcre2_jit_compile_8(re, PCRE2_JIT_COMPLETE) == 0) {
+		pcre2_jit_stack_pool_assign_8(mcontext, pool);
+		subjects[0] = subjects[1] = (PCRE2_SPTR8)"xbc";
+		lengths[0] = lengths[1] = 3;
+		mdatas[0] = mdatas[1] = mdata;
+
+		if (pcre2_jit_match_8(re, subjects[0], lengths[0], 0, 0, mdata, mcontext) == PCRE2_ERROR_NOMEMORY
+				&& pcre2_match_8(re, subjects[0], lengths[0], 0, 0, mdata, mcontext) == PCRE2_ERROR_NOMEMORY
+				&& pcre2_jit_match_batch_8(re, subjects, lengths, 2, 0, mdatas, mcontext, results) == 0
+				&& results[0] == PCRE2_ERROR_NOMEMORY && results[1] == PCRE2_ERROR_NOMEMORY
+				&& pcre2_match_8(re, subjects[0], lengths[0], 0, 0, mdata, NULL) == 2)
+			failed = 0;
+	}
+
+	pcre2_code_free_8(re);
+	pcre2_match_data_free_8(mdata);
+	pcre2_match_context_free_8(mcontext);
+	pcre2_jit_stack_pool_free_8(pool);
+	pcre2_general_context_free_8(gcontext);
+
+	if (failed)
+		printf("Stack pool test: a match did not report that no stack could be created\n");
+	else
+		printf("Stack pool tests are successfully passed.\n");
+	return failed;
+}
+
+#endif /* SUPPORT_PCRE2_8 */
+
+#ifdef FORK_TESTS
+
+/* JIT code which is compiled before a fork() is shared by the two processes,
+   so neither of them may reuse its memory when the other frees a pattern. */
+
+static pcre2_code_8 *fork_compile(const char *pattern)
+{
+	int errorcode;
+	PCRE2_SIZE erroroffset;
+	pcre2_code_8 *re = pcre2_compile_8((PCRE2_SPTR8)pattern, PCRE2_ZERO_TERMINATED, 0, &errorcode, &erroroffset, NULL);
+
+	if (re && pcre2_jit_compile_8(re, PCRE2_JIT_COMPLETE) != 0) {
+		pcre2_code_free_8(re);
+		re = NULL;
+	}
+	return re;
+}
+
+static int fork_match(pcre2_code_8 *re, const char *subject)
+{
+	pcre2_match_data_8 *mdata = pcre2_match_data_create_from_pattern_8(re, NULL);
+	int rc;
+
+	if (!mdata)
+		return PCRE2_ERROR_NOMEMORY;
+	rc = pcre2_jit_match_8(re, (PCRE2_SPTR8)subject, strlen(subject), 0, 0, mdata, NULL);
+	pcre2_match_data_free_8(mdata);
+	return rc;
+}
+
+/* Returns 0 when the inherited pattern still matches as it did before the
+   fork, and the other pattern is not matched by it. */
+
+static int fork_check(pcre2_code_8 *re)
+{
+	return (fork_match(re, "xxbarbaz") == 2 && fork_match(re, "xxzapbaz") == PCRE2_ERROR_NOMATCH) ? 0 : 1;
+}
+
+/* The process which frees the shared pattern compiles another one. */
+
+static int fork_replace(pcre2_code_8 *re)
+{
+	int result;
+
+	pcre2_code_free_8(re);
+	re = fork_compile("(qux|zap)baz");
+	if (!re)
+		return 1;
+	result = (fork_match(re, "xxzapbaz") == 2) ? 0 : 1;
+	pcre2_code_free_8(re);
+	return result;
+}
+
+static int fork_wait(pid_t pid)
+{
+	int status;
+
+	if (waitpid(pid, &status, 0) != pid)
+		return 1;
+	return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+}
+
+/* A worker which is forked after a code cache is sealed frees both a
+   pattern in the cache and one outside it, and compiles a new one. */
+
+static int fork_cache_test(void)
+{
+	pcre2_jit_code_cache_8 *cache = pcre2_jit_code_cache_create_8(1, NULL);
+	pcre2_code_8 *cached;
+	pcre2_code_8 *re;
+	int errorcode;
+	PCRE2_SIZE erroroffset;
+	int failed = 0;
+	pid_t pid;
+
+	/* The library has no arena allocator. */
+	if (!cache)
+		return 0;
+
+	cached = pcre2_compile_8((PCRE2_SPTR8)"(one|two)three", PCRE2_ZERO_TERMINATED, 0, &errorcode, &erroroffset, NULL);
+	if (!cached || pcre2_jit_code_cache_compile_8(cache, cached, PCRE2_JIT_COMPLETE) != 0
+			|| pcre2_jit_code_cache_seal_8(cache) != 0) {
+		pcre2_code_free_8(cached);
+		pcre2_jit_code_cache_free_8(cache);
+		return 1;
+	}
+	re = fork_compile("(foo|bar)baz");
+
+	pid = fork();
+	if (pid == 0) {
+		if (fork_match(cached, "xxtwothree") != 2)
+			_exit(1);
+		pcre2_code_free_8(cached);
+		_exit(re ? fork_replace(re) : 1);
+	}
+
+	if (pid < 0 || fork_wait(pid) != 0 || !re || fork_check(re) != 0
+			|| fork_match(cached, "xxtwothree") != 2)
+		failed = 1;
+
+	pcre2_code_free_8(re);
+	pcre2_code_free_8(cached);
+	pcre2_jit_code_cache_free_8(cache);
+	return failed;
+}
+
+static int fork_tests(void)
+{
+	pcre2_code_8 *re = fork_compile("(foo|bar)baz");
+	int fds[2];
+	int failed = 0;
+	char c = 0;
+	pid_t pid;
+
+	if (!re || fork_check(re) != 0) {
+		printf("Fork test: cannot compile the shared pattern\n");
+		return 1;
+	}
+	fflush(stdout);
+
+	/* The child frees the shared pattern. */
+	pid = fork();
+	if (pid == 0)
+		_exit(fork_replace(re));
+	if (pid < 0 || fork_wait(pid) != 0 || fork_check(re) != 0) {
+		printf("Fork test: the child has changed the code of the parent\n");
+		failed = 1;
+	}
+
+	/* The parent frees the shared pattern. */
+	if (pipe(fds) != 0) {
+		pcre2_code_free_8(re);
+		return 1;
+	}
+	pid = fork();
+	if (pid == 0) {
+		close(fds[1]);
+		if (read(fds[0], &c, 1) != 1)
+			_exit(1);
+		_exit(fork_check(re));
+	}
+	close(fds[0]);
+	if (pid < 0) {
+		pcre2_code_free_8(re);
+		failed = 1;
+	} else if (fork_replace(re) != 0 || write(fds[1], &c, 1) != 1 || fork_wait(pid) != 0) {
+		printf("Fork test: the parent has changed the code of the child\n");
+		failed = 1;
+	}
+	close(fds[1]);
+
+	if (fork_cache_test() != 0) {
+		printf("Fork test: the worker has changed the code of the parent\n");
+		failed = 1;
+	}
+
+	if (!failed)
+		printf("Fork tests are successfully passed.\n");
+	return failed;
+}
+
+#endif /* FORK_TESTS */
+
 /* End of pcre2_jit_test.c */
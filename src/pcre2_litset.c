@@ -0,0 +1,828 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2017 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+
+/* This module contains the matchers for literal patterns. When a pattern is
+nothing but an alternation of two or more literal strings, such as
+/cat|dog|mouse/, an Aho-Corasick automaton is built for it when it is compiled,
+and pcre2_match() uses this instead of trying each string at each starting
+position. The strings may be caseless, and may be wrapped in non-capturing
+groups that have only one branch. The automaton scans the subject once, a code
+unit at a time, and finds the match that the interpreter would find: the one
+that starts earliest, and of those that start there, the one in the earliest
+branch.
+
+A pattern that is a single literal string, possibly with an assertion such as
+^ or $ at either end, is matched by a substring search, which pcre2_match()
+does without setting up for the interpreter at all. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* The greatest number of different code units greater than 255 that can be in
+the strings. Each one needs its own class, and there are at least as many
+states as classes, so a larger number could not fit in LITSET_MAX_CELLS. */
+
+#define LITSET_MAX_WIDE   1024
+
+/* Data that is passed around while the strings are being found */
+
+typedef struct scan_block {
+  const uint8_t *lcc;             /* Lower casing table */
+  PCRE2_UCHAR *units;             /* Where to put the code units, or NULL */
+  uint32_t *lengths;              /* Where to put the lengths, or NULL */
+  uint8_t *caseless_units;        /* Where to put caseless flags, or NULL */
+  uint32_t unit_count;            /* Code units so far */
+  uint32_t literal_count;         /* Strings so far */
+  BOOL utf;                       /* UTF mode */
+  BOOL caseless;                  /* A caseless character has been seen */
+  uint8_t cased[32];              /* Caseful code units < 256 */
+} scan_block;
+
+
+
+/*************************************************
+*     Scan a sequence of literal characters      *
+*************************************************/
+
+/* This function scans single characters in a branch of the pattern, possibly
+inside non-capturing groups that have only one branch. The code units are
+counted, and saved if there is somewhere to put them.
+
+Arguments:
+  sb          the scan block
+  code        points to the first item
+
+Returns:      pointer to the first item that is not a character or a group, or
+                NULL if a group contains anything else
+*/
+
+static PCRE2_SPTR
+scan_sequence(scan_block *sb, PCRE2_SPTR code)
+{
+for (;;)
+  {
+  uint32_t length;
+
+  switch(*code)
+    {
+    case OP_BRA:
+    if (code[GET(code, 1)] != OP_KET) return NULL;
+    code = scan_sequence(sb, code + 1 + LINK_SIZE);
+    if (code == NULL || *code != OP_KET) return NULL;
+    code += 1 + LINK_SIZE;
+    break;
+
+    case OP_CHAR:
+    case OP_CHARI:
+    length = 1;
+#ifdef SUPPORT_UNICODE
+    if (sb->utf && HAS_EXTRALEN(code[1])) length += GET_EXTRALEN(code[1]);
+#endif
+
+    /* A caseless character that is not in the tables has its other case found
+    from the Unicode properties, which cannot be done a code unit at a time. */
+
+    if (*code == OP_CHARI)
+      {
+      if (sb->utf && code[1] >= 128) return NULL;
+      sb->caseless = TRUE;
+      }
+    else if (length == 1 && MAX_255(code[1]))
+      sb->cased[code[1]/8] |= 1u << (code[1]%8);
+
+    if (sb->units != NULL)
+      memcpy(sb->units + sb->unit_count, code + 1, CU2BYTES(length));
+    if (sb->caseless_units != NULL)
+      memset(sb->caseless_units + sb->unit_count, *code == OP_CHARI, length);
+    sb->unit_count += length;
+    code += 1 + length;
+    break;
+
+    default:
+    return code;
+    }
+  }
+}
+
+
+
+/*************************************************
+*   Check the case tables for use in UTF mode    *
+*************************************************/
+
+/* In UTF mode, the interpreter uses the lower casing table for a caseless
+character less than 128, applying it to a whole subject character. Code units
+can be lower cased separately only if the table maps all characters less than
+128 to characters less than 128, and leaves all the others alone, as the
+default tables do.
+
+Argument:   the lower casing table
+Returns:    TRUE if the table is suitable
+*/
+
+static BOOL
+utf_tables_usable(const uint8_t *lcc)
+{
+uint32_t c;
+for (c = 0; c < 256; c++)
+  if ((c < 128)? lcc[c] >= 128 : lcc[c] != c) return FALSE;
+return TRUE;
+}
+
+
+
+/*************************************************
+*        Find the literal strings of a pattern   *
+*************************************************/
+
+/* The pattern must be a single group with at least two branches, none of them
+empty, followed by OP_END.
+
+Arguments:
+  sb          the scan block
+  code        points to the start of the compiled pattern
+
+Returns:      TRUE if the pattern is a set of literal strings
+*/
+
+static BOOL
+scan_pattern(scan_block *sb, PCRE2_SPTR code)
+{
+sb->unit_count = 0;
+sb->literal_count = 0;
+if (*code != OP_BRA) return FALSE;
+
+do
+  {
+  uint32_t start = sb->unit_count;
+  PCRE2_SPTR next = scan_sequence(sb, code + 1 + LINK_SIZE);
+  if (next == NULL || (*next != OP_ALT && *next != OP_KET) ||
+      sb->unit_count == start)
+    return FALSE;
+  if (sb->lengths != NULL)
+    sb->lengths[sb->literal_count] = sb->unit_count - start;
+  sb->literal_count++;
+  code = next;
+  }
+while (*code == OP_ALT);
+
+return sb->literal_count >= 2 && code[1 + LINK_SIZE] == OP_END;
+}
+
+
+
+/*************************************************
+*   Find the class of a code unit in the strings *
+*************************************************/
+
+/* Code units greater than 255 have classes that follow wide_base, in the order
+of the sorted wide_units vector.
+
+Arguments:
+  ls          the automaton
+  c           the code unit
+
+Returns:      the class, which is 0 for a code unit that is in no string
+*/
+
+static uint32_t
+unit_class(const litset_automaton *ls, uint32_t c)
+{
+uint32_t bot = 0;
+uint32_t top = ls->wide_count;
+
+if (c < 256) return ls->classes[c];
+while (bot < top)
+  {
+  uint32_t mid = (bot + top)/2;
+  if (c == ls->wide_units[mid]) return ls->wide_base + mid;
+  if (c < ls->wide_units[mid]) top = mid; else bot = mid + 1;
+  }
+return 0;
+}
+
+
+
+/*************************************************
+*    Build a literal set automaton for a pattern *
+*************************************************/
+
+/* This function is called after a pattern has been compiled. If the pattern is
+a set of literal strings, an automaton is built and attached to the compiled
+code; otherwise re->litset is left NULL and the pattern is matched in the usual
+way. The automaton is an optimization, so failure to get memory is not an
+error. In a caseless set, all the code units are compared after lower casing,
+which is what the interpreter does for characters in the tables; this is
+correct for a caseful character too, provided no other code unit has the same
+lower case. The pattern may not be anchored, or restricted to the first line.
+
+Argument:   points to the compiled pattern
+Returns:    nothing
+*/
+
+void
+PRIV(litset_attach)(pcre2_real_code *re)
+{
+scan_block sb;
+litset_automaton *ls;
+PCRE2_UCHAR wide[LITSET_MAX_WIDE];
+uint16_t key_class[256];
+uint32_t *lengths, *first_child, *next_sibling, *edge_unit, *literal;
+uint32_t *fail, *queue, *depth;
+uint32_t i, c, bound, state_count, class_count, wide_count, max_length, cells;
+uint32_t head, tail;
+size_t unit_size;
+PCRE2_UCHAR *units, *u;
+const uint8_t *lcc = re->tables + lcc_offset;
+PCRE2_SPTR code = (PCRE2_SPTR)((const uint8_t *)re + sizeof(pcre2_real_code)) +
+  re->name_count * re->name_entry_size;
+
+re->litset = NULL;
+if ((re->overall_options & (PCRE2_ANCHORED|PCRE2_FIRSTLINE)) != 0) return;
+
+/* The first scan counts the strings and their code units. */
+
+memset(&sb, 0, sizeof(scan_block));
+sb.lcc = lcc;
+sb.utf = (re->overall_options & PCRE2_UTF) != 0;
+if (!scan_pattern(&sb, code)) return;
+
+/* Check that lower casing cannot merge a caseful code unit with another. */
+
+if (sb.caseless)
+  {
+  uint8_t lcc_count[256];
+  if (sb.utf && !utf_tables_usable(lcc)) return;
+  memset(lcc_count, 0, sizeof(lcc_count));
+  for (c = 0; c < 256; c++) lcc_count[lcc[c]]++;
+  for (c = 0; c < 256; c++)
+    if ((sb.cased[c/8] & (1u << (c%8))) != 0 && lcc_count[lcc[c]] > 1)
+      return;
+  }
+
+/* Get working memory for the strings, which are lower cased if necessary, and
+for the trie that is built from them. There can be no more states than one more
+than the number of code units. */
+
+bound = sb.unit_count + 1;
+unit_size = (CU2BYTES(sb.unit_count) + sizeof(uint32_t) - 1) &
+  ~(sizeof(uint32_t) - 1);
+units = re->memctl.malloc(unit_size +
+  (sb.literal_count + 6 * bound) * sizeof(uint32_t), re->memctl.memory_data);
+if (units == NULL) return;
+lengths = (uint32_t *)((uint8_t *)units + unit_size);
+first_child = lengths + sb.literal_count;
+next_sibling = first_child + bound;
+edge_unit = next_sibling + bound;
+literal = edge_unit + bound;
+fail = literal + bound;
+queue = fail + bound;
+
+sb.units = units;
+sb.lengths = lengths;
+(void)scan_pattern(&sb, code);
+
+if (sb.caseless)
+  for (i = 0; i < sb.unit_count; i++)
+    if (MAX_255(units[i])) units[i] = lcc[units[i]];
+
+/* Give each different code unit a class. Those greater than 255 are kept in
+a sorted vector. */
+
+memset(key_class, 0, sizeof(key_class));
+class_count = 1;
+wide_count = 0;
+
+for (i = 0; i < sb.unit_count; i++)
+  {
+  uint32_t bot = 0, top = wide_count;
+  c = units[i];
+  if (c < 256)
+    {
+    if (key_class[c] == 0) key_class[c] = (uint16_t)class_count++;
+    continue;
+    }
+  while (bot < top)
+    {
+    uint32_t mid = (bot + top)/2;
+    if (c == wide[mid]) break;
+    if (c < wide[mid]) top = mid; else bot = mid + 1;
+    }
+  if (bot < top) continue;
+  if (wide_count >= LITSET_MAX_WIDE) goto FREE_WORK;
+  memmove(wide + bot + 1, wide + bot, CU2BYTES(wide_count - bot));
+  wide[bot] = c;
+  wide_count++;
+  }
+class_count += wide_count;
+
+/* Build the trie, in which each state has a list of its children. State 0 is
+the root. A state whose string is one of the literals records the first branch
+that has it; the value in the literal vector is one more than the branch
+number. */
+
+state_count = 1;
+first_child[0] = 0;
+literal[0] = 0;
+max_length = 0;
+u = units;
+
+for (i = 0; i < sb.literal_count; i++)
+  {
+  uint32_t k;
+  uint32_t state = 0;
+  for (k = 0; k < lengths[i]; k++)
+    {
+    uint32_t child;
+    for (child = first_child[state]; child != 0; child = next_sibling[child])
+      if (edge_unit[child] == u[k]) break;
+    if (child == 0)
+      {
+      child = state_count++;
+      first_child[child] = 0;
+      literal[child] = 0;
+      edge_unit[child] = u[k];
+      next_sibling[child] = first_child[state];
+      first_child[state] = child;
+      }
+    state = child;
+    }
+  if (literal[state] == 0) literal[state] = i + 1;
+  if (lengths[i] > max_length) max_length = lengths[i];
+  u += lengths[i];
+  }
+
+if ((uint64_t)state_count * class_count > LITSET_MAX_CELLS) goto FREE_WORK;
+cells = state_count * class_count;
+
+/* Get the memory for the automaton, and copy the trie into it. A transition
+to state 0 means that there is no child. */
+
+ls = re->memctl.malloc(sizeof(litset_automaton) +
+  cells * sizeof(uint32_t) + state_count * sizeof(litset_output) +
+  CU2BYTES(wide_count), re->memctl.memory_data);
+if (ls == NULL) goto FREE_WORK;
+
+ls->delta = (uint32_t *)(ls + 1);
+ls->outputs = (litset_output *)(ls->delta + cells);
+ls->wide_units = (PCRE2_UCHAR *)(ls->outputs + state_count);
+ls->literal_count = sb.literal_count;
+ls->state_count = state_count;
+ls->class_count = class_count;
+ls->wide_count = wide_count;
+ls->wide_base = class_count - wide_count;
+ls->max_length = max_length;
+memcpy(ls->wide_units, wide, CU2BYTES(wide_count));
+memset(ls->delta, 0, cells * sizeof(uint32_t));
+
+/* Map each code unit less than 256 to the class of its (lower cased) value. */
+
+for (c = 0; c < 256; c++)
+  ls->classes[c] = key_class[sb.caseless? lcc[c] : c];
+
+for (i = 0; i < state_count; i++)
+  {
+  uint32_t child;
+  for (child = first_child[i]; child != 0; child = next_sibling[child])
+    {
+    c = edge_unit[child];
+    ls->delta[i * class_count +
+      ((c < 256)? key_class[c] : unit_class(ls, c))] = child;
+    }
+  }
+
+/* Fill in the failure transitions breadth first, finding the output of each
+state on the way. This is the longest literal that is a suffix of the state's
+string: the state's own string if it is a literal, or else the output of its
+failure state, which is nearer the root. The depth of each state is the length
+of its own string; the edge_unit vector is no longer needed and is reused for
+it. */
+
+depth = edge_unit;
+depth[0] = 0;
+ls->outputs[0].length = 0;
+ls->outputs[0].branch = 0;
+head = tail = 0;
+fail[0] = 0;
+queue[tail++] = 0;
+
+while (head < tail)
+  {
+  uint32_t state = queue[head++];
+  uint32_t *row = ls->delta + state * class_count;
+  const uint32_t *frow = ls->delta + fail[state] * class_count;
+
+  for (c = 0; c < class_count; c++)
+    {
+    uint32_t child = row[c];
+    if (child == 0)
+      {
+      if (state != 0) row[c] = frow[c];
+      continue;
+      }
+    fail[child] = (state == 0)? 0 : frow[c];
+    depth[child] = depth[state] + 1;
+    if (literal[child] != 0)
+      {
+      ls->outputs[child].length = depth[child];
+      ls->outputs[child].branch = literal[child] - 1;
+      }
+    else ls->outputs[child] = ls->outputs[fail[child]];
+    queue[tail++] = child;
+    }
+  }
+
+/* Set the bitmap of code units that can start a string. All code units
+greater than 254 share the last bit. */
+
+memset(ls->first_bitmap, 0, 32);
+for (c = 0; c < 256; c++)
+  if (ls->delta[ls->classes[c]] != 0)
+    ls->first_bitmap[c/8] |= 1u << (c%8);
+for (c = 0; c < wide_count; c++)
+  if (ls->delta[ls->wide_base + c] != 0) ls->first_bitmap[31] |= 0x80u;
+PRIV(bitmap_tables)(ls->first_bitmap, ls->first_tables);
+
+re->litset = ls;
+
+FREE_WORK:
+re->memctl.free(units, re->memctl.memory_data);
+}
+
+
+
+/*************************************************
+*      Match a subject with a literal set        *
+*************************************************/
+
+/* The subject is scanned from the starting point. Whenever a literal ends,
+its start is compared with the best match so far. Scanning stops when no
+literal that starts at or before the best match can still end, which is always
+so when the automaton is back at its root.
+
+Arguments:
+  ls          the automaton
+  start       where to start scanning
+  end         the end of the subject
+  pmstart     where to return the start of the match
+  pmend       where to return the end of the match
+
+Returns:      TRUE if there is a match
+*/
+
+BOOL
+PRIV(litset_match)(const litset_automaton *ls, PCRE2_SPTR start,
+  PCRE2_SPTR end, PCRE2_SPTR *pmstart, PCRE2_SPTR *pmend)
+{
+PCRE2_SPTR p = start;
+PCRE2_SPTR best_start = NULL;
+PCRE2_SPTR best_end = NULL;
+uint32_t best_branch = 0;
+uint32_t state = 0;
+const uint32_t *delta = ls->delta;
+uint32_t class_count = ls->class_count;
+
+for (;;)
+  {
+  uint32_t c;
+  const litset_output *out;
+
+  /* At the root, skip to the next code unit that can start a string. */
+
+  if (state == 0)
+    {
+    if (best_start != NULL) break;
+    p = PRIV(find_bitmap)(p, end, ls->first_bitmap, ls->first_tables);
+    }
+  if (p >= end) break;
+
+  c = *p++;
+  state = delta[state * class_count +
+    ((c < 256)? ls->classes[c] : unit_class(ls, c))];
+  out = ls->outputs + state;
+
+  if (out->length != 0)
+    {
+    PCRE2_SPTR s = p - out->length;
+    if (best_start == NULL || s < best_start ||
+        (s == best_start && out->branch < best_branch))
+      {
+      best_start = s;
+      best_end = p;
+      best_branch = out->branch;
+      }
+    }
+
+  if (best_start != NULL && (PCRE2_SIZE)(p - best_start) >= ls->max_length)
+    break;
+  }
+
+if (best_start == NULL) return FALSE;
+*pmstart = best_start;
+*pmend = best_end;
+return TRUE;
+}
+
+/*************************************************
+*     Build a literal string for a pattern       *
+*************************************************/
+
+/* This function is called after a pattern has been compiled. If the pattern is
+a single literal string, possibly inside non-capturing groups, and possibly
+preceded by \A, ^, or \G and followed by \z, \Z, or $, the string is attached
+to the compiled code. Multiline ^ and $ are not recognized, and \Z and $ are
+recognized only when the newline is a fixed sequence. Like the other matching
+structures, the string is an optimization, so failure to get memory is not an
+error.
+
+Argument:   points to the compiled pattern
+Returns:    nothing
+*/
+
+void
+PRIV(literal_attach)(pcre2_real_code *re)
+{
+scan_block sb;
+literal_string *lit;
+uint32_t i, c, start_kind, end_kind;
+uint32_t nllen = 0;
+PCRE2_UCHAR nl[2] = { 0, 0 };
+PCRE2_SPTR body, p;
+const uint8_t *lcc = re->tables + lcc_offset;
+PCRE2_SPTR code = (PCRE2_SPTR)((const uint8_t *)re + sizeof(pcre2_real_code)) +
+  re->name_count * re->name_entry_size;
+
+re->literal = NULL;
+if ((re->overall_options & (PCRE2_FIRSTLINE|PCRE2_USE_OFFSET_LIMIT)) != 0 ||
+    *code != OP_BRA || code[GET(code, 1)] != OP_KET) return;
+
+body = code + 1 + LINK_SIZE;
+switch(*body)
+  {
+  case OP_SOD: start_kind = LITERAL_SOD; body++; break;
+  case OP_CIRC: start_kind = LITERAL_CIRC; body++; break;
+  case OP_SOM: start_kind = LITERAL_SOM; body++; break;
+  default: start_kind = LITERAL_FLOAT; break;
+  }
+
+memset(&sb, 0, sizeof(scan_block));
+sb.utf = (re->overall_options & PCRE2_UTF) != 0;
+p = scan_sequence(&sb, body);
+if (p == NULL || sb.unit_count == 0) return;
+if (sb.caseless && sb.utf && !utf_tables_usable(lcc)) return;
+
+switch(*p)
+  {
+  case OP_EOD: end_kind = LITERAL_EOD; p++; break;
+  case OP_EODN: end_kind = LITERAL_EODN; p++; break;
+  case OP_DOLL: end_kind = LITERAL_DOLL; p++; break;
+  default: end_kind = LITERAL_OPEN; break;
+  }
+if (*p != OP_KET || p[1 + LINK_SIZE] != OP_END) return;
+
+/* An assertion that allows a final newline needs to know what it is. */
+
+if (end_kind == LITERAL_EODN || (end_kind == LITERAL_DOLL &&
+    (re->overall_options & PCRE2_DOLLAR_ENDONLY) == 0))
+  {
+  switch(re->newline_convention)
+    {
+    case PCRE2_NEWLINE_CR: nl[0] = CHAR_CR; nllen = 1; break;
+    case PCRE2_NEWLINE_LF: nl[0] = CHAR_NL; nllen = 1; break;
+    case PCRE2_NEWLINE_NUL: nl[0] = CHAR_NUL; nllen = 1; break;
+    case PCRE2_NEWLINE_CRLF: nl[0] = CHAR_CR; nl[1] = CHAR_NL; nllen = 2; break;
+    default: return;
+    }
+  }
+
+lit = re->memctl.malloc(sizeof(literal_string) + CU2BYTES(sb.unit_count) +
+  sb.unit_count, re->memctl.memory_data);
+if (lit == NULL) return;
+
+lit->units = (PCRE2_UCHAR *)(lit + 1);
+lit->caseless = (uint8_t *)(lit->units + sb.unit_count);
+lit->length = sb.unit_count;
+lit->start_kind = start_kind;
+lit->end_kind = end_kind;
+lit->nllen = nllen;
+lit->nl[0] = nl[0];
+lit->nl[1] = nl[1];
+
+sb.units = lit->units;
+sb.caseless_units = lit->caseless;
+sb.unit_count = 0;
+(void)scan_sequence(&sb, body);
+
+for (i = 0; i < lit->length; i++)
+  if (lit->caseless[i] && MAX_255(lit->units[i]))
+    lit->units[i] = lcc[lit->units[i]];
+
+/* Find the code units that can start a match. For a caseless character there
+are usually two, but a locale's tables might have more. */
+
+memset(lit->first_bitmap, 0, 32);
+lit->first_cu = lit->first_cu2 = lit->units[0];
+lit->first_count = 1;
+
+if (lit->caseless[0] && MAX_255(lit->units[0]))
+  {
+  lit->first_count = 0;
+  for (c = 0; c < 256; c++)
+    {
+    if (lcc[c] != lit->units[0]) continue;
+    lit->first_bitmap[c/8] |= 1u << (c%8);
+    if (lit->first_count++ == 0) lit->first_cu = lit->first_cu2 = c;
+      else if (lit->first_count == 2) lit->first_cu2 = c;
+    }
+  }
+PRIV(bitmap_tables)(lit->first_bitmap, lit->first_tables);
+
+re->literal = lit;
+}
+
+
+
+/*************************************************
+*     Compare a literal string with the subject  *
+*************************************************/
+
+/* The caller has checked that there are enough code units in the subject. The
+last code unit is compared first, because the first one is usually known to
+match already.
+
+Arguments:
+  lit         the literal string
+  lcc         the lower casing table
+  p           where to compare in the subject
+
+Returns:      TRUE if the string is there
+*/
+
+static BOOL
+literal_here(const literal_string *lit, const uint8_t *lcc, PCRE2_SPTR p)
+{
+uint32_t i, c;
+uint32_t n = lit->length - 1;
+
+c = p[n];
+if (lit->caseless[n]) c = TABLE_GET(c, lcc, c);
+if (c != lit->units[n]) return FALSE;
+
+for (i = 0; i < n; i++)
+  {
+  c = p[i];
+  if (lit->caseless[i]) c = TABLE_GET(c, lcc, c);
+  if (c != lit->units[i]) return FALSE;
+  }
+return TRUE;
+}
+
+
+
+/*************************************************
+*      Match a subject with a literal string     *
+*************************************************/
+
+/* The string's assertions are interpreted as the interpreter would interpret
+them, and PCRE2_ANCHORED and PCRE2_ENDANCHORED are also obeyed. An anchored
+string is compared only at the starting offset. If the string must end at the
+end of the subject (or before a final newline), there are at most two places to
+compare. Otherwise a vectorized search finds each place where the first code
+unit occurs.
+
+Arguments:
+  re              the compiled pattern, which has a literal string
+  subject         the subject string
+  length          the length of the subject
+  start_offset    where to start in the subject
+  options         the match options
+  pstart          where to return the offset of the match
+
+Returns:          TRUE if there is a match
+*/
+
+BOOL
+PRIV(literal_match)(const pcre2_real_code *re, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, uint32_t options,
+  PCRE2_SIZE *pstart)
+{
+const literal_string *lit = re->literal;
+const uint8_t *lcc = re->tables + lcc_offset;
+PCRE2_SPTR start = subject + start_offset;
+PCRE2_SPTR end = subject + length;
+PCRE2_SPTR last, p;
+uint32_t end_kind = lit->end_kind;
+BOOL anchored = ((re->overall_options | options) & PCRE2_ANCHORED) != 0;
+
+switch(lit->start_kind)
+  {
+  case LITERAL_CIRC:
+  if ((options & PCRE2_NOTBOL) != 0) return FALSE;
+  /* Fall through */
+
+  case LITERAL_SOD:
+  if (start_offset != 0) return FALSE;
+  /* Fall through */
+
+  case LITERAL_SOM:
+  anchored = TRUE;
+  break;
+  }
+
+if (end_kind == LITERAL_DOLL)
+  {
+  if ((options & PCRE2_NOTEOL) != 0) return FALSE;
+  end_kind = (lit->nllen == 0)? LITERAL_EOD : LITERAL_EODN;
+  }
+if (((re->overall_options | options) & PCRE2_ENDANCHORED) != 0)
+  end_kind = LITERAL_EOD;
+
+if ((PCRE2_SIZE)(end - start) < lit->length) return FALSE;
+last = end - lit->length;
+
+/* The string must end at the end of the subject, or before a final newline
+when that is allowed. The latter starts earlier, so it is tried first. */
+
+if (end_kind != LITERAL_OPEN)
+  {
+  if (end_kind == LITERAL_EODN && last - start >= (ptrdiff_t)lit->nllen &&
+      end[-(ptrdiff_t)lit->nllen] == lit->nl[0] &&
+      (lit->nllen == 1 || end[-1] == lit->nl[1]))
+    {
+    p = last - lit->nllen;
+    if ((!anchored || p == start) && literal_here(lit, lcc, p)) goto FOUND;
+    }
+  p = last;
+  if ((!anchored || p == start) && literal_here(lit, lcc, p)) goto FOUND;
+  return FALSE;
+  }
+
+if (anchored)
+  {
+  p = start;
+  if (literal_here(lit, lcc, p)) goto FOUND;
+  return FALSE;
+  }
+
+for (p = start; p <= last; p++)
+  {
+  if (lit->first_count == 1)
+    p = PRIV(find_cu)(p, last + 1, lit->first_cu);
+  else if (lit->first_count == 2)
+    p = PRIV(find_cu2)(p, last + 1, lit->first_cu, lit->first_cu2);
+  else
+    p = PRIV(find_bitmap)(p, last + 1, lit->first_bitmap,
+      lit->first_tables);
+  if (p > last) break;
+  if (literal_here(lit, lcc, p)) goto FOUND;
+  }
+return FALSE;
+
+FOUND:
+*pstart = p - subject;
+return TRUE;
+}
+
+/* End of pcre2_litset.c */
@@ -474,7 +474,8 @@ a refactoring that uses a vector of frames to remember backtracking points.
 This runs no slower, and possibly even a bit faster than the original recursive
 implementation. An initial vector of size START_FRAMES_SIZE (enough for maybe
 50 frames) is allocated on the system stack. If this is not big enough, the
-heap is used for a larger vector.
+heap is used for a larger vector, which is kept in the match data block so that
+subsequent matches can use it without getting new memory.
 
 *******************************************************************************
 ******************************************************************************/
@@ -567,7 +568,7 @@ heapframe *F;           /* Current frame pointer */
 heapframe *N = NULL;    /* Temporary frame pointers */
 heapframe *P = NULL;
 heapframe *assert_accept_frame;  /* For passing back the frame with captures */
-PCRE2_SIZE frame_copy_size;      /* Amount to copy when creating a new frame */
+PCRE2_SIZE frame_copy_size;      /* Fixed amount to copy for a new frame */
 
 /* Local variables that do not need to be preserved over calls to RRMATCH(). */
 
@@ -598,10 +599,13 @@ BOOL utf = (mb->poptions & PCRE2_UTF) != 0;
 BOOL utf = FALSE;
 #endif
 
-/* This is the length of the last part of a backtracking frame that must be
-copied when a new frame is created. */
+/* This is the length of the fixed fields in the last part of a backtracking
+frame, which must be copied when a new frame is created. Only the part of the
+ovector that is below the current offset_top is copied after them, because the
+slots above it are never inspected. When offset_top is raised, any slots that
+it passes over are explicitly unset. */
 
-frame_copy_size = frame_size - offsetof(heapframe, eptr);
+frame_copy_size = offsetof(heapframe, ovector) - offsetof(heapframe, eptr);
 
 /* Set up the first current frame at the start of the vector, and initialize
 fields that are not reset for new frames. */
@@ -623,7 +627,8 @@ backtracking point. */
 MATCH_RECURSE:
 
 /* Set up a new backtracking frame. If the vector is full, get a new one
-on the heap, doubling the size, but constrained by the heap limit. */
+on the heap, doubling the size, but constrained by the heap limit. The new
+vector is kept in the match data, replacing any previous one. */
 
 N = (heapframe *)((char *)F + frame_size);
 if (N >= mb->match_frames_top)
@@ -638,15 +643,19 @@ if (N >= mb->match_frames_top)
     newsize = maxsize;
     }
 
-  new = mb->memctl.malloc(newsize, mb->memctl.memory_data);
+  new = mb->match_data->memctl.malloc(newsize,
+    mb->match_data->memctl.memory_data);
   if (new == NULL) return PCRE2_ERROR_NOMEMORY;
   memcpy(new, mb->match_frames, mb->frame_vector_size);
 
   F = (heapframe *)((char *)new + ((char *)F - (char *)mb->match_frames));
   N = (heapframe *)((char *)F + frame_size);
 
-  if (mb->match_frames != mb->stack_frames)
-    mb->memctl.free(mb->match_frames, mb->memctl.memory_data);
+  if (mb->match_data->heapframes != NULL)
+    mb->match_data->memctl.free(mb->match_data->heapframes,
+      mb->match_data->memctl.memory_data);
+  mb->match_data->heapframes = new;
+  mb->match_data->heapframes_size = newsize;
   mb->match_frames = new;
   mb->match_frames_top = (heapframe *)((char *)mb->match_frames + newsize);
   mb->frame_vector_size = newsize;
@@ -689,7 +698,7 @@ current. */
 
 memcpy((char *)N + offsetof(heapframe, eptr),
        (char *)F + offsetof(heapframe, eptr),
-       frame_copy_size);
+       frame_copy_size + Foffset_top * sizeof(PCRE2_SIZE));
 
 N->rdepth = Frdepth + 1;
 F = N;
@@ -758,7 +767,12 @@ fprintf(stderr, "++ op=%d\n", *Fecode);
       Fcapture_last = number;
       Fovector[offset] = P->eptr - mb->start_subject;
       Fovector[offset+1] = Feptr - mb->start_subject;
-      if (offset >= Foffset_top) Foffset_top = offset + 2;
+      if (offset >= Foffset_top)
+        {
+        for (i = (uint32_t)Foffset_top; i < offset; i++)
+          Fovector[i] = PCRE2_UNSET;
+        Foffset_top = offset + 2;
+        }
       }
     Fecode += PRIV(OP_lengths)[*Fecode];
     break;
@@ -844,7 +858,8 @@ fprintf(stderr, "++ op=%d\n", *Fecode);
     /* Set i to the smaller of the sizes of the external and frame ovectors. */
 
     i = 2 * ((top_bracket + 1 > oveccount)? oveccount : top_bracket + 1);
-    memcpy(ovector + 2, Fovector, (i - 2) * sizeof(PCRE2_SIZE));
+    memcpy(ovector + 2, Fovector,
+      ((i - 2 < Foffset_top)? i - 2 : Foffset_top) * sizeof(PCRE2_SIZE));
     while (--i >= Foffset_top + 2) ovector[i] = PCRE2_UNSET;
     return MATCH_MATCH;  /* Note: NOT RRETURN */
 
@@ -5582,7 +5597,12 @@ fprintf(stderr, "++ op=%d\n", *Fecode);
       Fcapture_last = number;
       Fovector[offset] = P->eptr - mb->start_subject;
       Fovector[offset+1] = Feptr - mb->start_subject;
-      if (offset >= Foffset_top) Foffset_top = offset + 2;
+      if (offset >= Foffset_top)
+        {
+        for (i = (uint32_t)Foffset_top; i < offset; i++)
+          Fovector[i] = PCRE2_UNSET;
+        Foffset_top = offset + 2;
+        }
       break;
       }  /* End actions relating to the starting opcode */
 
@@ -5595,7 +5615,7 @@ fprintf(stderr, "++ op=%d\n", *Fecode);
       {
       memcpy((char *)P + offsetof(heapframe, eptr),
              (char *)F + offsetof(heapframe, eptr),
-             frame_copy_size);
+             frame_copy_size + Foffset_top * sizeof(PCRE2_SIZE));
       RRETURN(MATCH_KETRPOS);
       }
 
@@ -5988,87 +6008,26 @@ switch (Freturn_id)
 
 
 /*************************************************
-*           Match a Regular Expression           *
+*      Check a pattern and its match options     *
 *************************************************/
 
-/* This function applies a compiled pattern to a subject string and picks out
-portions of the string if it matches. Two elements in the vector are set for
-each substring: the offsets to the start and end of the substring.
+/* This function makes the checks on the pattern, the options, and the match
+context that do not depend on the subject, and starts to fill in a match_setup
+block. It is shared by pcre2_match() and pcre2_match_batch().
 
 Arguments:
-  code            points to the compiled expression
-  subject         points to the subject string
-  length          length of subject string (may contain binary zeros)
-  start_offset    where to start in the subject string
+  re              points to the compiled expression
   options         option bits
-  match_data      points to a match_data block
-  mcontext        points a PCRE2 context
+  mcontext        points to a match context, or is NULL
+  ms              points to a match_setup block
 
-Returns:          > 0 => success; value is the number of ovector pairs filled
-                  = 0 => success, but ovector is not big enough
-                   -1 => failed to match (PCRE2_ERROR_NOMATCH)
-                   -2 => partial match (PCRE2_ERROR_PARTIAL)
-                 < -2 => some kind of unexpected problem
+Returns:          0 if all is well, or a negative error code
 */
 
-PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
-pcre2_match(const pcre2_code *code, PCRE2_SPTR subject, PCRE2_SIZE length,
-  PCRE2_SIZE start_offset, uint32_t options, pcre2_match_data *match_data,
-  pcre2_match_context *mcontext)
+static int
+check_match(const pcre2_real_code *re, uint32_t options,
+  pcre2_match_context *mcontext, match_setup *ms)
 {
-int rc;
-const uint8_t *start_bits = NULL;
-
-const pcre2_real_code *re = (const pcre2_real_code *)code;
-
-BOOL anchored;
-BOOL firstline;
-BOOL has_first_cu = FALSE;
-BOOL has_req_cu = FALSE;
-BOOL startline;
-BOOL utf;
-
-PCRE2_UCHAR first_cu = 0;
-PCRE2_UCHAR first_cu2 = 0;
-PCRE2_UCHAR req_cu = 0;
-PCRE2_UCHAR req_cu2 = 0;
-
-PCRE2_SPTR bumpalong_limit;
-PCRE2_SPTR end_subject;
-PCRE2_SPTR start_match = subject + start_offset;
-PCRE2_SPTR req_cu_ptr = start_match - 1;
-PCRE2_SPTR start_partial = NULL;
-PCRE2_SPTR match_partial = NULL;
-
-PCRE2_SIZE frame_size;
-
-/* We need to have mb as a pointer to a match block, because the IS_NEWLINE
-macro is used below, and it expects NLBLOCK to be defined as a pointer. */
-
-match_block actual_match_block;
-match_block *mb = &actual_match_block;
-
-/* Allocate an initial vector of backtracking frames on the stack. If this
-proves to be too small, it is replaced by a larger one on the heap. To get a
-vector of the size required that is aligned for pointers, allocate it as a
-vector of pointers. */
-
-PCRE2_SPTR stack_frames_vector[START_FRAMES_SIZE/sizeof(PCRE2_SPTR)];
-mb->stack_frames = (heapframe *)stack_frames_vector;
-
-/* A length equal to PCRE2_ZERO_TERMINATED implies a zero-terminated
-subject string. */
-
-if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(subject);
-end_subject = subject + length;
-
-/* Plausibility checks */
-
-if ((options & ~PUBLIC_MATCH_OPTIONS) != 0) return PCRE2_ERROR_BADOPTION;
-if (code == NULL || subject == NULL || match_data == NULL)
-  return PCRE2_ERROR_NULL;
-if (start_offset > length) return PCRE2_ERROR_BADOFFSET;
-
 /* Check that the first field in the block is the magic number. */
 
 if (re->magic_number != MAGIC_NUMBER) return PCRE2_ERROR_BADMAGIC;
@@ -6096,132 +6055,211 @@ options |= (re->flags & FF) / ((FF & (~FF+1)) / (OO & (~OO+1)));
 #undef FF
 #undef OO
 
-/* These two settings are used in the code for checking a UTF string that
-follows immediately afterwards. Other values in the mb block are used only
-during interpretive processing, not when the JIT support is in use, so they are
-set up later. */
+/* These settings are used in the code for checking a UTF string, which may
+come next. Other values in the match_setup block are used only during
+interpretive processing, not when the JIT support is in use, so they are set up
+later. */
 
-utf = (re->overall_options & PCRE2_UTF) != 0;
-mb->partial = ((options & PCRE2_PARTIAL_HARD) != 0)? 2 :
+ms->re = re;
+ms->options = options;
+ms->utf = (re->overall_options & PCRE2_UTF) != 0;
+ms->partial = ((options & PCRE2_PARTIAL_HARD) != 0)? 2 :
               ((options & PCRE2_PARTIAL_SOFT) != 0)? 1 : 0;
 
 /* Partial matching and PCRE2_ENDANCHORED are currently not allowed at the same
 time. */
 
-if (mb->partial != 0 &&
+if (ms->partial != 0 &&
    ((re->overall_options | options) & PCRE2_ENDANCHORED) != 0)
   return PCRE2_ERROR_BADOPTION;
 
-/* Check a UTF string for validity if required. For 8-bit and 16-bit strings,
-we must also check that a starting offset does not point into the middle of a
-multiunit character. We check only the portion of the subject that is going to
-be inspected during matching - from the offset minus the maximum back reference
-to the given length. This saves time when a small part of a large subject is
-being matched by the use of a starting offset. Note that the maximum lookbehind
-is a number of characters, not code units. */
+/* A pattern compiled with PCRE2_EXTRA_LINEAR is matched only by its
+linear-time program, which does not support partial matching. */
 
-#ifdef SUPPORT_UNICODE
-if (utf && (options & PCRE2_NO_UTF_CHECK) == 0)
+if (ms->partial != 0 && (re->flags & PCRE2_LINEAR) != 0)
+  return PCRE2_ERROR_BADOPTION;
+
+/* It is an error to set an offset limit without setting the flag at compile
+time. */
+
+if (mcontext != NULL && mcontext->offset_limit != PCRE2_UNSET &&
+     (re->overall_options & PCRE2_USE_OFFSET_LIMIT) == 0)
+  return PCRE2_ERROR_BADOFFSETLIMIT;
+
+return 0;
+}
+
+
+/*************************************************
+*       Match a subject with a literal string    *
+*************************************************/
+
+/* A pattern that is a single literal string is matched by a substring search,
+without setting up a match block. This is not done for partial matching, or
+when any of the limits has been lowered, because a caller that does this
+expects the limit to apply.
+
+Arguments:
+  ms              points to the match_setup block from check_match()
+  mcontext        points to a match context, or is NULL
+  subject         points to the subject string
+  length          length of subject string
+  start_offset    where to start in the subject string
+  match_data      points to a match_data block
+
+Returns:          as for pcre2_match(), or PCRE2_ERROR_BADOPTION if the
+                    substring search cannot be used
+*/
+
+static int
+match_literal(const match_setup *ms, const pcre2_match_context *mcontext,
+  PCRE2_SPTR subject, PCRE2_SIZE length, PCRE2_SIZE start_offset,
+  pcre2_match_data *match_data)
+{
+const pcre2_real_code *re = ms->re;
+PCRE2_SIZE start;
+
+if (mcontext == NULL) mcontext = &PRIV(default_match_context);
+if (ms->partial != 0 ||
+    mcontext->match_limit < MATCH_LIMIT || re->limit_match < MATCH_LIMIT ||
+    mcontext->depth_limit < MATCH_LIMIT_DEPTH ||
+    re->limit_depth < MATCH_LIMIT_DEPTH ||
+    mcontext->heap_limit < HEAP_LIMIT || re->limit_heap < HEAP_LIMIT)
+  return PCRE2_ERROR_BADOPTION;
+
+match_data->code = re;
+match_data->subject = subject;
+match_data->mark = NULL;
+match_data->matchedby = PCRE2_MATCHEDBY_INTERPRETER;
+
+if (!PRIV(literal_match)(re, subject, length, start_offset, ms->options,
+    &start))
   {
-  PCRE2_SPTR check_subject = start_match;  /* start_match includes offset */
+  match_data->rc = PCRE2_ERROR_NOMATCH;
+  return match_data->rc;
+  }
 
-  if (start_offset > 0)
-    {
+match_data->ovector[0] = start;
+match_data->ovector[1] = start + re->literal->length;
+match_data->startchar = start;
+match_data->leftchar = start;
+match_data->rightchar = start + re->literal->length;
+match_data->rc = 1;
+return match_data->rc;
+}
+
+
+
+#ifdef SUPPORT_UNICODE
+/*************************************************
+*         Check a UTF subject for validity       *
+*************************************************/
+
+/* For 8-bit and 16-bit strings, we must also check that a starting offset does
+not point into the middle of a multiunit character. We check only the portion
+of the subject that is going to be inspected during matching - from the offset
+minus the maximum back reference to the given length. This saves time when a
+small part of a large subject is being matched by the use of a starting offset.
+Note that the maximum lookbehind is a number of characters, not code units.
+
+Arguments:
+  ms              points to the match_setup block
+  subject         points to the subject string
+  length          length of subject string
+  start_offset    where to start in the subject string
+  match_data      points to a match_data block
+
+Returns:          0 if the string is valid, or a negative error code
+*/
+
+static int
+check_utf_subject(const match_setup *ms, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, pcre2_match_data *match_data)
+{
+PCRE2_SPTR check_subject = subject + start_offset;
+
+if (start_offset > 0)
+  {
 #if PCRE2_CODE_UNIT_WIDTH != 32
-    unsigned int i;
-    if (start_match < end_subject && NOT_FIRSTCU(*start_match))
-      return PCRE2_ERROR_BADUTFOFFSET;
-    for (i = re->max_lookbehind; i > 0 && check_subject > subject; i--)
-      {
-      check_subject--;
-      while (check_subject > subject &&
+  unsigned int i;
+  if (start_offset < length && NOT_FIRSTCU(*check_subject))
+    return PCRE2_ERROR_BADUTFOFFSET;
+  for (i = ms->re->max_lookbehind; i > 0 && check_subject > subject; i--)
+    {
+    check_subject--;
+    while (check_subject > subject &&
 #if PCRE2_CODE_UNIT_WIDTH == 8
-      (*check_subject & 0xc0) == 0x80)
+    (*check_subject & 0xc0) == 0x80)
 #else  /* 16-bit */
-      (*check_subject & 0xfc00) == 0xdc00)
+    (*check_subject & 0xfc00) == 0xdc00)
 #endif /* PCRE2_CODE_UNIT_WIDTH == 8 */
-        check_subject--;
-      }
+      check_subject--;
+    }
 #else
-    /* In the 32-bit library, one code unit equals one character. However,
-    we cannot just subtract the lookbehind and then compare pointers, because
-    a very large lookbehind could create an invalid pointer. */
+  /* In the 32-bit library, one code unit equals one character. However,
+  we cannot just subtract the lookbehind and then compare pointers, because
+  a very large lookbehind could create an invalid pointer. */
 
-    if (start_offset >= re->max_lookbehind)
-      check_subject -= re->max_lookbehind;
-    else
-      check_subject = subject;
+  if (start_offset >= ms->re->max_lookbehind)
+    check_subject -= ms->re->max_lookbehind;
+  else
+    check_subject = subject;
 #endif  /* PCRE2_CODE_UNIT_WIDTH != 32 */
-    }
+  }
 
-  /* Validate the relevant portion of the subject. After an error, adjust the
-  offset to be an absolute offset in the whole string. */
+/* Validate the relevant portion of the subject. After an error, adjust the
+offset to be an absolute offset in the whole string. */
 
-  match_data->rc = PRIV(valid_utf)(check_subject,
-    length - (check_subject - subject), &(match_data->startchar));
-  if (match_data->rc != 0)
-    {
-    match_data->startchar += check_subject - subject;
-    return match_data->rc;
-    }
-  }
+match_data->rc = PRIV(valid_utf)(check_subject,
+  length - (check_subject - subject), &(match_data->startchar));
+if (match_data->rc != 0)
+  match_data->startchar += check_subject - subject;
+return match_data->rc;
+}
 #endif  /* SUPPORT_UNICODE */
 
-/* It is an error to set an offset limit without setting the flag at compile
-time. */
 
-if (mcontext != NULL && mcontext->offset_limit != PCRE2_UNSET &&
-     (re->overall_options & PCRE2_USE_OFFSET_LIMIT) == 0)
-  return PCRE2_ERROR_BADOFFSETLIMIT;
+/*************************************************
+*   Set up for interpretive matching of subjects *
+*************************************************/
 
-/* If the pattern was successfully studied with JIT support, run the JIT
-executable instead of the rest of this function. Most options must be set at
-compile time for the JIT code to be usable. Fallback to the normal code path if
-an unsupported option is set or if JIT returns BADOPTION (which means that the
-selected normal or partial matching mode was not compiled). */
+/* This function completes the match_setup block and fills in the fields of
+the match block that are the same for every subject.
 
-#ifdef SUPPORT_JIT
-if (re->executable_jit != NULL && (options & ~PUBLIC_JIT_MATCH_OPTIONS) == 0)
-  {
-  rc = pcre2_jit_match(code, subject, length, start_offset, options,
-    match_data, mcontext);
-  if (rc != PCRE2_ERROR_JIT_BADOPTION) return rc;
-  }
-#endif
+Arguments:
+  ms              points to a match_setup block from check_match()
+  mcontext        points to a match context, or is NULL
+  mb              points to the match block
 
-/* Carry on with non-JIT matching. A NULL match context means "use a default
-context", but we take the memory control functions from the pattern. */
+Returns:          0 if all is well, or a negative error code
+*/
+
+static int
+prepare_match(match_setup *ms, pcre2_match_context *mcontext,
+  match_block *mb)
+{
+const pcre2_real_code *re = ms->re;
+
+/* A NULL match context means "use a default context". */
 
 if (mcontext == NULL)
-  {
   mcontext = (pcre2_match_context *)(&PRIV(default_match_context));
-  mb->memctl = re->memctl;
-  }
-else mb->memctl = mcontext->memctl;
 
-anchored = ((re->overall_options | options) & PCRE2_ANCHORED) != 0;
-firstline = (re->overall_options & PCRE2_FIRSTLINE) != 0;
-startline = (re->flags & PCRE2_STARTLINE) != 0;
-bumpalong_limit =  (mcontext->offset_limit == PCRE2_UNSET)?
-  end_subject : subject + mcontext->offset_limit;
+ms->anchored = ((re->overall_options | ms->options) & PCRE2_ANCHORED) != 0;
+ms->firstline = (re->overall_options & PCRE2_FIRSTLINE) != 0;
+ms->startline = (re->flags & PCRE2_STARTLINE) != 0;
+ms->offset_limit = mcontext->offset_limit;
 
-/* Fill in the remaining fields in the match block. */
+/* Fill in the fields in the match block that do not depend on the subject. */
 
 mb->callout = mcontext->callout;
 mb->callout_data = mcontext->callout_data;
-
-mb->start_subject = subject;
-mb->start_offset = start_offset;
-mb->end_subject = end_subject;
 mb->hasthen = (re->flags & PCRE2_HASTHEN) != 0;
+mb->partial = ms->partial;
 
-mb->moptions = options;                 /* Match options */
+mb->moptions = ms->options;             /* Match options */
 mb->poptions = re->overall_options;     /* Pattern options */
 
-mb->ignore_skip_arg = 0;
-mb->mark = mb->nomatch_mark = NULL;     /* In case never set */
-mb->hitend = FALSE;
-
 /* The name table is needed for finding all the numbers associated with a
 given name, for condition testing. The code follows the name table. */
 
@@ -6280,7 +6318,7 @@ The last of these is changed within the match() function if the frame vector
 has to be expanded. We therefore put it into the match block so that it is
 correct when calling match() more than once for non-anchored patterns. */
 
-frame_size = offsetof(heapframe, ovector) + 
+ms->frame_size = offsetof(heapframe, ovector) +
   re->top_bracket * 2 * sizeof(PCRE2_SIZE);
 
 /* Limits set in the pattern override the match context only if they are
@@ -6295,38 +6333,6 @@ mb->match_limit = (mcontext->match_limit < re->limit_match)?
 mb->match_limit_depth = (mcontext->depth_limit < re->limit_depth)?
   mcontext->depth_limit : re->limit_depth;
 
-/* If a pattern has very many capturing parentheses, the frame size may be very
-large. Ensure that there are at least 10 available frames by getting an initial
-vector on the heap if necessary, except when the heap limit prevents this. Get
-fewer if possible. (The heap limit is in kilobytes.) */
-
-if (frame_size <= START_FRAMES_SIZE/10)
-  {
-  mb->match_frames = mb->stack_frames;   /* Initial frame vector on the stack */
-  mb->frame_vector_size = ((START_FRAMES_SIZE/frame_size) * frame_size);
-  }
-else
-  {
-  mb->frame_vector_size = frame_size * 10;
-  if ((mb->frame_vector_size / 1024) > mb->heap_limit)
-    {
-    if (frame_size > mb->heap_limit * 1024) return PCRE2_ERROR_HEAPLIMIT;
-    mb->frame_vector_size = ((mb->heap_limit * 1024)/frame_size) * frame_size;
-    }
-  mb->match_frames = mb->memctl.malloc(mb->frame_vector_size,
-    mb->memctl.memory_data);
-  if (mb->match_frames == NULL) return PCRE2_ERROR_NOMEMORY;
-  }
-
-mb->match_frames_top =
-  (heapframe *)((char *)mb->match_frames + mb->frame_vector_size);
-
-/* Write to the ovector within the first frame to mark every capture unset and
-to avoid uninitialized memory read errors when it is copied to a new frame. */
-
-memset((char *)(mb->match_frames) + offsetof(heapframe, ovector), 0xff,
-  re->top_bracket * 2 * sizeof(PCRE2_SIZE));
-
 /* Pointers to the individual character tables */
 
 mb->lcc = re->tables + lcc_offset;
@@ -6339,41 +6345,273 @@ forced at run time, so we have to test for anchoring. The first code unit may
 be unset for an unanchored pattern, of course. If there's no first code unit
 there may be a bitmap of possible first characters. */
 
-if (!anchored)
+ms->start_bits = NULL;
+ms->has_first_cu = FALSE;
+ms->first_cu = ms->first_cu2 = 0;
+
+if (!ms->anchored)
   {
   if ((re->flags & PCRE2_FIRSTSET) != 0)
     {
-    has_first_cu = TRUE;
-    first_cu = first_cu2 = (PCRE2_UCHAR)(re->first_codeunit);
+    ms->has_first_cu = TRUE;
+    ms->first_cu = ms->first_cu2 = (PCRE2_UCHAR)(re->first_codeunit);
     if ((re->flags & PCRE2_FIRSTCASELESS) != 0)
       {
-      first_cu2 = TABLE_GET(first_cu, mb->fcc, first_cu);
+      ms->first_cu2 = TABLE_GET(ms->first_cu, mb->fcc, ms->first_cu);
 #if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 8
-      if (utf && first_cu > 127) first_cu2 = UCD_OTHERCASE(first_cu);
+      if (ms->utf && ms->first_cu > 127)
+        ms->first_cu2 = UCD_OTHERCASE(ms->first_cu);
 #endif
       }
     }
   else
-    if (!startline && (re->flags & PCRE2_FIRSTMAPSET) != 0)
-      start_bits = re->start_bitmap;
+    if (!ms->startline && (re->flags & PCRE2_FIRSTMAPSET) != 0)
+      ms->start_bits = re->start_bitmap;
   }
 
 /* For anchored or unanchored matches, there may be a "last known required
 character" set. */
 
+ms->has_req_cu = FALSE;
+ms->req_cu = ms->req_cu2 = 0;
+
 if ((re->flags & PCRE2_LASTSET) != 0)
   {
-  has_req_cu = TRUE;
-  req_cu = req_cu2 = (PCRE2_UCHAR)(re->last_codeunit);
+  ms->has_req_cu = TRUE;
+  ms->req_cu = ms->req_cu2 = (PCRE2_UCHAR)(re->last_codeunit);
   if ((re->flags & PCRE2_LASTCASELESS) != 0)
     {
-    req_cu2 = TABLE_GET(req_cu, mb->fcc, req_cu);
+    ms->req_cu2 = TABLE_GET(ms->req_cu, mb->fcc, ms->req_cu);
 #if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 8
-    if (utf && req_cu > 127) req_cu2 = UCD_OTHERCASE(req_cu);
+    if (ms->utf && ms->req_cu > 127) ms->req_cu2 = UCD_OTHERCASE(ms->req_cu);
 #endif
     }
   }
 
+return 0;
+}
+
+
+/*************************************************
+*       Match one subject interpretively         *
+*************************************************/
+
+/* This function runs the bumpalong loop for a single subject, using values
+that were set up by check_match() and prepare_match().
+
+Arguments:
+  ms              points to the match_setup block
+  mb              points to the match block
+  subject         points to the subject string
+  length          length of subject string (already resolved)
+  start_offset    where to start in the subject string
+  match_data      points to a match_data block
+
+Returns:          as for pcre2_match()
+*/
+
+static int
+match_subject(const match_setup *ms, match_block *mb, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, pcre2_match_data *match_data)
+{
+int rc;
+const pcre2_real_code *re = ms->re;
+const uint8_t *start_bits = ms->start_bits;
+
+BOOL anchored = ms->anchored;
+BOOL firstline = ms->firstline;
+BOOL has_first_cu = ms->has_first_cu;
+BOOL has_req_cu = ms->has_req_cu;
+BOOL startline = ms->startline;
+BOOL utf = ms->utf;
+
+PCRE2_UCHAR first_cu = ms->first_cu;
+PCRE2_UCHAR first_cu2 = ms->first_cu2;
+PCRE2_UCHAR req_cu = ms->req_cu;
+PCRE2_UCHAR req_cu2 = ms->req_cu2;
+
+PCRE2_SPTR end_subject = subject + length;
+PCRE2_SPTR start_match = subject + start_offset;
+PCRE2_SPTR req_cu_ptr = start_match - 1;
+PCRE2_SPTR req_literal_ptr = start_match - 1;
+PCRE2_SPTR inner_ptr = start_match - 1;
+PCRE2_SPTR start_partial = NULL;
+PCRE2_SPTR match_partial = NULL;
+PCRE2_SPTR bumpalong_limit = (ms->offset_limit == PCRE2_UNSET)?
+  end_subject : subject + ms->offset_limit;
+PCRE2_SPTR glushkov_limit = end_subject;
+
+PCRE2_SIZE frame_size = ms->frame_size;
+PCRE2_SIZE heapframes_size;
+
+const glushkov_machine *glushkov = NULL;
+const onepass_program *onepass = NULL;
+glushkov_context gcx;
+const inner_literal *inner = (anchored || firstline)? NULL : re->inner;
+
+/* Allocate an initial vector of backtracking frames on the stack. If this
+proves to be too small, it is replaced by a larger one on the heap. To get a
+vector of the size required that is aligned for pointers, allocate it as a
+vector of pointers. */
+
+PCRE2_SPTR stack_frames_vector[START_FRAMES_SIZE/sizeof(PCRE2_SPTR)];
+mb->stack_frames = (heapframe *)stack_frames_vector;
+
+/* Fill in the fields in the match block that depend on the subject. */
+
+mb->start_subject = subject;
+mb->start_offset = start_offset;
+mb->end_subject = end_subject;
+
+mb->ignore_skip_arg = 0;
+mb->mark = mb->nomatch_mark = NULL;     /* In case never set */
+mb->hitend = FALSE;
+
+/* If a pattern has very many capturing parentheses, the frame size may be very
+large. Ensure that there are at least 10 available frames by getting an initial
+vector on the heap if necessary, except when the heap limit prevents this. Get
+fewer if possible. (The heap limit is in kilobytes.) Memory for backtracking
+frames is obtained using the functions in the match data, which keeps the frame
+vector between matches. */
+
+mb->match_data = match_data;
+
+if (frame_size <= START_FRAMES_SIZE/10)
+  {
+  mb->match_frames = mb->stack_frames;   /* Initial frame vector on the stack */
+  mb->frame_vector_size = ((START_FRAMES_SIZE/frame_size) * frame_size);
+  }
+else
+  {
+  mb->match_frames = NULL;
+  mb->frame_vector_size = frame_size * 10;
+  if ((mb->frame_vector_size / 1024) > mb->heap_limit)
+    {
+    if (frame_size > mb->heap_limit * 1024) return PCRE2_ERROR_HEAPLIMIT;
+    mb->frame_vector_size = ((mb->heap_limit * 1024)/frame_size) * frame_size;
+    }
+  }
+
+/* A frame vector on the heap is kept in the match data after a match, so that
+repeated matches need not get a new one each time. If there is one, and it is
+bigger than the initial vector that would otherwise be used, use it instead,
+but no more of it than the heap limit allows. Otherwise, get a new heap vector
+if necessary; it replaces any smaller vector in the match data. */
+
+heapframes_size = match_data->heapframes_size;
+if ((heapframes_size / 1024) > mb->heap_limit)
+  heapframes_size = mb->heap_limit * 1024;
+heapframes_size = (heapframes_size / frame_size) * frame_size;
+
+if (heapframes_size > mb->frame_vector_size)
+  {
+  mb->match_frames = match_data->heapframes;
+  mb->frame_vector_size = heapframes_size;
+  }
+else if (mb->match_frames == NULL)
+  {
+  mb->match_frames = match_data->memctl.malloc(mb->frame_vector_size,
+    match_data->memctl.memory_data);
+  if (mb->match_frames == NULL) return PCRE2_ERROR_NOMEMORY;
+  if (match_data->heapframes != NULL)
+    match_data->memctl.free(match_data->heapframes,
+      match_data->memctl.memory_data);
+  match_data->heapframes = mb->match_frames;
+  match_data->heapframes_size = mb->frame_vector_size;
+  }
+
+mb->match_frames_top =
+  (heapframe *)((char *)mb->match_frames + mb->frame_vector_size);
+
+/* A pattern that is a set of literal strings has an Aho-Corasick automaton,
+which finds the match that the interpreter would find in one scan of the
+subject. It is not used for an anchored or partial match, with an offset limit
+or PCRE2_ENDANCHORED, or when one of the limits has been lowered. */
+
+if (re->litset != NULL && !anchored && !mb->partial &&
+    bumpalong_limit == end_subject &&
+    ((re->overall_options | mb->moptions) & PCRE2_ENDANCHORED) == 0 &&
+    mb->match_limit >= MATCH_LIMIT &&
+    mb->match_limit_depth >= MATCH_LIMIT_DEPTH &&
+    mb->heap_limit >= HEAP_LIMIT)
+  {
+  if (!PRIV(litset_match)(re->litset, start_match, end_subject, &start_match,
+      &mb->end_match_ptr))
+    {
+    rc = MATCH_NOMATCH;
+    goto ENDLOOP;
+    }
+  match_data->ovector[0] = start_match - subject;
+  match_data->ovector[1] = mb->end_match_ptr - subject;
+  mb->end_offset_top = 0;
+  mb->start_used_ptr = start_match;
+  mb->last_used_ptr = start_match;
+  rc = MATCH_MATCH;
+  goto ENDLOOP;
+  }
+
+/* If the pattern was compiled with PCRE2_EXTRA_BIT_PARALLEL and a bit-parallel
+automaton could be built for it, it is used, like the start of match
+optimizations, to avoid running the interpreter where it cannot match. For an
+unanchored match, the subject is first scanned once to find the earliest end of
+any match; no match can start beyond it. Thereafter, the automaton checks each
+starting point before the interpreter is run to find the actual match and its
+captures. This is not done for partial matching, for a first line match or with
+an offset limit, or when PCRE2_ENDANCHORED or PCRE2_NO_START_OPTIMIZE is set. */
+
+if (re->glushkov != NULL && !mb->partial && !firstline &&
+    bumpalong_limit == end_subject &&
+    ((re->overall_options | mb->moptions) &
+      (PCRE2_ENDANCHORED|PCRE2_NO_START_OPTIMIZE)) == 0)
+  {
+  glushkov = re->glushkov;
+  gcx.start_subject = subject;
+  gcx.end_subject = end_subject;
+  gcx.start_offset = start_offset;
+  gcx.moptions = mb->moptions;
+  gcx.poptions = mb->poptions;
+  if (!anchored)
+    {
+    glushkov_limit = PRIV(glushkov_first_end)(glushkov, &gcx, start_match);
+    if (glushkov_limit == NULL)
+      {
+      rc = MATCH_NOMATCH;
+      goto ENDLOOP;
+      }
+    }
+  }
+
+/* An anchored pattern that has a one-pass program is matched by it instead of
+the interpreter, except for partial matching. The program needs no backtracking
+frames, and sets the ovector exactly as the interpreter would. A caller that
+lowers one of the limits expects it to apply to the interpreter, so the program
+is not used then. */
+
+if (re->onepass != NULL && anchored && !mb->partial &&
+    mb->match_limit >= MATCH_LIMIT &&
+    mb->match_limit_depth >= MATCH_LIMIT_DEPTH &&
+    mb->heap_limit >= HEAP_LIMIT)
+  {
+  onepass = re->onepass;
+  gcx.start_subject = subject;
+  gcx.end_subject = end_subject;
+  gcx.start_offset = start_offset;
+  gcx.moptions = mb->moptions;
+  gcx.poptions = mb->poptions;
+  }
+
+/* A pattern compiled with PCRE2_EXTRA_LINEAR is matched by its linear-time
+program, which takes the place of the whole bumpalong loop, unless the
+one-pass program can be used. */
+
+if (re->pikevm != NULL && onepass == NULL)
+  {
+  rc = PRIV(pikevm_match)(ms, mb, start_match,
+    (bumpalong_limit < glushkov_limit)? bumpalong_limit : glushkov_limit,
+    match_data, &start_match);
+  goto ENDLOOP;
+  }
+
 
 /* ==========================================================================*/
 
@@ -6419,42 +6657,17 @@ for(;;)
       end_subject = t;
       }
 
-    /* Advance to a unique first code unit if there is one. In 8-bit mode, the
-    use of memchr() gives a big speed up, even though we have to call it twice
-    in caseless mode, in order to find the first occurrence of the character in
-    either of its cases. */
+    /* Advance to a unique first code unit if there is one. The search
+    functions use vector instructions where they are available; in caseless
+    mode both cases are looked for in a single pass. */
 
     if (has_first_cu)
       {
       if (first_cu != first_cu2)  /* Caseless */
-        {
-#if PCRE2_CODE_UNIT_WIDTH != 8
-        PCRE2_UCHAR smc;
-        while (start_match < end_subject &&
-              (smc = UCHAR21TEST(start_match)) != first_cu && smc != first_cu2)
-          start_match++;
-#else  /* 8-bit code units */
-        PCRE2_SPTR pp1 = memchr(start_match, first_cu, end_subject-start_match);
-        PCRE2_SPTR pp2 = memchr(start_match, first_cu2, end_subject-start_match);
-        if (pp1 == NULL)
-          start_match = (pp2 == NULL)? end_subject : pp2;
-        else
-          start_match = (pp2 == NULL || pp1 < pp2)? pp1 : pp2;
-#endif
-        }
-
-      /* The caseful case */
-
+        start_match = PRIV(find_cu2)(start_match, end_subject, first_cu,
+          first_cu2);
       else
-        {
-#if PCRE2_CODE_UNIT_WIDTH != 8
-        while (start_match < end_subject && UCHAR21TEST(start_match) != first_cu)
-          start_match++;
-#else
-        start_match = memchr(start_match, first_cu, end_subject - start_match);
-        if (start_match == NULL) start_match = end_subject;
-#endif
-        }
+        start_match = PRIV(find_cu)(start_match, end_subject, first_cu);
 
       /* If we can't find the required code unit, break the bumpalong loop, to
       force a match failure, except when doing partial matching, when we let
@@ -6509,23 +6722,14 @@ for(;;)
     all code units greater than 254 set the 255 bit. */
 
     else if (start_bits != NULL)
-      {
-      while (start_match < end_subject)
-        {
-        uint32_t c = UCHAR21TEST(start_match);
-#if PCRE2_CODE_UNIT_WIDTH != 8
-        if (c > 255) c = 255;
-#endif
-        if ((start_bits[c/8] & (1 << (c&7))) != 0) break;
-        start_match++;
-        }
-      }
+      start_match = PRIV(find_bitmap)(start_match, end_subject, start_bits,
+        re->start_tables);
 
     /* Restore fudged end_subject */
 
     end_subject = save_end_subject;
 
-    /* The following two optimizations must be disabled for partial matching. */
+    /* The following optimizations must be disabled for partial matching. */
 
     if (!mb->partial)
       {
@@ -6544,21 +6748,22 @@ for(;;)
       subject for the (non-partial) match to succeed. If the first code unit is
       set, req_cu must be later in the subject; otherwise the test starts at
       the match point. This optimization can save a huge amount of backtracking
-      in patterns with nested unlimited repeats that aren't going to match.
-      Writing separate code for caseful/caseless versions makes it go faster,
-      as does using an autoincrement and backing off on a match. As in the case
-      of the first code unit, using memchr() in the 8-bit library gives a big
-      speed up. Unlike the first_cu check above, we do not need to call
-      memchr() twice in the caseless case because we only need to check for the
-      presence of the character in either case, not find the first occurrence.
+      in patterns with nested unlimited repeats that aren't going to match. The
+      search functions use vector instructions where they are available, and
+      in the caseless case look for both cases in a single pass.
 
       HOWEVER: when the subject string is very, very long, searching to its end
       can take a long time, and give bad performance on quite ordinary
       patterns. This showed up when somebody was matching something like
-      /^\d+C/ on a 32-megabyte string... so we don't do this when the string is
-      sufficiently long. */
-
-      if (has_req_cu && end_subject - start_match < REQ_CU_MAX)
+      /^\d+C/ on a 32-megabyte string... so we don't do this for an anchored
+      match when the string is sufficiently long, unless the pattern was
+      compiled with PCRE2_EXTRA_ALWAYS_CHECK_LASTCU. For an unanchored match
+      the search cannot cost more than the bumpalong would, because it stops
+      at the first occurrence and its result is remembered (see below), so it
+      is always done. */
+
+      if (has_req_cu && (!anchored || (re->flags & PCRE2_LASTCHECKALL) != 0 ||
+          end_subject - start_match < REQ_CU_MAX))
         {
         PCRE2_SPTR p = start_match + (has_first_cu? 1:0);
 
@@ -6570,42 +6775,9 @@ for(;;)
           if (p < end_subject)
             {
             if (req_cu != req_cu2)  /* Caseless */
-              {
-#if PCRE2_CODE_UNIT_WIDTH != 8
-              do
-                {
-                uint32_t pp = UCHAR21INCTEST(p);
-                if (pp == req_cu || pp == req_cu2) { p--; break; }
-                }
-              while (p < end_subject);
-
-#else  /* 8-bit code units */
-              PCRE2_SPTR pp = p;
-              p = memchr(pp, req_cu, end_subject - pp);
-              if (p == NULL)
-                {
-                p = memchr(pp, req_cu2, end_subject - pp);
-                if (p == NULL) p = end_subject;
-                }
-#endif /* PCRE2_CODE_UNIT_WIDTH != 8 */
-              }
-
-            /* The caseful case */
-
+              p = PRIV(find_cu2)(p, end_subject, req_cu, req_cu2);
             else
-              {
-#if PCRE2_CODE_UNIT_WIDTH != 8
-              do
-                {
-                if (UCHAR21INCTEST(p) == req_cu) { p--; break; }
-                }
-              while (p < end_subject);
-
-#else  /* 8-bit code units */
-              p = memchr(p, req_cu, end_subject - p);
-              if (p == NULL) p = end_subject;
-#endif
-              }
+              p = PRIV(find_cu)(p, end_subject, req_cu);
             }
 
           /* If we can't find the required code unit, break the bumpalong loop,
@@ -6624,30 +6796,79 @@ for(;;)
           req_cu_ptr = p;
           }
         }
+
+      /* In the same way, if there is a literal string that must be present
+      in every match, search for it, unless the start has not yet passed the
+      place where it was found last time. The same length limit is applied. */
+
+      if (re->req_literal_length != 0 && start_match > req_literal_ptr &&
+          (!anchored || (re->flags & PCRE2_LASTCHECKALL) != 0 ||
+           end_subject - start_match < REQ_CU_MAX))
+        {
+        req_literal_ptr = PRIV(find_literal)(start_match, end_subject,
+          re->req_literal, re->req_literal_length);
+        if (req_literal_ptr >= end_subject)
+          {
+          rc = MATCH_NOMATCH;
+          break;
+          }
+        }
+
+      /* If the pattern has an inner literal automaton, find the next
+      occurrence of the literal, and work back from it to the earliest place
+      where a match could start. No match can start earlier. This need not be
+      done again until the start has passed the occurrence. */
+
+      if (inner != NULL && start_match > inner_ptr)
+        {
+        PCRE2_SPTR p = PRIV(inner_start)(inner, start_match, end_subject,
+          &inner_ptr);
+        if (p == NULL)
+          {
+          rc = MATCH_NOMATCH;
+          break;
+          }
+        start_match = p;
+        }
       }
     }
 
   /* ------------ End of start of match optimizations ------------ */
 
-  /* Give no match if we have passed the bumpalong limit. */
+  /* Give no match if we have passed the bumpalong limit, or the earliest end
+of a match that the bit-parallel automaton found. */
 
-  if (start_match > bumpalong_limit)
+  if (start_match > bumpalong_limit || start_match > glushkov_limit)
     {
     rc = MATCH_NOMATCH;
     break;
     }
 
-  /* OK, we can now run the match. If "hitend" is set afterwards, remember the
+  /* OK, we can now run the match, unless the bit-parallel automaton shows
+  that there is no match here. If "hitend" is set afterwards, remember the
   first starting point for which a partial match was found. */
 
-  mb->start_used_ptr = start_match;
-  mb->last_used_ptr = start_match;
-  mb->match_call_count = 0;
-  mb->end_offset_top = 0;
-  mb->skip_arg_count = 0;
-
-  rc = match(start_match, mb->start_code, match_data->ovector,
-    match_data->oveccount, re->top_bracket, frame_size, mb);
+  if (glushkov != NULL && !PRIV(glushkov_match_at)(glushkov, &gcx, start_match))
+    rc = MATCH_NOMATCH;
+  else if (onepass != NULL)
+    {
+    mb->start_used_ptr = start_match;
+    mb->last_used_ptr = start_match;
+    rc = PRIV(onepass_match)(onepass, &gcx, start_match, re->top_bracket,
+      match_data->ovector, match_data->oveccount, &mb->end_match_ptr,
+      &mb->end_offset_top)? MATCH_MATCH : MATCH_NOMATCH;
+    }
+  else
+    {
+    mb->start_used_ptr = start_match;
+    mb->last_used_ptr = start_match;
+    mb->match_call_count = 0;
+    mb->end_offset_top = 0;
+    mb->skip_arg_count = 0;
+
+    rc = match(start_match, mb->start_code, match_data->ovector,
+      match_data->oveccount, re->top_bracket, frame_size, mb);
+    }
 
   if (mb->hitend && start_partial == NULL)
     {
@@ -6767,10 +6988,8 @@ for(;;)
 
 ENDLOOP:
 
-/* Release an enlarged frame vector that is on the heap. */
-
-if (mb->match_frames != mb->stack_frames)
-  mb->memctl.free(mb->match_frames, mb->memctl.memory_data);
+/* A frame vector that is on the heap is not released here; it is kept in the
+match data for use by the next match. */
 
 /* Fill in fields that are always returned in the match data. */
 
@@ -6823,4 +7042,280 @@ else match_data->rc = PCRE2_ERROR_NOMATCH;
 return match_data->rc;
 }
 
+
+/*************************************************
+*           Match a Regular Expression           *
+*************************************************/
+
+/* This function applies a compiled pattern to a subject string and picks out
+portions of the string if it matches. Two elements in the vector are set for
+each substring: the offsets to the start and end of the substring.
+
+Arguments:
+  code            points to the compiled expression
+  subject         points to the subject string
+  length          length of subject string (may contain binary zeros)
+  start_offset    where to start in the subject string
+  options         option bits
+  match_data      points to a match_data block
+  mcontext        points a PCRE2 context
+
+Returns:          > 0 => success; value is the number of ovector pairs filled
+                  = 0 => success, but ovector is not big enough
+                   -1 => failed to match (PCRE2_ERROR_NOMATCH)
+                   -2 => partial match (PCRE2_ERROR_PARTIAL)
+                 < -2 => some kind of unexpected problem
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_match(const pcre2_code *code, PCRE2_SPTR subject, PCRE2_SIZE length,
+  PCRE2_SIZE start_offset, uint32_t options, pcre2_match_data *match_data,
+  pcre2_match_context *mcontext)
+{
+int rc;
+match_setup ms;
+match_block mb;
+
+/* A length equal to PCRE2_ZERO_TERMINATED implies a zero-terminated
+subject string. */
+
+if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(subject);
+
+/* Plausibility checks */
+
+if ((options & ~PUBLIC_MATCH_OPTIONS) != 0) return PCRE2_ERROR_BADOPTION;
+if (code == NULL || subject == NULL || match_data == NULL)
+  return PCRE2_ERROR_NULL;
+if (start_offset > length) return PCRE2_ERROR_BADOFFSET;
+
+rc = check_match((const pcre2_real_code *)code, options, mcontext, &ms);
+if (rc != 0) return rc;
+
+/* Check a UTF string for validity if required. */
+
+#ifdef SUPPORT_UNICODE
+if (ms.utf && (options & PCRE2_NO_UTF_CHECK) == 0)
+  {
+  rc = check_utf_subject(&ms, subject, length, start_offset, match_data);
+  if (rc != 0) return rc;
+  }
+#endif  /* SUPPORT_UNICODE */
+
+/* If the pattern was successfully studied with JIT support, run the JIT
+executable instead of the rest of this function. Most options must be set at
+compile time for the JIT code to be usable. Fallback to the normal code path if
+an unsupported option is set or if JIT returns BADOPTION (which means that the
+selected normal or partial matching mode was not compiled). For a pattern that
+pcre2_jit_compile_lazy() has set up, the match is counted first, and this may
+cause the code to be compiled. */
+
+#ifdef SUPPORT_JIT
+if (JIT_FETCH(ms.re->executable_jit) != NULL &&
+    (ms.options & ~PUBLIC_JIT_MATCH_OPTIONS) == 0)
+  {
+  PRIV(jit_lazy)(ms.re, 1, length - start_offset);
+  rc = pcre2_jit_match(code, subject, length, start_offset, ms.options,
+    match_data, mcontext);
+  if (rc != PCRE2_ERROR_JIT_BADOPTION) return rc;
+  }
+#endif
+
+/* Carry on with non-JIT matching. A single literal string is found without
+setting up for the interpreter, if possible. */
+
+if (ms.re->literal != NULL)
+  {
+  rc = match_literal(&ms, mcontext, subject, length, start_offset,
+    match_data);
+  if (rc != PCRE2_ERROR_BADOPTION) return rc;
+  }
+
+rc = prepare_match(&ms, mcontext, &mb);
+if (rc != 0) return rc;
+return match_subject(&ms, &mb, subject, length, start_offset, match_data);
+}
+
+
+/*************************************************
+*   Match a Regular Expression against subjects  *
+*************************************************/
+
+/* This function applies a compiled pattern to each of a number of subject
+strings, starting at the beginning of each one. The work that does not depend
+on the subject is done only once. Each subject has its own match_data block,
+though the same block may be given more than once if only the return codes are
+wanted. The result of each match, as pcre2_match() would return it, is placed
+in the results vector.
+
+Arguments:
+  code            points to the compiled expression
+  subjects        points to a vector of subject pointers
+  lengths         points to a vector of subject lengths
+  count           number of subjects
+  options         option bits
+  match_data      points to a vector of match_data pointers
+  mcontext        points a PCRE2 context
+  results         points to a vector for the return codes
+
+Returns:         >= 0 => the number of subjects that matched
+                  < 0 => an error that was detected before any matching
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_match_batch(const pcre2_code *code, const PCRE2_SPTR *subjects,
+  const PCRE2_SIZE *lengths, uint32_t count, uint32_t options,
+  pcre2_match_data **match_data, pcre2_match_context *mcontext, int *results)
+{
+int rc;
+int yield = 0;
+uint32_t i;
+match_setup ms;
+match_block mb;
+
+/* Plausibility checks */
+
+if ((options & ~PUBLIC_MATCH_OPTIONS) != 0) return PCRE2_ERROR_BADOPTION;
+if (code == NULL || subjects == NULL || lengths == NULL ||
+    match_data == NULL || results == NULL)
+  return PCRE2_ERROR_NULL;
+for (i = 0; i < count; i++)
+  if (subjects[i] == NULL || match_data[i] == NULL) return PCRE2_ERROR_NULL;
+
+rc = check_match((const pcre2_real_code *)code, options, mcontext, &ms);
+if (rc != 0) return rc;
+
+/* If JIT is usable, pass runs of subjects to the JIT batch function. When UTF
+checking is required, a run ends at each invalid subject. If JIT returns
+BADOPTION at the first attempt, nothing has been matched and the interpreter is
+used for all the subjects. */
+
+#ifdef SUPPORT_JIT
+if (JIT_FETCH(ms.re->executable_jit) != NULL &&
+    (ms.options & ~PUBLIC_JIT_MATCH_OPTIONS) == 0)
+  {
+  uint32_t run_start = 0;
+  PCRE2_SIZE total = 0;
+
+  for (i = 0; i < count; i++)
+    total += (lengths[i] == PCRE2_ZERO_TERMINATED)?
+      PRIV(strlen)(subjects[i]) : lengths[i];
+  PRIV(jit_lazy)(ms.re, count, total);
+
+  for (i = 0; i <= count; i++)
+    {
+    if (i < count)
+      {
+#ifdef SUPPORT_UNICODE
+      if (ms.utf && (options & PCRE2_NO_UTF_CHECK) == 0)
+        {
+        PCRE2_SIZE length = lengths[i];
+        if (length == PCRE2_ZERO_TERMINATED)
+          length = PRIV(strlen)(subjects[i]);
+        results[i] = check_utf_subject(&ms, subjects[i], length, 0,
+          match_data[i]);
+        if (results[i] == 0) continue;
+        }
+      else
+#endif  /* SUPPORT_UNICODE */
+      continue;
+      }
+
+    if (i > run_start)
+      {
+      rc = pcre2_jit_match_batch(code, subjects + run_start,
+        lengths + run_start, i - run_start, ms.options,
+        match_data + run_start, mcontext, results + run_start);
+      if (rc == PCRE2_ERROR_JIT_BADOPTION) break;
+      yield += rc;
+      }
+    run_start = i + 1;
+    }
+
+  if (i > count) return yield;
+  }
+#endif  /* SUPPORT_JIT */
+
+/* Carry on with non-JIT matching. */
+
+rc = prepare_match(&ms, mcontext, &mb);
+if (rc != 0) return rc;
+
+for (i = 0; i < count; i++)
+  {
+  PCRE2_SIZE length = lengths[i];
+  if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(subjects[i]);
+
+#ifdef SUPPORT_UNICODE
+  if (ms.utf && (options & PCRE2_NO_UTF_CHECK) == 0)
+    {
+    results[i] = check_utf_subject(&ms, subjects[i], length, 0,
+      match_data[i]);
+    if (results[i] != 0) continue;
+    }
+#endif  /* SUPPORT_UNICODE */
+
+  if (ms.re->literal == NULL ||
+      (results[i] = match_literal(&ms, mcontext, subjects[i], length, 0,
+        match_data[i])) == PCRE2_ERROR_BADOPTION)
+    results[i] = match_subject(&ms, &mb, subjects[i], length, 0,
+      match_data[i]);
+  if (results[i] >= 0) yield++;
+  }
+
+return yield;
+}
+
+/*************************************************
+*   Match with a limit on the starting offset    *
+*************************************************/
+
+/* This function is called by the parallel matching functions to find a match
+that starts no later than a given offset, whether or not the pattern was
+compiled with PCRE2_USE_OFFSET_LIMIT. If it was, the limit can be put into a
+copy of the match context, so that pcre2_match() can use JIT. Otherwise, the
+JIT code cannot check the limit, so the interpreter is used. The caller must
+have checked the subject for UTF validity, and must set PCRE2_NO_UTF_CHECK.
+
+Arguments:
+  code            points to the compiled expression
+  subject         points to the subject string
+  length          length of subject string
+  start_offset    where to start in the subject string
+  options         option bits
+  match_data      points to a match_data block
+  mcontext        points to a match context, or is NULL
+  start_limit     the last offset at which a match may start
+
+Returns:          as for pcre2_match()
+*/
+
+int
+PRIV(match_limited)(const pcre2_code *code, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, uint32_t options,
+  pcre2_match_data *match_data, pcre2_match_context *mcontext,
+  PCRE2_SIZE start_limit)
+{
+int rc;
+match_setup ms;
+match_block mb;
+const pcre2_real_code *re = (const pcre2_real_code *)code;
+
+if ((re->overall_options & PCRE2_USE_OFFSET_LIMIT) != 0)
+  {
+  pcre2_match_context limited_context = (mcontext == NULL)?
+    PRIV(default_match_context) : *mcontext;
+  if (limited_context.offset_limit > start_limit)
+    limited_context.offset_limit = start_limit;
+  return pcre2_match(code, subject, length, start_offset, options,
+    match_data, &limited_context);
+  }
+
+rc = check_match(re, options, mcontext, &ms);
+if (rc != 0) return rc;
+rc = prepare_match(&ms, mcontext, &mb);
+if (rc != 0) return rc;
+ms.offset_limit = start_limit;
+return match_subject(&ms, &mb, subject, length, start_offset, match_data);
+}
+
 /* End of pcre2_match.c */
@@ -63,6 +63,9 @@ yield = PRIV(memctl_malloc)(
   (pcre2_memctl *)gcontext);
 if (yield == NULL) return NULL;
 yield->oveccount = oveccount;
+yield->heapframes = NULL;
+yield->heapframes_size = 0;
+yield->dfa_cache = NULL;
 return yield;
 }
 
@@ -93,7 +96,59 @@ PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
 pcre2_match_data_free(pcre2_match_data *match_data)
 {
 if (match_data != NULL)
+  {
+  if (match_data->heapframes != NULL)
+    match_data->memctl.free(match_data->heapframes,
+      match_data->memctl.memory_data);
+  if (match_data->dfa_cache != NULL)
+    match_data->memctl.free(match_data->dfa_cache,
+      match_data->memctl.memory_data);
   match_data->memctl.free(match_data, match_data->memctl.memory_data);
+  }
+}
+
+
+
+/*************************************************
+*   Get size of the heap backtracking vector     *
+*************************************************/
+
+PCRE2_EXP_DEFN PCRE2_SIZE PCRE2_CALL_CONVENTION
+pcre2_get_match_data_heapframes_size(pcre2_match_data *match_data)
+{
+return match_data->heapframes_size;
+}
+
+
+
+/*************************************************
+*   Shrink the heap backtracking vector          *
+*************************************************/
+
+/* The frame vector that pcre2_match() keeps in the match data block between
+matches grows to the largest size that any match has needed. This function
+releases it if it is bigger than the given size, so that the memory can be
+recovered after an unusually demanding match. A later match gets a new vector
+if it needs one.
+
+Arguments:
+  match_data   the match data block
+  size         the largest vector size to keep, in bytes
+
+Returns:       nothing
+*/
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_shrink_match_data_heapframes(pcre2_match_data *match_data,
+  PCRE2_SIZE size)
+{
+if (match_data->heapframes_size > size)
+  {
+  match_data->memctl.free(match_data->heapframes,
+    match_data->memctl.memory_data);
+  match_data->heapframes = NULL;
+  match_data->heapframes_size = 0;
+  }
 }
 
 
@@ -0,0 +1,998 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2017 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+
+/* This module contains the one-pass matcher, which pcre2_match() uses instead
+of the interpreter for an anchored pattern that can be matched by a single
+forward scan. The pattern may contain only single-character items, character
+classes, groups, alternatives, repeats, and simple assertions at the start and
+end of the top-level branches. Wherever the interpreter would have a choice,
+the next character must decide which way to go, except that the match may be
+able to end instead. In that case the matcher keeps a copy of the result that
+backtracking would find, and returns it if the scan fails later. The captured
+substrings are exactly those that the interpreter finds. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* A node value that means that a choice must be made in the current group,
+and an option value that means leaving the group. */
+
+#define NODE_CHOOSE   0xfffeu
+#define OPTION_EXIT   0xfffeu
+
+/* Assertions that may appear at the start of a top-level branch */
+
+#define START_ASSERTS \
+  (GLUSHKOV_A_SOD|GLUSHKOV_A_SOM|GLUSHKOV_A_CIRC|GLUSHKOV_A_CIRCM)
+
+/* Data that is passed around while the program is being built */
+
+typedef struct build_block {
+  const uint8_t *tables;          /* Character tables */
+  uint32_t nl;                    /* The newline character */
+  uint32_t depth;                 /* Group nesting depth */
+  uint32_t node_count;            /* Nodes so far */
+  uint32_t branch_count;          /* Branches so far */
+  uint32_t group_count;           /* Groups so far */
+  onepass_node nodes[ONEPASS_MAX_NODES];
+  onepass_branch branches[ONEPASS_MAX_BRANCHES];
+  uint8_t  choices[ONEPASS_MAX_GROUPS][257];
+} build_block;
+
+/* A group that is being matched, and the state of a match. Only as much of
+the vectors as is in use is copied. */
+
+typedef struct match_frame {
+  PCRE2_SPTR start;               /* Start of the current iteration */
+  uint32_t count;                 /* Iterations completed */
+  uint16_t group;                 /* The group's node */
+  uint16_t node;                  /* The next node, ONEPASS_NONE, or a choice */
+} match_frame;
+
+typedef struct match_state {
+  PCRE2_SPTR ptr;                 /* Current position */
+  uint32_t depth;                 /* Number of frames */
+  uint32_t branch;                /* The top-level branch */
+  PCRE2_SIZE offset_top;          /* As in the interpreter */
+  match_frame frames[ONEPASS_MAX_DEPTH];
+  PCRE2_SIZE ovector[2*ONEPASS_MAX_CAPTURES];
+} match_state;
+
+/* Data that is fixed for a match */
+
+typedef struct onepass_block {
+  const onepass_program *prog;    /* The program */
+  const glushkov_context *cx;     /* The subject and options */
+  PCRE2_SPTR start;               /* Start of the match */
+  BOOL notempty;                  /* An empty match is not allowed */
+  BOOL endanchored;               /* The match must end at the end */
+} onepass_block;
+
+
+
+/*************************************************
+*            Character set utilities             *
+*************************************************/
+
+static BOOL
+in_set(const uint8_t *bits, BOOL high, uint32_t c)
+{
+if (c > 255) return high;
+return (bits[c/8] & (1u << (c%8))) != 0;
+}
+
+static BOOL
+set_meets(const onepass_set *a, const onepass_set *b)
+{
+int i;
+if (a->high && b->high) return TRUE;
+for (i = 0; i < 32; i++) if ((a->bits[i] & b->bits[i]) != 0) return TRUE;
+return FALSE;
+}
+
+static void
+set_union(onepass_set *a, const onepass_set *b)
+{
+int i;
+for (i = 0; i < 32; i++) a->bits[i] |= b->bits[i];
+a->high |= b->high;
+}
+
+
+
+/*************************************************
+*               Build an item                    *
+*************************************************/
+
+/*
+Arguments:
+  bb          the build block
+  code        points to the opcode
+  pindex      where to put the node's index
+
+Returns:      pointer after the item, or NULL if it is not handled
+*/
+
+static PCRE2_SPTR
+build_item(build_block *bb, PCRE2_SPTR code, uint16_t *pindex)
+{
+glushkov_item item;
+onepass_node *n;
+
+code = PRIV(glushkov_item)(bb->tables, bb->nl, code, &item);
+if (code == NULL || bb->node_count >= ONEPASS_MAX_NODES) return NULL;
+
+*pindex = (uint16_t)bb->node_count;
+n = bb->nodes + bb->node_count++;
+memcpy(n->chars, item.bits, 32);
+n->high = item.high != 0;
+n->type = ONEPASS_ITEM;
+n->kind = (uint8_t)item.kind;
+n->ends = FALSE;
+n->next = ONEPASS_NONE;
+n->number = 0;
+n->first_branch = ONEPASS_NONE;
+n->choice = 0;
+n->min = item.min;
+n->max = item.max;
+return code;
+}
+
+
+
+/*************************************************
+*          Build a sequence of nodes             *
+*************************************************/
+
+/* A sequence ends at OP_ALT or at the end of the group. Assertions are
+allowed only at the start and end of the top-level branches, where they are
+recorded in the branch.
+
+Arguments:
+  bb          the build block
+  code        points to the first item
+  branch      the branch to fill in
+
+Returns:      pointer to the end of the sequence, or NULL if not handled
+*/
+
+static PCRE2_SPTR build_group(build_block *, PCRE2_SPTR, uint32_t, uint32_t,
+  uint16_t *);
+
+static PCRE2_SPTR
+build_sequence(build_block *bb, PCRE2_SPTR code, onepass_branch *branch)
+{
+uint16_t *link = &branch->first_node;
+BOOL started = FALSE;
+BOOL ending = FALSE;
+
+*link = ONEPASS_NONE;
+branch->start_asserts = branch->end_asserts = 0;
+
+for (;;)
+  {
+  uint16_t index;
+  uint32_t asserts = 0;
+  PCRE2_UCHAR op = *code;
+
+  switch(op)
+    {
+    case OP_ALT:
+    case OP_KET:
+    case OP_KETRMAX:
+    case OP_KETRMIN:
+    return code;
+
+    case OP_BRA:
+    case OP_CBRA:
+    code = build_group(bb, code, 1, GLUSHKOV_GREEDY, &index);
+    break;
+
+    case OP_BRAZERO:
+    case OP_BRAMINZERO:
+    code = build_group(bb, code + 1, 0,
+      (op == OP_BRAZERO)? GLUSHKOV_GREEDY : GLUSHKOV_LAZY, &index);
+    break;
+
+    /* A group that is repeated zero times is skipped. */
+
+    case OP_SKIPZERO:
+    code++;
+    do code += GET(code, 1); while (*code == OP_ALT);
+    code += 1 + LINK_SIZE;
+    continue;
+
+    case OP_SOD: asserts = GLUSHKOV_A_SOD; break;
+    case OP_SOM: asserts = GLUSHKOV_A_SOM; break;
+    case OP_CIRC: asserts = GLUSHKOV_A_CIRC; break;
+    case OP_CIRCM: asserts = GLUSHKOV_A_CIRCM; break;
+    case OP_EOD: asserts = GLUSHKOV_A_EOD; break;
+    case OP_EODN: asserts = GLUSHKOV_A_EODN; break;
+    case OP_DOLL: asserts = GLUSHKOV_A_DOLL; break;
+    case OP_DOLLM: asserts = GLUSHKOV_A_DOLLM; break;
+
+    default:
+    code = build_item(bb, code, &index);
+    break;
+    }
+
+  if (asserts != 0)
+    {
+    if (bb->depth != 1) return NULL;
+    if ((asserts & START_ASSERTS) != 0)
+      {
+      if (started || ending) return NULL;
+      branch->start_asserts |= asserts;
+      }
+    else
+      {
+      ending = TRUE;
+      branch->end_asserts |= asserts;
+      }
+    code++;
+    continue;
+    }
+
+  if (code == NULL || ending) return NULL;
+  started = TRUE;
+  *link = index;
+  link = &(bb->nodes[index].next);
+  }
+}
+
+
+
+/*************************************************
+*                Build a group                   *
+*************************************************/
+
+/* Only non-atomic groups, possibly capturing, are handled. They may be
+optional, or repeated indefinitely.
+
+Arguments:
+  bb          the build block
+  code        points to the opening bracket
+  min         0 for an optional group, or 1
+  kind        GLUSHKOV_GREEDY or GLUSHKOV_LAZY for an optional group
+  pindex      where to put the node's index
+
+Returns:      pointer after the group, or NULL if it is not handled
+*/
+
+static PCRE2_SPTR
+build_group(build_block *bb, PCRE2_SPTR code, uint32_t min, uint32_t kind,
+  uint16_t *pindex)
+{
+onepass_node *n;
+uint16_t *link;
+PCRE2_UCHAR op = *code;
+
+if (op != OP_BRA && op != OP_CBRA) return NULL;
+if (++bb->depth > ONEPASS_MAX_DEPTH) return NULL;
+if (bb->node_count >= ONEPASS_MAX_NODES ||
+    bb->group_count >= ONEPASS_MAX_GROUPS) return NULL;
+
+*pindex = (uint16_t)bb->node_count;
+n = bb->nodes + bb->node_count++;
+memset(n->chars, 0, 32);
+n->high = FALSE;
+n->type = ONEPASS_GROUP;
+n->kind = (uint8_t)kind;
+n->ends = FALSE;
+n->next = ONEPASS_NONE;
+n->choice = (uint16_t)bb->group_count++;
+n->number = (op == OP_CBRA)? (uint16_t)GET2(code, 1 + LINK_SIZE) : 0;
+n->min = min;
+n->max = 1;
+
+link = &(n->first_branch);
+do
+  {
+  onepass_branch *branch;
+  if (bb->branch_count >= ONEPASS_MAX_BRANCHES) return NULL;
+  *link = (uint16_t)bb->branch_count;
+  branch = bb->branches + bb->branch_count++;
+  branch->next = ONEPASS_NONE;
+  code = build_sequence(bb, code + PRIV(OP_lengths)[*code], branch);
+  if (code == NULL) return NULL;
+  link = &(branch->next);
+  }
+while (*code == OP_ALT);
+
+if (*code == OP_KETRMAX || *code == OP_KETRMIN)
+  {
+  n->max = GLUSHKOV_UNLIMITED;
+  if (*code == OP_KETRMIN) n->kind = GLUSHKOV_LAZY;
+  }
+
+bb->depth--;
+return code + 1 + LINK_SIZE;
+}
+
+
+
+/*************************************************
+*       Find what may start part of a branch     *
+*************************************************/
+
+/* These functions find the characters that may be matched first by a node or
+by the rest of a branch from a given node, and whether it can match an empty
+string, which is recorded in the "end" field.
+
+Arguments:
+  bb          the build block
+  index       the node, or ONEPASS_NONE
+  f           where to put the result
+
+Returns:      nothing
+*/
+
+static void sequence_first(const build_block *, uint32_t, onepass_set *);
+
+static void
+node_first(const build_block *bb, uint32_t index, onepass_set *f)
+{
+const onepass_node *n = bb->nodes + index;
+
+memset(f, 0, sizeof(onepass_set));
+f->end = n->min == 0;
+
+if (n->type == ONEPASS_ITEM)
+  {
+  if (n->max > 0)
+    {
+    memcpy(f->bits, n->chars, 32);
+    f->high = n->high;
+    }
+  }
+else
+  {
+  uint32_t b;
+  for (b = n->first_branch; b != ONEPASS_NONE; b = bb->branches[b].next)
+    {
+    onepass_set bf;
+    sequence_first(bb, bb->branches[b].first_node, &bf);
+    set_union(f, &bf);
+    if (bf.end) f->end = TRUE;
+    }
+  }
+}
+
+static void
+sequence_first(const build_block *bb, uint32_t index, onepass_set *f)
+{
+memset(f, 0, sizeof(onepass_set));
+f->end = TRUE;
+
+for (; index != ONEPASS_NONE && f->end; index = bb->nodes[index].next)
+  {
+  onepass_set nf;
+  node_first(bb, index, &nf);
+  set_union(f, &nf);
+  f->end = nf.end;
+  }
+}
+
+
+
+/*************************************************
+*       Check that every choice is decided       *
+*************************************************/
+
+/* The exit set of each node, and the predict set of each branch, are filled
+in, working down from the top of the pattern, which may be followed by the end
+of the match only. The choices are between continuing and leaving a repeated
+item, and between the branches of a group and leaving it. The characters that
+lead to each option must be distinct, so that they can be put in the group's
+row of the choice table. A group that is repeated indefinitely may not match
+an empty string.
+
+Arguments:
+  bb          the build block
+  index       the node, or the first node of a sequence
+  follow      what may follow the node or the sequence
+
+Returns:      TRUE if the pattern can be matched in one pass
+*/
+
+static BOOL analyze_node(build_block *, uint32_t, const onepass_set *);
+
+static BOOL
+analyze_sequence(build_block *bb, uint32_t index, const onepass_set *follow)
+{
+for (; index != ONEPASS_NONE; index = bb->nodes[index].next)
+  {
+  onepass_set rest;
+  sequence_first(bb, bb->nodes[index].next, &rest);
+  if (rest.end)
+    {
+    set_union(&rest, follow);
+    rest.end = follow->end;
+    }
+  if (!analyze_node(bb, index, &rest)) return FALSE;
+  }
+return TRUE;
+}
+
+static BOOL
+analyze_node(build_block *bb, uint32_t index, const onepass_set *follow)
+{
+onepass_node *n = bb->nodes + index;
+onepass_set body, after;
+uint8_t *row;
+uint32_t b, b2, c;
+BOOL can_exit;
+
+n->exit = *follow;
+
+if (n->type == ONEPASS_ITEM)
+  {
+  onepass_set chars;
+  if (n->kind == GLUSHKOV_POSSESSIVE || n->max <= n->min) return TRUE;
+  memcpy(chars.bits, n->chars, 32);
+  chars.high = n->high;
+  return !set_meets(&chars, follow);
+  }
+
+memset(&body, 0, sizeof(onepass_set));
+for (b = n->first_branch; b != ONEPASS_NONE; b = bb->branches[b].next)
+  {
+  onepass_set bf;
+  sequence_first(bb, bb->branches[b].first_node, &bf);
+  set_union(&body, &bf);
+  if (bf.end) body.end = TRUE;
+  }
+if (n->max > 1 && body.end) return FALSE;
+
+/* After an iteration of a repeated group, another iteration may start. */
+
+after = *follow;
+if (n->max > 1) set_union(&after, &body);
+
+for (b = n->first_branch; b != ONEPASS_NONE; b = bb->branches[b].next)
+  {
+  onepass_branch *branch = bb->branches + b;
+  if (!analyze_sequence(bb, branch->first_node, &after)) return FALSE;
+  sequence_first(bb, branch->first_node, &branch->predict);
+  if (branch->predict.end)
+    {
+    set_union(&branch->predict, &after);
+    branch->predict.end = after.end;
+    }
+  }
+
+can_exit = n->min == 0 || n->max > 1;
+row = bb->choices[n->choice];
+memset(row, ONEPASS_CHOOSE_NONE, 257);
+n->ends = can_exit && follow->end;
+
+for (b = n->first_branch; b != ONEPASS_NONE; b = bb->branches[b].next)
+  {
+  const onepass_branch *branch = bb->branches + b;
+  for (b2 = branch->next; b2 != ONEPASS_NONE; b2 = bb->branches[b2].next)
+    if (set_meets(&branch->predict, &bb->branches[b2].predict)) return FALSE;
+  if (can_exit && set_meets(&branch->predict, follow)) return FALSE;
+  for (c = 0; c <= 256; c++)
+    if (in_set(branch->predict.bits, branch->predict.high, c))
+      row[c] = (uint8_t)b;
+  if (branch->predict.end) n->ends = TRUE;
+  }
+
+if (can_exit)
+  {
+  for (c = 0; c <= 256; c++)
+    if (in_set(follow->bits, follow->high, c)) row[c] = ONEPASS_CHOOSE_EXIT;
+  }
+
+return TRUE;
+}
+
+
+
+/*************************************************
+*    Attach a one-pass program to a pattern      *
+*************************************************/
+
+/* This is called by pcre2_compile() for every anchored pattern, and when a
+pattern that has a program is copied or deserialized, because the program is
+held outside the compiled block. The pattern must not be in UTF or UCP mode,
+the newline must be a single character, and there must not be too many
+capturing groups. If the pattern is not suitable, or there is no memory, the
+pattern is left without a program; it is only an optimization.
+
+Argument:   the compiled pattern
+Returns:    nothing
+*/
+
+void
+PRIV(onepass_attach)(pcre2_real_code *re)
+{
+build_block bb;
+onepass_set follow;
+onepass_program *prog;
+uint16_t top;
+PCRE2_SPTR code = (PCRE2_SPTR)((const uint8_t *)re + sizeof(pcre2_real_code)) +
+  re->name_count * re->name_entry_size;
+
+re->onepass = NULL;
+if ((re->overall_options & (PCRE2_UTF|PCRE2_UCP)) != 0 ||
+    (re->overall_options & PCRE2_ANCHORED) == 0 ||
+    re->top_bracket > ONEPASS_MAX_CAPTURES)
+  return;
+
+switch(re->newline_convention)
+  {
+  case PCRE2_NEWLINE_CR: bb.nl = CHAR_CR; break;
+  case PCRE2_NEWLINE_LF: bb.nl = CHAR_NL; break;
+  case PCRE2_NEWLINE_NUL: bb.nl = CHAR_NUL; break;
+  default: return;
+  }
+
+bb.tables = re->tables;
+bb.depth = 0;
+bb.node_count = 0;
+bb.branch_count = 0;
+bb.group_count = 0;
+
+code = build_group(&bb, code, 1, GLUSHKOV_GREEDY, &top);
+if (code == NULL || *code != OP_END) return;
+
+memset(&follow, 0, sizeof(onepass_set));
+follow.end = TRUE;
+if (!analyze_node(&bb, top, &follow)) return;
+
+prog = re->memctl.malloc(sizeof(onepass_program) +
+  bb.node_count * sizeof(onepass_node) +
+  bb.branch_count * sizeof(onepass_branch) +
+  bb.group_count * 257, re->memctl.memory_data);
+if (prog == NULL) return;
+
+prog->nodes = (onepass_node *)(prog + 1);
+prog->branches = (onepass_branch *)(prog->nodes + bb.node_count);
+prog->choices = (uint8_t *)(prog->branches + bb.branch_count);
+prog->node_count = bb.node_count;
+prog->branch_count = bb.branch_count;
+prog->group_count = bb.group_count;
+prog->newline = bb.nl;
+memcpy(prog->nodes, bb.nodes, bb.node_count * sizeof(onepass_node));
+memcpy(prog->branches, bb.branches, bb.branch_count * sizeof(onepass_branch));
+memcpy(prog->choices, bb.choices, bb.group_count * 257);
+re->onepass = prog;
+}
+
+
+
+/*************************************************
+*              Match state utilities             *
+*************************************************/
+
+static void
+copy_state(match_state *to, const match_state *from)
+{
+to->ptr = from->ptr;
+to->depth = from->depth;
+to->branch = from->branch;
+to->offset_top = from->offset_top;
+memcpy(to->frames, from->frames, from->depth * sizeof(match_frame));
+memcpy(to->ovector, from->ovector, from->offset_top * sizeof(PCRE2_SIZE));
+}
+
+/* The match may end if the end assertions of the top-level branch hold, and
+the match is neither empty when that is not allowed, nor short of the end of
+the subject when PCRE2_ENDANCHORED is set. */
+
+static BOOL
+may_end(const onepass_block *ob, uint32_t branch, PCRE2_SPTR ptr)
+{
+uint32_t asserts = ob->prog->branches[branch].end_asserts;
+
+if (ptr == ob->start && ob->notempty) return FALSE;
+if (ptr < ob->cx->end_subject && ob->endanchored) return FALSE;
+return asserts == 0 ||
+  PRIV(glushkov_asserts)(ob->cx, ob->prog->newline, asserts, ptr);
+}
+
+
+
+/*************************************************
+*         Choose what to do in a group           *
+*************************************************/
+
+/* The options are considered in the order in which the interpreter tries
+them. The first one that can match the next character, or that lets the match
+end here, is chosen. If it does not let the match end, but a later option does,
+that option is returned as the alternative.
+
+Arguments:
+  ob          the match data
+  st          the match state
+  palt        where to put the alternative, or ONEPASS_NONE
+
+Returns:      a branch, OPTION_EXIT, or ONEPASS_NONE if there is no option
+*/
+
+static uint32_t
+choose(const onepass_block *ob, const match_state *st, uint32_t *palt)
+{
+const onepass_program *prog = ob->prog;
+const match_frame *f = st->frames + st->depth - 1;
+const onepass_node *g = prog->nodes + f->group;
+PCRE2_SPTR ptr = st->ptr;
+BOOL top = st->depth == 1;
+BOOL can_exit = f->count >= g->min;
+uint32_t options[ONEPASS_MAX_BRANCHES + 1];
+uint32_t count = 0;
+uint32_t chosen = ONEPASS_NONE;
+uint32_t b, i;
+
+if (can_exit && g->kind == GLUSHKOV_LAZY) options[count++] = OPTION_EXIT;
+if (f->count < g->max)
+  for (b = g->first_branch; b != ONEPASS_NONE; b = prog->branches[b].next)
+    options[count++] = b;
+if (can_exit && g->kind != GLUSHKOV_LAZY) options[count++] = OPTION_EXIT;
+
+*palt = ONEPASS_NONE;
+for (i = 0; i < count; i++)
+  {
+  const onepass_set *set;
+  uint32_t option = options[i];
+  uint32_t branch = st->branch;
+  BOOL consume, end;
+
+  if (option == OPTION_EXIT) set = &g->exit; else
+    {
+    uint32_t asserts = prog->branches[option].start_asserts;
+    set = &prog->branches[option].predict;
+    if (top)
+      {
+      branch = option;
+      if (asserts != 0 &&
+          !PRIV(glushkov_asserts)(ob->cx, prog->newline, asserts, ptr))
+        continue;
+      }
+    }
+
+  consume = ptr < ob->cx->end_subject && in_set(set->bits, set->high, *ptr);
+  end = set->end && may_end(ob, branch, ptr);
+
+  if (chosen == ONEPASS_NONE)
+    {
+    if (!consume && !end) continue;
+    chosen = option;
+    if (end) break;
+    }
+  else if (end)
+    {
+    *palt = option;
+    break;
+    }
+  }
+
+return chosen;
+}
+
+
+
+/*************************************************
+*          Take an option in a group             *
+*************************************************/
+
+static void
+take_option(const onepass_block *ob, match_state *st, uint32_t option)
+{
+match_frame *f = st->frames + st->depth - 1;
+
+if (option == OPTION_EXIT)
+  {
+  st->depth--;
+  st->frames[st->depth - 1].node = ob->prog->nodes[f->group].next;
+  }
+else
+  {
+  f->start = st->ptr;
+  f->node = ob->prog->branches[option].first_node;
+  if (st->depth == 1) st->branch = option;
+  }
+}
+
+
+
+/*************************************************
+*          Run the one-pass program              *
+*************************************************/
+
+/* The state is advanced until the match ends or fails. When a choice is made
+where an alternative would let the match end at the current position, the
+alternative is run on a copy of the state, which cannot consume any characters.
+If it succeeds, it is the result that backtracking would find, unless the
+main run succeeds. Later results replace earlier ones. Alternatives are not
+looked for while an alternative is being run.
+
+Arguments:
+  ob          the match data
+  st          the match state
+  best        where to keep the latest alternative result, or NULL
+  found       set TRUE when there is an alternative result
+
+Returns:      TRUE if the main run succeeds
+*/
+
+static BOOL
+run(const onepass_block *ob, match_state *st, match_state *best, BOOL *found)
+{
+const onepass_program *prog = ob->prog;
+PCRE2_SPTR end_subject = ob->cx->end_subject;
+match_state alt;
+
+for (;;)
+  {
+  match_frame *f = st->frames + st->depth - 1;
+  const onepass_node *g = prog->nodes + f->group;
+  const onepass_node *n;
+  PCRE2_SPTR ptr, last_end;
+  uint32_t count, option, other;
+
+  /* Make a choice in a group. When no option can end the match, the next
+  character decides; a top-level branch's start assertions must also hold. */
+
+  if (f->node == NODE_CHOOSE)
+    {
+    if (!g->ends)
+      {
+      uint32_t c;
+      if (st->ptr >= end_subject) return FALSE;
+      c = *(st->ptr);
+      option = prog->choices[g->choice * 257 + ((c > 255)? 256 : c)];
+      if (option == ONEPASS_CHOOSE_NONE) return FALSE;
+      if (option == ONEPASS_CHOOSE_EXIT)
+        {
+        if (f->count < g->min) return FALSE;
+        option = OPTION_EXIT;
+        }
+      else if (st->depth == 1)
+        {
+        uint32_t asserts = prog->branches[option].start_asserts;
+        if (asserts != 0 && !PRIV(glushkov_asserts)(ob->cx, prog->newline,
+            asserts, st->ptr))
+          return FALSE;
+        }
+      take_option(ob, st, option);
+      continue;
+      }
+
+    option = choose(ob, st, &other);
+    if (option == ONEPASS_NONE) return FALSE;
+    if (other != ONEPASS_NONE && best != NULL)
+      {
+      copy_state(&alt, st);
+      take_option(ob, &alt, other);
+      if (run(ob, &alt, NULL, NULL))
+        {
+        copy_state(best, &alt);
+        *found = TRUE;
+        }
+      }
+    take_option(ob, st, option);
+    continue;
+    }
+
+  /* At the end of an iteration of a group, set its capture. The end of the
+  outermost group is the end of the match. */
+
+  if (f->node == ONEPASS_NONE)
+    {
+    if (g->number != 0)
+      {
+      PCRE2_SIZE offset = (g->number << 1) - 2;
+      st->ovector[offset] = f->start - ob->cx->start_subject;
+      st->ovector[offset+1] = st->ptr - ob->cx->start_subject;
+      if (offset >= st->offset_top)
+        {
+        PCRE2_SIZE i;
+        for (i = st->offset_top; i < offset; i++) st->ovector[i] = PCRE2_UNSET;
+        st->offset_top = offset + 2;
+        }
+      }
+
+    if (++f->count < g->max)
+      {
+      f->node = NODE_CHOOSE;
+      continue;
+      }
+    if (st->depth == 1) return may_end(ob, st->branch, st->ptr);
+    st->depth--;
+    st->frames[st->depth - 1].node = g->next;
+    continue;
+    }
+
+  /* Enter a group. */
+
+  n = prog->nodes + f->node;
+  if (n->type == ONEPASS_GROUP)
+    {
+    match_frame *nf = st->frames + st->depth++;
+    nf->start = st->ptr;
+    nf->count = 0;
+    nf->group = f->node;
+    nf->node = NODE_CHOOSE;
+    continue;
+    }
+
+  /* Match an item. A greedy repeat is ended only when it cannot continue, but
+  the last place where the match could have ended after it is remembered, as
+  backtracking would find it. A lazy repeat is ended as soon as the following
+  character or the end of the match allows. */
+
+  ptr = st->ptr;
+  if ((PCRE2_SIZE)(end_subject - ptr) < n->min) return FALSE;
+  for (count = 0; count < n->min; count++)
+    {
+    if (!in_set(n->chars, n->high, *ptr)) return FALSE;
+    ptr++;
+    }
+
+  last_end = NULL;
+  if (n->kind == GLUSHKOV_LAZY)
+    {
+    for (; count < n->max; count++)
+      {
+      if (ptr < end_subject && in_set(n->exit.bits, n->exit.high, *ptr))
+        break;
+      if (n->exit.end && may_end(ob, st->branch, ptr)) break;
+      if (ptr >= end_subject || !in_set(n->chars, n->high, *ptr))
+        return FALSE;
+      ptr++;
+      }
+    }
+  else if (n->max > n->min)
+    {
+    PCRE2_SPTR limit = end_subject;
+    if (n->max != GLUSHKOV_UNLIMITED &&
+        (PCRE2_SIZE)(end_subject - ptr) > n->max - n->min)
+      limit = ptr + (n->max - n->min);
+    if (n->kind == GLUSHKOV_GREEDY) last_end = ptr;
+    while (ptr < limit && in_set(n->chars, n->high, *ptr)) ptr++;
+    }
+
+  if (last_end != NULL && best != NULL && n->exit.end && ptr > last_end &&
+      !ob->endanchored)
+    {
+    PCRE2_SPTR p;
+    if ((prog->branches[st->branch].end_asserts &
+        (GLUSHKOV_A_EOD|GLUSHKOV_A_EODN|GLUSHKOV_A_DOLL)) != 0 &&
+        last_end < end_subject - 1)
+      last_end = end_subject - 1;
+    for (p = ptr; p > last_end; )
+      {
+      if (may_end(ob, st->branch, --p))
+        {
+        copy_state(&alt, st);
+        alt.ptr = p;
+        alt.frames[alt.depth - 1].node = n->next;
+        if (run(ob, &alt, NULL, NULL))
+          {
+          copy_state(best, &alt);
+          *found = TRUE;
+          }
+        break;
+        }
+      }
+    }
+
+  st->ptr = ptr;
+  f->node = n->next;
+  }
+}
+
+
+
+/*************************************************
+*         Match with a one-pass program          *
+*************************************************/
+
+/* This function is called by pcre2_match() instead of the interpreter. The
+ovector is set exactly as the interpreter sets it for a match.
+
+Arguments:
+  prog          the one-pass program
+  cx            the subject and options
+  start         the starting position
+  top_bracket   the highest capture number in the pattern
+  ovector       the match data's ovector
+  oveccount     the number of pairs in the ovector
+  pend          where to put the end of the match
+  poffset_top   where to put the end of the captures, as the interpreter does
+
+Returns:        TRUE if there is a match
+*/
+
+BOOL
+PRIV(onepass_match)(const onepass_program *prog, const glushkov_context *cx,
+  PCRE2_SPTR start, uint32_t top_bracket, PCRE2_SIZE *ovector,
+  uint32_t oveccount, PCRE2_SPTR *pend, PCRE2_SIZE *poffset_top)
+{
+onepass_block ob;
+match_state st, best;
+match_state *result = &st;
+BOOL found = FALSE;
+PCRE2_SIZE i;
+
+ob.prog = prog;
+ob.cx = cx;
+ob.start = start;
+ob.notempty = (cx->moptions & PCRE2_NOTEMPTY) != 0 ||
+  ((cx->moptions & PCRE2_NOTEMPTY_ATSTART) != 0 &&
+    start == cx->start_subject + cx->start_offset);
+ob.endanchored = ((cx->moptions | cx->poptions) & PCRE2_ENDANCHORED) != 0;
+
+st.ptr = start;
+st.depth = 1;
+st.branch = 0;
+st.offset_top = 0;
+st.frames[0].start = start;
+st.frames[0].count = 0;
+st.frames[0].group = 0;
+st.frames[0].node = NODE_CHOOSE;
+
+if (!run(&ob, &st, &best, &found))
+  {
+  if (!found) return FALSE;
+  result = &best;
+  }
+
+ovector[0] = start - cx->start_subject;
+ovector[1] = result->ptr - cx->start_subject;
+i = 2 * ((top_bracket + 1 > oveccount)? oveccount : top_bracket + 1);
+memcpy(ovector + 2, result->ovector,
+  ((i - 2 < result->offset_top)? i - 2 : result->offset_top) *
+  sizeof(PCRE2_SIZE));
+while (--i >= result->offset_top + 2) ovector[i] = PCRE2_UNSET;
+
+*pend = result->ptr;
+*poffset_top = result->offset_top;
+return TRUE;
+}
+
+/* End of pcre2_onepass.c */
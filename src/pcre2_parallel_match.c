@@ -0,0 +1,717 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2017 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+/* This module contains functions for finding all the matches of a pattern in
+a large subject by dividing the subject into chunks that can be searched at the
+same time. These functions do not start any threads; the caller runs each
+chunk, typically from a pool of worker threads, and then merges the results,
+which are the same as those of a sequential global match. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+#define NLBLOCK pm             /* Block containing newline information */
+#define PSSTART start_subject  /* Field containing processed string start */
+#define PSEND   end_subject    /* Field containing processed string end */
+
+/* The options that may be passed to pcre2_parallel_match_split(). Partial
+matching is not supported, because a partial match at the end of one chunk
+would not be found by a sequential search that finds a complete match later. */
+
+#define PUBLIC_PARALLEL_MATCH_OPTIONS \
+  (PCRE2_ANCHORED|PCRE2_ENDANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY| \
+   PCRE2_NOTEMPTY_ATSTART|PCRE2_NO_UTF_CHECK|PCRE2_NO_JIT)
+
+/* The options that are added when a search is retried at the same point after
+an empty match, as is done by Perl's /g option. */
+
+#define RETRY_OPTIONS (PCRE2_NOTEMPTY_ATSTART|PCRE2_ANCHORED)
+
+/* The initial number of matches for which a vector is obtained. */
+
+#define START_MATCHES 64
+
+
+
+/*************************************************
+*      Enlarge a vector of match offsets         *
+*************************************************/
+
+/* The vector is doubled in size, keeping its current contents.
+
+Arguments:
+  pm          points to the parallel match block
+  vectorptr   points to the vector pointer
+  sizeptr     points to the number of entries that fit in the vector
+  used        the number of entries in use
+  width       the number of offsets in each entry
+
+Returns:      TRUE if all is well, FALSE if memory could not be obtained
+*/
+
+static BOOL
+grow_vector(pcre2_real_parallel_match *pm, PCRE2_SIZE **vectorptr,
+  PCRE2_SIZE *sizeptr, PCRE2_SIZE used, PCRE2_SIZE width)
+{
+PCRE2_SIZE newsize = (*sizeptr == 0)? START_MATCHES : 2 * (*sizeptr);
+PCRE2_SIZE *newvector;
+
+if (newsize > PCRE2_SIZE_MAX / (width * sizeof(PCRE2_SIZE))) return FALSE;
+newvector = pm->memctl.malloc(newsize * width * sizeof(PCRE2_SIZE),
+  pm->memctl.memory_data);
+if (newvector == NULL) return FALSE;
+
+if (used > 0)
+  memcpy(newvector, *vectorptr, used * width * sizeof(PCRE2_SIZE));
+if (*vectorptr != NULL) pm->memctl.free(*vectorptr, pm->memctl.memory_data);
+*vectorptr = newvector;
+*sizeptr = newsize;
+return TRUE;
+}
+
+
+
+/*************************************************
+*        Free the chunks of a subject            *
+*************************************************/
+
+static void
+free_chunks(pcre2_real_parallel_match *pm)
+{
+uint32_t i;
+if (pm->chunks == NULL) return;
+for (i = 0; i < pm->chunk_count; i++)
+  {
+  parallel_chunk *chunk = pm->chunks + i;
+  pcre2_match_data_free(chunk->match_data);
+  if (chunk->matches != NULL)
+    pm->memctl.free(chunk->matches, pm->memctl.memory_data);
+  }
+pm->memctl.free(pm->chunks, pm->memctl.memory_data);
+pm->chunks = NULL;
+pm->chunk_count = 0;
+}
+
+
+
+/*************************************************
+*        Advance a search offset by one          *
+*************************************************/
+
+/* This is the advance that a global search makes after failing to find a
+non-empty match at the end of an empty one, or after a match whose end is not
+beyond its starting point (which can happen with \K in a lookbehind). The
+advance is one character, or two code units at a CRLF newline when the newline
+convention allows CRLF and crlf is TRUE.
+
+Arguments:
+  pm          points to the parallel match block
+  offset      the offset to advance from
+  crlf        TRUE if CRLF is to be treated as one character
+
+Returns:      the new offset, which is greater than the length of the
+                subject if the search is over
+*/
+
+static PCRE2_SIZE
+advance_offset(const pcre2_real_parallel_match *pm, PCRE2_SIZE offset,
+  BOOL crlf)
+{
+PCRE2_SPTR p = pm->start_subject + offset;
+uint16_t nl = pm->code->newline_convention;
+
+if (offset >= pm->length) return pm->length + 1;
+
+if (crlf && (nl == PCRE2_NEWLINE_CRLF || nl == PCRE2_NEWLINE_ANY ||
+    nl == PCRE2_NEWLINE_ANYCRLF) &&
+    offset + 1 < pm->length && p[0] == CHAR_CR && p[1] == CHAR_NL)
+  return offset + 2;
+
+p++;
+#ifdef SUPPORT_UNICODE
+if ((pm->code->overall_options & PCRE2_UTF) != 0)
+  while (p < pm->end_subject && NOT_FIRSTCU(*p)) p++;
+#endif
+return (PCRE2_SIZE)(p - pm->start_subject);
+}
+
+
+
+/*************************************************
+*   Find the matches that start within a range   *
+*************************************************/
+
+/* This function runs a global search, in the same way as pcre2test's /g
+option, from the point recorded in the output block until a match would start
+beyond the limit. Each match is recorded as its start and end offsets, followed
+by the offset at which the search continues. The whole subject is always passed
+to the matching function, so lookbehinds and matches that extend beyond the
+limit work as they do in a sequential search.
+
+When a vector of matches from a chunk is given, a match that is the same as one
+of them, including where the search continues, means that the rest of the
+search would find the rest of the chunk's matches, so the search stops there.
+
+Arguments:
+  pm          points to the parallel match block
+  match_data  points to a match data block
+  mcontext    points to a match context, or is NULL
+  limit       the last offset at which a match may start
+  out         points to the block where the matches are recorded; its next
+                and flags fields say where to start, and are updated
+  sync        points to a chunk whose matches are already known, or is NULL
+  syncptr     where to put the index of the matching entry in sync
+
+Returns:      0 when the limit is reached
+              1 when a match that is in sync is found
+              < 0 on error
+*/
+
+static int
+search_range(pcre2_real_parallel_match *pm, pcre2_match_data *match_data,
+  pcre2_match_context *mcontext, PCRE2_SIZE limit, parallel_chunk *out,
+  const parallel_chunk *sync, PCRE2_SIZE *syncptr)
+{
+PCRE2_SIZE *ovector = match_data->ovector;
+PCRE2_SIZE pos = out->next;
+PCRE2_SIZE j = 0;
+uint32_t flags = out->flags;
+
+while (pos <= limit)
+  {
+  PCRE2_SIZE start, end, next, *entry;
+  int rc = PRIV(match_limited)((const pcre2_code *)pm->code, pm->start_subject,
+    pm->length, pos, pm->options | flags | PCRE2_NO_UTF_CHECK, match_data,
+    mcontext, limit);
+
+  /* Failing to match a non-empty string at the same point as an empty match
+  is not the end; the search continues one character further on. */
+
+  if (rc == PCRE2_ERROR_NOMATCH)
+    {
+    if (flags == 0)
+      {
+      pos = limit + 1;
+      break;
+      }
+    pos = advance_offset(pm, pos, TRUE);
+    flags = 0;
+    continue;
+    }
+  if (rc < 0) return rc;
+
+  start = ovector[0];
+  end = ovector[1];
+
+  if (start == end)
+    {
+    next = end;
+    flags = RETRY_OPTIONS;
+    }
+  else
+    {
+    next = (end <= match_data->startchar)?
+      advance_offset(pm, match_data->startchar, FALSE) : end;
+    flags = 0;
+    }
+
+  /* See if this match is one that the chunk has already found. */
+
+  if (sync != NULL)
+    {
+    PCRE2_SIZE k;
+    while (j < sync->count && sync->matches[3*j] < start) j++;
+    for (k = j; k < sync->count && sync->matches[3*k] == start; k++)
+      {
+      if (sync->matches[3*k+1] == end && sync->matches[3*k+2] == next)
+        {
+        *syncptr = k;
+        return 1;
+        }
+      }
+    }
+
+  if (out->count >= out->size &&
+      !grow_vector(pm, &(out->matches), &(out->size), out->count, 3))
+    return PCRE2_ERROR_NOMEMORY;
+
+  entry = out->matches + 3 * out->count++;
+  entry[0] = start;
+  entry[1] = end;
+  entry[2] = next;
+  pos = next;
+  }
+
+out->next = pos;
+out->flags = flags;
+return 0;
+}
+
+
+
+/*************************************************
+*   Add matches to the merged vector of results  *
+*************************************************/
+
+/* Arguments:
+  pm          points to the parallel match block
+  chunk       points to a block of matches
+  from        the index of the first match to add
+
+Returns:      TRUE if all is well, FALSE if memory could not be obtained
+*/
+
+static BOOL
+add_results(pcre2_real_parallel_match *pm, const parallel_chunk *chunk,
+  PCRE2_SIZE from)
+{
+PCRE2_SIZE i;
+for (i = from; i < chunk->count; i++)
+  {
+  if (pm->results_count >= pm->results_size &&
+      !grow_vector(pm, &(pm->results), &(pm->results_size), pm->results_count,
+        2))
+    return FALSE;
+  pm->results[2*pm->results_count] = chunk->matches[3*i];
+  pm->results[2*pm->results_count+1] = chunk->matches[3*i+1];
+  pm->results_count++;
+  }
+return TRUE;
+}
+
+
+
+/*************************************************
+*      Create a block for parallel matching      *
+*************************************************/
+
+/* The pattern is not copied, so it must not be freed while the block is in
+use. If no context is supplied, the memory allocator from the pattern is used.
+
+Arguments:
+  code        points to the compiled pattern
+  gcontext    points to a general context, for memory management, or is NULL
+
+Returns:      pointer to the new block, or NULL on error (NULL or invalid
+                pattern, or failure to get memory)
+*/
+
+PCRE2_EXP_DEFN pcre2_parallel_match * PCRE2_CALL_CONVENTION
+pcre2_parallel_match_create(const pcre2_code *code,
+  pcre2_general_context *gcontext)
+{
+const pcre2_real_code *re = (const pcre2_real_code *)code;
+pcre2_parallel_match *pm;
+
+if (re == NULL || re->magic_number != MAGIC_NUMBER ||
+    (re->flags & PCRE2_MODE_MASK) != PCRE2_CODE_UNIT_WIDTH/8)
+  return NULL;
+
+if (gcontext == NULL) gcontext = (pcre2_general_context *)code;
+pm = PRIV(memctl_malloc)(sizeof(pcre2_parallel_match),
+  (pcre2_memctl *)gcontext);
+if (pm == NULL) return NULL;
+
+pm->code = re;
+pm->start_subject = pm->end_subject = NULL;
+pm->length = 0;
+pm->chunks = NULL;
+pm->chunk_count = 0;
+pm->options = 0;
+pm->results = NULL;
+pm->results_size = pm->results_count = 0;
+return pm;
+}
+
+
+
+/*************************************************
+*       Free a block for parallel matching       *
+*************************************************/
+
+/* The pattern and the subject are not freed.
+
+Argument:  the block to be freed (may be NULL)
+Returns:   nothing
+*/
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_parallel_match_free(pcre2_parallel_match *pm)
+{
+if (pm != NULL)
+  {
+  free_chunks(pm);
+  if (pm->results != NULL)
+    pm->memctl.free(pm->results, pm->memctl.memory_data);
+  pm->memctl.free(pm, pm->memctl.memory_data);
+  }
+}
+
+
+
+/*************************************************
+*        Divide a subject into chunks            *
+*************************************************/
+
+/* Each chunk except the last is at least chunk_size code units long, and ends
+just after a newline, as defined by the pattern's newline convention. A CRLF
+newline is never split. Starting each chunk at the start of a line means that
+the start of match optimizations behave exactly as in a sequential search. If
+a match could depend on the offset at which searching starts (for example, if
+the pattern is anchored or contains \G, (*COMMIT), or (*SKIP)), the subject is
+not divided. Any previous subject and results are discarded. The subject is not
+copied, so it must remain available until all matching is complete.
+
+Arguments:
+  pm          points to the parallel match block
+  subject     points to the subject string
+  length      length of subject string
+  options     option bits
+  chunk_size  the minimum chunk size in code units; 0 means no division
+
+Returns:      > 0 => the number of chunks
+              < 0 => PCRE2_ERROR_NULL, PCRE2_ERROR_BADOPTION,
+                       PCRE2_ERROR_NOMEMORY, or a UTF error
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_parallel_match_split(pcre2_parallel_match *pm, PCRE2_SPTR subject,
+  PCRE2_SIZE length, uint32_t options, PCRE2_SIZE chunk_size)
+{
+const pcre2_real_code *re;
+parallel_chunk *chunk;
+PCRE2_SIZE start, max_chunks;
+BOOL utf;
+
+if (pm == NULL || subject == NULL) return PCRE2_ERROR_NULL;
+if ((options & ~PUBLIC_PARALLEL_MATCH_OPTIONS) != 0)
+  return PCRE2_ERROR_BADOPTION;
+
+re = pm->code;
+utf = (re->overall_options & PCRE2_UTF) != 0;
+if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(subject);
+
+/* Check a UTF string once, so that the searches in the chunks need not. */
+
+#ifdef SUPPORT_UNICODE
+if (utf && (options & PCRE2_NO_UTF_CHECK) == 0)
+  {
+  PCRE2_SIZE erroroffset;
+  int rc = PRIV(valid_utf)(subject, length, &erroroffset);
+  if (rc != 0) return rc;
+  }
+#endif
+
+free_chunks(pm);
+pm->results_count = 0;
+pm->start_subject = subject;
+pm->end_subject = subject + length;
+pm->length = length;
+pm->options = options;
+
+/* Do not divide the subject if a match could depend on the starting offset.
+Otherwise ensure that the number of chunks fits in an int. */
+
+if ((re->overall_options & (PCRE2_ANCHORED|PCRE2_FIRSTLINE)) != 0 ||
+    (options & (PCRE2_ANCHORED|PCRE2_NOTEMPTY_ATSTART)) != 0 ||
+    (re->flags & (PCRE2_STARTDEP|PCRE2_NE_ATST_SET)) != 0)
+  chunk_size = 0;
+
+if (chunk_size == 0 || chunk_size >= length) max_chunks = 1; else
+  {
+  if (length / chunk_size >= INT_MAX) chunk_size = length / (INT_MAX - 1);
+  max_chunks = length / chunk_size + 1;
+  }
+
+pm->chunks = pm->memctl.malloc(max_chunks * sizeof(parallel_chunk),
+  pm->memctl.memory_data);
+if (pm->chunks == NULL) return PCRE2_ERROR_NOMEMORY;
+
+/* Set up the newline information, as in pcre2_match(). */
+
+pm->nltype = NLTYPE_FIXED;
+switch(re->newline_convention)
+  {
+  case PCRE2_NEWLINE_CR:
+  pm->nllen = 1;
+  pm->nl[0] = CHAR_CR;
+  break;
+
+  case PCRE2_NEWLINE_LF:
+  pm->nllen = 1;
+  pm->nl[0] = CHAR_NL;
+  break;
+
+  case PCRE2_NEWLINE_NUL:
+  pm->nllen = 1;
+  pm->nl[0] = CHAR_NUL;
+  break;
+
+  case PCRE2_NEWLINE_CRLF:
+  pm->nllen = 2;
+  pm->nl[0] = CHAR_CR;
+  pm->nl[1] = CHAR_NL;
+  break;
+
+  case PCRE2_NEWLINE_ANY:
+  pm->nltype = NLTYPE_ANY;
+  break;
+
+  case PCRE2_NEWLINE_ANYCRLF:
+  pm->nltype = NLTYPE_ANYCRLF;
+  break;
+
+  default: return PCRE2_ERROR_INTERNAL;
+  }
+
+/* Find the chunk boundaries. */
+
+start = 0;
+for (;;)
+  {
+  PCRE2_SPTR p;
+
+  chunk = pm->chunks + pm->chunk_count++;
+  chunk->match_data = NULL;
+  chunk->matches = NULL;
+  chunk->size = chunk->count = 0;
+  chunk->start = chunk->next = start;
+  chunk->flags = 0;
+  chunk->rc = 1;
+
+  if (max_chunks == 1 || length - start <= chunk_size) break;
+
+  for (p = subject + start + chunk_size; p < pm->end_subject; p++)
+    {
+#ifdef SUPPORT_UNICODE
+    if (utf && NOT_FIRSTCU(*p)) continue;
+#endif
+    if (IS_NEWLINE(p)) break;
+    }
+
+  if (p >= pm->end_subject) break;
+  start = (PCRE2_SIZE)(p - subject) + pm->nllen;
+  if (start >= length) break;
+  chunk->limit = start - 1;
+  }
+
+chunk->limit = length;
+
+/* When the newline convention includes CRLF and the pattern contains no
+explicit CR or LF, the interpreter does not start a match at the LF of a CRLF
+after advancing over the CR. JIT does not always follow this rule, and it
+applies the offset limit before it does, so the matches that it finds near the
+end of a chunk may differ from those of a sequential search. The chunks of such
+a subject are therefore searched by the interpreter. */
+
+if ((re->flags & PCRE2_HASCRORLF) == 0 && pm->chunk_count > 1 &&
+    (re->newline_convention == PCRE2_NEWLINE_CRLF ||
+     re->newline_convention == PCRE2_NEWLINE_ANY ||
+     re->newline_convention == PCRE2_NEWLINE_ANYCRLF))
+  pm->options |= PCRE2_NO_JIT;
+
+return (int)pm->chunk_count;
+}
+
+
+
+/*************************************************
+*       Find the matches in one chunk            *
+*************************************************/
+
+/* This function finds the matches that start within one chunk, as if a
+global search started at the beginning of the chunk. Different chunks may be
+run at the same time in different threads, provided that the memory management
+functions and any callout function are thread-safe, but each chunk must be run
+in only one thread. A chunk may be run again, discarding its previous matches.
+
+Arguments:
+  pm          points to the parallel match block
+  index       the number of the chunk, starting at zero
+  mcontext    points to a match context, or is NULL
+
+Returns:      0 if all is well, or a negative error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_parallel_match_run(pcre2_parallel_match *pm, uint32_t index,
+  pcre2_match_context *mcontext)
+{
+parallel_chunk *chunk;
+
+if (pm == NULL) return PCRE2_ERROR_NULL;
+if (index >= pm->chunk_count) return PCRE2_ERROR_BADDATA;
+chunk = pm->chunks + index;
+
+if (chunk->match_data == NULL)
+  {
+  chunk->match_data = pcre2_match_data_create(1, (pcre2_general_context *)pm);
+  if (chunk->match_data == NULL) return PCRE2_ERROR_NOMEMORY;
+  }
+
+chunk->count = 0;
+chunk->next = chunk->start;
+chunk->flags = 0;
+chunk->rc = search_range(pm, chunk->match_data, mcontext, chunk->limit, chunk,
+  NULL, NULL);
+return chunk->rc;
+}
+
+
+
+/*************************************************
+*    Merge the matches from all the chunks       *
+*************************************************/
+
+/* The chunks are processed in order, running any that have not yet been run.
+When the sequential search that is being reproduced would start a chunk at the
+same point as the chunk's own search, the chunk's matches are taken as they
+are. Otherwise (for example, when a match extends from one chunk into the
+next), the search is continued into the chunk until one of its matches is
+found, after which the two searches are the same. This function must not be
+called while any chunk is being run.
+
+Arguments:
+  pm          points to the parallel match block
+  mcontext    points to a match context, or is NULL
+
+Returns:      0 if all is well, or a negative error code
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_parallel_match_merge(pcre2_parallel_match *pm,
+  pcre2_match_context *mcontext)
+{
+int rc = 0;
+uint32_t i;
+PCRE2_SIZE pos = 0;
+uint32_t flags = 0;
+parallel_chunk extra;
+
+if (pm == NULL) return PCRE2_ERROR_NULL;
+if (pm->chunks == NULL) return PCRE2_ERROR_BADDATA;
+
+pm->results_count = 0;
+extra.matches = NULL;
+extra.size = 0;
+
+for (i = 0; i < pm->chunk_count; i++)
+  {
+  parallel_chunk *chunk = pm->chunks + i;
+  PCRE2_SIZE from = 0;
+
+  rc = (chunk->rc > 0)? pcre2_parallel_match_run(pm, i, mcontext) : chunk->rc;
+  if (rc < 0) break;
+
+  /* Skip a chunk that the previous matches have passed. */
+
+  if (pos > chunk->limit) continue;
+
+  /* Continue the sequential search into the chunk if necessary. */
+
+  if (pos != chunk->start || flags != 0)
+    {
+    extra.count = 0;
+    extra.next = pos;
+    extra.flags = flags;
+    rc = search_range(pm, chunk->match_data, mcontext, chunk->limit, &extra,
+      chunk, &from);
+    if (rc < 0) break;
+    if (!add_results(pm, &extra, 0))
+      {
+      rc = PCRE2_ERROR_NOMEMORY;
+      break;
+      }
+    if (rc == 0)
+      {
+      pos = extra.next;
+      flags = extra.flags;
+      continue;
+      }
+    rc = 0;
+    }
+
+  if (!add_results(pm, chunk, from))
+    {
+    rc = PCRE2_ERROR_NOMEMORY;
+    break;
+    }
+  pos = chunk->next;
+  flags = chunk->flags;
+  }
+
+if (extra.matches != NULL)
+  pm->memctl.free(extra.matches, pm->memctl.memory_data);
+if (rc < 0) pm->results_count = 0;
+return rc;
+}
+
+
+
+/*************************************************
+*     Get the number of merged matches           *
+*************************************************/
+
+PCRE2_EXP_DEFN PCRE2_SIZE PCRE2_CALL_CONVENTION
+pcre2_parallel_match_count(pcre2_parallel_match *pm)
+{
+return pm->results_count;
+}
+
+
+
+/*************************************************
+*     Get a pointer to the merged matches        *
+*************************************************/
+
+/* The vector contains a pair of offsets for each match, in the same order
+as a sequential global search would find them. */
+
+PCRE2_EXP_DEFN PCRE2_SIZE * PCRE2_CALL_CONVENTION
+pcre2_parallel_match_ovector(pcre2_parallel_match *pm)
+{
+return pm->results;
+}
+
+/* End of pcre2_parallel_match.c */
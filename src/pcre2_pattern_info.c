@@ -73,6 +73,7 @@ if (where == NULL)   /* Requests field length */
     case PCRE2_INFO_ALLOPTIONS:
     case PCRE2_INFO_ARGOPTIONS:
     case PCRE2_INFO_BACKREFMAX:
+    case PCRE2_INFO_BITPARALLEL:
     case PCRE2_INFO_BSR:
     case PCRE2_INFO_CAPTURECOUNT:
     case PCRE2_INFO_DEPTHLIMIT:
@@ -131,6 +132,10 @@ switch(what)
   *((uint32_t *)where) = re->top_backref;
   break;
 
+  case PCRE2_INFO_BITPARALLEL:
+  *((uint32_t *)where) = re->glushkov != NULL;
+  break;
+
   case PCRE2_INFO_BSR:
   *((uint32_t *)where) = re->bsr_convention;
   break;
@@ -0,0 +1,448 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2017 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+/* This module contains functions for building a set of compiled patterns and
+matching a subject against all of them at once. The patterns in a set are
+still matched individually by pcre2_match(), but a single pass over the subject
+is used to find the code units that are present, and this is then used with
+each pattern's starting and required code unit information to skip patterns
+that cannot possibly match. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* The options that may be passed to pcre2_pattern_set_match(). Partial
+matching is not supported, because a pattern can partially match a subject that
+does not contain its starting code unit. */
+
+#define PUBLIC_PATTERN_SET_MATCH_OPTIONS \
+  (PCRE2_ANCHORED|PCRE2_ENDANCHORED|PCRE2_NOTBOL|PCRE2_NOTEOL|PCRE2_NOTEMPTY| \
+   PCRE2_NOTEMPTY_ATSTART|PCRE2_NO_UTF_CHECK|PCRE2_NO_JIT)
+
+/* The number of patterns for which the vector of candidate flags is kept on
+the system stack during matching. Larger sets get a vector from the heap. */
+
+#define CANDIDATE_STACK_BITS 8192
+
+/* Macros for handling the 256-bit maps of code unit values. When code units
+are wider than 8 bits, all values greater than 254 use the 255 bit, which is
+the same convention as the start_bitmap in a compiled pattern. */
+
+#if PCRE2_CODE_UNIT_WIDTH == 8
+#define MAPBIT(c) (c)
+#else
+#define MAPBIT(c) (((c) > 255)? 255 : (c))
+#endif
+
+#define SETMAPBIT(map, c) map[MAPBIT(c)/8] |= (uint8_t)(1u << (MAPBIT(c)&7))
+#define TESTMAPBIT(map, c) ((map[MAPBIT(c)/8] & (1u << (MAPBIT(c)&7))) != 0)
+
+
+
+/*************************************************
+*    Check whether two 256-bit maps intersect    *
+*************************************************/
+
+static BOOL
+maps_intersect(const uint8_t *a, const uint8_t *b)
+{
+int i;
+for (i = 0; i < 32; i++) if ((a[i] & b[i]) != 0) return TRUE;
+return FALSE;
+}
+
+
+
+/*************************************************
+*          Create a set of compiled patterns     *
+*************************************************/
+
+/* Each pattern is classified according to the information that was recorded
+when it was compiled. Patterns with a single caseful first code unit are listed
+in a "bucket" for that code unit; patterns with a caseless first code unit or a
+start bitmap are checked against the subject's map of code units; all others
+(for example, anchored patterns) are always run. The patterns themselves are
+not copied, so they must not be freed while the set is in use.
+
+Arguments:
+  codes       points to a vector of compiled patterns
+  count       the number of patterns in the vector
+  gcontext    points to a general context, for memory management, or is NULL
+
+Returns:      pointer to the new set, or NULL on error (NULL or invalid
+                pattern, or failure to get memory)
+*/
+
+PCRE2_EXP_DEFN pcre2_pattern_set * PCRE2_CALL_CONVENTION
+pcre2_pattern_set_create(const pcre2_code **codes, uint32_t count,
+  pcre2_general_context *gcontext)
+{
+pcre2_pattern_set *set;
+uint32_t bucket_count[256];
+uint32_t bucket_total = 0;
+uint32_t bitmap_count = 0;
+uint32_t always_count = 0;
+uint32_t i, c;
+size_t size;
+
+if (codes == NULL || count == 0) return NULL;
+memset(bucket_count, 0, sizeof(bucket_count));
+
+/* First pass: check the patterns, and count the entries that are needed for
+each list. */
+
+for (i = 0; i < count; i++)
+  {
+  const pcre2_real_code *re = (const pcre2_real_code *)(codes[i]);
+  if (re == NULL || re->magic_number != MAGIC_NUMBER ||
+      (re->flags & PCRE2_MODE_MASK) != PCRE2_CODE_UNIT_WIDTH/8)
+    return NULL;
+
+  if ((re->overall_options & (PCRE2_ANCHORED|PCRE2_NO_START_OPTIMIZE)) != 0)
+    always_count++;
+  else if ((re->flags & (PCRE2_FIRSTSET|PCRE2_FIRSTCASELESS)) == PCRE2_FIRSTSET)
+    bucket_count[MAPBIT(re->first_codeunit)]++;
+  else if ((re->flags & PCRE2_FIRSTSET) != 0 ||
+           ((re->flags & (PCRE2_FIRSTMAPSET|PCRE2_STARTLINE)) ==
+             PCRE2_FIRSTMAPSET))
+    bitmap_count++;
+  else always_count++;
+  }
+
+for (c = 0; c < 256; c++) bucket_total += bucket_count[c];
+
+/* Get one block of memory for the set and all its vectors. The entry vector
+comes first, because it contains pointers. */
+
+size = sizeof(pcre2_pattern_set) + count * sizeof(pattern_set_entry) +
+  (bucket_total + bitmap_count + always_count) * sizeof(uint32_t);
+
+set = PRIV(memctl_malloc)(size, (pcre2_memctl *)gcontext);
+if (set == NULL) return NULL;
+
+set->entries = (pattern_set_entry *)((char *)set + sizeof(pcre2_pattern_set));
+set->bucket_ids = (uint32_t *)(set->entries + count);
+set->bitmap_ids = set->bucket_ids + bucket_total;
+set->always_ids = set->bitmap_ids + bitmap_count;
+set->count = count;
+set->bitmap_count = 0;
+set->always_count = 0;
+memset(set->start_bitmap, 0, 32);
+
+/* Turn the counts into starting offsets, leaving bucket_start[c+1] pointing
+to the start of bucket c while it is being filled. */
+
+set->bucket_start[0] = set->bucket_start[1] = 0;
+for (c = 1; c < 256; c++)
+  set->bucket_start[c+1] = set->bucket_start[c] + bucket_count[c-1];
+
+/* Second pass: fill in the entries and the lists. */
+
+for (i = 0; i < count; i++)
+  {
+  const pcre2_real_code *re = (const pcre2_real_code *)(codes[i]);
+  pattern_set_entry *entry = set->entries + i;
+  const uint8_t *fcc = re->tables + fcc_offset;
+#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 8
+  BOOL utf = (re->overall_options & PCRE2_UTF) != 0;
+#endif
+
+  entry->code = re;
+  entry->has_req_cu = FALSE;
+  entry->req_cu = entry->req_cu2 = 0;
+  memset(entry->start_bitmap, 0, 32);
+
+  /* The required code unit and its other case are computed in the same way
+  as in pcre2_match(). */
+
+  if ((re->flags & PCRE2_LASTSET) != 0)
+    {
+    entry->has_req_cu = TRUE;
+    entry->req_cu = entry->req_cu2 = re->last_codeunit;
+    if ((re->flags & PCRE2_LASTCASELESS) != 0)
+      {
+      entry->req_cu2 = TABLE_GET(re->last_codeunit, fcc, re->last_codeunit);
+#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 8
+      if (utf && re->last_codeunit > 127)
+        entry->req_cu2 = UCD_OTHERCASE(re->last_codeunit);
+#endif
+      }
+    }
+
+  if ((re->overall_options & (PCRE2_ANCHORED|PCRE2_NO_START_OPTIMIZE)) != 0)
+    {
+    entry->type = PSET_ALWAYS;
+    set->always_ids[set->always_count++] = i;
+    }
+
+  else if ((re->flags & PCRE2_FIRSTSET) != 0)
+    {
+    uint32_t first_cu = re->first_codeunit;
+    SETMAPBIT(set->start_bitmap, first_cu);
+    SETMAPBIT(entry->start_bitmap, first_cu);
+
+    if ((re->flags & PCRE2_FIRSTCASELESS) == 0)
+      {
+      entry->type = PSET_FIRSTCU;
+      c = MAPBIT(first_cu);
+      set->bucket_ids[set->bucket_start[c+1]++] = i;
+      }
+    else
+      {
+      uint32_t first_cu2 = TABLE_GET(first_cu, fcc, first_cu);
+#if defined SUPPORT_UNICODE && PCRE2_CODE_UNIT_WIDTH != 8
+      if (utf && first_cu > 127) first_cu2 = UCD_OTHERCASE(first_cu);
+#endif
+      SETMAPBIT(set->start_bitmap, first_cu2);
+      SETMAPBIT(entry->start_bitmap, first_cu2);
+      entry->type = PSET_BITMAP;
+      set->bitmap_ids[set->bitmap_count++] = i;
+      }
+    }
+
+  else if ((re->flags & (PCRE2_FIRSTMAPSET|PCRE2_STARTLINE)) ==
+             PCRE2_FIRSTMAPSET)
+    {
+    for (c = 0; c < 32; c++) set->start_bitmap[c] |= re->start_bitmap[c];
+    memcpy(entry->start_bitmap, re->start_bitmap, 32);
+    entry->type = PSET_BITMAP;
+    set->bitmap_ids[set->bitmap_count++] = i;
+    }
+
+  else
+    {
+    entry->type = PSET_ALWAYS;
+    set->always_ids[set->always_count++] = i;
+    }
+  }
+
+return set;
+}
+
+
+
+/*************************************************
+*            Free a set of patterns              *
+*************************************************/
+
+/* The patterns themselves are not freed.
+
+Argument:  the set to be freed (may be NULL)
+Returns:   nothing
+*/
+
+PCRE2_EXP_DEFN void PCRE2_CALL_CONVENTION
+pcre2_pattern_set_free(pcre2_pattern_set *set)
+{
+if (set != NULL)
+  set->memctl.free(set, set->memctl.memory_data);
+}
+
+
+
+/*************************************************
+*     Match a subject against a set of patterns  *
+*************************************************/
+
+/* The subject is scanned once to build a map of the code units that it
+contains from the starting offset onwards. When the match is anchored, only the
+code unit at the starting offset can start a match, so a separate map is used
+for that. The patterns whose starting code units are present are then run in
+ID order, after checking their required code unit and minimum length. The
+match data block is used for each call of pcre2_match(), so after this
+function returns it contains the result of whichever pattern was run last.
+
+Arguments:
+  set             points to the pattern set
+  subject         points to the subject string
+  length          length of subject string
+  start_offset    where to start in the subject string
+  options         option bits
+  match_data      points to a match data block
+  mcontext        points to a match context, or is NULL
+  ids             where to put the IDs of matching patterns (may be NULL)
+  idcount         the number of elements in the ids vector
+
+Returns:          >= 0 => the number of patterns that matched (this may be
+                            greater than idcount, in which case only the first
+                            idcount IDs are stored)
+                   < 0 => an error from pcre2_match() or one of:
+                            PCRE2_ERROR_NULL, PCRE2_ERROR_BADOPTION,
+                            PCRE2_ERROR_BADOFFSET, PCRE2_ERROR_NOMEMORY
+*/
+
+PCRE2_EXP_DEFN int PCRE2_CALL_CONVENTION
+pcre2_pattern_set_match(const pcre2_pattern_set *set, PCRE2_SPTR subject,
+  PCRE2_SIZE length, PCRE2_SIZE start_offset, uint32_t options,
+  pcre2_match_data *match_data, pcre2_match_context *mcontext, uint32_t *ids,
+  uint32_t idcount)
+{
+int yield = 0;
+uint32_t i, c;
+uint32_t stack_candidates[CANDIDATE_STACK_BITS/32];
+uint32_t *candidates = stack_candidates;
+uint8_t present[32];
+uint8_t anchored_start[32];
+const uint8_t *start_map = present;
+PCRE2_SPTR p, end_subject;
+
+if (set == NULL || subject == NULL || match_data == NULL)
+  return PCRE2_ERROR_NULL;
+if ((options & ~PUBLIC_PATTERN_SET_MATCH_OPTIONS) != 0)
+  return PCRE2_ERROR_BADOPTION;
+if (ids == NULL) idcount = 0;
+
+if (length == PCRE2_ZERO_TERMINATED) length = PRIV(strlen)(subject);
+if (start_offset > length) return PCRE2_ERROR_BADOFFSET;
+end_subject = subject + length;
+
+/* Build the map of code units that are present in the subject. */
+
+memset(present, 0, 32);
+for (p = subject + start_offset; p < end_subject; p++)
+  {
+  c = *p;
+  SETMAPBIT(present, c);
+  }
+
+/* For an anchored match, only the first code unit can start a match. */
+
+if ((options & PCRE2_ANCHORED) != 0)
+  {
+  memset(anchored_start, 0, 32);
+  if (start_offset < length)
+    {
+    c = subject[start_offset];
+    SETMAPBIT(anchored_start, c);
+    }
+  start_map = anchored_start;
+  }
+
+/* If there are no patterns that must always be run, and no possible starting
+code unit is present, nothing can match. */
+
+if (set->always_count == 0 && !maps_intersect(start_map, set->start_bitmap))
+  return 0;
+
+/* Get a vector of candidate flags that is big enough for the set. */
+
+if (set->count > CANDIDATE_STACK_BITS)
+  {
+  candidates = set->memctl.malloc(((set->count + 31)/32) * sizeof(uint32_t),
+    set->memctl.memory_data);
+  if (candidates == NULL) return PCRE2_ERROR_NOMEMORY;
+  }
+memset(candidates, 0, ((set->count + 31)/32) * sizeof(uint32_t));
+
+/* Flag the candidate patterns. */
+
+for (c = 0; c < 256; c++)
+  {
+  if ((start_map[c/8] & (1u << (c&7))) != 0)
+    {
+    for (i = set->bucket_start[c]; i < set->bucket_start[c+1]; i++)
+      {
+      uint32_t id = set->bucket_ids[i];
+      candidates[id/32] |= 1u << (id&31);
+      }
+    }
+  }
+
+for (i = 0; i < set->bitmap_count; i++)
+  {
+  uint32_t id = set->bitmap_ids[i];
+  if (maps_intersect(start_map, set->entries[id].start_bitmap))
+    candidates[id/32] |= 1u << (id&31);
+  }
+
+for (i = 0; i < set->always_count; i++)
+  {
+  uint32_t id = set->always_ids[i];
+  candidates[id/32] |= 1u << (id&31);
+  }
+
+/* Run the candidates in ID order. */
+
+for (i = 0; i < set->count; i++)
+  {
+  int rc;
+  const pattern_set_entry *entry;
+
+  if ((candidates[i/32] & (1u << (i&31))) == 0)
+    {
+    if (candidates[i/32] == 0) i |= 31;    /* Skip an empty word */
+    continue;
+    }
+
+  entry = set->entries + i;
+
+  /* The required code unit must be present, and there must be enough of the
+  subject left for the minimum length of match. */
+
+  if (entry->has_req_cu && !TESTMAPBIT(present, entry->req_cu) &&
+      !TESTMAPBIT(present, entry->req_cu2))
+    continue;
+  if (length - start_offset < entry->code->minlength) continue;
+
+  rc = pcre2_match((const pcre2_code *)entry->code, subject, length,
+    start_offset, options, match_data, mcontext);
+
+  if (rc >= 0)
+    {
+    if ((uint32_t)yield < idcount) ids[yield] = i;
+    yield++;
+    }
+  else if (rc != PCRE2_ERROR_NOMATCH)
+    {
+    yield = rc;
+    break;
+    }
+  }
+
+if (candidates != stack_candidates)
+  set->memctl.free(candidates, set->memctl.memory_data);
+return yield;
+}
+
+/* End of pcre2_pattern_set.c */
@@ -0,0 +1,1478 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2017 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+
+/* This module contains the linear-time matcher that pcre2_match() uses for a
+pattern compiled with PCRE2_EXTRA_LINEAR. The compiled pattern is turned into a
+program for a Pike virtual machine. All the threads of a match advance through
+the subject together, one character at a time, and they are kept in the order
+in which the interpreter would try the alternatives, so the first thread to
+reach the end of the pattern finds the match (and the captured substrings) that
+backtracking would find. Only one thread is kept for each instruction, so the
+time taken is proportional to the length of the subject multiplied by the size
+of the program, whatever the pattern. Items that need backtracking, such as
+back references, recursion, lookaround assertions, atomic groups, possessive
+quantifiers, and backtracking verbs, are rejected when the pattern is
+compiled. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define NLBLOCK mb             /* Block containing newline information */
+#define PSSTART start_subject  /* Field containing processed string start */
+#define PSEND   end_subject    /* Field containing processed string end */
+
+#include "pcre2_internal.h"
+
+/* Instructions */
+
+enum { PIKEVM_CHAR,      /* Match a single-character item */
+       PIKEVM_MATCH,     /* The end of the pattern */
+       PIKEVM_JUMP,      /* Continue at "next" */
+       PIKEVM_SPLIT,     /* Try "next", then "alt" */
+       PIKEVM_LOOP,      /* Greedy repeat of a group that may be empty */
+       PIKEVM_LOOPMIN,   /* Lazy repeat of a group that may be empty */
+       PIKEVM_OPEN,      /* Start of a capturing group */
+       PIKEVM_CLOSE,     /* End of a capturing group */
+       PIKEVM_MARK,      /* Start of an iteration of a group */
+       PIKEVM_ASSERT,    /* A simple assertion */
+       PIKEVM_FAIL };    /* (*FAIL) */
+
+/* The fixed slots of a thread */
+
+#define SLOT_START      0      /* Start of the match */
+#define SLOT_TOP        1      /* Highwater mark of the ovector */
+#define SLOT_OVECTOR    2      /* First captured substring */
+
+/* A slot value in a stack entry that means "try this instruction" rather than
+"restore this slot" */
+
+#define EXPLORE  0xffffffffu
+
+/* Data that is passed around while a program is being built */
+
+typedef struct build_block {
+  pcre2_memctl *memctl;           /* For getting memory */
+  const uint8_t *fcc;             /* Case-flipping table */
+  const uint8_t *ctypes;          /* Character types table */
+  pikevm_inst *insts;             /* Instructions so far */
+  uint32_t count;                 /* Number of instructions */
+  uint32_t size;                  /* Size of the vector */
+  uint32_t loop_count;            /* Groups that need an empty check */
+  uint32_t loop_base;             /* First slot for these groups */
+  uint32_t loop;                  /* Slot of the innermost one, or 0 */
+  uint32_t depth;                 /* Current nesting of these groups */
+  uint32_t max_depth;             /* Deepest nesting */
+  int error;                      /* PIKEVM_OK or a reason for failure */
+  BOOL utf;                       /* UTF mode */
+} build_block;
+
+/* A list of threads, which wait at instructions that consume a character or
+at the end of the pattern. The dense vector holds the instruction numbers in
+order of priority; the sparse vector gives the place of each instruction in the
+dense vector, and the slots of a thread are indexed by instruction number. The
+states that have been reached at the list's position are held in the same way;
+see add_thread() below. */
+
+typedef struct thread_list {
+  uint32_t count;
+  uint32_t *dense;
+  uint32_t *sparse;
+  PCRE2_SIZE *slots;
+  uint32_t seen_count;
+  uint32_t *seen_dense;
+  uint32_t *seen_sparse;
+} thread_list;
+
+/* An entry in the stack that add_thread() uses instead of recursion */
+
+typedef struct stack_entry {
+  PCRE2_SIZE value;               /* Value to restore */
+  uint32_t pc;                    /* Instruction to try */
+  uint32_t slot;                  /* Slot to restore, or EXPLORE */
+} stack_entry;
+
+
+
+/*************************************************
+*       Test a character against an item         *
+*************************************************/
+
+/* This function is used for characters greater than 255 when matching, and
+when the bitmap of an item is being set up. Newline checking for OP_ANY is done
+by the caller, because it depends on the subject.
+
+Arguments:
+  in          the instruction
+  c           the character
+  ctypes      the character types table
+  utf         TRUE in UTF mode
+
+Returns:      TRUE if the character matches
+*/
+
+#ifdef SUPPORT_UNICODE
+static BOOL
+has_property(uint32_t c, uint32_t ptype, uint32_t pvalue)
+{
+const uint32_t *cp;
+const ucd_record *prop = GET_UCD(c);
+
+switch(ptype)
+  {
+  case PT_ANY:
+  return TRUE;
+
+  case PT_LAMP:
+  return prop->chartype == ucp_Lu || prop->chartype == ucp_Ll ||
+         prop->chartype == ucp_Lt;
+
+  case PT_GC:
+  return pvalue == PRIV(ucp_gentype)[prop->chartype];
+
+  case PT_PC:
+  return pvalue == prop->chartype;
+
+  case PT_SC:
+  return pvalue == prop->script;
+
+  case PT_ALNUM:
+  return PRIV(ucp_gentype)[prop->chartype] == ucp_L ||
+         PRIV(ucp_gentype)[prop->chartype] == ucp_N;
+
+  case PT_SPACE:    /* Perl space */
+  case PT_PXSPACE:  /* POSIX space */
+  switch(c)
+    {
+    HSPACE_CASES:
+    VSPACE_CASES:
+    return TRUE;
+
+    default:
+    return PRIV(ucp_gentype)[prop->chartype] == ucp_Z;
+    }
+
+  case PT_WORD:
+  return PRIV(ucp_gentype)[prop->chartype] == ucp_L ||
+         PRIV(ucp_gentype)[prop->chartype] == ucp_N ||
+         c == CHAR_UNDERSCORE;
+
+  case PT_CLIST:
+  cp = PRIV(ucd_caseless_sets) + pvalue;
+  for (;;)
+    {
+    if (c < *cp) return FALSE;
+    if (c == *cp++) return TRUE;
+    }
+
+  case PT_UCNC:
+  return c == CHAR_DOLLAR_SIGN || c == CHAR_COMMERCIAL_AT ||
+         c == CHAR_GRAVE_ACCENT || (c >= 0xa0 && c <= 0xd7ff) ||
+         c >= 0xe000;
+
+  default:
+  return FALSE;
+  }
+}
+#endif  /* SUPPORT_UNICODE */
+
+
+static BOOL
+match_char(const pikevm_inst *in, uint32_t c, const uint8_t *ctypes, BOOL utf)
+{
+switch(in->arg)
+  {
+  case OP_CHAR:
+  case OP_CHARI:
+  return c == in->c || c == in->oc;
+
+  case OP_NOT:
+  case OP_NOTI:
+  return c != in->c && c != in->oc;
+
+  case OP_NOT_DIGIT:
+  return c > 255 || (ctypes[c] & ctype_digit) == 0;
+
+  case OP_DIGIT:
+  return c <= 255 && (ctypes[c] & ctype_digit) != 0;
+
+  case OP_NOT_WHITESPACE:
+  return c > 255 || (ctypes[c] & ctype_space) == 0;
+
+  case OP_WHITESPACE:
+  return c <= 255 && (ctypes[c] & ctype_space) != 0;
+
+  case OP_NOT_WORDCHAR:
+  return c > 255 || (ctypes[c] & ctype_word) == 0;
+
+  case OP_WORDCHAR:
+  return c <= 255 && (ctypes[c] & ctype_word) != 0;
+
+  case OP_ANY:
+  case OP_ALLANY:
+  case OP_ANYBYTE:
+  return TRUE;
+
+  case OP_NOT_HSPACE:
+  case OP_HSPACE:
+  switch(c)
+    {
+    HSPACE_CASES: return in->arg == OP_HSPACE;
+    default: return in->arg != OP_HSPACE;
+    }
+
+  case OP_NOT_VSPACE:
+  case OP_VSPACE:
+  switch(c)
+    {
+    VSPACE_CASES: return in->arg == OP_VSPACE;
+    default: return in->arg != OP_VSPACE;
+    }
+
+#ifdef SUPPORT_UNICODE
+  case OP_PROP:
+  case OP_NOTPROP:
+  return has_property(c, in->data[0], in->data[1]) == (in->arg == OP_PROP);
+#endif
+
+  case OP_CLASS:
+  case OP_NCLASS:
+  if (c > 255) return in->arg == OP_NCLASS;
+  return (((const uint8_t *)in->data)[c/8] & (1u << (c%8))) != 0;
+
+#ifdef SUPPORT_WIDE_CHARS
+  case OP_XCLASS:
+  return PRIV(xclass)(c, in->data, utf);
+#endif
+
+  default:
+  (void)utf;
+  return FALSE;
+  }
+}
+
+
+
+/*************************************************
+*            Add an instruction                  *
+*************************************************/
+
+/* The vector of instructions is extended as necessary. The new instruction
+continues with the one after it unless its "next" field is changed.
+
+Arguments:
+  bb          the build block
+  op          the instruction code
+
+Returns:      the number of the instruction, or PIKEVM_MAX_INSTS on error
+*/
+
+static uint32_t
+emit(build_block *bb, uint32_t op)
+{
+pikevm_inst *in;
+
+if (bb->count >= PIKEVM_MAX_INSTS)
+  {
+  bb->error = PIKEVM_TOO_LARGE;
+  return PIKEVM_MAX_INSTS;
+  }
+
+if (bb->count >= bb->size)
+  {
+  uint32_t size = (bb->size == 0)? 64 : 2 * bb->size;
+  pikevm_inst *new_insts;
+  if (size > PIKEVM_MAX_INSTS) size = PIKEVM_MAX_INSTS;
+  new_insts = bb->memctl->malloc(size * sizeof(pikevm_inst),
+    bb->memctl->memory_data);
+  if (new_insts == NULL)
+    {
+    bb->error = PIKEVM_NOMEMORY;
+    return PIKEVM_MAX_INSTS;
+    }
+  if (bb->insts != NULL)
+    {
+    memcpy(new_insts, bb->insts, bb->count * sizeof(pikevm_inst));
+    bb->memctl->free(bb->insts, bb->memctl->memory_data);
+    }
+  bb->insts = new_insts;
+  bb->size = size;
+  }
+
+in = bb->insts + bb->count;
+memset(in, 0, sizeof(pikevm_inst));
+in->op = op;
+in->next = bb->count + 1;
+in->loop = bb->loop;
+return bb->count++;
+}
+
+
+
+/*************************************************
+*       Decode a single-character item           *
+*************************************************/
+
+/* This function handles the opcodes for single characters, types, and
+classes, with or without a repeat. A possessive repeat cannot have been created
+by auto-possessification, which is not done for a linear pattern, so it is one
+that was written in the pattern and is not supported.
+
+Arguments:
+  bb          the build block
+  code        points to the opcode
+  item        where to put the item's instruction
+  pmin        where to put the minimum repeat
+  pmax        where to put the maximum repeat, or GLUSHKOV_UNLIMITED
+  plazy       where to put TRUE for a lazy repeat
+
+Returns:      pointer after the item, or NULL if it is not supported
+*/
+
+static PCRE2_SPTR
+decode_type(build_block *bb, PCRE2_SPTR code, pikevm_inst *item)
+{
+switch(*code)
+  {
+  case OP_ANYNL:
+  case OP_EXTUNI:
+  return NULL;
+
+  case OP_ANYBYTE:
+  if (bb->utf) return NULL;
+  break;
+
+  case OP_PROP:
+  case OP_NOTPROP:
+  item->arg = *code;
+  item->data = code + 1;
+  return code + 3;
+
+  default:
+  if (*code < OP_NOT_DIGIT || *code > OP_VSPACE) return NULL;
+  break;
+  }
+
+item->arg = *code;
+return code + 1;
+}
+
+
+static PCRE2_SPTR
+decode_item(build_block *bb, PCRE2_SPTR code, pikevm_inst *item,
+  uint32_t *pmin, uint32_t *pmax, BOOL *plazy)
+{
+PCRE2_UCHAR op = *code;
+PCRE2_SPTR next;
+uint32_t min = 1;
+uint32_t max = 1;
+uint32_t kind;
+
+memset(item, 0, sizeof(pikevm_inst));
+item->op = PIKEVM_CHAR;
+*plazy = FALSE;
+
+/* Single types */
+
+if (op < OP_CHAR) next = decode_type(bb, code, item);
+
+/* Single characters and repeated characters and types. The repeat opcodes
+come in blocks of 13 in the same order for characters, caseless characters,
+negated characters, caseless negated characters, and types. */
+
+else if (op <= OP_TYPEPOSUPTO)
+  {
+  uint32_t base;
+  BOOL caseless = FALSE;
+  BOOL negated = FALSE;
+  PCRE2_SPTR ptr = code + 1;
+
+  if (op <= OP_NOTI)
+    {
+    kind = 0xff;   /* Not a repeat */
+    caseless = op == OP_CHARI || op == OP_NOTI;
+    negated = op == OP_NOT || op == OP_NOTI;
+    base = OP_CHAR;
+    }
+  else
+    {
+    if (op >= OP_TYPESTAR) base = OP_TYPESTAR;
+    else if (op >= OP_NOTSTARI) { base = OP_NOTSTARI; negated = caseless = TRUE; }
+    else if (op >= OP_NOTSTAR) { base = OP_NOTSTAR; negated = TRUE; }
+    else if (op >= OP_STARI) { base = OP_STARI; caseless = TRUE; }
+    else base = OP_STAR;
+    kind = op - base;
+    if (kind == OP_UPTO - OP_STAR || kind == OP_MINUPTO - OP_STAR ||
+        kind == OP_EXACT - OP_STAR || kind == OP_POSUPTO - OP_STAR)
+      ptr += IMM2_SIZE;
+    }
+
+  if (base == OP_TYPESTAR) next = decode_type(bb, ptr, item); else
+    {
+    uint32_t c = *ptr;
+    uint32_t oc;
+    int len = 1;
+#ifdef SUPPORT_UNICODE
+    if (bb->utf) { GETCHARLEN(c, ptr, len); }
+#endif
+    next = ptr + len;
+
+    oc = c;
+    if (caseless)
+      {
+#ifdef SUPPORT_UNICODE
+      if (bb->utf && c > 127) oc = UCD_OTHERCASE(c); else
+#endif
+      oc = TABLE_GET(c, bb->fcc, c);
+      }
+
+    item->arg = negated? (caseless? OP_NOTI : OP_NOT) :
+                         (caseless? OP_CHARI : OP_CHAR);
+    item->c = c;
+    item->oc = oc;
+    }
+
+  switch(kind)
+    {
+    case 0xff:
+    break;
+
+    case OP_MINSTAR - OP_STAR:
+    *plazy = TRUE;
+    /* Fall through */
+    case OP_STAR - OP_STAR:
+    min = 0;
+    max = GLUSHKOV_UNLIMITED;
+    break;
+
+    case OP_MINPLUS - OP_STAR:
+    *plazy = TRUE;
+    /* Fall through */
+    case OP_PLUS - OP_STAR:
+    max = GLUSHKOV_UNLIMITED;
+    break;
+
+    case OP_MINQUERY - OP_STAR:
+    *plazy = TRUE;
+    /* Fall through */
+    case OP_QUERY - OP_STAR:
+    min = 0;
+    break;
+
+    case OP_MINUPTO - OP_STAR:
+    *plazy = TRUE;
+    /* Fall through */
+    case OP_UPTO - OP_STAR:
+    min = 0;
+    max = GET2(code, 1);
+    break;
+
+    case OP_EXACT - OP_STAR:
+    min = max = GET2(code, 1);
+    break;
+
+    default:       /* Possessive */
+    return NULL;
+    }
+  }
+
+/* Classes, with or without a repeat */
+
+else if (op == OP_CLASS || op == OP_NCLASS
+#ifdef SUPPORT_WIDE_CHARS
+    || op == OP_XCLASS
+#endif
+    )
+  {
+  item->arg = op;
+  if (op == OP_XCLASS)
+    {
+    item->data = code + 1 + LINK_SIZE;
+    next = code + GET(code, 1);
+    }
+  else
+    {
+    item->data = code + 1;
+    next = code + 1 + 32 / sizeof(PCRE2_UCHAR);
+    }
+
+  op = *next;
+  switch(op)
+    {
+    case OP_CRMINSTAR:
+    *plazy = TRUE;
+    /* Fall through */
+    case OP_CRSTAR:
+    min = 0;
+    max = GLUSHKOV_UNLIMITED;
+    break;
+
+    case OP_CRMINPLUS:
+    *plazy = TRUE;
+    /* Fall through */
+    case OP_CRPLUS:
+    max = GLUSHKOV_UNLIMITED;
+    break;
+
+    case OP_CRMINQUERY:
+    *plazy = TRUE;
+    /* Fall through */
+    case OP_CRQUERY:
+    min = 0;
+    break;
+
+    case OP_CRMINRANGE:
+    *plazy = TRUE;
+    /* Fall through */
+    case OP_CRRANGE:
+    min = GET2(next, 1);
+    max = GET2(next, 1 + IMM2_SIZE);
+    if (max == 0) max = GLUSHKOV_UNLIMITED;
+    break;
+
+    case OP_CRPOSSTAR:
+    case OP_CRPOSPLUS:
+    case OP_CRPOSQUERY:
+    case OP_CRPOSRANGE:
+    return NULL;
+
+    default:
+    op = OP_END;   /* No repeat */
+    break;
+    }
+  if (op != OP_END) next += PRIV(OP_lengths)[op];
+  }
+
+else return NULL;
+
+*pmin = min;
+*pmax = max;
+return next;
+}
+
+
+
+/*************************************************
+*      Build a single-character item             *
+*************************************************/
+
+/* The item is decoded, its bitmap is set up, and it is repeated as necessary.
+The mandatory copies come first; then either a loop, or a chain of optional
+copies, each of which can skip to the end.
+
+Arguments:
+  bb          the build block
+  code        points to the opcode
+
+Returns:      pointer after the item, or NULL on error
+*/
+
+static PCRE2_SPTR
+build_item(build_block *bb, PCRE2_SPTR code)
+{
+pikevm_inst item;
+uint32_t c, i, min, max, first, end;
+BOOL lazy;
+
+code = decode_item(bb, code, &item, &min, &max, &lazy);
+if (code == NULL)
+  {
+  bb->error = PIKEVM_UNSUPPORTED;
+  return NULL;
+  }
+
+for (c = 0; c < 256; c++)
+  if (match_char(&item, c, bb->ctypes, bb->utf))
+    item.bits[c/8] |= 1u << (c%8);
+
+/* Check the size first, because a large count could otherwise take a long
+time to fail. */
+
+if (min > PIKEVM_MAX_INSTS || (max != GLUSHKOV_UNLIMITED &&
+    max - min > PIKEVM_MAX_INSTS) ||
+    bb->count + min + 2 * ((max == GLUSHKOV_UNLIMITED)? 1 : max - min) >
+    PIKEVM_MAX_INSTS)
+  {
+  bb->error = PIKEVM_TOO_LARGE;
+  return NULL;
+  }
+
+for (i = 0; i < min; i++)
+  {
+  uint32_t n = emit(bb, PIKEVM_CHAR);
+  if (bb->error != PIKEVM_OK) return NULL;
+  item.next = n + 1;
+  bb->insts[n] = item;
+  }
+
+if (max == min) return code;
+
+/* An unlimited repeat is a choice between the item, which jumps back to the
+choice, and the rest of the pattern. */
+
+if (max == GLUSHKOV_UNLIMITED)
+  {
+  uint32_t split = emit(bb, PIKEVM_SPLIT);
+  uint32_t n = emit(bb, PIKEVM_CHAR);
+  if (bb->error != PIKEVM_OK) return NULL;
+  item.next = split;
+  bb->insts[n] = item;
+  end = bb->count;
+  bb->insts[split].next = lazy? end : n;
+  bb->insts[split].alt = lazy? n : end;
+  return code;
+  }
+
+/* A limited repeat is a chain of choices, all of which may leave the item. */
+
+first = bb->count;
+for (i = min; i < max; i++)
+  {
+  uint32_t n;
+  (void)emit(bb, PIKEVM_SPLIT);
+  n = emit(bb, PIKEVM_CHAR);
+  if (bb->error != PIKEVM_OK) return NULL;
+  item.next = n + 1;
+  bb->insts[n] = item;
+  }
+
+end = bb->count;
+for (i = first; i < end; i += 2)
+  {
+  bb->insts[i].next = lazy? end : i + 1;
+  bb->insts[i].alt = lazy? i + 1 : end;
+  }
+
+return code;
+}
+
+
+
+/*************************************************
+*         Build a sequence of items              *
+*************************************************/
+
+/* The sequence ends at OP_ALT, a KET opcode, or OP_END.
+
+Arguments:
+  bb          the build block
+  code        points to the first opcode
+
+Returns:      pointer to the opcode that ends the sequence, or NULL on error
+*/
+
+static PCRE2_SPTR build_group(build_block *, PCRE2_SPTR);
+
+static PCRE2_SPTR
+build_sequence(build_block *bb, PCRE2_SPTR code)
+{
+for (;;)
+  {
+  uint32_t n;
+  BOOL lazy;
+
+  switch(*code)
+    {
+    case OP_ALT:
+    case OP_KET:
+    case OP_KETRMAX:
+    case OP_KETRMIN:
+    case OP_END:
+    return code;
+
+    /* An optional group is a choice between the group and skipping it. */
+
+    case OP_BRAZERO:
+    case OP_BRAMINZERO:
+    lazy = *code++ == OP_BRAMINZERO;
+    if (*code != OP_BRA && *code != OP_SBRA && *code != OP_CBRA &&
+        *code != OP_SCBRA)
+      {
+      bb->error = PIKEVM_UNSUPPORTED;
+      return NULL;
+      }
+    n = emit(bb, PIKEVM_SPLIT);
+    if (bb->error != PIKEVM_OK) return NULL;
+    code = build_group(bb, code);
+    if (code == NULL) return NULL;
+    bb->insts[n].next = lazy? bb->count : n + 1;
+    bb->insts[n].alt = lazy? n + 1 : bb->count;
+    break;
+
+    /* A group that is repeated zero times is skipped. */
+
+    case OP_SKIPZERO:
+    code++;
+    do code += GET(code, 1); while (*code == OP_ALT);
+    code += 1 + LINK_SIZE;
+    break;
+
+    case OP_BRA:
+    case OP_SBRA:
+    case OP_CBRA:
+    case OP_SCBRA:
+    code = build_group(bb, code);
+    if (code == NULL) return NULL;
+    break;
+
+    case OP_SOD:
+    case OP_SOM:
+    case OP_NOT_WORD_BOUNDARY:
+    case OP_WORD_BOUNDARY:
+    case OP_EODN:
+    case OP_EOD:
+    case OP_DOLL:
+    case OP_DOLLM:
+    case OP_CIRC:
+    case OP_CIRCM:
+    n = emit(bb, PIKEVM_ASSERT);
+    if (bb->error != PIKEVM_OK) return NULL;
+    bb->insts[n].arg = *code++;
+    break;
+
+    case OP_FAIL:
+    (void)emit(bb, PIKEVM_FAIL);
+    if (bb->error != PIKEVM_OK) return NULL;
+    code++;
+    break;
+
+    default:
+    code = build_item(bb, code);
+    if (code == NULL) return NULL;
+    break;
+    }
+  }
+}
+
+
+
+/*************************************************
+*                Build a group                   *
+*************************************************/
+
+/* A capturing group is enclosed in instructions that record its start and
+set its captured substring. Each branch except the last is preceded by a
+choice between it and the following branches, and followed by a jump to the
+end of the group. A repeated group ends with a choice between going round again
+and carrying on. If the group may match an empty string, the start of each
+iteration is recorded, and the interpreter's rule is followed: an iteration
+that matches an empty string does not go round again.
+
+Arguments:
+  bb          the build block
+  code        points to the bracket opcode
+
+Returns:      pointer after the KET opcode, or NULL on error
+*/
+
+static PCRE2_SPTR
+build_group(build_block *bb, PCRE2_SPTR code)
+{
+PCRE2_UCHAR op = *code;
+PCRE2_SPTR ket = code;
+uint32_t number = 0;
+uint32_t slot = 0;
+uint32_t start = bb->count;
+uint32_t jumps = PIKEVM_MAX_INSTS;   /* Chain of jumps to the end */
+uint32_t outer_loop = bb->loop;
+uint32_t n, end;
+BOOL check;
+
+do ket += GET(ket, 1); while (*ket == OP_ALT);
+check = *ket != OP_KET && (op == OP_SBRA || op == OP_SCBRA);
+
+if (op == OP_CBRA || op == OP_SCBRA)
+  {
+  number = GET2(code, 1 + LINK_SIZE);
+  n = emit(bb, PIKEVM_OPEN);
+  if (bb->error != PIKEVM_OK) return NULL;
+  bb->insts[n].arg = number;
+  }
+
+if (check)
+  {
+  slot = bb->loop_base + bb->loop_count++;
+  n = emit(bb, PIKEVM_MARK);
+  if (bb->error != PIKEVM_OK) return NULL;
+  bb->insts[n].arg = slot;
+  bb->insts[n].c = outer_loop;     /* Remembered for the parents vector */
+  bb->loop = slot;
+  if (++bb->depth > bb->max_depth) bb->max_depth = bb->depth;
+  }
+
+for (;;)
+  {
+  uint32_t split = PIKEVM_MAX_INSTS;
+
+  if (code[GET(code, 1)] == OP_ALT)
+    {
+    split = emit(bb, PIKEVM_SPLIT);
+    if (bb->error != PIKEVM_OK) return NULL;
+    }
+
+  code = build_sequence(bb, code + PRIV(OP_lengths)[*code]);
+  if (code == NULL) return NULL;
+  if (*code != OP_ALT) break;
+
+  n = emit(bb, PIKEVM_JUMP);
+  if (bb->error != PIKEVM_OK) return NULL;
+  bb->insts[n].alt = jumps;
+  jumps = n;
+  bb->insts[split].alt = bb->count;
+  }
+
+end = bb->count;
+while (jumps != PIKEVM_MAX_INSTS)
+  {
+  n = bb->insts[jumps].alt;
+  bb->insts[jumps].next = end;
+  bb->insts[jumps].alt = 0;
+  jumps = n;
+  }
+
+if (number != 0)
+  {
+  n = emit(bb, PIKEVM_CLOSE);
+  if (bb->error != PIKEVM_OK) return NULL;
+  bb->insts[n].arg = number;
+  }
+
+switch(*code)
+  {
+  case OP_KETRMAX:
+  n = emit(bb, check? PIKEVM_LOOP : PIKEVM_SPLIT);
+  if (bb->error != PIKEVM_OK) return NULL;
+  bb->insts[n].next = start;
+  bb->insts[n].alt = n + 1;
+  bb->insts[n].arg = slot;
+  break;
+
+  case OP_KETRMIN:
+  n = emit(bb, check? PIKEVM_LOOPMIN : PIKEVM_SPLIT);
+  if (bb->error != PIKEVM_OK) return NULL;
+  bb->insts[n].alt = start;
+  bb->insts[n].arg = slot;
+  break;
+
+  default:
+  break;
+  }
+
+if (check)
+  {
+  bb->loop = outer_loop;
+  bb->depth--;
+  }
+
+return code + 1 + LINK_SIZE;
+}
+
+
+
+/*************************************************
+*   Attach a linear-time program to a pattern    *
+*************************************************/
+
+/* This is called by pcre2_compile() for a pattern compiled with
+PCRE2_EXTRA_LINEAR, and when such a pattern is copied or deserialized, because
+the program is held outside the compiled block.
+
+Argument:   the compiled pattern
+Returns:    PIKEVM_OK, or the reason why there is no program
+*/
+
+int
+PRIV(pikevm_attach)(pcre2_real_code *re)
+{
+build_block bb;
+pikevm_program *prog;
+PCRE2_SPTR code = (PCRE2_SPTR)((const uint8_t *)re + sizeof(pcre2_real_code)) +
+  re->name_count * re->name_entry_size;
+
+re->pikevm = NULL;
+
+bb.memctl = &re->memctl;
+bb.fcc = re->tables + fcc_offset;
+bb.ctypes = re->tables + ctypes_offset;
+bb.insts = NULL;
+bb.count = 0;
+bb.size = 0;
+bb.loop_count = 0;
+bb.loop_base = SLOT_OVECTOR + 3 * re->top_bracket;
+bb.loop = 0;
+bb.depth = 0;
+bb.max_depth = 0;
+bb.error = PIKEVM_OK;
+bb.utf = (re->overall_options & PCRE2_UTF) != 0;
+
+code = build_group(&bb, code);
+if (code != NULL && *code != OP_END) bb.error = PIKEVM_UNSUPPORTED;
+if (bb.error == PIKEVM_OK) (void)emit(&bb, PIKEVM_MATCH);
+
+if (bb.error == PIKEVM_OK)
+  {
+  prog = re->memctl.malloc(sizeof(pikevm_program) +
+    bb.count * sizeof(pikevm_inst) + bb.loop_count * sizeof(uint32_t),
+    re->memctl.memory_data);
+  if (prog == NULL) bb.error = PIKEVM_NOMEMORY; else
+    {
+    uint32_t i;
+    prog->insts = (pikevm_inst *)(prog + 1);
+    prog->loop_parents = (uint32_t *)(prog->insts + bb.count);
+    prog->inst_count = bb.count;
+    prog->slot_count = bb.loop_base + bb.loop_count;
+    prog->top_bracket = re->top_bracket;
+    prog->loop_base = bb.loop_base;
+    prog->loop_depth = bb.max_depth;
+    memcpy(prog->insts, bb.insts, bb.count * sizeof(pikevm_inst));
+    for (i = 0; i < bb.count; i++)
+      {
+      if (bb.insts[i].op == PIKEVM_MARK)
+        prog->loop_parents[bb.insts[i].arg - bb.loop_base] = bb.insts[i].c;
+      }
+    re->pikevm = prog;
+    }
+  }
+
+if (bb.insts != NULL) re->memctl.free(bb.insts, re->memctl.memory_data);
+return bb.error;
+}
+
+
+
+/*************************************************
+*             Check an assertion                 *
+*************************************************/
+
+/* These follow the interpreter, except that there is no partial matching.
+
+Arguments:
+  op          the assertion's opcode
+  ptr         the current position
+  mb          the match block
+  utf         TRUE in UTF mode
+
+Returns:      TRUE if the assertion holds
+*/
+
+static BOOL
+is_word(uint32_t c, match_block *mb)
+{
+#ifdef SUPPORT_UNICODE
+if ((mb->poptions & PCRE2_UCP) != 0)
+  {
+  int cat;
+  if (c == CHAR_UNDERSCORE) return TRUE;
+  cat = UCD_CATEGORY(c);
+  return cat == ucp_L || cat == ucp_N;
+  }
+#endif
+return c <= 255 && (mb->ctypes[c] & ctype_word) != 0;
+}
+
+
+static BOOL
+check_assert(uint32_t op, PCRE2_SPTR ptr, match_block *mb, BOOL utf)
+{
+uint32_t c;
+BOOL prev_is_word, cur_is_word;
+
+switch(op)
+  {
+  case OP_CIRC:
+  return ptr == mb->start_subject && (mb->moptions & PCRE2_NOTBOL) == 0;
+
+  case OP_SOD:
+  return ptr == mb->start_subject;
+
+  case OP_SOM:
+  return ptr == mb->start_subject + mb->start_offset;
+
+  case OP_CIRCM:
+  if (ptr == mb->start_subject) return (mb->moptions & PCRE2_NOTBOL) == 0;
+  return (ptr != mb->end_subject ||
+    (mb->poptions & PCRE2_ALT_CIRCUMFLEX) != 0) && WAS_NEWLINE(ptr);
+
+  case OP_DOLL:
+  if ((mb->moptions & PCRE2_NOTEOL) != 0) return FALSE;
+  if ((mb->poptions & PCRE2_DOLLAR_ENDONLY) != 0)
+    return ptr >= mb->end_subject;
+  /* Fall through */
+
+  case OP_EODN:
+  return ptr >= mb->end_subject ||
+    (IS_NEWLINE(ptr) && ptr == mb->end_subject - mb->nllen);
+
+  case OP_EOD:
+  return ptr >= mb->end_subject;
+
+  case OP_DOLLM:
+  if (ptr < mb->end_subject) return IS_NEWLINE(ptr);
+  return (mb->moptions & PCRE2_NOTEOL) == 0;
+
+  case OP_NOT_WORD_BOUNDARY:
+  case OP_WORD_BOUNDARY:
+  if (ptr == mb->start_subject) prev_is_word = FALSE; else
+    {
+    PCRE2_SPTR lastptr = ptr - 1;
+#ifdef SUPPORT_UNICODE
+    if (utf)
+      {
+      BACKCHAR(lastptr);
+      GETCHAR(c, lastptr);
+      }
+    else
+#endif
+    c = *lastptr;
+    prev_is_word = is_word(c, mb);
+    }
+
+  if (ptr >= mb->end_subject) cur_is_word = FALSE; else
+    {
+#ifdef SUPPORT_UNICODE
+    if (utf) { GETCHAR(c, ptr); } else
+#endif
+    c = *ptr;
+    cur_is_word = is_word(c, mb);
+    }
+
+  return (op == OP_WORD_BOUNDARY)?
+    cur_is_word != prev_is_word : cur_is_word == prev_is_word;
+
+  default:
+  return FALSE;
+  }
+}
+
+
+
+/*************************************************
+*          Add a thread to a list                *
+*************************************************/
+
+/* The thread is followed through the instructions that do not consume a
+character, in order of priority, and a copy of its slots is put in the list
+for each instruction that does, or for the end of the pattern. An instruction
+that is already in the list has been reached by a thread of higher priority,
+so it is not followed again.
+
+Before a character is consumed, what happens next depends not only on the
+instruction but also on which of the enclosing groups that are checked for an
+empty iteration started their current iteration at this position. This is
+always some number of the innermost ones, so the state of a thread is its
+instruction and that number, and a state that has already been reached is not
+followed again. Without this, the interpreter's final empty iteration of such
+a group, which sets its captured substrings, would be lost.
+
+A stack is used instead of recursion; changes to the slots are undone when the
+stack unwinds past them.
+
+Arguments:
+  prog        the program
+  mb          the match block
+  list        the list
+  pc          the first instruction
+  slots       the thread's slots; they are unchanged on return
+  ptr         the current position
+  stack       workspace for the stack
+  utf         TRUE in UTF mode
+
+Returns:      nothing
+*/
+
+static void
+add_thread(const pikevm_program *prog, match_block *mb, thread_list *list,
+  uint32_t pc, PCRE2_SIZE *slots, PCRE2_SPTR ptr, stack_entry *stack,
+  BOOL utf)
+{
+const pikevm_inst *insts = prog->insts;
+uint32_t k = prog->slot_count;
+uint32_t open_base = SLOT_OVECTOR + 2 * prog->top_bracket - 1;
+PCRE2_SIZE offset = ptr - mb->start_subject;
+stack_entry *sp = stack;
+
+sp->pc = pc;
+sp->slot = EXPLORE;
+sp++;
+
+while (sp > stack)
+  {
+  sp--;
+  if (sp->slot != EXPLORE)
+    {
+    slots[sp->slot] = sp->value;
+    continue;
+    }
+
+  for (pc = sp->pc;;)
+    {
+    const pikevm_inst *in = insts + pc;
+    uint32_t index, s, state;
+
+    if (in->op == PIKEVM_CHAR || in->op == PIKEVM_MATCH)
+      {
+      index = list->sparse[pc];
+      if (index >= list->count || list->dense[index] != pc)
+        {
+        list->sparse[pc] = list->count;
+        list->dense[list->count++] = pc;
+        memcpy(list->slots + (PCRE2_SIZE)pc * k, slots,
+          k * sizeof(PCRE2_SIZE));
+        }
+      break;
+      }
+
+    state = pc * (prog->loop_depth + 1);
+    for (s = in->loop; s != 0 && slots[s] == offset;
+         s = prog->loop_parents[s - prog->loop_base])
+      state++;
+
+    index = list->seen_sparse[state];
+    if (index < list->seen_count && list->seen_dense[index] == state) break;
+    list->seen_sparse[state] = list->seen_count;
+    list->seen_dense[list->seen_count++] = state;
+
+    switch(in->op)
+      {
+      case PIKEVM_JUMP:
+      pc = in->next;
+      continue;
+
+      case PIKEVM_SPLIT:
+      sp->pc = in->alt;
+      sp->slot = EXPLORE;
+      sp++;
+      pc = in->next;
+      continue;
+
+      case PIKEVM_LOOP:
+      if (slots[in->arg] == offset)
+        {
+        pc = in->alt;
+        continue;
+        }
+      sp->pc = in->alt;
+      sp->slot = EXPLORE;
+      sp++;
+      pc = in->next;
+      continue;
+
+      case PIKEVM_LOOPMIN:
+      if (slots[in->arg] != offset)
+        {
+        sp->pc = in->alt;
+        sp->slot = EXPLORE;
+        sp++;
+        }
+      pc = in->next;
+      continue;
+
+      case PIKEVM_OPEN:
+      s = open_base + in->arg;
+      sp->slot = s;
+      sp->value = slots[s];
+      sp++;
+      slots[s] = offset;
+      pc = in->next;
+      continue;
+
+      case PIKEVM_CLOSE:
+      s = SLOT_OVECTOR + 2 * (in->arg - 1);
+      sp->slot = SLOT_TOP;
+      sp->value = slots[SLOT_TOP];
+      sp++;
+      sp->slot = s;
+      sp->value = slots[s];
+      sp++;
+      sp->slot = s + 1;
+      sp->value = slots[s + 1];
+      sp++;
+      slots[s] = slots[open_base + in->arg];
+      slots[s + 1] = offset;
+      if (s - SLOT_OVECTOR >= slots[SLOT_TOP])
+        slots[SLOT_TOP] = s - SLOT_OVECTOR + 2;
+      pc = in->next;
+      continue;
+
+      case PIKEVM_MARK:
+      sp->slot = in->arg;
+      sp->value = slots[in->arg];
+      sp++;
+      slots[in->arg] = offset;
+      pc = in->next;
+      continue;
+
+      case PIKEVM_ASSERT:
+      if (!check_assert(in->arg, ptr, mb, utf)) break;
+      pc = in->next;
+      continue;
+
+      default:   /* PIKEVM_FAIL */
+      break;
+      }
+    break;
+    }
+  }
+}
+
+
+
+/*************************************************
+*        Match with a linear-time program        *
+*************************************************/
+
+/* This function replaces the bumpalong loop of pcre2_match() for a pattern
+that has a linear-time program. A new thread, of lower priority than all the
+others, is started at each position where the interpreter would start a match,
+until a match is found. Thereafter, threads of lower priority than the one that
+matched are abandoned, and matching continues until no threads remain, in case
+one of higher priority matches later. The workspace is kept in the match data,
+like the interpreter's backtracking frames.
+
+Arguments:
+  ms              the match_setup block
+  mb              the match block
+  start_match     where to start
+  start_limit     the last position at which a match may start
+  match_data      the match data block
+  pstart          where to put the start of the match
+
+Returns:          1 for a match, 0 for no match, or a negative error code
+*/
+
+int
+PRIV(pikevm_match)(const match_setup *ms, match_block *mb,
+  PCRE2_SPTR start_match, PCRE2_SPTR start_limit, pcre2_match_data *match_data,
+  PCRE2_SPTR *pstart)
+{
+const pcre2_real_code *re = ms->re;
+const pikevm_program *prog = re->pikevm;
+const pikevm_inst *insts = prog->insts;
+uint32_t n = prog->inst_count;
+uint32_t k = prog->slot_count;
+uint32_t states = n * (prog->loop_depth + 1);
+uint64_t needed;
+PCRE2_SIZE i, offset_top;
+PCRE2_SIZE *scratch, *best;
+PCRE2_SIZE *ovector = match_data->ovector;
+PCRE2_SPTR subject = mb->start_subject;
+PCRE2_SPTR end_subject = mb->end_subject;
+PCRE2_SPTR ptr = start_match;
+PCRE2_SPTR match_end = NULL;
+stack_entry *stack;
+thread_list lists[2];
+thread_list *clist = lists;
+thread_list *nlist = lists + 1;
+char *workspace;
+BOOL utf = ms->utf;
+BOOL starting = TRUE;
+BOOL notempty = (mb->moptions & PCRE2_NOTEMPTY) != 0;
+BOOL notempty_atstart = (mb->moptions & PCRE2_NOTEMPTY_ATSTART) != 0;
+BOOL endanchored = ((mb->moptions | mb->poptions) & PCRE2_ENDANCHORED) != 0;
+BOOL start_opt = (re->overall_options & PCRE2_NO_START_OPTIMIZE) == 0;
+BOOL skip_ahead = start_opt && !ms->anchored && !ms->firstline &&
+  ms->has_first_cu;
+BOOL skip_crlf = (re->flags & PCRE2_HASCRORLF) == 0 &&
+  (mb->nltype == NLTYPE_ANY || mb->nltype == NLTYPE_ANYCRLF ||
+   mb->nllen == 2);
+
+/* Get the workspace: two lists, each with a set of slots for every
+instruction, a scratch set of slots, the slots of the best match so far, the
+stack, and the dense and sparse vectors for the lists and their states. The heap
+limit applies to its size. */
+
+needed = ((uint64_t)2 * n * k + 2 * k) * sizeof(PCRE2_SIZE) +
+  ((uint64_t)3 * states + 2) * sizeof(stack_entry) +
+  ((uint64_t)4 * n + (uint64_t)4 * states) * sizeof(uint32_t);
+if (needed / 1024 > mb->heap_limit) return PCRE2_ERROR_HEAPLIMIT;
+
+if (match_data->heapframes_size < needed)
+  {
+  workspace = match_data->memctl.malloc((PCRE2_SIZE)needed,
+    match_data->memctl.memory_data);
+  if (workspace == NULL) return PCRE2_ERROR_NOMEMORY;
+  if (match_data->heapframes != NULL)
+    match_data->memctl.free(match_data->heapframes,
+      match_data->memctl.memory_data);
+  match_data->heapframes = (heapframe *)workspace;
+  match_data->heapframes_size = (PCRE2_SIZE)needed;
+  }
+else workspace = (char *)match_data->heapframes;
+
+lists[0].slots = (PCRE2_SIZE *)workspace;
+lists[1].slots = lists[0].slots + (PCRE2_SIZE)n * k;
+scratch = lists[1].slots + (PCRE2_SIZE)n * k;
+best = scratch + k;
+stack = (stack_entry *)(best + k);
+lists[0].dense = (uint32_t *)(stack + 3 * states + 2);
+lists[0].sparse = lists[0].dense + n;
+lists[1].dense = lists[0].sparse + n;
+lists[1].sparse = lists[1].dense + n;
+lists[0].seen_dense = lists[1].sparse + n;
+lists[0].seen_sparse = lists[0].seen_dense + states;
+lists[1].seen_dense = lists[0].seen_sparse + states;
+lists[1].seen_sparse = lists[1].seen_dense + states;
+memset(lists[0].sparse, 0, n * sizeof(uint32_t));
+memset(lists[1].sparse, 0, n * sizeof(uint32_t));
+memset(lists[0].seen_sparse, 0, states * sizeof(uint32_t));
+memset(lists[1].seen_sparse, 0, states * sizeof(uint32_t));
+lists[0].count = lists[1].count = 0;
+lists[0].seen_count = lists[1].seen_count = 0;
+
+/* Scan the subject, one character at a time. */
+
+for (;;)
+  {
+  uint32_t c = 0;
+  uint32_t j;
+  int len = 1;
+
+  if (starting && ptr > start_limit) starting = FALSE;
+
+  /* When there are no threads, stop if no more are to be started. Otherwise,
+  if the pattern has a first code unit, skip to the next one. */
+
+  if (clist->count == 0)
+    {
+    if (!starting) break;
+    if (skip_ahead)
+      {
+      ptr = (ms->first_cu == ms->first_cu2)?
+        PRIV(find_cu)(ptr, end_subject, ms->first_cu) :
+        PRIV(find_cu2)(ptr, end_subject, ms->first_cu, ms->first_cu2);
+      if (ptr >= end_subject || ptr > start_limit) break;
+      }
+    }
+
+  /* Start a new thread, unless the interpreter would skip this position
+  because it is the LF of a CRLF pair. After a newline with PCRE2_FIRSTLINE,
+  or after the first position of an anchored match, no more are started. When
+  the interpreter searches the first line for a first code unit, it does not
+  start at the newline itself. */
+
+  if (starting && ms->firstline && start_opt && ms->has_first_cu &&
+      ptr < end_subject && IS_NEWLINE(ptr))
+    starting = FALSE;
+
+  if (starting)
+    {
+    if (!skip_crlf || ptr <= subject + mb->start_offset ||
+        ptr[-1] != CHAR_CR || ptr >= end_subject || *ptr != CHAR_NL)
+      {
+      scratch[SLOT_START] = ptr - subject;
+      scratch[SLOT_TOP] = 0;
+      for (j = SLOT_OVECTOR; j < k; j++) scratch[j] = PCRE2_UNSET;
+      add_thread(prog, mb, clist, 0, scratch, ptr, stack, utf);
+      }
+    if (ms->anchored || (ms->firstline && IS_NEWLINE(ptr))) starting = FALSE;
+    }
+
+  if (ptr < end_subject)
+    {
+    c = *ptr;
+#ifdef SUPPORT_UNICODE
+    if (utf) { GETCHARLEN(c, ptr, len); }
+#endif
+    }
+
+  /* Run the threads in order of priority. A thread that reaches the end of
+  the pattern is the best match so far, and all lower threads are dropped. */
+
+  nlist->count = nlist->seen_count = 0;
+  for (j = 0; j < clist->count; j++)
+    {
+    uint32_t pc = clist->dense[j];
+    const pikevm_inst *in = insts + pc;
+    PCRE2_SIZE *slots = clist->slots + (PCRE2_SIZE)pc * k;
+
+    if (in->op == PIKEVM_MATCH)
+      {
+      PCRE2_SPTR start = subject + slots[SLOT_START];
+      if (ptr == start && (notempty ||
+          (notempty_atstart && start == subject + mb->start_offset)))
+        continue;
+      if (endanchored && ptr < end_subject) continue;
+      memcpy(best, slots, k * sizeof(PCRE2_SIZE));
+      match_end = ptr;
+      starting = FALSE;
+      break;
+      }
+
+    if (ptr >= end_subject) continue;
+    if (c < 256)
+      {
+      if ((in->bits[c/8] & (1u << (c%8))) == 0) continue;
+      }
+    else if (!match_char(in, c, mb->ctypes, utf)) continue;
+    if (in->arg == OP_ANY && IS_NEWLINE(ptr)) continue;
+
+    add_thread(prog, mb, nlist, in->next, slots, ptr + len, stack, utf);
+    }
+
+  if (ptr >= end_subject) break;
+  clist = nlist;
+  nlist = (clist == lists)? lists + 1 : lists;
+  ptr += len;
+  }
+
+if (match_end == NULL) return 0;
+
+/* Set the ovector as the interpreter does at the end of the pattern. */
+
+offset_top = best[SLOT_TOP];
+ovector[0] = best[SLOT_START];
+ovector[1] = match_end - subject;
+i = 2 * ((prog->top_bracket + 1 > match_data->oveccount)?
+  match_data->oveccount : prog->top_bracket + 1);
+memcpy(ovector + 2, best + SLOT_OVECTOR,
+  ((i - 2 < offset_top)? i - 2 : offset_top) * sizeof(PCRE2_SIZE));
+while (--i >= offset_top + 2) ovector[i] = PCRE2_UNSET;
+
+*pstart = subject + best[SLOT_START];
+mb->start_used_ptr = *pstart;
+mb->last_used_ptr = match_end;
+mb->end_match_ptr = match_end;
+mb->end_offset_top = offset_top;
+return 1;
+}
+
+/* End of pcre2_pikevm.c */
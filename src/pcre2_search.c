@@ -0,0 +1,623 @@
+/*************************************************
+*      Perl-Compatible Regular Expressions       *
+*************************************************/
+
+/* PCRE is a library of functions to support regular expressions whose syntax
+and semantics are as close as possible to those of the Perl 5 language.
+
+                       Written by Philip Hazel
+     Original API code Copyright (c) 1997-2012 University of Cambridge
+          New API code Copyright (c) 2016-2017 University of Cambridge
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the University of Cambridge nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+/* This module contains internal functions that search a subject string for
+code units that may start a match, or for a literal string that must be
+present. They are used by the interpreters to skip
+over parts of the subject that cannot match. On x86 and x86-64 processors SSE2
+instructions are used when the compiler provides them, and AVX2 instructions
+are used when the compiler supports them and the processor on which the
+library is running has them (this is checked at run time). Otherwise, or when
+there is only a short piece of subject left, the search is done one code unit
+at a time. */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcre2_internal.h"
+
+/* Decide which vector instruction sets can be used. SSE2 is always present on
+x86-64, and is available on 32-bit x86 if the compiler is generating code for
+it. AVX2 code is compiled only with compilers that allow individual functions
+to be compiled for a different target and that provide a run time test for the
+processor's features. */
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SEARCH_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SEARCH_SSE2) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || __GNUC__ > 4 || \
+      (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define SEARCH_AVX2
+#include <immintrin.h>
+#if defined(__AVX2__)
+#define HAVE_AVX2() TRUE
+#else
+#define HAVE_AVX2() __builtin_cpu_supports("avx2")
+#endif
+#endif
+
+/* The number of code units in a 16-byte and a 32-byte vector. */
+
+#define CU_BYTES (PCRE2_CODE_UNIT_WIDTH/8)
+#define SSE2_UNITS (16/CU_BYTES)
+#define AVX2_UNITS (32/CU_BYTES)
+
+/* Width-dependent intrinsics for comparing and broadcasting code units. The
+result of a comparison is converted to a bit mask with one bit per byte, so
+the index of the first matching code unit is the index of the lowest set bit
+divided by the code unit size. */
+
+#if PCRE2_CODE_UNIT_WIDTH == 8
+#define SSE2_SET1(c) _mm_set1_epi8((char)(c))
+#define SSE2_CMPEQ(a, b) _mm_cmpeq_epi8(a, b)
+#define AVX2_SET1(c) _mm256_set1_epi8((char)(c))
+#define AVX2_CMPEQ(a, b) _mm256_cmpeq_epi8(a, b)
+#elif PCRE2_CODE_UNIT_WIDTH == 16
+#define SSE2_SET1(c) _mm_set1_epi16((short)(c))
+#define SSE2_CMPEQ(a, b) _mm_cmpeq_epi16(a, b)
+#define AVX2_SET1(c) _mm256_set1_epi16((short)(c))
+#define AVX2_CMPEQ(a, b) _mm256_cmpeq_epi16(a, b)
+#else
+#define SSE2_SET1(c) _mm_set1_epi32((int)(c))
+#define SSE2_CMPEQ(a, b) _mm_cmpeq_epi32(a, b)
+#define AVX2_SET1(c) _mm256_set1_epi32((int)(c))
+#define AVX2_CMPEQ(a, b) _mm256_cmpeq_epi32(a, b)
+#endif
+
+
+
+#ifdef SEARCH_SSE2
+/*************************************************
+*      Find the lowest set bit in a mask         *
+*************************************************/
+
+/*
+Argument:  a non-zero mask
+Returns:   the index of its lowest set bit
+*/
+
+static unsigned int
+lowest_bit(uint32_t mask)
+{
+#if defined(__GNUC__)
+return (unsigned int)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+unsigned long index;
+_BitScanForward(&index, mask);
+return (unsigned int)index;
+#else
+unsigned int index = 0;
+while ((mask & 1) == 0) { mask >>= 1; index++; }
+return index;
+#endif
+}
+#endif  /* SEARCH_SSE2 */
+
+
+
+#ifdef SEARCH_AVX2
+/*************************************************
+*      AVX2 search for one of two code units     *
+*************************************************/
+
+/* This function processes whole 32-byte blocks; the caller finishes off any
+remainder.
+
+Arguments:
+  p           the start of the search
+  end         the end of the subject
+  c1, c2      the code units to look for (may be the same)
+  found       set TRUE if a code unit was found
+
+Returns:      pointer to the first code unit found, or to the start of the
+                unsearched remainder
+*/
+
+__attribute__((target("avx2"))) static PCRE2_SPTR
+find_cu2_avx2(PCRE2_SPTR p, PCRE2_SPTR end, uint32_t c1, uint32_t c2,
+  BOOL *found)
+{
+__m256i v1 = AVX2_SET1(c1);
+__m256i v2 = AVX2_SET1(c2);
+
+while (end - p >= AVX2_UNITS)
+  {
+  __m256i data = _mm256_loadu_si256((const __m256i *)p);
+  uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+    _mm256_or_si256(AVX2_CMPEQ(data, v1), AVX2_CMPEQ(data, v2)));
+  if (mask != 0)
+    {
+    *found = TRUE;
+    return p + lowest_bit(mask)/CU_BYTES;
+    }
+  p += AVX2_UNITS;
+  }
+
+*found = FALSE;
+return p;
+}
+
+
+/*************************************************
+*      AVX2 search for a literal string          *
+*************************************************/
+
+/* Each 32-byte block of possible starting positions is compared with the
+first code unit of the literal, and the block that is (length - 1) code units
+further on with its last code unit. Only positions where both compare equal
+are checked in full. Only whole blocks are processed; the caller finishes off
+any remainder.
+
+Arguments:
+  p           the start of the search
+  last_start  one past the last position at which the literal can start
+  literal     the literal string
+  length      its length, at least 2
+  found       set TRUE if the literal was found
+
+Returns:      pointer to the start of the literal, or to the start of the
+                unsearched remainder
+*/
+
+__attribute__((target("avx2"))) static PCRE2_SPTR
+find_literal_avx2(PCRE2_SPTR p, PCRE2_SPTR last_start, PCRE2_SPTR literal,
+  uint32_t length, BOOL *found)
+{
+__m256i first = AVX2_SET1(literal[0]);
+__m256i last = AVX2_SET1(literal[length - 1]);
+
+while (last_start - p >= AVX2_UNITS)
+  {
+  __m256i data1 = _mm256_loadu_si256((const __m256i *)p);
+  __m256i data2 = _mm256_loadu_si256((const __m256i *)(p + length - 1));
+  uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+    _mm256_and_si256(AVX2_CMPEQ(data1, first), AVX2_CMPEQ(data2, last)));
+
+  while (mask != 0)
+    {
+    unsigned int bit = lowest_bit(mask);
+    PCRE2_SPTR q = p + bit/CU_BYTES;
+    if (memcmp(q + 1, literal + 1, (length - 2) * CU_BYTES) == 0)
+      {
+      *found = TRUE;
+      return q;
+      }
+    mask &= ~((((uint32_t)1 << CU_BYTES) - 1) << bit);
+    }
+  p += AVX2_UNITS;
+  }
+
+*found = FALSE;
+return p;
+}
+
+
+
+#if PCRE2_CODE_UNIT_WIDTH == 8
+/*************************************************
+*     AVX2 search for a code unit in a bitmap    *
+*************************************************/
+
+/* This uses the technique of splitting each byte into two 4-bit halves and
+using each half as an index into a 16-byte table with the PSHUFB instruction.
+The low half selects, from one of two tables, a byte that has a bit set for
+each high half value that makes a code unit in the bitmap. The high half
+selects a byte with just its own bit set, and the two are ANDed. The tables are
+built from the bitmap by PRIV(bitmap_tables)(). As in find_cu2_avx2(), only
+whole 32-byte blocks are processed.
+
+Arguments:
+  p           the start of the search
+  end         the end of the subject
+  tables      the two 16-byte tables for the bitmap
+  found       set TRUE if a code unit was found
+
+Returns:      pointer to the first code unit found, or to the start of the
+                unsearched remainder
+*/
+
+__attribute__((target("avx2"))) static PCRE2_SPTR
+find_bitmap_avx2(PCRE2_SPTR p, PCRE2_SPTR end, const uint8_t *tables,
+  BOOL *found)
+{
+__m256i low_rows, high_rows, bits, nibble_mask;
+
+low_rows = _mm256_broadcastsi128_si256(
+  _mm_loadu_si128((const __m128i *)tables));
+high_rows = _mm256_broadcastsi128_si256(
+  _mm_loadu_si128((const __m128i *)(tables + 16)));
+bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64,
+  -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+nibble_mask = _mm256_set1_epi8(0x0f);
+
+while (end - p >= AVX2_UNITS)
+  {
+  __m256i data = _mm256_loadu_si256((const __m256i *)p);
+  __m256i low = _mm256_and_si256(data, nibble_mask);
+  __m256i high = _mm256_and_si256(_mm256_srli_epi16(data, 4), nibble_mask);
+
+  /* The top bit of each data byte selects the table. */
+
+  __m256i rows = _mm256_blendv_epi8(_mm256_shuffle_epi8(low_rows, low),
+    _mm256_shuffle_epi8(high_rows, low), data);
+  __m256i bit = _mm256_shuffle_epi8(bits, high);
+  uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+    _mm256_cmpeq_epi8(_mm256_and_si256(rows, bit), bit));
+
+  if (mask != 0)
+    {
+    *found = TRUE;
+    return p + lowest_bit(mask);
+    }
+  p += AVX2_UNITS;
+  }
+
+*found = FALSE;
+return p;
+}
+#endif  /* PCRE2_CODE_UNIT_WIDTH == 8 */
+#endif  /* SEARCH_AVX2 */
+
+
+
+#ifdef SEARCH_SSE2
+/*************************************************
+*      SSE2 search for one of two code units     *
+*************************************************/
+
+/* Whole 16-byte blocks are processed; the caller finishes off any remainder.
+
+Arguments:
+  p           the start of the search
+  end         the end of the subject
+  c1, c2      the code units to look for (may be the same)
+  found       set TRUE if a code unit was found
+
+Returns:      pointer to the first code unit found, or to the start of the
+                unsearched remainder
+*/
+
+static PCRE2_SPTR
+find_cu2_sse2(PCRE2_SPTR p, PCRE2_SPTR end, uint32_t c1, uint32_t c2,
+  BOOL *found)
+{
+__m128i v1 = SSE2_SET1(c1);
+__m128i v2 = SSE2_SET1(c2);
+
+while (end - p >= SSE2_UNITS)
+  {
+  __m128i data = _mm_loadu_si128((const __m128i *)p);
+  uint32_t mask = (uint32_t)_mm_movemask_epi8(
+    _mm_or_si128(SSE2_CMPEQ(data, v1), SSE2_CMPEQ(data, v2)));
+  if (mask != 0)
+    {
+    *found = TRUE;
+    return p + lowest_bit(mask)/CU_BYTES;
+    }
+  p += SSE2_UNITS;
+  }
+
+*found = FALSE;
+return p;
+}
+
+
+/*************************************************
+*      SSE2 search for a literal string          *
+*************************************************/
+
+/* This is the 16-byte version of find_literal_avx2().
+
+Arguments:
+  p           the start of the search
+  last_start  one past the last position at which the literal can start
+  literal     the literal string
+  length      its length, at least 2
+  found       set TRUE if the literal was found
+
+Returns:      pointer to the start of the literal, or to the start of the
+                unsearched remainder
+*/
+
+static PCRE2_SPTR
+find_literal_sse2(PCRE2_SPTR p, PCRE2_SPTR last_start, PCRE2_SPTR literal,
+  uint32_t length, BOOL *found)
+{
+__m128i first = SSE2_SET1(literal[0]);
+__m128i last = SSE2_SET1(literal[length - 1]);
+
+while (last_start - p >= SSE2_UNITS)
+  {
+  __m128i data1 = _mm_loadu_si128((const __m128i *)p);
+  __m128i data2 = _mm_loadu_si128((const __m128i *)(p + length - 1));
+  uint32_t mask = (uint32_t)_mm_movemask_epi8(
+    _mm_and_si128(SSE2_CMPEQ(data1, first), SSE2_CMPEQ(data2, last)));
+
+  while (mask != 0)
+    {
+    unsigned int bit = lowest_bit(mask);
+    PCRE2_SPTR q = p + bit/CU_BYTES;
+    if (memcmp(q + 1, literal + 1, (length - 2) * CU_BYTES) == 0)
+      {
+      *found = TRUE;
+      return q;
+      }
+    mask &= ~((((uint32_t)1 << CU_BYTES) - 1) << bit);
+    }
+  p += SSE2_UNITS;
+  }
+
+*found = FALSE;
+return p;
+}
+#endif  /* SEARCH_SSE2 */
+
+
+
+/*************************************************
+*      Search for one of two code units          *
+*************************************************/
+
+/* This is used for a caseless first code unit, where both cases are looked
+for. It is also used for a single code unit in the 16-bit and 32-bit libraries,
+by passing the same value twice.
+
+Arguments:
+  p           the start of the search
+  end         the end of the subject
+  c1, c2      the code units to look for
+
+Returns:      pointer to the first occurrence of either code unit, or end if
+                neither is found
+*/
+
+PCRE2_SPTR
+PRIV(find_cu2)(PCRE2_SPTR p, PCRE2_SPTR end, uint32_t c1, uint32_t c2)
+{
+#ifdef SEARCH_SSE2
+BOOL found;
+
+#ifdef SEARCH_AVX2
+if (end - p >= AVX2_UNITS && HAVE_AVX2())
+  {
+  p = find_cu2_avx2(p, end, c1, c2, &found);
+  if (found) return p;
+  }
+#endif
+
+p = find_cu2_sse2(p, end, c1, c2, &found);
+if (found) return p;
+#endif  /* SEARCH_SSE2 */
+
+for (; p < end; p++)
+  {
+  uint32_t c = UCHAR21TEST(p);
+  if (c == c1 || c == c2) break;
+  }
+return p;
+}
+
+
+
+/*************************************************
+*          Search for a single code unit         *
+*************************************************/
+
+/* In the 8-bit library memchr() is used, because C libraries usually have a
+well-tuned implementation.
+
+Arguments:
+  p           the start of the search
+  end         the end of the subject
+  c           the code unit to look for
+
+Returns:      pointer to the first occurrence of the code unit, or end if it is
+                not found
+*/
+
+PCRE2_SPTR
+PRIV(find_cu)(PCRE2_SPTR p, PCRE2_SPTR end, uint32_t c)
+{
+#if PCRE2_CODE_UNIT_WIDTH == 8
+p = memchr(p, c, end - p);
+return (p == NULL)? end : p;
+#else
+return PRIV(find_cu2)(p, end, c, c);
+#endif
+}
+
+
+
+/*************************************************
+*     Build the vector tables for a bitmap       *
+*************************************************/
+
+/* The AVX2 bitmap search needs two 16-byte tables, one for code units less
+than 128 and one for the rest, indexed by the low 4 bits of a code unit. Each
+entry has a bit set for each value of the high 4 bits that makes a code unit in
+the bitmap. They are built once, when the bitmap is made, and are stored after
+it; they are built in every configuration so that they are valid wherever the
+bitmap is used.
+
+Arguments:
+  bitmap      the 256-bit map
+  tables      where to put the 32 bytes of tables
+
+Returns:      nothing
+*/
+
+void
+PRIV(bitmap_tables)(const uint8_t *bitmap, uint8_t *tables)
+{
+int i;
+memset(tables, 0, BITMAP_TABLES_SIZE);
+for (i = 0; i < 256; i++)
+  {
+  if ((bitmap[i/8] & (1 << (i&7))) == 0) continue;
+  if (i < 128)
+    tables[i & 0x0f] |= (uint8_t)(1 << (i >> 4));
+  else
+    tables[16 + (i & 0x0f)] |= (uint8_t)(1 << ((i >> 4) - 8));
+  }
+}
+
+
+
+/*************************************************
+*    Search for a code unit that is in a bitmap  *
+*************************************************/
+
+/* The bitmap contains only 256 bits. When code units are 16 or 32 bits wide,
+all code units greater than 254 use the 255 bit. A few code units are checked
+individually before the vector search is started, because a match is often
+found very close to the start.
+
+Arguments:
+  p           the start of the search
+  end         the end of the subject
+  bitmap      the 256-bit map
+  tables      its vector tables, from PRIV(bitmap_tables)()
+
+Returns:      pointer to the first code unit whose bit is set, or end if there
+                is none
+*/
+
+#define BITMAP_PRESCAN 16
+
+PCRE2_SPTR
+PRIV(find_bitmap)(PCRE2_SPTR p, PCRE2_SPTR end, const uint8_t *bitmap,
+  const uint8_t *tables)
+{
+#if defined SEARCH_AVX2 && PCRE2_CODE_UNIT_WIDTH == 8
+PCRE2_SPTR prescan_end = (end - p > BITMAP_PRESCAN)? p + BITMAP_PRESCAN : end;
+
+for (; p < prescan_end; p++)
+  {
+  uint32_t c = *p;
+  if ((bitmap[c/8] & (1 << (c&7))) != 0) return p;
+  }
+
+if (end - p >= AVX2_UNITS && HAVE_AVX2())
+  {
+  BOOL found;
+  p = find_bitmap_avx2(p, end, tables, &found);
+  if (found) return p;
+  }
+#else
+(void)tables;
+#endif
+
+for (; p < end; p++)
+  {
+  uint32_t c = UCHAR21TEST(p);
+#if PCRE2_CODE_UNIT_WIDTH != 8
+  if (c > 255) c = 255;
+#endif
+  if ((bitmap[c/8] & (1 << (c&7))) != 0) break;
+  }
+return p;
+}
+
+
+/*************************************************
+*         Search for a literal string            *
+*************************************************/
+
+/* This is used for the literal string that must be present in every match.
+Candidate positions are found by looking for the first and last code units of
+the literal together, and are then checked in full.
+
+Arguments:
+  p           the start of the search
+  end         the end of the subject
+  literal     the literal string
+  length      its length in code units, at least 1
+
+Returns:      pointer to the start of the first occurrence of the literal, or
+                end if it is not found
+*/
+
+PCRE2_SPTR
+PRIV(find_literal)(PCRE2_SPTR p, PCRE2_SPTR end, PCRE2_SPTR literal,
+  uint32_t length)
+{
+PCRE2_SPTR last_start;
+#ifdef SEARCH_SSE2
+BOOL found;
+#endif
+
+if (length == 1) return PRIV(find_cu)(p, end, literal[0]);
+if (end - p < (ptrdiff_t)length) return end;
+last_start = end - length + 1;
+
+#ifdef SEARCH_SSE2
+#ifdef SEARCH_AVX2
+if (last_start - p >= AVX2_UNITS && HAVE_AVX2())
+  {
+  p = find_literal_avx2(p, last_start, literal, length, &found);
+  if (found) return p;
+  }
+#endif
+
+p = find_literal_sse2(p, last_start, literal, length, &found);
+if (found) return p;
+#endif  /* SEARCH_SSE2 */
+
+while (p < last_start)
+  {
+  p = PRIV(find_cu)(p, last_start, literal[0]);
+  if (p >= last_start) break;
+  if (memcmp(p + 1, literal + 1, (length - 1) * CU_BYTES) == 0) return p;
+  p++;
+  }
+return end;
+}
+
+/* End of pcre2_search.c */
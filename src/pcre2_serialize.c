@@ -224,6 +224,33 @@ for (i = 0; i < number_of_codes; i++)
   dst_re->tables = tables;
   dst_re->executable_jit = NULL;
   dst_re->flags |= PCRE2_DEREF_TABLES;
+  if ((dst_re->flags & PCRE2_BITPARALLEL) != 0) PRIV(glushkov_attach)(dst_re);
+  else dst_re->glushkov = NULL;
+  if ((dst_re->flags & PCRE2_ONEPASS) != 0) PRIV(onepass_attach)(dst_re);
+  else dst_re->onepass = NULL;
+  if ((dst_re->flags & PCRE2_LITSET) != 0) PRIV(litset_attach)(dst_re);
+  else dst_re->litset = NULL;
+  if ((dst_re->flags & PCRE2_LITSTRING) != 0) PRIV(literal_attach)(dst_re);
+  else dst_re->literal = NULL;
+  if ((dst_re->flags & PCRE2_INNERLIT) != 0) PRIV(inner_attach)(dst_re);
+  else dst_re->inner = NULL;
+
+  /* A linear-time program cannot be done without. If it cannot be built, all
+  the codes so far are freed, together with the tables when the reference count
+  reaches zero. */
+
+  if ((dst_re->flags & PCRE2_LINEAR) == 0) dst_re->pikevm = NULL;
+    else if (PRIV(pikevm_attach)(dst_re) != PIKEVM_OK)
+    {
+    *(PCRE2_SIZE *)(tables + tables_length) = i + 1;
+    pcre2_code_free(dst_re);
+    for (j = 0; j < i; j++)
+      {
+      pcre2_code_free(codes[j]);
+      codes[j] = NULL;
+      }
+    return PCRE2_ERROR_NOMEMORY;
+    }
 
   codes[i] = dst_re;
   src_bytes += blocksize;
@@ -1588,7 +1588,11 @@ if ((re->overall_options & PCRE2_ANCHORED) == 0 &&
   {
   int rc = set_start_bits(re, code, utf);
   if (rc == SSB_UNKNOWN) return 1;
-  if (rc == SSB_DONE) re->flags |= PCRE2_FIRSTMAPSET;
+  if (rc == SSB_DONE)
+    {
+    re->flags |= PCRE2_FIRSTMAPSET;
+    PRIV(bitmap_tables)(re->start_bitmap, re->start_tables);
+    }
   }
 
 /* Find the minimum length of subject string. If the pattern can match an empty
@@ -186,9 +186,11 @@ void vms_setsymbol( char *, char *, int );
 #endif
 #endif
 
+#define BATCHSIZE 20              /* Maximum subjects for batch matching */
 #define CFORE_UNSET UINT32_MAX    /* Unset value for startend/cfail/cerror fields */
 #define CONVERT_UNSET UINT32_MAX  /* Unset value for convert_type field */
 #define DFA_WS_DIMENSION 1000     /* Size of DFA workspace */
+#define DFA_WS_MAXIMUM 100000     /* Maximum size of DFA workspace object */
 #define DEFAULT_OVECCOUNT 15      /* Default ovector count */
 #define JUNK_OFFSET 0xdeadbeef    /* For initializing ovector */
 #define LOCALESIZE 32             /* Size of locale name */
@@ -369,13 +371,15 @@ typedef struct cmdstruct {
 } cmdstruct;
 
 enum { CMD_FORBID_UTF, CMD_LOAD, CMD_NEWLINE_DEFAULT, CMD_PATTERN,
-  CMD_PERLTEST, CMD_POP, CMD_POPCOPY, CMD_SAVE, CMD_SUBJECT, CMD_UNKNOWN };
+  CMD_PATTERNSET, CMD_PERLTEST, CMD_POP, CMD_POPCOPY, CMD_SAVE, CMD_SUBJECT,
+  CMD_UNKNOWN };
 
 static cmdstruct cmdlist[] = {
   { "forbid_utf",      CMD_FORBID_UTF },
   { "load",            CMD_LOAD },
   { "newline_default", CMD_NEWLINE_DEFAULT },
   { "pattern",         CMD_PATTERN },
+  { "patternset",      CMD_PATTERNSET },
   { "perltest",        CMD_PERLTEST },
   { "pop",             CMD_POP },
   { "popcopy",         CMD_POPCOPY },
@@ -480,6 +484,11 @@ so many of them that they are split into two fields. */
 #define CTL2_SUBSTITUTE_UNKNOWN_UNSET    0x00000004u
 #define CTL2_SUBSTITUTE_UNSET_EMPTY      0x00000008u
 #define CTL2_SUBJECT_LITERAL             0x00000010u
+#define CTL2_HEAPFRAMES_SIZE             0x00000020u
+#define CTL2_BATCH                       0x00000040u
+#define CTL2_JITRELOAD                   0x00000080u
+#define CTL2_JITASYNC                    0x00000100u
+#define CTL2_JITCACHE                    0x00000200u
 
 #define CTL_NL_SET                       0x40000000u  /* Informational */
 #define CTL_BSR_SET                      0x80000000u  /* Informational */
@@ -522,6 +531,7 @@ typedef struct patctl {    /* Structure for pattern modifiers. */
   uint32_t  jitstack;      /* Must be in same position as datctl */
    uint8_t  replacement[REPLACE_MODSIZE];  /* So must this */
   uint32_t  jit;
+  uint32_t  jitlazy[2];
   uint32_t  stackguard_test;
   uint32_t  tables_id;
   uint32_t  convert_type;
@@ -549,6 +559,12 @@ typedef struct datctl {    /* Structure for data line modifiers. */
    int32_t  get_numbers[MAXCPYGET];
   uint32_t  oveccount;
   uint32_t  offset;
+  uint32_t  parallel;
+  uint32_t  jitstackpool;
+  uint32_t  dfaworkspace;
+  uint32_t  dfastream;
+  uint32_t  dfastreamretain;
+  PCRE2_SIZE heapframes_shrink;
   uint8_t   copy_names[LENCPYGET];
   uint8_t   get_names[LENCPYGET];
 } datctl;
@@ -591,10 +607,13 @@ static modstruct modlist[] = {
   { "alt_circumflex",             MOD_PAT,  MOD_OPT, PCRE2_ALT_CIRCUMFLEX,       PO(options) },
   { "alt_verbnames",              MOD_PAT,  MOD_OPT, PCRE2_ALT_VERBNAMES,        PO(options) },
   { "altglobal",                  MOD_PND,  MOD_CTL, CTL_ALTGLOBAL,              PO(control) },
+  { "always_check_lastcu",        MOD_CTC,  MOD_OPT, PCRE2_EXTRA_ALWAYS_CHECK_LASTCU, CO(extra_options) },
   { "anchored",                   MOD_PD,   MOD_OPT, PCRE2_ANCHORED,             PD(options) },
   { "auto_callout",               MOD_PAT,  MOD_OPT, PCRE2_AUTO_CALLOUT,         PO(options) },
   { "bad_escape_is_literal",      MOD_CTC,  MOD_OPT, PCRE2_EXTRA_BAD_ESCAPE_IS_LITERAL, CO(extra_options) },
+  { "batch",                      MOD_DAT,  MOD_CTL, CTL2_BATCH,                 DO(control2) },
   { "bincode",                    MOD_PAT,  MOD_CTL, CTL_BINCODE,                PO(control) },
+  { "bit_parallel",               MOD_CTC,  MOD_OPT, PCRE2_EXTRA_BIT_PARALLEL,   CO(extra_options) },
   { "bsr",                        MOD_CTC,  MOD_BSR, 0,                          CO(bsr_convention) },
   { "callout_capture",            MOD_DAT,  MOD_CTL, CTL_CALLOUT_CAPTURE,        DO(control) },
   { "callout_data",               MOD_DAT,  MOD_INS, 0,                          DO(callout_data) },
@@ -611,8 +630,12 @@ static modstruct modlist[] = {
   { "debug",                      MOD_PAT,  MOD_CTL, CTL_DEBUG,                  PO(control) },
   { "depth_limit",                MOD_CTM,  MOD_INT, 0,                          MO(depth_limit) },
   { "dfa",                        MOD_DAT,  MOD_CTL, CTL_DFA,                    DO(control) },
+  { "dfa_lazy",                   MOD_DAT,  MOD_OPT, PCRE2_DFA_LAZY,             DO(options) },
   { "dfa_restart",                MOD_DAT,  MOD_OPT, PCRE2_DFA_RESTART,          DO(options) },
   { "dfa_shortest",               MOD_DAT,  MOD_OPT, PCRE2_DFA_SHORTEST,         DO(options) },
+  { "dfa_stream",                 MOD_DAT,  MOD_INT, 0,                          DO(dfastream) },
+  { "dfa_stream_retain",          MOD_DAT,  MOD_INT, 0,                          DO(dfastreamretain) },
+  { "dfa_workspace",              MOD_DAT,  MOD_INT, 0,                          DO(dfaworkspace) },
   { "dollar_endonly",             MOD_PAT,  MOD_OPT, PCRE2_DOLLAR_ENDONLY,       PO(options) },
   { "dotall",                     MOD_PATP, MOD_OPT, PCRE2_DOTALL,               PO(options) },
   { "dupnames",                   MOD_PATP, MOD_OPT, PCRE2_DUPNAMES,             PO(options) },
@@ -628,12 +651,20 @@ static modstruct modlist[] = {
   { "getall",                     MOD_DAT,  MOD_CTL, CTL_GETALL,                 DO(control) },
   { "global",                     MOD_PNDP, MOD_CTL, CTL_GLOBAL,                 PO(control) },
   { "heap_limit",                 MOD_CTM,  MOD_INT, 0,                          MO(heap_limit) },
+  { "heapframes_shrink",          MOD_DAT,  MOD_SIZ, 0,                          DO(heapframes_shrink) },
+  { "heapframes_size",            MOD_DAT,  MOD_CTL, CTL2_HEAPFRAMES_SIZE,       DO(control2) },
   { "hex",                        MOD_PAT,  MOD_CTL, CTL_HEXPAT,                 PO(control) },
   { "info",                       MOD_PAT,  MOD_CTL, CTL_INFO,                   PO(control) },
   { "jit",                        MOD_PAT,  MOD_IND, 7,                          PO(jit) },
+  { "jitasync",                   MOD_PAT,  MOD_CTL, CTL2_JITASYNC,              PO(control2) },
+  { "jitcache",                   MOD_PAT,  MOD_CTL, CTL2_JITCACHE,              PO(control2) },
   { "jitfast",                    MOD_PAT,  MOD_CTL, CTL_JITFAST,                PO(control) },
+  { "jitlazy",                    MOD_PAT,  MOD_IN2, 0,                          PO(jitlazy) },
+  { "jitreload",                  MOD_PAT,  MOD_CTL, CTL2_JITRELOAD,             PO(control2) },
   { "jitstack",                   MOD_PNDP, MOD_INT, 0,                          PO(jitstack) },
+  { "jitstackpool",               MOD_DAT,  MOD_INT, 0,                          DO(jitstackpool) },
   { "jitverify",                  MOD_PAT,  MOD_CTL, CTL_JITVERIFY,              PO(control) },
+  { "linear",                     MOD_CTC,  MOD_OPT, PCRE2_EXTRA_LINEAR,         CO(extra_options) },
   { "literal",                    MOD_PAT,  MOD_OPT, PCRE2_LITERAL,              PO(options) },
   { "locale",                     MOD_PAT,  MOD_STR, LOCALESIZE,                 PO(locale) },
   { "mark",                       MOD_PNDP, MOD_CTL, CTL_MARK,                   PO(control) },
@@ -662,6 +693,7 @@ static modstruct modlist[] = {
   { "offset",                     MOD_DAT,  MOD_INT, 0,                          DO(offset) },
   { "offset_limit",               MOD_CTM,  MOD_SIZ, 0,                          MO(offset_limit)},
   { "ovector",                    MOD_DAT,  MOD_INT, 0,                          DO(oveccount) },
+  { "parallel",                   MOD_DAT,  MOD_INT, 0,                          DO(parallel) },
   { "parens_nest_limit",          MOD_CTC,  MOD_INT, 0,                          CO(parens_nest_limit) },
   { "partial_hard",               MOD_DAT,  MOD_OPT, PCRE2_PARTIAL_HARD,         DO(options) },
   { "partial_soft",               MOD_DAT,  MOD_OPT, PCRE2_PARTIAL_SOFT,         DO(options) },
@@ -860,6 +892,9 @@ static FILE *outfile;
 static const void *last_callout_mark;
 static PCRE2_JIT_STACK *jit_stack = NULL;
 static size_t jit_stack_size = 0;
+static void *jit_stack_pool = NULL;
+static void *jit_code_cache = NULL;
+static size_t jit_stack_pool_size = 0;
 
 static BOOL first_callout;
 static BOOL jit_was_used;
@@ -896,6 +931,10 @@ static datctl dat_datctl;
 static void *patstack[PATSTACKSIZE];
 static int patstacknext = 0;
 
+static void *pattern_set = NULL;
+static void *patsetcodes[PATSTACKSIZE];
+static int patsetcount = 0;
+
 static void *malloclist[MALLOCLISTSIZE];
 static PCRE2_SIZE malloclistlength[MALLOCLISTSIZE];
 static uint32_t malloclistptr = 0;
@@ -905,6 +944,14 @@ static regex_t preg = { NULL, NULL, 0, 0, 0, 0 };
 #endif
 
 static int *dfa_workspace = NULL;
+static void *dfa_workspace_object = NULL;
+static size_t dfa_workspace_object_size = 0;
+
+/* The workspace argument for pcre2_dfa_match() is NULL when a workspace object
+has been assigned to the match context. */
+
+#define DFA_WS_VECTOR ((dat_datctl.dfaworkspace != 0)? NULL : dfa_workspace)
+
 static const uint8_t *locale_tables = NULL;
 static const uint8_t *use_tables = NULL;
 static uint8_t locale_name[32];
@@ -1041,6 +1088,30 @@ are supported. */
   else \
     (void)pchars8((PCRE2_SPTR8)(p)+offset, len, utf, f)
 
+#define PCRE2_BATCH_DATA_CREATE(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    a = (void *)pcre2_match_data_create_from_pattern_8(G(b,8),NULL); \
+  else if (test_mode == PCRE16_MODE) \
+    a = (void *)pcre2_match_data_create_from_pattern_16(G(b,16),NULL); \
+  else \
+    a = (void *)pcre2_match_data_create_from_pattern_32(G(b,32),NULL)
+
+#define PCRE2_BATCH_DATA_FREE(a) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_match_data_free_8((pcre2_match_data_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_match_data_free_16((pcre2_match_data_16 *)a); \
+  else \
+    pcre2_match_data_free_32((pcre2_match_data_32 *)a)
+
+#define PCRE2_BATCH_OVECTOR(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_get_ovector_pointer_8((pcre2_match_data_8 *)b); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_get_ovector_pointer_16((pcre2_match_data_16 *)b); \
+  else \
+    a = pcre2_get_ovector_pointer_32((pcre2_match_data_32 *)b)
+
 #define PCRE2_CALLOUT_ENUMERATE(a,b,c) \
   if (test_mode == PCRE8_MODE) \
      a = pcre2_callout_enumerate_8(compiled_code8, \
@@ -1097,6 +1168,89 @@ are supported. */
   else \
     a = pcre2_dfa_match_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),h,i,j)
 
+#define PCRE2_DFA_STREAM_CREATE(a,b,c,d) \
+  if (test_mode == PCRE8_MODE) \
+    a = (void *)pcre2_dfa_stream_create_8(G(b,8),c,d,NULL); \
+  else if (test_mode == PCRE16_MODE) \
+    a = (void *)pcre2_dfa_stream_create_16(G(b,16),c,d,NULL); \
+  else \
+    a = (void *)pcre2_dfa_stream_create_32(G(b,32),c,d,NULL)
+
+#define PCRE2_DFA_STREAM_END(a,b,c) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_dfa_stream_end_8((pcre2_dfa_stream_8 *)b,c); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_dfa_stream_end_16((pcre2_dfa_stream_16 *)b,c); \
+  else \
+    a = pcre2_dfa_stream_end_32((pcre2_dfa_stream_32 *)b,c)
+
+#define PCRE2_DFA_STREAM_FREE(a) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_dfa_stream_free_8((pcre2_dfa_stream_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_dfa_stream_free_16((pcre2_dfa_stream_16 *)a); \
+  else \
+    pcre2_dfa_stream_free_32((pcre2_dfa_stream_32 *)a)
+
+#define PCRE2_DFA_STREAM_RESULTS(a,b,c) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_dfa_stream_count_8((pcre2_dfa_stream_8 *)c), \
+      b = pcre2_dfa_stream_ovector_8((pcre2_dfa_stream_8 *)c); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_dfa_stream_count_16((pcre2_dfa_stream_16 *)c), \
+      b = pcre2_dfa_stream_ovector_16((pcre2_dfa_stream_16 *)c); \
+  else \
+    a = pcre2_dfa_stream_count_32((pcre2_dfa_stream_32 *)c), \
+      b = pcre2_dfa_stream_ovector_32((pcre2_dfa_stream_32 *)c)
+
+#define PCRE2_DFA_STREAM_SCAN(a,b,c,d,e) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_dfa_stream_scan_8((pcre2_dfa_stream_8 *)b,(PCRE2_SPTR8)c,d,e); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_dfa_stream_scan_16((pcre2_dfa_stream_16 *)b,(PCRE2_SPTR16)c,d,e); \
+  else \
+    a = pcre2_dfa_stream_scan_32((pcre2_dfa_stream_32 *)b,(PCRE2_SPTR32)c,d,e)
+
+#define PCRE2_DFA_WORKSPACE_ASSIGN(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_dfa_workspace_assign_8(G(a,8),(pcre2_dfa_workspace_8 *)b); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_dfa_workspace_assign_16(G(a,16),(pcre2_dfa_workspace_16 *)b); \
+  else \
+    pcre2_dfa_workspace_assign_32(G(a,32),(pcre2_dfa_workspace_32 *)b);
+
+#define PCRE2_DFA_WORKSPACE_CREATE(a,b,c,d) \
+  if (test_mode == PCRE8_MODE) \
+    a = (void *)pcre2_dfa_workspace_create_8(b,c,d); \
+  else if (test_mode == PCRE16_MODE) \
+    a = (void *)pcre2_dfa_workspace_create_16(b,c,d); \
+  else \
+    a = (void *)pcre2_dfa_workspace_create_32(b,c,d);
+
+#define PCRE2_DFA_WORKSPACE_FREE(a) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_dfa_workspace_free_8((pcre2_dfa_workspace_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_dfa_workspace_free_16((pcre2_dfa_workspace_16 *)a); \
+  else \
+    pcre2_dfa_workspace_free_32((pcre2_dfa_workspace_32 *)a);
+
+#define PCRE2_DFA_WORKSPACE_PEAK(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_dfa_workspace_peak_8((pcre2_dfa_workspace_8 *)b); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_dfa_workspace_peak_16((pcre2_dfa_workspace_16 *)b); \
+  else \
+    a = pcre2_dfa_workspace_peak_32((pcre2_dfa_workspace_32 *)b)
+
+#define PCRE2_DFA_WORKSPACE_SIZE(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_dfa_workspace_size_8((pcre2_dfa_workspace_8 *)b); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_dfa_workspace_size_16((pcre2_dfa_workspace_16 *)b); \
+  else \
+    a = pcre2_dfa_workspace_size_32((pcre2_dfa_workspace_32 *)b)
+
 #define PCRE2_GET_ERROR_MESSAGE(r,a,b) \
   if (test_mode == PCRE8_MODE) \
     r = pcre2_get_error_message_8(a,G(b,8),G(G(b,8),_size)); \
@@ -1113,6 +1267,14 @@ are supported. */
   else \
     a = pcre2_get_ovector_count_32(G(b,32))
 
+#define PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_get_match_data_heapframes_size_8(G(b,8)); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_get_match_data_heapframes_size_16(G(b,16)); \
+  else \
+    a = pcre2_get_match_data_heapframes_size_32(G(b,32))
+
 #define PCRE2_GET_STARTCHAR(a,b) \
   if (test_mode == PCRE8_MODE) \
     a = pcre2_get_startchar_8(G(b,8)); \
@@ -1121,16 +1283,71 @@ are supported. */
   else \
     a = pcre2_get_startchar_32(G(b,32))
 
+#define PCRE2_JIT_CODE_CACHE_COMPILE(r,a,b,c) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_jit_code_cache_compile_8((pcre2_jit_code_cache_8 *)a,G(b,8),c); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_jit_code_cache_compile_16((pcre2_jit_code_cache_16 *)a,G(b,16),c); \
+  else \
+    r = pcre2_jit_code_cache_compile_32((pcre2_jit_code_cache_32 *)a,G(b,32),c)
+
+#define PCRE2_JIT_CODE_CACHE_CREATE(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    a = (void *)pcre2_jit_code_cache_create_8(b,NULL); \
+  else if (test_mode == PCRE16_MODE) \
+    a = (void *)pcre2_jit_code_cache_create_16(b,NULL); \
+  else \
+    a = (void *)pcre2_jit_code_cache_create_32(b,NULL);
+
+#define PCRE2_JIT_CODE_CACHE_FREE(a) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_jit_code_cache_free_8((pcre2_jit_code_cache_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_jit_code_cache_free_16((pcre2_jit_code_cache_16 *)a); \
+  else \
+    pcre2_jit_code_cache_free_32((pcre2_jit_code_cache_32 *)a);
+
 #define PCRE2_JIT_COMPILE(r,a,b) \
   if (test_mode == PCRE8_MODE) r = pcre2_jit_compile_8(G(a,8),b); \
   else if (test_mode == PCRE16_MODE) r = pcre2_jit_compile_16(G(a,16),b); \
   else r = pcre2_jit_compile_32(G(a,32),b)
 
+#define PCRE2_JIT_COMPILE_ASYNC(r,a,b) \
+  if (test_mode == PCRE8_MODE) r = pcre2_jit_compile_async_8(G(a,8),b); \
+  else if (test_mode == PCRE16_MODE) r = pcre2_jit_compile_async_16(G(a,16),b); \
+  else r = pcre2_jit_compile_async_32(G(a,32),b)
+
+#define PCRE2_JIT_COMPILE_LAZY(r,a,b,c,d) \
+  if (test_mode == PCRE8_MODE) r = pcre2_jit_compile_lazy_8(G(a,8),b,c,d); \
+  else if (test_mode == PCRE16_MODE) r = pcre2_jit_compile_lazy_16(G(a,16),b,c,d); \
+  else r = pcre2_jit_compile_lazy_32(G(a,32),b,c,d)
+
+#define PCRE2_JIT_COMPILE_WAIT(r,a) \
+  if (test_mode == PCRE8_MODE) r = pcre2_jit_compile_wait_8(G(a,8)); \
+  else if (test_mode == PCRE16_MODE) r = pcre2_jit_compile_wait_16(G(a,16)); \
+  else r = pcre2_jit_compile_wait_32(G(a,32))
+
 #define PCRE2_JIT_FREE_UNUSED_MEMORY(a) \
   if (test_mode == PCRE8_MODE) pcre2_jit_free_unused_memory_8(G(a,8)); \
   else if (test_mode == PCRE16_MODE) pcre2_jit_free_unused_memory_16(G(a,16)); \
   else pcre2_jit_free_unused_memory_32(G(a,32))
 
+#define PCRE2_JIT_SERIALIZE_DECODE(r,a,b,c) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_jit_serialize_decode_8(G(a,8),b,c); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_jit_serialize_decode_16(G(a,16),b,c); \
+  else \
+    r = pcre2_jit_serialize_decode_32(G(a,32),b,c)
+
+#define PCRE2_JIT_SERIALIZE_ENCODE(r,a,b,c,d) \
+  if (test_mode == PCRE8_MODE) \
+    r = pcre2_jit_serialize_encode_8(G(a,8),b,c,G(d,8)); \
+  else if (test_mode == PCRE16_MODE) \
+    r = pcre2_jit_serialize_encode_16(G(a,16),b,c,G(d,16)); \
+  else \
+    r = pcre2_jit_serialize_encode_32(G(a,32),b,c,G(d,32))
+
 #define PCRE2_JIT_MATCH(a,b,c,d,e,f,g,h) \
   if (test_mode == PCRE8_MODE) \
     a = pcre2_jit_match_8(G(b,8),(PCRE2_SPTR8)c,d,e,f,G(g,8),h); \
@@ -1139,6 +1356,17 @@ are supported. */
   else \
     a = pcre2_jit_match_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),h)
 
+#define PCRE2_JIT_MATCH_BATCH(a,b,c,d,e,f,g,h,i) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_jit_match_batch_8(G(b,8),(const PCRE2_SPTR8 *)c,d,e,f, \
+      (pcre2_match_data_8 **)g,h,i); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_jit_match_batch_16(G(b,16),(const PCRE2_SPTR16 *)c,d,e,f, \
+      (pcre2_match_data_16 **)g,h,i); \
+  else \
+    a = pcre2_jit_match_batch_32(G(b,32),(const PCRE2_SPTR32 *)c,d,e,f, \
+      (pcre2_match_data_32 **)g,h,i)
+
 #define PCRE2_JIT_STACK_CREATE(a,b,c,d) \
   if (test_mode == PCRE8_MODE) \
     a = (PCRE2_JIT_STACK *)pcre2_jit_stack_create_8(b,c,d); \
@@ -1163,6 +1391,38 @@ are supported. */
   else \
     pcre2_jit_stack_free_32((pcre2_jit_stack_32 *)a);
 
+#define PCRE2_JIT_STACK_POOL_ASSIGN(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_jit_stack_pool_assign_8(G(a,8),(pcre2_jit_stack_pool_8 *)b); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_jit_stack_pool_assign_16(G(a,16),(pcre2_jit_stack_pool_16 *)b); \
+  else \
+    pcre2_jit_stack_pool_assign_32(G(a,32),(pcre2_jit_stack_pool_32 *)b);
+
+#define PCRE2_JIT_STACK_POOL_CREATE(a,b,c,d) \
+  if (test_mode == PCRE8_MODE) \
+    a = (void *)pcre2_jit_stack_pool_create_8(b,c,d); \
+  else if (test_mode == PCRE16_MODE) \
+    a = (void *)pcre2_jit_stack_pool_create_16(b,c,d); \
+  else \
+    a = (void *)pcre2_jit_stack_pool_create_32(b,c,d);
+
+#define PCRE2_JIT_STACK_POOL_FREE(a) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_jit_stack_pool_free_8((pcre2_jit_stack_pool_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_jit_stack_pool_free_16((pcre2_jit_stack_pool_16 *)a); \
+  else \
+    pcre2_jit_stack_pool_free_32((pcre2_jit_stack_pool_32 *)a);
+
+#define PCRE2_JIT_STACK_POOL_INFO(a,b,c,d) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_jit_stack_pool_info_8((pcre2_jit_stack_pool_8 *)b,c,d); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_jit_stack_pool_info_16((pcre2_jit_stack_pool_16 *)b,c,d); \
+  else \
+    a = pcre2_jit_stack_pool_info_32((pcre2_jit_stack_pool_32 *)b,c,d)
+
 #define PCRE2_MAKETABLES(a) \
   if (test_mode == PCRE8_MODE) a = pcre2_maketables_8(NULL); \
   else if (test_mode == PCRE16_MODE) a = pcre2_maketables_16(NULL); \
@@ -1176,6 +1436,17 @@ are supported. */
   else \
     a = pcre2_match_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),h)
 
+#define PCRE2_MATCH_BATCH(a,b,c,d,e,f,g,h,i) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_match_batch_8(G(b,8),(const PCRE2_SPTR8 *)c,d,e,f, \
+      (pcre2_match_data_8 **)g,h,i); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_match_batch_16(G(b,16),(const PCRE2_SPTR16 *)c,d,e,f, \
+      (pcre2_match_data_16 **)g,h,i); \
+  else \
+    a = pcre2_match_batch_32(G(b,32),(const PCRE2_SPTR32 *)c,d,e,f, \
+      (pcre2_match_data_32 **)g,h,i)
+
 #define PCRE2_MATCH_DATA_CREATE(a,b,c) \
   if (test_mode == PCRE8_MODE) \
     G(a,8) = pcre2_match_data_create_8(b,c); \
@@ -1208,6 +1479,60 @@ are supported. */
   else \
     a = pcre2_pattern_convert_32(G(b,32),c,d,(PCRE2_UCHAR32 **)e,f,G(g,32))
 
+#define PCRE2_PARALLEL_CREATE(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    a = (void *)pcre2_parallel_match_create_8(G(b,8),NULL); \
+  else if (test_mode == PCRE16_MODE) \
+    a = (void *)pcre2_parallel_match_create_16(G(b,16),NULL); \
+  else \
+    a = (void *)pcre2_parallel_match_create_32(G(b,32),NULL)
+
+#define PCRE2_PARALLEL_FREE(a) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_parallel_match_free_8((pcre2_parallel_match_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_parallel_match_free_16((pcre2_parallel_match_16 *)a); \
+  else \
+    pcre2_parallel_match_free_32((pcre2_parallel_match_32 *)a)
+
+#define PCRE2_PARALLEL_MERGE(a,b,c) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_parallel_match_merge_8((pcre2_parallel_match_8 *)b,c); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_parallel_match_merge_16((pcre2_parallel_match_16 *)b,c); \
+  else \
+    a = pcre2_parallel_match_merge_32((pcre2_parallel_match_32 *)b,c)
+
+#define PCRE2_PARALLEL_RESULTS(a,b,c) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_parallel_match_count_8((pcre2_parallel_match_8 *)c), \
+      b = pcre2_parallel_match_ovector_8((pcre2_parallel_match_8 *)c); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_parallel_match_count_16((pcre2_parallel_match_16 *)c), \
+      b = pcre2_parallel_match_ovector_16((pcre2_parallel_match_16 *)c); \
+  else \
+    a = pcre2_parallel_match_count_32((pcre2_parallel_match_32 *)c), \
+      b = pcre2_parallel_match_ovector_32((pcre2_parallel_match_32 *)c)
+
+#define PCRE2_PARALLEL_RUN(a,b,c,d) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_parallel_match_run_8((pcre2_parallel_match_8 *)b,c,d); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_parallel_match_run_16((pcre2_parallel_match_16 *)b,c,d); \
+  else \
+    a = pcre2_parallel_match_run_32((pcre2_parallel_match_32 *)b,c,d)
+
+#define PCRE2_PARALLEL_SPLIT(a,b,c,d,e,f) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_parallel_match_split_8((pcre2_parallel_match_8 *)b, \
+      (PCRE2_SPTR8)c,d,e,f); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_parallel_match_split_16((pcre2_parallel_match_16 *)b, \
+      (PCRE2_SPTR16)c,d,e,f); \
+  else \
+    a = pcre2_parallel_match_split_32((pcre2_parallel_match_32 *)b, \
+      (PCRE2_SPTR32)c,d,e,f)
+
 #define PCRE2_PATTERN_INFO(a,b,c,d) \
   if (test_mode == PCRE8_MODE) \
     a = pcre2_pattern_info_8(G(b,8),c,d); \
@@ -1216,6 +1541,33 @@ are supported. */
   else \
     a = pcre2_pattern_info_32(G(b,32),c,d)
 
+#define PCRE2_PATTERN_SET_CREATE(a,b,c,d) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_pattern_set_create_8((const pcre2_code_8 **)b,c,G(d,8)); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_pattern_set_create_16((const pcre2_code_16 **)b,c,G(d,16)); \
+  else \
+    a = pcre2_pattern_set_create_32((const pcre2_code_32 **)b,c,G(d,32))
+
+#define PCRE2_PATTERN_SET_FREE(a) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_pattern_set_free_8((pcre2_pattern_set_8 *)a); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_pattern_set_free_16((pcre2_pattern_set_16 *)a); \
+  else \
+    pcre2_pattern_set_free_32((pcre2_pattern_set_32 *)a)
+
+#define PCRE2_PATTERN_SET_MATCH(a,b,c,d,e,f,g,h,i,j) \
+  if (test_mode == PCRE8_MODE) \
+    a = pcre2_pattern_set_match_8((pcre2_pattern_set_8 *)b,(PCRE2_SPTR8)c,d, \
+      e,f,G(g,8),h,i,j); \
+  else if (test_mode == PCRE16_MODE) \
+    a = pcre2_pattern_set_match_16((pcre2_pattern_set_16 *)b,(PCRE2_SPTR16)c, \
+      d,e,f,G(g,16),h,i,j); \
+  else \
+    a = pcre2_pattern_set_match_32((pcre2_pattern_set_32 *)b,(PCRE2_SPTR32)c, \
+      d,e,f,G(g,32),h,i,j)
+
 #define PCRE2_PRINTINT(a) \
   if (test_mode == PCRE8_MODE) \
     pcre2_printint_8(compiled_code8,outfile,a); \
@@ -1344,6 +1696,14 @@ are supported. */
   else \
     pcre2_set_parens_nest_limit_32(G(a,32),b)
 
+#define PCRE2_SHRINK_MATCH_DATA_HEAPFRAMES(a,b) \
+  if (test_mode == PCRE8_MODE) \
+    pcre2_shrink_match_data_heapframes_8(G(a,8),b); \
+  else if (test_mode == PCRE16_MODE) \
+    pcre2_shrink_match_data_heapframes_16(G(a,16),b); \
+  else \
+    pcre2_shrink_match_data_heapframes_32(G(a,32),b)
+
 #define PCRE2_SUBSTITUTE(a,b,c,d,e,f,g,h,i,j,k,l) \
   if (test_mode == PCRE8_MODE) \
     a = pcre2_substitute_8(G(b,8),(PCRE2_SPTR8)c,d,e,f,G(g,8),G(h,8), \
@@ -1569,6 +1929,24 @@ the three different cases. */
   else \
     (void)G(pchars,BITTWO)((G(PCRE2_SPTR,BITTWO))(p)+offset, len, utf, f)
 
+#define PCRE2_BATCH_DATA_CREATE(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = (void *)G(pcre2_match_data_create_from_pattern_,BITONE)(G(b,BITONE),NULL); \
+  else \
+    a = (void *)G(pcre2_match_data_create_from_pattern_,BITTWO)(G(b,BITTWO),NULL)
+
+#define PCRE2_BATCH_DATA_FREE(a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_match_data_free_,BITONE)((G(pcre2_match_data_,BITONE) *)a); \
+  else \
+    G(pcre2_match_data_free_,BITTWO)((G(pcre2_match_data_,BITTWO) *)a)
+
+#define PCRE2_BATCH_OVECTOR(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_get_ovector_pointer_,BITONE)((G(pcre2_match_data_,BITONE) *)b); \
+  else \
+    a = G(pcre2_get_ovector_pointer_,BITTWO)((G(pcre2_match_data_,BITTWO) *)b)
+
 #define PCRE2_CALLOUT_ENUMERATE(a,b,c) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
      a = G(pcre2_callout_enumerate,BITONE)(G(compiled_code,BITONE), \
@@ -1615,6 +1993,76 @@ the three different cases. */
     a = G(pcre2_dfa_match_,BITTWO)(G(b,BITTWO),(G(PCRE2_SPTR,BITTWO))c,d,e,f, \
       G(g,BITTWO),h,i,j)
 
+#define PCRE2_DFA_STREAM_CREATE(a,b,c,d) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = (void *)G(pcre2_dfa_stream_create_,BITONE)(G(b,BITONE),c,d,NULL); \
+  else \
+    a = (void *)G(pcre2_dfa_stream_create_,BITTWO)(G(b,BITTWO),c,d,NULL)
+
+#define PCRE2_DFA_STREAM_END(a,b,c) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_dfa_stream_end_,BITONE)((G(pcre2_dfa_stream_,BITONE) *)b,c); \
+  else \
+    a = G(pcre2_dfa_stream_end_,BITTWO)((G(pcre2_dfa_stream_,BITTWO) *)b,c)
+
+#define PCRE2_DFA_STREAM_FREE(a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_dfa_stream_free_,BITONE)((G(pcre2_dfa_stream_,BITONE) *)a); \
+  else \
+    G(pcre2_dfa_stream_free_,BITTWO)((G(pcre2_dfa_stream_,BITTWO) *)a)
+
+#define PCRE2_DFA_STREAM_RESULTS(a,b,c) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_dfa_stream_count_,BITONE)((G(pcre2_dfa_stream_,BITONE) *)c), \
+      b = G(pcre2_dfa_stream_ovector_,BITONE)((G(pcre2_dfa_stream_,BITONE) *)c); \
+  else \
+    a = G(pcre2_dfa_stream_count_,BITTWO)((G(pcre2_dfa_stream_,BITTWO) *)c), \
+      b = G(pcre2_dfa_stream_ovector_,BITTWO)((G(pcre2_dfa_stream_,BITTWO) *)c)
+
+#define PCRE2_DFA_STREAM_SCAN(a,b,c,d,e) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_dfa_stream_scan_,BITONE)((G(pcre2_dfa_stream_,BITONE) *)b, \
+      (G(PCRE2_SPTR,BITONE))c,d,e); \
+  else \
+    a = G(pcre2_dfa_stream_scan_,BITTWO)((G(pcre2_dfa_stream_,BITTWO) *)b, \
+      (G(PCRE2_SPTR,BITTWO))c,d,e)
+
+#define PCRE2_DFA_WORKSPACE_ASSIGN(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_dfa_workspace_assign_,BITONE)(G(a,BITONE), \
+      (G(pcre2_dfa_workspace_,BITONE) *)b); \
+  else \
+    G(pcre2_dfa_workspace_assign_,BITTWO)(G(a,BITTWO), \
+      (G(pcre2_dfa_workspace_,BITTWO) *)b);
+
+#define PCRE2_DFA_WORKSPACE_CREATE(a,b,c,d) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = (void *)G(pcre2_dfa_workspace_create_,BITONE)(b,c,d); \
+  else \
+    a = (void *)G(pcre2_dfa_workspace_create_,BITTWO)(b,c,d);
+
+#define PCRE2_DFA_WORKSPACE_FREE(a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_dfa_workspace_free_,BITONE)((G(pcre2_dfa_workspace_,BITONE) *)a); \
+  else \
+    G(pcre2_dfa_workspace_free_,BITTWO)((G(pcre2_dfa_workspace_,BITTWO) *)a);
+
+#define PCRE2_DFA_WORKSPACE_PEAK(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_dfa_workspace_peak_,BITONE)( \
+      (G(pcre2_dfa_workspace_,BITONE) *)b); \
+  else \
+    a = G(pcre2_dfa_workspace_peak_,BITTWO)( \
+      (G(pcre2_dfa_workspace_,BITTWO) *)b)
+
+#define PCRE2_DFA_WORKSPACE_SIZE(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_dfa_workspace_size_,BITONE)( \
+      (G(pcre2_dfa_workspace_,BITONE) *)b); \
+  else \
+    a = G(pcre2_dfa_workspace_size_,BITTWO)( \
+      (G(pcre2_dfa_workspace_,BITTWO) *)b)
+
 #define PCRE2_GET_ERROR_MESSAGE(r,a,b) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     r = G(pcre2_get_error_message_,BITONE)(a,G(b,BITONE),G(G(b,BITONE),_size/BYTEONE)); \
@@ -1627,24 +2075,80 @@ the three different cases. */
   else \
     a = G(pcre2_get_ovector_count_,BITTWO)(G(b,BITTWO))
 
+#define PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_get_match_data_heapframes_size_,BITONE)(G(b,BITONE)); \
+  else \
+    a = G(pcre2_get_match_data_heapframes_size_,BITTWO)(G(b,BITTWO))
+
 #define PCRE2_GET_STARTCHAR(a,b) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     a = G(pcre2_get_startchar_,BITONE)(G(b,BITONE)); \
   else \
     a = G(pcre2_get_startchar_,BITTWO)(G(b,BITTWO))
 
+#define PCRE2_JIT_CODE_CACHE_COMPILE(r,a,b,c) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_jit_code_cache_compile_,BITONE)( \
+      (G(pcre2_jit_code_cache_,BITONE) *)a,G(b,BITONE),c); \
+  else \
+    r = G(pcre2_jit_code_cache_compile_,BITTWO)( \
+      (G(pcre2_jit_code_cache_,BITTWO) *)a,G(b,BITTWO),c)
+
+#define PCRE2_JIT_CODE_CACHE_CREATE(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = (void *)G(pcre2_jit_code_cache_create_,BITONE)(b,NULL); \
+  else \
+    a = (void *)G(pcre2_jit_code_cache_create_,BITTWO)(b,NULL);
+
+#define PCRE2_JIT_CODE_CACHE_FREE(a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_jit_code_cache_free_,BITONE)((G(pcre2_jit_code_cache_,BITONE) *)a); \
+  else \
+    G(pcre2_jit_code_cache_free_,BITTWO)((G(pcre2_jit_code_cache_,BITTWO) *)a);
+
 #define PCRE2_JIT_COMPILE(r,a,b) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     r = G(pcre2_jit_compile_,BITONE)(G(a,BITONE),b); \
   else \
     r = G(pcre2_jit_compile_,BITTWO)(G(a,BITTWO),b)
 
+#define PCRE2_JIT_COMPILE_ASYNC(r,a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_jit_compile_async_,BITONE)(G(a,BITONE),b); \
+  else \
+    r = G(pcre2_jit_compile_async_,BITTWO)(G(a,BITTWO),b)
+
+#define PCRE2_JIT_COMPILE_LAZY(r,a,b,c,d) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_jit_compile_lazy_,BITONE)(G(a,BITONE),b,c,d); \
+  else \
+    r = G(pcre2_jit_compile_lazy_,BITTWO)(G(a,BITTWO),b,c,d)
+
+#define PCRE2_JIT_COMPILE_WAIT(r,a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_jit_compile_wait_,BITONE)(G(a,BITONE)); \
+  else \
+    r = G(pcre2_jit_compile_wait_,BITTWO)(G(a,BITTWO))
+
 #define PCRE2_JIT_FREE_UNUSED_MEMORY(a) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     G(pcre2_jit_free_unused_memory_,BITONE)(G(a,BITONE)); \
   else \
     G(pcre2_jit_free_unused_memory_,BITTWO)(G(a,BITTWO))
 
+#define PCRE2_JIT_SERIALIZE_DECODE(r,a,b,c) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_jit_serialize_decode_,BITONE)(G(a,BITONE),b,c); \
+  else \
+    r = G(pcre2_jit_serialize_decode_,BITTWO)(G(a,BITTWO),b,c)
+
+#define PCRE2_JIT_SERIALIZE_ENCODE(r,a,b,c,d) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    r = G(pcre2_jit_serialize_encode_,BITONE)(G(a,BITONE),b,c,G(d,BITONE)); \
+  else \
+    r = G(pcre2_jit_serialize_encode_,BITTWO)(G(a,BITTWO),b,c,G(d,BITTWO))
+
 #define PCRE2_JIT_MATCH(a,b,c,d,e,f,g,h) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     a = G(pcre2_jit_match_,BITONE)(G(b,BITONE),(G(PCRE2_SPTR,BITONE))c,d,e,f, \
@@ -1653,6 +2157,14 @@ the three different cases. */
     a = G(pcre2_jit_match_,BITTWO)(G(b,BITTWO),(G(PCRE2_SPTR,BITTWO))c,d,e,f, \
       G(g,BITTWO),h)
 
+#define PCRE2_JIT_MATCH_BATCH(a,b,c,d,e,f,g,h,i) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_jit_match_batch_,BITONE)(G(b,BITONE), \
+      (const G(PCRE2_SPTR,BITONE) *)c,d,e,f,(G(pcre2_match_data_,BITONE) **)g,h,i); \
+  else \
+    a = G(pcre2_jit_match_batch_,BITTWO)(G(b,BITTWO), \
+      (const G(PCRE2_SPTR,BITTWO) *)c,d,e,f,(G(pcre2_match_data_,BITTWO) **)g,h,i)
+
 #define PCRE2_JIT_STACK_CREATE(a,b,c,d) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     a = (PCRE2_JIT_STACK *)G(pcre2_jit_stack_create_,BITONE)(b,c,d); \
@@ -1671,6 +2183,34 @@ the three different cases. */
   else \
     G(pcre2_jit_stack_free_,BITTWO)((G(pcre2_jit_stack_,BITTWO) *)a);
 
+#define PCRE2_JIT_STACK_POOL_ASSIGN(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_jit_stack_pool_assign_,BITONE)(G(a,BITONE), \
+      (G(pcre2_jit_stack_pool_,BITONE) *)b); \
+  else \
+    G(pcre2_jit_stack_pool_assign_,BITTWO)(G(a,BITTWO), \
+      (G(pcre2_jit_stack_pool_,BITTWO) *)b);
+
+#define PCRE2_JIT_STACK_POOL_CREATE(a,b,c,d) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = (void *)G(pcre2_jit_stack_pool_create_,BITONE)(b,c,d); \
+  else \
+    a = (void *)G(pcre2_jit_stack_pool_create_,BITTWO)(b,c,d);
+
+#define PCRE2_JIT_STACK_POOL_FREE(a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_jit_stack_pool_free_,BITONE)((G(pcre2_jit_stack_pool_,BITONE) *)a); \
+  else \
+    G(pcre2_jit_stack_pool_free_,BITTWO)((G(pcre2_jit_stack_pool_,BITTWO) *)a);
+
+#define PCRE2_JIT_STACK_POOL_INFO(a,b,c,d) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_jit_stack_pool_info_,BITONE)( \
+      (G(pcre2_jit_stack_pool_,BITONE) *)b,c,d); \
+  else \
+    a = G(pcre2_jit_stack_pool_info_,BITTWO)( \
+      (G(pcre2_jit_stack_pool_,BITTWO) *)b,c,d)
+
 #define PCRE2_MAKETABLES(a) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     a = G(pcre2_maketables_,BITONE)(NULL); \
@@ -1685,6 +2225,14 @@ the three different cases. */
     a = G(pcre2_match_,BITTWO)(G(b,BITTWO),(G(PCRE2_SPTR,BITTWO))c,d,e,f, \
       G(g,BITTWO),h)
 
+#define PCRE2_MATCH_BATCH(a,b,c,d,e,f,g,h,i) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_match_batch_,BITONE)(G(b,BITONE), \
+      (const G(PCRE2_SPTR,BITONE) *)c,d,e,f,(G(pcre2_match_data_,BITONE) **)g,h,i); \
+  else \
+    a = G(pcre2_match_batch_,BITTWO)(G(b,BITTWO), \
+      (const G(PCRE2_SPTR,BITTWO) *)c,d,e,f,(G(pcre2_match_data_,BITTWO) **)g,h,i)
+
 #define PCRE2_MATCH_DATA_CREATE(a,b,c) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     G(a,BITONE) = G(pcre2_match_data_create_,BITONE)(b,c); \
@@ -1709,12 +2257,72 @@ the three different cases. */
   else \
     a = G(pcre2_pattern_convert_,BITTWO)(G(b,BITTWO),c,d,(G(PCRE2_UCHAR,BITTWO) **)e,f,G(g,BITTWO))
 
+#define PCRE2_PARALLEL_CREATE(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = (void *)G(pcre2_parallel_match_create_,BITONE)(G(b,BITONE),NULL); \
+  else \
+    a = (void *)G(pcre2_parallel_match_create_,BITTWO)(G(b,BITTWO),NULL)
+
+#define PCRE2_PARALLEL_FREE(a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_parallel_match_free_,BITONE)((G(pcre2_parallel_match_,BITONE) *)a); \
+  else \
+    G(pcre2_parallel_match_free_,BITTWO)((G(pcre2_parallel_match_,BITTWO) *)a)
+
+#define PCRE2_PARALLEL_MERGE(a,b,c) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_parallel_match_merge_,BITONE)((G(pcre2_parallel_match_,BITONE) *)b,c); \
+  else \
+    a = G(pcre2_parallel_match_merge_,BITTWO)((G(pcre2_parallel_match_,BITTWO) *)b,c)
+
+#define PCRE2_PARALLEL_RESULTS(a,b,c) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_parallel_match_count_,BITONE)((G(pcre2_parallel_match_,BITONE) *)c), \
+      b = G(pcre2_parallel_match_ovector_,BITONE)((G(pcre2_parallel_match_,BITONE) *)c); \
+  else \
+    a = G(pcre2_parallel_match_count_,BITTWO)((G(pcre2_parallel_match_,BITTWO) *)c), \
+      b = G(pcre2_parallel_match_ovector_,BITTWO)((G(pcre2_parallel_match_,BITTWO) *)c)
+
+#define PCRE2_PARALLEL_RUN(a,b,c,d) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_parallel_match_run_,BITONE)((G(pcre2_parallel_match_,BITONE) *)b,c,d); \
+  else \
+    a = G(pcre2_parallel_match_run_,BITTWO)((G(pcre2_parallel_match_,BITTWO) *)b,c,d)
+
+#define PCRE2_PARALLEL_SPLIT(a,b,c,d,e,f) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_parallel_match_split_,BITONE)((G(pcre2_parallel_match_,BITONE) *)b, \
+      (G(PCRE2_SPTR,BITONE))c,d,e,f); \
+  else \
+    a = G(pcre2_parallel_match_split_,BITTWO)((G(pcre2_parallel_match_,BITTWO) *)b, \
+      (G(PCRE2_SPTR,BITTWO))c,d,e,f)
+
 #define PCRE2_PATTERN_INFO(a,b,c,d) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     a = G(pcre2_pattern_info_,BITONE)(G(b,BITONE),c,d); \
   else \
     a = G(pcre2_pattern_info_,BITTWO)(G(b,BITTWO),c,d)
 
+#define PCRE2_PATTERN_SET_CREATE(a,b,c,d) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_pattern_set_create_,BITONE)((G(const pcre2_code_,BITONE) **)b,c,G(d,BITONE)); \
+  else \
+    a = G(pcre2_pattern_set_create_,BITTWO)((G(const pcre2_code_,BITTWO) **)b,c,G(d,BITTWO))
+
+#define PCRE2_PATTERN_SET_FREE(a) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_pattern_set_free_,BITONE)((G(pcre2_pattern_set_,BITONE) *)a); \
+  else \
+    G(pcre2_pattern_set_free_,BITTWO)((G(pcre2_pattern_set_,BITTWO) *)a)
+
+#define PCRE2_PATTERN_SET_MATCH(a,b,c,d,e,f,g,h,i,j) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    a = G(pcre2_pattern_set_match_,BITONE)((G(pcre2_pattern_set_,BITONE) *)b, \
+      (G(PCRE2_SPTR,BITONE))c,d,e,f,G(g,BITONE),h,i,j); \
+  else \
+    a = G(pcre2_pattern_set_match_,BITTWO)((G(pcre2_pattern_set_,BITTWO) *)b, \
+      (G(PCRE2_SPTR,BITTWO))c,d,e,f,G(g,BITTWO),h,i,j)
+
 #define PCRE2_PRINTINT(a) \
  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     G(pcre2_printint_,BITONE)(G(compiled_code,BITONE),outfile,a); \
@@ -1813,6 +2421,12 @@ the three different cases. */
   else \
     G(pcre2_set_parens_nest_limit_,BITTWO)(G(a,BITTWO),b)
 
+#define PCRE2_SHRINK_MATCH_DATA_HEAPFRAMES(a,b) \
+  if (test_mode == G(G(PCRE,BITONE),_MODE)) \
+    G(pcre2_shrink_match_data_heapframes_,BITONE)(G(a,BITONE),b); \
+  else \
+    G(pcre2_shrink_match_data_heapframes_,BITTWO)(G(a,BITTWO),b)
+
 #define PCRE2_SUBSTITUTE(a,b,c,d,e,f,g,h,i,j,k,l) \
   if (test_mode == G(G(PCRE,BITONE),_MODE)) \
     a = G(pcre2_substitute_,BITONE)(G(b,BITONE),(G(PCRE2_SPTR,BITONE))c,d,e,f, \
@@ -1959,6 +2573,12 @@ the three different cases. */
   lv = pchars8((PCRE2_SPTR8)(p)+offset, len, utf, f)
 #define PCHARSV(p, offset, len, utf, f) \
   (void)pchars8((PCRE2_SPTR8)(p)+offset, len, utf, f)
+#define PCRE2_BATCH_DATA_CREATE(a,b) \
+  a = (void *)pcre2_match_data_create_from_pattern_8(G(b,8),NULL)
+#define PCRE2_BATCH_DATA_FREE(a) \
+  pcre2_match_data_free_8((pcre2_match_data_8 *)a)
+#define PCRE2_BATCH_OVECTOR(a,b) \
+  a = pcre2_get_ovector_pointer_8((pcre2_match_data_8 *)b)
 #define PCRE2_CALLOUT_ENUMERATE(a,b,c) \
    a = pcre2_callout_enumerate_8(compiled_code8, \
      (int (*)(struct pcre2_callout_enumerate_block_8 *, void *))b,c)
@@ -1971,28 +2591,100 @@ the three different cases. */
   pcre2_converted_pattern_free_8((PCRE2_UCHAR8 *)a)
 #define PCRE2_DFA_MATCH(a,b,c,d,e,f,g,h,i,j) \
   a = pcre2_dfa_match_8(G(b,8),(PCRE2_SPTR8)c,d,e,f,G(g,8),h,i,j)
+#define PCRE2_DFA_STREAM_CREATE(a,b,c,d) \
+  a = (void *)pcre2_dfa_stream_create_8(G(b,8),c,d,NULL)
+#define PCRE2_DFA_STREAM_END(a,b,c) \
+  a = pcre2_dfa_stream_end_8((pcre2_dfa_stream_8 *)b,c)
+#define PCRE2_DFA_STREAM_FREE(a) \
+  pcre2_dfa_stream_free_8((pcre2_dfa_stream_8 *)a)
+#define PCRE2_DFA_STREAM_RESULTS(a,b,c) \
+  a = pcre2_dfa_stream_count_8((pcre2_dfa_stream_8 *)c), \
+    b = pcre2_dfa_stream_ovector_8((pcre2_dfa_stream_8 *)c)
+#define PCRE2_DFA_STREAM_SCAN(a,b,c,d,e) \
+  a = pcre2_dfa_stream_scan_8((pcre2_dfa_stream_8 *)b,(PCRE2_SPTR8)c,d,e)
+#define PCRE2_DFA_WORKSPACE_ASSIGN(a,b) \
+  pcre2_dfa_workspace_assign_8(G(a,8),(pcre2_dfa_workspace_8 *)b);
+#define PCRE2_DFA_WORKSPACE_CREATE(a,b,c,d) \
+  a = (void *)pcre2_dfa_workspace_create_8(b,c,d);
+#define PCRE2_DFA_WORKSPACE_FREE(a) \
+  pcre2_dfa_workspace_free_8((pcre2_dfa_workspace_8 *)a);
+#define PCRE2_DFA_WORKSPACE_PEAK(a,b) \
+  a = pcre2_dfa_workspace_peak_8((pcre2_dfa_workspace_8 *)b)
+#define PCRE2_DFA_WORKSPACE_SIZE(a,b) \
+  a = pcre2_dfa_workspace_size_8((pcre2_dfa_workspace_8 *)b)
 #define PCRE2_GET_ERROR_MESSAGE(r,a,b) \
   r = pcre2_get_error_message_8(a,G(b,8),G(G(b,8),_size))
 #define PCRE2_GET_OVECTOR_COUNT(a,b) a = pcre2_get_ovector_count_8(G(b,8))
+#define PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(a,b) \
+  a = pcre2_get_match_data_heapframes_size_8(G(b,8))
 #define PCRE2_GET_STARTCHAR(a,b) a = pcre2_get_startchar_8(G(b,8))
+#define PCRE2_JIT_CODE_CACHE_COMPILE(r,a,b,c) \
+  r = pcre2_jit_code_cache_compile_8((pcre2_jit_code_cache_8 *)a,G(b,8),c)
+#define PCRE2_JIT_CODE_CACHE_CREATE(a,b) \
+  a = (void *)pcre2_jit_code_cache_create_8(b,NULL);
+#define PCRE2_JIT_CODE_CACHE_FREE(a) \
+  pcre2_jit_code_cache_free_8((pcre2_jit_code_cache_8 *)a);
 #define PCRE2_JIT_COMPILE(r,a,b) r = pcre2_jit_compile_8(G(a,8),b)
+#define PCRE2_JIT_COMPILE_ASYNC(r,a,b) r = pcre2_jit_compile_async_8(G(a,8),b)
+#define PCRE2_JIT_COMPILE_LAZY(r,a,b,c,d) \
+  r = pcre2_jit_compile_lazy_8(G(a,8),b,c,d)
+#define PCRE2_JIT_COMPILE_WAIT(r,a) r = pcre2_jit_compile_wait_8(G(a,8))
 #define PCRE2_JIT_FREE_UNUSED_MEMORY(a) pcre2_jit_free_unused_memory_8(G(a,8))
+#define PCRE2_JIT_SERIALIZE_DECODE(r,a,b,c) \
+  r = pcre2_jit_serialize_decode_8(G(a,8),b,c)
+#define PCRE2_JIT_SERIALIZE_ENCODE(r,a,b,c,d) \
+  r = pcre2_jit_serialize_encode_8(G(a,8),b,c,G(d,8))
 #define PCRE2_JIT_MATCH(a,b,c,d,e,f,g,h) \
   a = pcre2_jit_match_8(G(b,8),(PCRE2_SPTR8)c,d,e,f,G(g,8),h)
+#define PCRE2_JIT_MATCH_BATCH(a,b,c,d,e,f,g,h,i) \
+  a = pcre2_jit_match_batch_8(G(b,8),(const PCRE2_SPTR8 *)c,d,e,f, \
+    (pcre2_match_data_8 **)g,h,i)
 #define PCRE2_JIT_STACK_CREATE(a,b,c,d) \
   a = (PCRE2_JIT_STACK *)pcre2_jit_stack_create_8(b,c,d);
 #define PCRE2_JIT_STACK_ASSIGN(a,b,c) \
   pcre2_jit_stack_assign_8(G(a,8),(pcre2_jit_callback_8)b,c);
 #define PCRE2_JIT_STACK_FREE(a) pcre2_jit_stack_free_8((pcre2_jit_stack_8 *)a);
+#define PCRE2_JIT_STACK_POOL_ASSIGN(a,b) \
+  pcre2_jit_stack_pool_assign_8(G(a,8),(pcre2_jit_stack_pool_8 *)b);
+#define PCRE2_JIT_STACK_POOL_CREATE(a,b,c,d) \
+  a = (void *)pcre2_jit_stack_pool_create_8(b,c,d);
+#define PCRE2_JIT_STACK_POOL_FREE(a) \
+  pcre2_jit_stack_pool_free_8((pcre2_jit_stack_pool_8 *)a);
+#define PCRE2_JIT_STACK_POOL_INFO(a,b,c,d) \
+  a = pcre2_jit_stack_pool_info_8((pcre2_jit_stack_pool_8 *)b,c,d)
 #define PCRE2_MAKETABLES(a) a = pcre2_maketables_8(NULL)
 #define PCRE2_MATCH(a,b,c,d,e,f,g,h) \
   a = pcre2_match_8(G(b,8),(PCRE2_SPTR8)c,d,e,f,G(g,8),h)
+#define PCRE2_MATCH_BATCH(a,b,c,d,e,f,g,h,i) \
+  a = pcre2_match_batch_8(G(b,8),(const PCRE2_SPTR8 *)c,d,e,f, \
+    (pcre2_match_data_8 **)g,h,i)
 #define PCRE2_MATCH_DATA_CREATE(a,b,c) G(a,8) = pcre2_match_data_create_8(b,c)
 #define PCRE2_MATCH_DATA_CREATE_FROM_PATTERN(a,b,c) \
   G(a,8) = pcre2_match_data_create_from_pattern_8(G(b,8),c)
 #define PCRE2_MATCH_DATA_FREE(a) pcre2_match_data_free_8(G(a,8))
 #define PCRE2_PATTERN_CONVERT(a,b,c,d,e,f,g) a = pcre2_pattern_convert_8(G(b,8),c,d,(PCRE2_UCHAR8 **)e,f,G(g,8))
+#define PCRE2_PARALLEL_CREATE(a,b) \
+  a = (void *)pcre2_parallel_match_create_8(G(b,8),NULL)
+#define PCRE2_PARALLEL_FREE(a) \
+  pcre2_parallel_match_free_8((pcre2_parallel_match_8 *)a)
+#define PCRE2_PARALLEL_MERGE(a,b,c) \
+  a = pcre2_parallel_match_merge_8((pcre2_parallel_match_8 *)b,c)
+#define PCRE2_PARALLEL_RESULTS(a,b,c) \
+  a = pcre2_parallel_match_count_8((pcre2_parallel_match_8 *)c), \
+    b = pcre2_parallel_match_ovector_8((pcre2_parallel_match_8 *)c)
+#define PCRE2_PARALLEL_RUN(a,b,c,d) \
+  a = pcre2_parallel_match_run_8((pcre2_parallel_match_8 *)b,c,d)
+#define PCRE2_PARALLEL_SPLIT(a,b,c,d,e,f) \
+  a = pcre2_parallel_match_split_8((pcre2_parallel_match_8 *)b, \
+    (PCRE2_SPTR8)c,d,e,f)
 #define PCRE2_PATTERN_INFO(a,b,c,d) a = pcre2_pattern_info_8(G(b,8),c,d)
+#define PCRE2_PATTERN_SET_CREATE(a,b,c,d) \
+  a = pcre2_pattern_set_create_8((const pcre2_code_8 **)b,c,G(d,8))
+#define PCRE2_PATTERN_SET_FREE(a) \
+  pcre2_pattern_set_free_8((pcre2_pattern_set_8 *)a)
+#define PCRE2_PATTERN_SET_MATCH(a,b,c,d,e,f,g,h,i,j) \
+  a = pcre2_pattern_set_match_8((pcre2_pattern_set_8 *)b,(PCRE2_SPTR8)c,d,e,f, \
+    G(g,8),h,i,j)
 #define PCRE2_PRINTINT(a) pcre2_printint_8(compiled_code8,outfile,a)
 #define PCRE2_SERIALIZE_DECODE(r,a,b,c,d) \
   r = pcre2_serialize_decode_8((pcre2_code_8 **)a,b,c,G(d,8))
@@ -2014,6 +2706,8 @@ the three different cases. */
 #define PCRE2_SET_MAX_PATTERN_LENGTH(a,b) pcre2_set_max_pattern_length_8(G(a,8),b)
 #define PCRE2_SET_OFFSET_LIMIT(a,b) pcre2_set_offset_limit_8(G(a,8),b)
 #define PCRE2_SET_PARENS_NEST_LIMIT(a,b) pcre2_set_parens_nest_limit_8(G(a,8),b)
+#define PCRE2_SHRINK_MATCH_DATA_HEAPFRAMES(a,b) \
+  pcre2_shrink_match_data_heapframes_8(G(a,8),b)
 #define PCRE2_SUBSTITUTE(a,b,c,d,e,f,g,h,i,j,k,l) \
   a = pcre2_substitute_8(G(b,8),(PCRE2_SPTR8)c,d,e,f,G(g,8),G(h,8), \
     (PCRE2_SPTR8)i,j,(PCRE2_UCHAR8 *)k,l)
@@ -2063,6 +2757,12 @@ the three different cases. */
   lv = pchars16((PCRE2_SPTR16)(p)+offset, len, utf, f)
 #define PCHARSV(p, offset, len, utf, f) \
   (void)pchars16((PCRE2_SPTR16)(p)+offset, len, utf, f)
+#define PCRE2_BATCH_DATA_CREATE(a,b) \
+  a = (void *)pcre2_match_data_create_from_pattern_16(G(b,16),NULL)
+#define PCRE2_BATCH_DATA_FREE(a) \
+  pcre2_match_data_free_16((pcre2_match_data_16 *)a)
+#define PCRE2_BATCH_OVECTOR(a,b) \
+  a = pcre2_get_ovector_pointer_16((pcre2_match_data_16 *)b)
 #define PCRE2_CALLOUT_ENUMERATE(a,b,c) \
    a = pcre2_callout_enumerate_16(compiled_code16, \
      (int (*)(struct pcre2_callout_enumerate_block_16 *, void *))b,c)
@@ -2075,28 +2775,100 @@ the three different cases. */
   pcre2_converted_pattern_free_16((PCRE2_UCHAR16 *)a)
 #define PCRE2_DFA_MATCH(a,b,c,d,e,f,g,h,i,j) \
   a = pcre2_dfa_match_16(G(b,16),(PCRE2_SPTR16)c,d,e,f,G(g,16),h,i,j)
+#define PCRE2_DFA_STREAM_CREATE(a,b,c,d) \
+  a = (void *)pcre2_dfa_stream_create_16(G(b,16),c,d,NULL)
+#define PCRE2_DFA_STREAM_END(a,b,c) \
+  a = pcre2_dfa_stream_end_16((pcre2_dfa_stream_16 *)b,c)
+#define PCRE2_DFA_STREAM_FREE(a) \
+  pcre2_dfa_stream_free_16((pcre2_dfa_stream_16 *)a)
+#define PCRE2_DFA_STREAM_RESULTS(a,b,c) \
+  a = pcre2_dfa_stream_count_16((pcre2_dfa_stream_16 *)c), \
+    b = pcre2_dfa_stream_ovector_16((pcre2_dfa_stream_16 *)c)
+#define PCRE2_DFA_STREAM_SCAN(a,b,c,d,e) \
+  a = pcre2_dfa_stream_scan_16((pcre2_dfa_stream_16 *)b,(PCRE2_SPTR16)c,d,e)
+#define PCRE2_DFA_WORKSPACE_ASSIGN(a,b) \
+  pcre2_dfa_workspace_assign_16(G(a,16),(pcre2_dfa_workspace_16 *)b);
+#define PCRE2_DFA_WORKSPACE_CREATE(a,b,c,d) \
+  a = (void *)pcre2_dfa_workspace_create_16(b,c,d);
+#define PCRE2_DFA_WORKSPACE_FREE(a) \
+  pcre2_dfa_workspace_free_16((pcre2_dfa_workspace_16 *)a);
+#define PCRE2_DFA_WORKSPACE_PEAK(a,b) \
+  a = pcre2_dfa_workspace_peak_16((pcre2_dfa_workspace_16 *)b)
+#define PCRE2_DFA_WORKSPACE_SIZE(a,b) \
+  a = pcre2_dfa_workspace_size_16((pcre2_dfa_workspace_16 *)b)
 #define PCRE2_GET_ERROR_MESSAGE(r,a,b) \
   r = pcre2_get_error_message_16(a,G(b,16),G(G(b,16),_size/2))
 #define PCRE2_GET_OVECTOR_COUNT(a,b) a = pcre2_get_ovector_count_16(G(b,16))
+#define PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(a,b) \
+  a = pcre2_get_match_data_heapframes_size_16(G(b,16))
 #define PCRE2_GET_STARTCHAR(a,b) a = pcre2_get_startchar_16(G(b,16))
+#define PCRE2_JIT_CODE_CACHE_COMPILE(r,a,b,c) \
+  r = pcre2_jit_code_cache_compile_16((pcre2_jit_code_cache_16 *)a,G(b,16),c)
+#define PCRE2_JIT_CODE_CACHE_CREATE(a,b) \
+  a = (void *)pcre2_jit_code_cache_create_16(b,NULL);
+#define PCRE2_JIT_CODE_CACHE_FREE(a) \
+  pcre2_jit_code_cache_free_16((pcre2_jit_code_cache_16 *)a);
 #define PCRE2_JIT_COMPILE(r,a,b) r = pcre2_jit_compile_16(G(a,16),b)
+#define PCRE2_JIT_COMPILE_ASYNC(r,a,b) r = pcre2_jit_compile_async_16(G(a,16),b)
+#define PCRE2_JIT_COMPILE_LAZY(r,a,b,c,d) \
+  r = pcre2_jit_compile_lazy_16(G(a,16),b,c,d)
+#define PCRE2_JIT_COMPILE_WAIT(r,a) r = pcre2_jit_compile_wait_16(G(a,16))
 #define PCRE2_JIT_FREE_UNUSED_MEMORY(a) pcre2_jit_free_unused_memory_16(G(a,16))
+#define PCRE2_JIT_SERIALIZE_DECODE(r,a,b,c) \
+  r = pcre2_jit_serialize_decode_16(G(a,16),b,c)
+#define PCRE2_JIT_SERIALIZE_ENCODE(r,a,b,c,d) \
+  r = pcre2_jit_serialize_encode_16(G(a,16),b,c,G(d,16))
 #define PCRE2_JIT_MATCH(a,b,c,d,e,f,g,h) \
   a = pcre2_jit_match_16(G(b,16),(PCRE2_SPTR16)c,d,e,f,G(g,16),h)
+#define PCRE2_JIT_MATCH_BATCH(a,b,c,d,e,f,g,h,i) \
+  a = pcre2_jit_match_batch_16(G(b,16),(const PCRE2_SPTR16 *)c,d,e,f, \
+    (pcre2_match_data_16 **)g,h,i)
 #define PCRE2_JIT_STACK_CREATE(a,b,c,d) \
   a = (PCRE2_JIT_STACK *)pcre2_jit_stack_create_16(b,c,d);
 #define PCRE2_JIT_STACK_ASSIGN(a,b,c) \
   pcre2_jit_stack_assign_16(G(a,16),(pcre2_jit_callback_16)b,c);
 #define PCRE2_JIT_STACK_FREE(a) pcre2_jit_stack_free_16((pcre2_jit_stack_16 *)a);
+#define PCRE2_JIT_STACK_POOL_ASSIGN(a,b) \
+  pcre2_jit_stack_pool_assign_16(G(a,16),(pcre2_jit_stack_pool_16 *)b);
+#define PCRE2_JIT_STACK_POOL_CREATE(a,b,c,d) \
+  a = (void *)pcre2_jit_stack_pool_create_16(b,c,d);
+#define PCRE2_JIT_STACK_POOL_FREE(a) \
+  pcre2_jit_stack_pool_free_16((pcre2_jit_stack_pool_16 *)a);
+#define PCRE2_JIT_STACK_POOL_INFO(a,b,c,d) \
+  a = pcre2_jit_stack_pool_info_16((pcre2_jit_stack_pool_16 *)b,c,d)
 #define PCRE2_MAKETABLES(a) a = pcre2_maketables_16(NULL)
 #define PCRE2_MATCH(a,b,c,d,e,f,g,h) \
   a = pcre2_match_16(G(b,16),(PCRE2_SPTR16)c,d,e,f,G(g,16),h)
+#define PCRE2_MATCH_BATCH(a,b,c,d,e,f,g,h,i) \
+  a = pcre2_match_batch_16(G(b,16),(const PCRE2_SPTR16 *)c,d,e,f, \
+    (pcre2_match_data_16 **)g,h,i)
 #define PCRE2_MATCH_DATA_CREATE(a,b,c) G(a,16) = pcre2_match_data_create_16(b,c)
 #define PCRE2_MATCH_DATA_CREATE_FROM_PATTERN(a,b,c) \
   G(a,16) = pcre2_match_data_create_from_pattern_16(G(b,16),c)
 #define PCRE2_MATCH_DATA_FREE(a) pcre2_match_data_free_16(G(a,16))
 #define PCRE2_PATTERN_CONVERT(a,b,c,d,e,f,g) a = pcre2_pattern_convert_16(G(b,16),c,d,(PCRE2_UCHAR16 **)e,f,G(g,16))
+#define PCRE2_PARALLEL_CREATE(a,b) \
+  a = (void *)pcre2_parallel_match_create_16(G(b,16),NULL)
+#define PCRE2_PARALLEL_FREE(a) \
+  pcre2_parallel_match_free_16((pcre2_parallel_match_16 *)a)
+#define PCRE2_PARALLEL_MERGE(a,b,c) \
+  a = pcre2_parallel_match_merge_16((pcre2_parallel_match_16 *)b,c)
+#define PCRE2_PARALLEL_RESULTS(a,b,c) \
+  a = pcre2_parallel_match_count_16((pcre2_parallel_match_16 *)c), \
+    b = pcre2_parallel_match_ovector_16((pcre2_parallel_match_16 *)c)
+#define PCRE2_PARALLEL_RUN(a,b,c,d) \
+  a = pcre2_parallel_match_run_16((pcre2_parallel_match_16 *)b,c,d)
+#define PCRE2_PARALLEL_SPLIT(a,b,c,d,e,f) \
+  a = pcre2_parallel_match_split_16((pcre2_parallel_match_16 *)b, \
+    (PCRE2_SPTR16)c,d,e,f)
 #define PCRE2_PATTERN_INFO(a,b,c,d) a = pcre2_pattern_info_16(G(b,16),c,d)
+#define PCRE2_PATTERN_SET_CREATE(a,b,c,d) \
+  a = pcre2_pattern_set_create_16((const pcre2_code_16 **)b,c,G(d,16))
+#define PCRE2_PATTERN_SET_FREE(a) \
+  pcre2_pattern_set_free_16((pcre2_pattern_set_16 *)a)
+#define PCRE2_PATTERN_SET_MATCH(a,b,c,d,e,f,g,h,i,j) \
+  a = pcre2_pattern_set_match_16((pcre2_pattern_set_16 *)b,(PCRE2_SPTR16)c,d,e,f, \
+    G(g,16),h,i,j)
 #define PCRE2_PRINTINT(a) pcre2_printint_16(compiled_code16,outfile,a)
 #define PCRE2_SERIALIZE_DECODE(r,a,b,c,d) \
   r = pcre2_serialize_decode_16((pcre2_code_16 **)a,b,c,G(d,16))
@@ -2118,6 +2890,8 @@ the three different cases. */
 #define PCRE2_SET_MAX_PATTERN_LENGTH(a,b) pcre2_set_max_pattern_length_16(G(a,16),b)
 #define PCRE2_SET_OFFSET_LIMIT(a,b) pcre2_set_offset_limit_16(G(a,16),b)
 #define PCRE2_SET_PARENS_NEST_LIMIT(a,b) pcre2_set_parens_nest_limit_16(G(a,16),b)
+#define PCRE2_SHRINK_MATCH_DATA_HEAPFRAMES(a,b) \
+  pcre2_shrink_match_data_heapframes_16(G(a,16),b)
 #define PCRE2_SUBSTITUTE(a,b,c,d,e,f,g,h,i,j,k,l) \
   a = pcre2_substitute_16(G(b,16),(PCRE2_SPTR16)c,d,e,f,G(g,16),G(h,16), \
     (PCRE2_SPTR16)i,j,(PCRE2_UCHAR16 *)k,l)
@@ -2167,6 +2941,12 @@ the three different cases. */
   lv = pchars32((PCRE2_SPTR32)(p)+offset, len, utf, f)
 #define PCHARSV(p, offset, len, utf, f) \
   (void)pchars32((PCRE2_SPTR32)(p)+offset, len, utf, f)
+#define PCRE2_BATCH_DATA_CREATE(a,b) \
+  a = (void *)pcre2_match_data_create_from_pattern_32(G(b,32),NULL)
+#define PCRE2_BATCH_DATA_FREE(a) \
+  pcre2_match_data_free_32((pcre2_match_data_32 *)a)
+#define PCRE2_BATCH_OVECTOR(a,b) \
+  a = pcre2_get_ovector_pointer_32((pcre2_match_data_32 *)b)
 #define PCRE2_CALLOUT_ENUMERATE(a,b,c) \
    a = pcre2_callout_enumerate_32(compiled_code32, \
      (int (*)(struct pcre2_callout_enumerate_block_32 *, void *))b,c)
@@ -2179,28 +2959,100 @@ the three different cases. */
   pcre2_converted_pattern_free_32((PCRE2_UCHAR32 *)a)
 #define PCRE2_DFA_MATCH(a,b,c,d,e,f,g,h,i,j) \
   a = pcre2_dfa_match_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),h,i,j)
+#define PCRE2_DFA_STREAM_CREATE(a,b,c,d) \
+  a = (void *)pcre2_dfa_stream_create_32(G(b,32),c,d,NULL)
+#define PCRE2_DFA_STREAM_END(a,b,c) \
+  a = pcre2_dfa_stream_end_32((pcre2_dfa_stream_32 *)b,c)
+#define PCRE2_DFA_STREAM_FREE(a) \
+  pcre2_dfa_stream_free_32((pcre2_dfa_stream_32 *)a)
+#define PCRE2_DFA_STREAM_RESULTS(a,b,c) \
+  a = pcre2_dfa_stream_count_32((pcre2_dfa_stream_32 *)c), \
+    b = pcre2_dfa_stream_ovector_32((pcre2_dfa_stream_32 *)c)
+#define PCRE2_DFA_STREAM_SCAN(a,b,c,d,e) \
+  a = pcre2_dfa_stream_scan_32((pcre2_dfa_stream_32 *)b,(PCRE2_SPTR32)c,d,e)
+#define PCRE2_DFA_WORKSPACE_ASSIGN(a,b) \
+  pcre2_dfa_workspace_assign_32(G(a,32),(pcre2_dfa_workspace_32 *)b);
+#define PCRE2_DFA_WORKSPACE_CREATE(a,b,c,d) \
+  a = (void *)pcre2_dfa_workspace_create_32(b,c,d);
+#define PCRE2_DFA_WORKSPACE_FREE(a) \
+  pcre2_dfa_workspace_free_32((pcre2_dfa_workspace_32 *)a);
+#define PCRE2_DFA_WORKSPACE_PEAK(a,b) \
+  a = pcre2_dfa_workspace_peak_32((pcre2_dfa_workspace_32 *)b)
+#define PCRE2_DFA_WORKSPACE_SIZE(a,b) \
+  a = pcre2_dfa_workspace_size_32((pcre2_dfa_workspace_32 *)b)
 #define PCRE2_GET_ERROR_MESSAGE(r,a,b) \
   r = pcre2_get_error_message_32(a,G(b,32),G(G(b,32),_size/4))
 #define PCRE2_GET_OVECTOR_COUNT(a,b) a = pcre2_get_ovector_count_32(G(b,32))
+#define PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(a,b) \
+  a = pcre2_get_match_data_heapframes_size_32(G(b,32))
 #define PCRE2_GET_STARTCHAR(a,b) a = pcre2_get_startchar_32(G(b,32))
+#define PCRE2_JIT_CODE_CACHE_COMPILE(r,a,b,c) \
+  r = pcre2_jit_code_cache_compile_32((pcre2_jit_code_cache_32 *)a,G(b,32),c)
+#define PCRE2_JIT_CODE_CACHE_CREATE(a,b) \
+  a = (void *)pcre2_jit_code_cache_create_32(b,NULL);
+#define PCRE2_JIT_CODE_CACHE_FREE(a) \
+  pcre2_jit_code_cache_free_32((pcre2_jit_code_cache_32 *)a);
 #define PCRE2_JIT_COMPILE(r,a,b) r = pcre2_jit_compile_32(G(a,32),b)
+#define PCRE2_JIT_COMPILE_ASYNC(r,a,b) r = pcre2_jit_compile_async_32(G(a,32),b)
+#define PCRE2_JIT_COMPILE_LAZY(r,a,b,c,d) \
+  r = pcre2_jit_compile_lazy_32(G(a,32),b,c,d)
+#define PCRE2_JIT_COMPILE_WAIT(r,a) r = pcre2_jit_compile_wait_32(G(a,32))
 #define PCRE2_JIT_FREE_UNUSED_MEMORY(a) pcre2_jit_free_unused_memory_32(G(a,32))
+#define PCRE2_JIT_SERIALIZE_DECODE(r,a,b,c) \
+  r = pcre2_jit_serialize_decode_32(G(a,32),b,c)
+#define PCRE2_JIT_SERIALIZE_ENCODE(r,a,b,c,d) \
+  r = pcre2_jit_serialize_encode_32(G(a,32),b,c,G(d,32))
 #define PCRE2_JIT_MATCH(a,b,c,d,e,f,g,h) \
   a = pcre2_jit_match_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),h)
+#define PCRE2_JIT_MATCH_BATCH(a,b,c,d,e,f,g,h,i) \
+  a = pcre2_jit_match_batch_32(G(b,32),(const PCRE2_SPTR32 *)c,d,e,f, \
+    (pcre2_match_data_32 **)g,h,i)
 #define PCRE2_JIT_STACK_CREATE(a,b,c,d) \
   a = (PCRE2_JIT_STACK *)pcre2_jit_stack_create_32(b,c,d);
 #define PCRE2_JIT_STACK_ASSIGN(a,b,c) \
   pcre2_jit_stack_assign_32(G(a,32),(pcre2_jit_callback_32)b,c);
 #define PCRE2_JIT_STACK_FREE(a) pcre2_jit_stack_free_32((pcre2_jit_stack_32 *)a);
+#define PCRE2_JIT_STACK_POOL_ASSIGN(a,b) \
+  pcre2_jit_stack_pool_assign_32(G(a,32),(pcre2_jit_stack_pool_32 *)b);
+#define PCRE2_JIT_STACK_POOL_CREATE(a,b,c,d) \
+  a = (void *)pcre2_jit_stack_pool_create_32(b,c,d);
+#define PCRE2_JIT_STACK_POOL_FREE(a) \
+  pcre2_jit_stack_pool_free_32((pcre2_jit_stack_pool_32 *)a);
+#define PCRE2_JIT_STACK_POOL_INFO(a,b,c,d) \
+  a = pcre2_jit_stack_pool_info_32((pcre2_jit_stack_pool_32 *)b,c,d)
 #define PCRE2_MAKETABLES(a) a = pcre2_maketables_32(NULL)
 #define PCRE2_MATCH(a,b,c,d,e,f,g,h) \
   a = pcre2_match_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),h)
+#define PCRE2_MATCH_BATCH(a,b,c,d,e,f,g,h,i) \
+  a = pcre2_match_batch_32(G(b,32),(const PCRE2_SPTR32 *)c,d,e,f, \
+    (pcre2_match_data_32 **)g,h,i)
 #define PCRE2_MATCH_DATA_CREATE(a,b,c) G(a,32) = pcre2_match_data_create_32(b,c)
 #define PCRE2_MATCH_DATA_CREATE_FROM_PATTERN(a,b,c) \
   G(a,32) = pcre2_match_data_create_from_pattern_32(G(b,32),c)
 #define PCRE2_MATCH_DATA_FREE(a) pcre2_match_data_free_32(G(a,32))
 #define PCRE2_PATTERN_CONVERT(a,b,c,d,e,f,g) a = pcre2_pattern_convert_32(G(b,32),c,d,(PCRE2_UCHAR32 **)e,f,G(g,32))
+#define PCRE2_PARALLEL_CREATE(a,b) \
+  a = (void *)pcre2_parallel_match_create_32(G(b,32),NULL)
+#define PCRE2_PARALLEL_FREE(a) \
+  pcre2_parallel_match_free_32((pcre2_parallel_match_32 *)a)
+#define PCRE2_PARALLEL_MERGE(a,b,c) \
+  a = pcre2_parallel_match_merge_32((pcre2_parallel_match_32 *)b,c)
+#define PCRE2_PARALLEL_RESULTS(a,b,c) \
+  a = pcre2_parallel_match_count_32((pcre2_parallel_match_32 *)c), \
+    b = pcre2_parallel_match_ovector_32((pcre2_parallel_match_32 *)c)
+#define PCRE2_PARALLEL_RUN(a,b,c,d) \
+  a = pcre2_parallel_match_run_32((pcre2_parallel_match_32 *)b,c,d)
+#define PCRE2_PARALLEL_SPLIT(a,b,c,d,e,f) \
+  a = pcre2_parallel_match_split_32((pcre2_parallel_match_32 *)b, \
+    (PCRE2_SPTR32)c,d,e,f)
 #define PCRE2_PATTERN_INFO(a,b,c,d) a = pcre2_pattern_info_32(G(b,32),c,d)
+#define PCRE2_PATTERN_SET_CREATE(a,b,c,d) \
+  a = pcre2_pattern_set_create_32((const pcre2_code_32 **)b,c,G(d,32))
+#define PCRE2_PATTERN_SET_FREE(a) \
+  pcre2_pattern_set_free_32((pcre2_pattern_set_32 *)a)
+#define PCRE2_PATTERN_SET_MATCH(a,b,c,d,e,f,g,h,i,j) \
+  a = pcre2_pattern_set_match_32((pcre2_pattern_set_32 *)b,(PCRE2_SPTR32)c,d,e,f, \
+    G(g,32),h,i,j)
 #define PCRE2_PRINTINT(a) pcre2_printint_32(compiled_code32,outfile,a)
 #define PCRE2_SERIALIZE_DECODE(r,a,b,c,d) \
   r = pcre2_serialize_decode_32((pcre2_code_32 **)a,b,c,G(d,32))
@@ -2222,6 +3074,8 @@ the three different cases. */
 #define PCRE2_SET_MAX_PATTERN_LENGTH(a,b) pcre2_set_max_pattern_length_32(G(a,32),b)
 #define PCRE2_SET_OFFSET_LIMIT(a,b) pcre2_set_offset_limit_32(G(a,32),b)
 #define PCRE2_SET_PARENS_NEST_LIMIT(a,b) pcre2_set_parens_nest_limit_32(G(a,32),b)
+#define PCRE2_SHRINK_MATCH_DATA_HEAPFRAMES(a,b) \
+  pcre2_shrink_match_data_heapframes_32(G(a,32),b)
 #define PCRE2_SUBSTITUTE(a,b,c,d,e,f,g,h,i,j,k,l) \
   a = pcre2_substitute_32(G(b,32),(PCRE2_SPTR32)c,d,e,f,G(g,32),G(h,32), \
     (PCRE2_SPTR32)i,j,(PCRE2_UCHAR32 *)k,l)
@@ -3971,13 +4825,14 @@ Returns:      nothing
 static void
 show_controls(uint32_t controls, uint32_t controls2, const char *before)
 {
-fprintf(outfile, "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s",
+fprintf(outfile, "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s",
   before,
   ((controls & CTL_AFTERTEXT) != 0)? " aftertext" : "",
   ((controls & CTL_ALLAFTERTEXT) != 0)? " allaftertext" : "",
   ((controls & CTL_ALLCAPTURES) != 0)? " allcaptures" : "",
   ((controls & CTL_ALLUSEDTEXT) != 0)? " allusedtext" : "",
   ((controls & CTL_ALTGLOBAL) != 0)? " altglobal" : "",
+  ((controls2 & CTL2_BATCH) != 0)? " batch" : "",
   ((controls & CTL_BINCODE) != 0)? " bincode" : "",
   ((controls2 & CTL_BSR_SET) != 0)? " bsr" : "",
   ((controls & CTL_CALLOUT_CAPTURE) != 0)? " callout_capture" : "",
@@ -3990,9 +4845,13 @@ fprintf(outfile, "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s
   ((controls & CTL_FULLBINCODE) != 0)? " fullbincode" : "",
   ((controls & CTL_GETALL) != 0)? " getall" : "",
   ((controls & CTL_GLOBAL) != 0)? " global" : "",
+  ((controls2 & CTL2_HEAPFRAMES_SIZE) != 0)? " heapframes_size" : "",
   ((controls & CTL_HEXPAT) != 0)? " hex" : "",
   ((controls & CTL_INFO) != 0)? " info" : "",
+  ((controls2 & CTL2_JITASYNC) != 0)? " jitasync" : "",
+  ((controls2 & CTL2_JITCACHE) != 0)? " jitcache" : "",
   ((controls & CTL_JITFAST) != 0)? " jitfast" : "",
+  ((controls2 & CTL2_JITRELOAD) != 0)? " jitreload" : "",
   ((controls & CTL_JITVERIFY) != 0)? " jitverify" : "",
   ((controls & CTL_MARK) != 0)? " mark" : "",
   ((controls & CTL_MEMORY) != 0)? " memory" : "",
@@ -4087,10 +4946,13 @@ show_compile_extra_options(uint32_t options, const char *before,
   const char *after)
 {
 if (options == 0) fprintf(outfile, "%s <none>%s", before, after);
-else fprintf(outfile, "%s%s%s%s",
+else fprintf(outfile, "%s%s%s%s%s%s%s",
   before,
   ((options & PCRE2_EXTRA_ALLOW_SURROGATE_ESCAPES) != 0)? " allow_surrogate_escapes" : "",
+  ((options & PCRE2_EXTRA_ALWAYS_CHECK_LASTCU) != 0)? " always_check_lastcu" : "",
   ((options & PCRE2_EXTRA_BAD_ESCAPE_IS_LITERAL) != 0)? " bad_escape_is_literal" : "",
+  ((options & PCRE2_EXTRA_BIT_PARALLEL) != 0)? " bit_parallel" : "",
+  ((options & PCRE2_EXTRA_LINEAR) != 0)? " linear" : "",
   after);
 }
 
@@ -4106,8 +4968,9 @@ else fprintf(outfile, "%s%s%s%s",
 static void
 show_match_options(uint32_t options)
 {
-fprintf(outfile, "%s%s%s%s%s%s%s%s%s%s%s",
+fprintf(outfile, "%s%s%s%s%s%s%s%s%s%s%s%s",
   ((options & PCRE2_ANCHORED) != 0)? " anchored" : "",
+  ((options & PCRE2_DFA_LAZY) != 0)? " dfa_lazy" : "",
   ((options & PCRE2_DFA_RESTART) != 0)? " dfa_restart" : "",
   ((options & PCRE2_DFA_SHORTEST) != 0)? " dfa_shortest" : "",
   ((options & PCRE2_ENDANCHORED) != 0)? " endanchored" : "",
@@ -4280,8 +5143,8 @@ if ((pat_patctl.control & CTL_INFO) != 0)
   void *nametable;
   uint8_t *start_bits;
   BOOL heap_limit_set, match_limit_set, depth_limit_set;
-  uint32_t backrefmax, bsr_convention, capture_count, first_ctype, first_cunit,
-    hasbackslashc, hascrorlf, jchanged, last_ctype, last_cunit, match_empty,
+  uint32_t backrefmax, bitparallel, bsr_convention, capture_count, first_ctype,
+    first_cunit, hasbackslashc, hascrorlf, jchanged, last_ctype, last_cunit, match_empty,
     depth_limit, heap_limit, match_limit, minlength, nameentrysize, namecount,
     newline_convention;
 
@@ -4337,6 +5200,7 @@ if ((pat_patctl.control & CTL_INFO) != 0)
   /* These info requests should always succeed. */
 
   if (pattern_info(PCRE2_INFO_BACKREFMAX, &backrefmax, FALSE) +
+      pattern_info(PCRE2_INFO_BITPARALLEL, &bitparallel, FALSE) +
       pattern_info(PCRE2_INFO_BSR, &bsr_convention, FALSE) +
       pattern_info(PCRE2_INFO_CAPTURECOUNT, &capture_count, FALSE) +
       pattern_info(PCRE2_INFO_FIRSTBITMAP, &start_bits, FALSE) +
@@ -4403,6 +5267,7 @@ if ((pat_patctl.control & CTL_INFO) != 0)
   if (hascrorlf)     fprintf(outfile, "Contains explicit CR or LF match\n");
   if (hasbackslashc) fprintf(outfile, "Contains \\C\n");
   if (match_empty)   fprintf(outfile, "May match empty string\n");
+  if (bitparallel)   fprintf(outfile, "Has a bit-parallel automaton\n");
 
   pattern_info(PCRE2_INFO_ARGOPTIONS, &compile_options, FALSE);
   pattern_info(PCRE2_INFO_ALLOPTIONS, &overall_options, FALSE);
@@ -4777,6 +5642,30 @@ switch(cmd)
     }
   break;
 
+  /* Make a pattern set from all the compiled patterns on the stack, which is
+  then empty. The first pattern that was pushed has ID 0. A copy of that pattern
+  becomes the current pattern, so that subject lines can be processed. */
+
+  case CMD_PATTERNSET:
+  if (patstacknext <= 0)
+    {
+    fprintf(outfile, "** Can't make a pattern set from an empty stack\n");
+    return PR_SKIP;
+    }
+  PCRE2_PATTERN_SET_CREATE(pattern_set, patstack, patstacknext,
+    general_context);
+  if (pattern_set == NULL)
+    {
+    fprintf(outfile, "** Failed to create pattern set\n");
+    return PR_SKIP;
+    }
+  memcpy(patsetcodes, patstack, patstacknext * sizeof(void *));
+  patsetcount = patstacknext;
+  patstacknext = 0;
+  memset(&pat_patctl, 0, sizeof(patctl));
+  PCRE2_CODE_COPY_FROM_VOID(compiled_code, patsetcodes[0]);
+  break;
+
   /* Save the stack of compiled patterns to a file, then empty the stack. */
 
   case CMD_SAVE:
@@ -4995,11 +5884,13 @@ for (k = 0; k < sizeof(exclusive_pat_controls)/sizeof(uint32_t); k++)
     }
   }
 
-/* Assume full JIT compile for jitverify and/or jitfast if nothing else was
-specified. */
+/* Assume full JIT compile for jitverify, jitfast, jitasync, jitcache, and/or
+jitlazy if nothing else was specified. */
 
 if (pat_patctl.jit == 0 &&
-    (pat_patctl.control & (CTL_JITVERIFY|CTL_JITFAST)) != 0)
+    ((pat_patctl.control & (CTL_JITVERIFY|CTL_JITFAST)) != 0 ||
+      (pat_patctl.control2 & (CTL2_JITASYNC|CTL2_JITCACHE)) != 0 ||
+      pat_patctl.jitlazy[0] != 0 || pat_patctl.jitlazy[1] != 0))
   pat_patctl.jit = 7;
 
 /* Now copy the pattern to pbuffer8 for use in 8-bit testing and for reflecting
@@ -5599,10 +6490,77 @@ if (TEST(compiled_code, !=, NULL) && pat_patctl.jit != 0)
       (((double)time_taken * 1000.0) / (double)timeit) /
         (double)CLOCKS_PER_SEC);
     }
+  else if (pat_patctl.jitlazy[0] != 0 || pat_patctl.jitlazy[1] != 0)
+    {
+    PCRE2_JIT_COMPILE_LAZY(jitrc, compiled_code, pat_patctl.jit,
+      pat_patctl.jitlazy[0], pat_patctl.jitlazy[1]);
+    }
+
+  /* For jitasync, start the compile in the background and then wait for it,
+  so that the output is the same as for a synchronous compile. */
+
+  else if ((pat_patctl.control2 & CTL2_JITASYNC) != 0)
+    {
+    PCRE2_JIT_COMPILE_ASYNC(jitrc, compiled_code, pat_patctl.jit);
+    if (jitrc == 0) { PCRE2_JIT_COMPILE_WAIT(jitrc, compiled_code); }
+    }
+
+  /* For jitcache, compile into a shared code cache, which is created the first
+  time and kept until the end. If the library does not support code caches, an
+  ordinary compile is done, so that the output is the same. */
+
+  else if ((pat_patctl.control2 & CTL2_JITCACHE) != 0)
+    {
+    if (jit_code_cache == NULL)
+      {
+      PCRE2_JIT_CODE_CACHE_CREATE(jit_code_cache, 1024*1024);
+      }
+    if (jit_code_cache != NULL)
+      {
+      PCRE2_JIT_CODE_CACHE_COMPILE(jitrc, jit_code_cache, compiled_code,
+        pat_patctl.jit);
+      }
+    else
+      {
+      PCRE2_JIT_COMPILE(jitrc, compiled_code, pat_patctl.jit);
+      }
+    }
   else
     {
     PCRE2_JIT_COMPILE(jitrc, compiled_code, pat_patctl.jit);
     }
+
+  /* For jitreload, save the JIT code, replace the pattern with a copy that has
+  no JIT code, and load the saved code into the copy. Nothing is done if saving
+  JIT code is not supported. */
+
+  if ((pat_patctl.control2 & CTL2_JITRELOAD) != 0 && jitrc == 0)
+    {
+    int rc;
+    uint8_t *jitbytes;
+    PCRE2_SIZE jitsize;
+    void *copy;
+
+    PCRE2_JIT_SERIALIZE_ENCODE(rc, compiled_code, &jitbytes, &jitsize,
+      general_context);
+    if (rc == 0)
+      {
+      PCRE2_CODE_COPY_TO_VOID(copy, compiled_code);
+      if (copy == NULL)
+        {
+        PCRE2_SERIALIZE_FREE(jitbytes);
+        fprintf(outfile, "** pcre2test: pattern copy failed\n");
+        return PR_ABEND;
+        }
+      SUB1(pcre2_code_free, compiled_code);
+      SET(compiled_code, copy);
+      PCRE2_JIT_SERIALIZE_DECODE(rc, compiled_code, jitbytes, jitsize);
+      PCRE2_SERIALIZE_FREE(jitbytes);
+      }
+    if (rc != 0 && rc != PCRE2_ERROR_JIT_BADOPTION &&
+        !serial_error(rc, "JIT reload"))
+      return PR_ABEND;
+    }
   }
 
 /* If valgrind is supported, mark the pbuffer as accessible again. The 16-bit
@@ -5771,7 +6729,7 @@ for (;;)
       dfa_workspace[0] = -1;  /* To catch bad restart */
     PCRE2_DFA_MATCH(capcount, compiled_code, pp, ulen, dat_datctl.offset,
       dat_datctl.options, match_data,
-      PTR(dat_context), dfa_workspace, DFA_WS_DIMENSION);
+      PTR(dat_context), DFA_WS_VECTOR, DFA_WS_DIMENSION);
     }
 
   else if ((pat_patctl.control & CTL_JITFAST) != 0)
@@ -6658,6 +7616,11 @@ if ((pat_patctl.control & CTL_POSIX) != 0)
   if (dat_datctl.get_numbers[0] >= 0 || dat_datctl.get_names[0] != 0)
     prmsg(&msg, "get");
   if (dat_datctl.jitstack != 0) prmsg(&msg, "jitstack");
+  if (dat_datctl.jitstackpool != 0) prmsg(&msg, "jitstackpool");
+  if (dat_datctl.dfaworkspace != 0) prmsg(&msg, "dfa_workspace");
+  if (dat_datctl.dfastream != 0) prmsg(&msg, "dfa_stream");
+  if (dat_datctl.heapframes_shrink != PCRE2_UNSET)
+    prmsg(&msg, "heapframes_shrink");
   if (dat_datctl.offset != 0) prmsg(&msg, "offset");
 
   if ((dat_datctl.options & ~POSIX_SUPPORTED_MATCH_OPTIONS) != 0)
@@ -6805,10 +7768,58 @@ else if (jit_stack != NULL)
   jit_stack_size = 0;
   }
 
+/* A pool of JIT stacks is kept while the requested maximum stack size stays
+the same, so the statistics accumulate over the subject lines that use it. It
+replaces any JIT stack that was assigned above. The match context is copied
+afresh for each subject line, so an unwanted pool need only be freed. */
+
+if (dat_datctl.jitstackpool != 0)
+  {
+  if (dat_datctl.jitstackpool != jit_stack_pool_size)
+    {
+    if (jit_stack_pool != NULL) { PCRE2_JIT_STACK_POOL_FREE(jit_stack_pool); }
+    PCRE2_JIT_STACK_POOL_CREATE(jit_stack_pool, 1,
+      dat_datctl.jitstackpool * 1024, NULL);
+    jit_stack_pool_size = dat_datctl.jitstackpool;
+    }
+  PCRE2_JIT_STACK_POOL_ASSIGN(dat_context, jit_stack_pool);
+  }
+
+else if (jit_stack_pool != NULL)
+  {
+  PCRE2_JIT_STACK_POOL_FREE(jit_stack_pool);
+  jit_stack_pool = NULL;
+  jit_stack_pool_size = 0;
+  }
+
+/* A DFA workspace object is handled in the same way. When it is assigned, a
+NULL workspace is passed to pcre2_dfa_match(), which then uses the object. */
+
+if (dat_datctl.dfaworkspace != 0)
+  {
+  if (dat_datctl.dfaworkspace != dfa_workspace_object_size)
+    {
+    if (dfa_workspace_object != NULL)
+      { PCRE2_DFA_WORKSPACE_FREE(dfa_workspace_object); }
+    PCRE2_DFA_WORKSPACE_CREATE(dfa_workspace_object, dat_datctl.dfaworkspace,
+      DFA_WS_MAXIMUM, NULL);
+    dfa_workspace_object_size = dat_datctl.dfaworkspace;
+    }
+  PCRE2_DFA_WORKSPACE_ASSIGN(dat_context, dfa_workspace_object);
+  }
+
+else if (dfa_workspace_object != NULL)
+  {
+  PCRE2_DFA_WORKSPACE_FREE(dfa_workspace_object);
+  dfa_workspace_object = NULL;
+  dfa_workspace_object_size = 0;
+  }
+
 /* When no JIT stack is assigned, we must ensure that there is a JIT callback
 if we want to verify that JIT was actually used. */
 
-if ((pat_patctl.control & CTL_JITVERIFY) != 0 && jit_stack == NULL)
+if ((pat_patctl.control & CTL_JITVERIFY) != 0 && jit_stack == NULL &&
+    jit_stack_pool == NULL)
    {
    PCRE2_JIT_STACK_ASSIGN(dat_context, jit_callback, NULL);
    }
@@ -6841,6 +7852,290 @@ if (CASTVAR(void *, match_data) == NULL)
   return PR_OK;
   }
 
+/* When there is a pattern set, pcre2_pattern_set_match() is called once, and
+the IDs of the patterns that match are listed. */
+
+if (pattern_set != NULL)
+  {
+  int rc;
+  uint32_t ids[PATSTACKSIZE];
+
+  PCRE2_PATTERN_SET_MATCH(rc, pattern_set, pp, arg_ulen, dat_datctl.offset,
+    dat_datctl.options, match_data, use_dat_context, ids, PATSTACKSIZE);
+  if (rc < 0)
+    {
+    fprintf(outfile, "Failed: error %d: ", rc);
+    if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+    }
+  else if (rc == 0) fprintf(outfile, "No match\n");
+  else
+    {
+    fprintf(outfile, "Matched patterns:");
+    for (k = 0; k < (uint32_t)rc; k++) fprintf(outfile, " %u", ids[k]);
+    fprintf(outfile, "\n");
+    }
+  return PR_OK;
+  }
+
+/* When the batch modifier is set, the subject is split into separate strings
+at each binary zero, and they are all matched by one call of
+pcre2_match_batch(), or pcre2_jit_match_batch() if jitfast is set. Each string
+has its own match data block, and the results are shown in turn. */
+
+if ((dat_datctl.control2 & CTL2_BATCH) != 0)
+  {
+  int rc;
+  uint32_t count = 0;
+  PCRE2_SIZE start = 0;
+  PCRE2_SIZE i;
+  void *subjects[BATCHSIZE];
+  void *batch_md[BATCHSIZE];
+  PCRE2_SIZE lengths[BATCHSIZE];
+  int results[BATCHSIZE];
+
+  if ((dat_datctl.control & (CTL_ANYGLOB|CTL_DFA|CTL_ZERO_TERMINATE)) != 0 ||
+      dat_datctl.replacement[0] != 0 || dat_datctl.offset != 0)
+    {
+    fprintf(outfile, "** Batch matching is not supported with dfa, global, "
+      "offset, replace, or zero_terminate\n");
+    return PR_OK;
+    }
+
+  for (i = 0; i <= arg_ulen; i++)
+    {
+    if (i < arg_ulen && CODE_UNIT(pp, i) != 0) continue;
+    if (count >= BATCHSIZE)
+      {
+      fprintf(outfile, "** Too many subjects for batch matching (max %d)\n",
+        BATCHSIZE);
+      return PR_OK;
+      }
+    subjects[count] = pp + start * code_unit_size;
+    lengths[count++] = i - start;
+    start = i + 1;
+    }
+
+  for (k = 0; k < count; k++)
+    {
+    PCRE2_BATCH_DATA_CREATE(batch_md[k], compiled_code);
+    if (batch_md[k] == NULL)
+      {
+      fprintf(outfile, "** Failed to get memory for batch match data\n");
+      while (k-- > 0) { PCRE2_BATCH_DATA_FREE(batch_md[k]); }
+      return PR_ABEND;
+      }
+    }
+
+  PCRE2_SET_CALLOUT(dat_context, NULL, NULL);  /* No callout */
+
+  if ((pat_patctl.control & CTL_JITFAST) != 0)
+    {
+    PCRE2_JIT_MATCH_BATCH(rc, compiled_code, subjects, lengths, count,
+      dat_datctl.options, batch_md, use_dat_context, results);
+    }
+  else
+    {
+    PCRE2_MATCH_BATCH(rc, compiled_code, subjects, lengths, count,
+      dat_datctl.options, batch_md, use_dat_context, results);
+    }
+
+  if (rc < 0)
+    {
+    fprintf(outfile, "Failed: error %d: ", rc);
+    if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+    }
+
+  else for (k = 0; k < count; k++)
+    {
+    PCRE2_SIZE *ovector;
+    int j;
+
+    PCRE2_BATCH_OVECTOR(ovector, batch_md[k]);
+    fprintf(outfile, "Subject %u: ", k);
+
+    if (results[k] == PCRE2_ERROR_NOMATCH) fprintf(outfile, "No match\n");
+    else if (results[k] == PCRE2_ERROR_PARTIAL)
+      {
+      fprintf(outfile, "Partial match: ");
+      PCHARSV(subjects[k], ovector[0], ovector[1] - ovector[0], utf, outfile);
+      fprintf(outfile, "\n");
+      }
+    else if (results[k] < 0)
+      {
+      fprintf(outfile, "Failed: error %d: ", results[k]);
+      if (!print_error_message(results[k], "", "\n")) return PR_ABEND;
+      }
+    else
+      {
+      fprintf(outfile, "Matched\n");
+      for (j = 0; j < 2 * results[k]; j += 2)
+        {
+        fprintf(outfile, "%2d: ", j/2);
+        if (ovector[j] == PCRE2_UNSET) fprintf(outfile, "<unset>");
+        else
+          {
+          PCHARSV(subjects[k], ovector[j], ovector[j+1] - ovector[j], utf,
+            outfile);
+          }
+        fprintf(outfile, "\n");
+        }
+      }
+    }
+
+  if (rc >= 0) fprintf(outfile, "Batch matched %d of %u\n", rc, count);
+  for (k = 0; k < count; k++) { PCRE2_BATCH_DATA_FREE(batch_md[k]); }
+  return PR_OK;
+  }
+
+/* When the parallel modifier is set, the subject is divided into chunks of
+at least the given size, and all the matches are found by the parallel matching
+functions. The chunks are run in reverse order, except for the first, which is
+left for pcre2_parallel_match_merge() to run. */
+
+if (dat_datctl.parallel != 0)
+  {
+  int rc;
+  void *pm;
+  PCRE2_SIZE i, count, *pv;
+
+  if ((dat_datctl.control & (CTL_ANYGLOB|CTL_DFA|CTL_ZERO_TERMINATE)) != 0 ||
+      dat_datctl.replacement[0] != 0 || dat_datctl.offset != 0)
+    {
+    fprintf(outfile, "** Parallel matching is not supported with dfa, global, "
+      "offset, replace, or zero_terminate\n");
+    return PR_OK;
+    }
+
+  PCRE2_PARALLEL_CREATE(pm, compiled_code);
+  if (pm == NULL)
+    {
+    fprintf(outfile, "** Failed to get memory for parallel matching\n");
+    return PR_ABEND;
+    }
+
+  PCRE2_SET_CALLOUT(dat_context, NULL, NULL);  /* No callout */
+
+  PCRE2_PARALLEL_SPLIT(rc, pm, pp, arg_ulen, dat_datctl.options,
+    dat_datctl.parallel);
+  if (rc > 0)
+    {
+    int chunk;
+    fprintf(outfile, "Chunks: %d\n", rc);
+    for (chunk = rc - 1; chunk > 0; chunk--)
+      {
+      PCRE2_PARALLEL_RUN(rc, pm, (uint32_t)chunk, use_dat_context);
+      if (rc < 0) break;
+      }
+    if (rc >= 0) { PCRE2_PARALLEL_MERGE(rc, pm, use_dat_context); }
+    }
+
+  if (rc < 0)
+    {
+    fprintf(outfile, "Failed: error %d: ", rc);
+    if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+    }
+  else
+    {
+    PCRE2_PARALLEL_RESULTS(count, pv, pm);
+    if (count == 0) fprintf(outfile, "No match\n");
+    for (i = 0; i < count; i++)
+      {
+      PCRE2_SIZE start = pv[2*i];
+      PCRE2_SIZE end = pv[2*i+1];
+      if (start > end)
+        {
+        start = pv[2*i+1];
+        end = pv[2*i];
+        fprintf(outfile, "Start of matched string is beyond its end - "
+          "displaying from end to start.\n");
+        }
+      fprintf(outfile, " 0: ");
+      PCHARSV(pp, start, end - start, utf, outfile);
+      fprintf(outfile, "\n");
+      }
+    }
+
+  PCRE2_PARALLEL_FREE(pm);
+  return PR_OK;
+  }
+
+/* When the dfa_stream modifier is set, the subject is passed in pieces of the
+given size to the DFA streaming functions, and the matches that are reported
+after each piece and at the end are shown. The whole subject is available here,
+so the stream offsets can be used to display the matched strings. */
+
+if (dat_datctl.dfastream != 0)
+  {
+  int rc = 0;
+  void *ds;
+  PCRE2_SIZE start, count;
+  PCRE2_SIZE total = 0;
+  uint64_t *dv;
+
+  if ((dat_datctl.control & (CTL_ANYGLOB|CTL_ZERO_TERMINATE)) != 0 ||
+      dat_datctl.replacement[0] != 0 || dat_datctl.offset != 0)
+    {
+    fprintf(outfile, "** DFA streaming is not supported with global, offset, "
+      "replace, or zero_terminate\n");
+    return PR_OK;
+    }
+
+  PCRE2_DFA_STREAM_CREATE(ds, compiled_code, dat_datctl.options,
+    dat_datctl.dfastreamretain);
+  if (ds == NULL)
+    {
+    fprintf(outfile, "** DFA streaming is not supported for this pattern or "
+      "these options\n");
+    return PR_OK;
+    }
+
+  PCRE2_SET_CALLOUT(dat_context, NULL, NULL);  /* No callout */
+
+  for (start = 0; rc >= 0; start += dat_datctl.dfastream)
+    {
+    PCRE2_SIZE i;
+
+    if (start < arg_ulen)
+      {
+      PCRE2_SIZE plen = arg_ulen - start;
+      uint8_t *piece = pp + start * code_unit_size;
+      if (plen > dat_datctl.dfastream) plen = dat_datctl.dfastream;
+      PCRE2_DFA_STREAM_SCAN(rc, ds, piece, plen, use_dat_context);
+      }
+    else
+      {
+      PCRE2_DFA_STREAM_END(rc, ds, use_dat_context);
+      }
+
+    if (rc < 0)
+      {
+      fprintf(outfile, "Failed: error %d: ", rc);
+      if (!print_error_message(rc, "", "\n")) return PR_ABEND;
+      break;
+      }
+
+    PCRE2_DFA_STREAM_RESULTS(count, dv, ds);
+    for (i = 0; i < count; i++)
+      {
+      PCRE2_SIZE mstart = (PCRE2_SIZE)dv[2*i];
+      PCRE2_SIZE mend = (PCRE2_SIZE)dv[2*i+1];
+      fprintf(outfile, " 0: ");
+      PCHARSV(pp, mstart, mend - mstart, utf, outfile);
+      fprintf(outfile, "\n");
+      }
+    total += count;
+
+    if (start >= arg_ulen)
+      {
+      if (total == 0) fprintf(outfile, "No match\n");
+      break;
+      }
+    }
+
+  PCRE2_DFA_STREAM_FREE(ds);
+  return PR_OK;
+  }
+
 /* Replacement processing is ignored for DFA matching. */
 
 if (dat_datctl.replacement[0] != 0 && (dat_datctl.control & CTL_DFA) != 0)
@@ -7054,7 +8349,7 @@ else for (gmatched = 0;; gmatched++)
         {
         PCRE2_DFA_MATCH(capcount, compiled_code, pp, arg_ulen,
           dat_datctl.offset, dat_datctl.options | g_notempty, match_data,
-          use_dat_context, dfa_workspace, DFA_WS_DIMENSION);
+          use_dat_context, DFA_WS_VECTOR, DFA_WS_DIMENSION);
         }
       }
 
@@ -7141,7 +8436,7 @@ else for (gmatched = 0;; gmatched++)
         dfa_workspace[0] = -1;  /* To catch bad restart */
       PCRE2_DFA_MATCH(capcount, compiled_code, pp, arg_ulen,
         dat_datctl.offset, dat_datctl.options | g_notempty, match_data,
-        use_dat_context, dfa_workspace, DFA_WS_DIMENSION);
+        use_dat_context, DFA_WS_VECTOR, DFA_WS_DIMENSION);
       if (capcount == 0)
         {
         fprintf(outfile, "Matched, but offsets vector is too small to show all matches\n");
@@ -7569,6 +8864,51 @@ else for (gmatched = 0;; gmatched++)
     }
   }  /* End of global loop */
 
+/* Shrink the heap frame vector that pcre2_match() has left in the match data,
+and show whether there is one, if requested. Its exact size depends on the
+code unit width and the size of pointers, so it is not shown. */
+
+if (dat_datctl.heapframes_shrink != PCRE2_UNSET)
+  {
+  PCRE2_SHRINK_MATCH_DATA_HEAPFRAMES(match_data, dat_datctl.heapframes_shrink);
+  }
+
+if ((dat_datctl.control2 & CTL2_HEAPFRAMES_SIZE) != 0)
+  {
+  PCRE2_SIZE heapframes_size;
+  PCRE2_GET_MATCH_DATA_HEAPFRAMES_SIZE(heapframes_size, match_data);
+  fprintf(outfile, "Heapframes size in match_data: %s\n",
+    (heapframes_size == 0)? "0" : "nonzero");
+  }
+
+/* Show the DFA workspace object's size and peak usage, both in ints. */
+
+if (dat_datctl.dfaworkspace != 0 && dfa_workspace_object != NULL &&
+    (dat_datctl.control & CTL_DFA) != 0)
+  {
+  PCRE2_SIZE size, peak;
+  PCRE2_DFA_WORKSPACE_SIZE(size, dfa_workspace_object);
+  PCRE2_DFA_WORKSPACE_PEAK(peak, dfa_workspace_object);
+  fprintf(outfile, "DFA workspace: size %zd, peak %zd\n", size, peak);
+  }
+
+/* Show the JIT stack pool statistics that do not depend on the platform. */
+
+if (dat_datctl.jitstackpool != 0 && jit_stack_pool != NULL)
+  {
+  int rc;
+  uint32_t stacks, peak;
+  PCRE2_JIT_STACK_POOL_INFO(rc, jit_stack_pool, PCRE2_POOLINFO_STACKS,
+    &stacks);
+  if (rc == 0)
+    {
+    PCRE2_JIT_STACK_POOL_INFO(rc, jit_stack_pool, PCRE2_POOLINFO_PEAKINUSE,
+      &peak);
+    }
+  if (rc == 0) fprintf(outfile, "JIT stack pool: %u stack%s, %u peak in use\n",
+    stacks, (stacks == 1)? "" : "s", peak);
+  }
+
 show_memory = FALSE;
 return PR_OK;
 }
@@ -7944,6 +9284,7 @@ def_datctl.get_numbers[0] = -1;
 def_datctl.startend[0] = def_datctl.startend[1] = CFORE_UNSET;
 def_datctl.cerror[0] = def_datctl.cerror[1] = CFORE_UNSET;
 def_datctl.cfail[0] = def_datctl.cfail[1] = CFORE_UNSET;
+def_datctl.heapframes_shrink = PCRE2_UNSET;
 
 /* Scan command line options. */
 
@@ -8389,6 +9730,17 @@ while (notdone)
         SUB1(pcre2_code_free, compiled_code);
         SET(compiled_code, NULL);
         }
+      if (pattern_set != NULL)
+        {
+        PCRE2_PATTERN_SET_FREE(pattern_set);
+        pattern_set = NULL;
+        while (patsetcount > 0)
+          {
+          SET(compiled_code, patsetcodes[--patsetcount]);
+          SUB1(pcre2_code_free, compiled_code);
+          }
+        SET(compiled_code, NULL);
+        }
       skipping = FALSE;
       setlocale(LC_CTYPE, "C");
       }
@@ -8488,11 +9840,33 @@ while(patstacknext-- > 0)
   SUB1(pcre2_code_free, compiled_code);
   }
 
+if (pattern_set != NULL)
+  {
+  PCRE2_PATTERN_SET_FREE(pattern_set);
+  }
+while(patsetcount-- > 0)
+  {
+  SET(compiled_code, patsetcodes[patsetcount]);
+  SUB1(pcre2_code_free, compiled_code);
+  }
+
 PCRE2_JIT_FREE_UNUSED_MEMORY(general_context);
 if (jit_stack != NULL)
   {
   PCRE2_JIT_STACK_FREE(jit_stack);
   }
+if (jit_stack_pool != NULL)
+  {
+  PCRE2_JIT_STACK_POOL_FREE(jit_stack_pool);
+  }
+if (jit_code_cache != NULL)
+  {
+  PCRE2_JIT_CODE_CACHE_FREE(jit_code_cache);
+  }
+if (dfa_workspace_object != NULL)
+  {
+  PCRE2_DFA_WORKSPACE_FREE(dfa_workspace_object);
+  }
 
 #define FREECONTEXTS \
   G(pcre2_general_context_free_,BITS)(G(general_context,BITS)); \
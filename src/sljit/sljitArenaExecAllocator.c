@@ -0,0 +1,682 @@
+/*
+ *    Stack-less Just-In-Time compiler
+ *
+ *    Copyright Zoltan Herczeg (hzmester@freemail.hu). All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright notice, this list of
+ *      conditions and the following disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *      of conditions and the following disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND CONTRIBUTORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDER(S) OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+   This file contains an executable memory allocator which packs the
+   machine code into large arenas, and never maps memory with writable
+   and executable permissions at the same time.
+
+   Each arena is a memory file (memfd on Linux, a POSIX shared memory
+   object elsewhere) of ARENA_SIZE bytes, or a multiple of it for large
+   code. It is mapped twice: with read/write permissions, where the code
+   is generated, and with read/exec permissions, where it runs. Both
+   mappings are aligned to ARENA_SIZE. The arena is backed by reserved
+   huge pages if there are any left, otherwise transparent huge pages
+   are requested. Thus the code of many patterns shares a few TLB entries
+   instead of needing one for every small page.
+
+   Code is allocated in groups. Each group has its own arenas, so code
+   allocated with SLJIT_EXEC_HOT as exec_allocator_data (code which is
+   known to run often) is packed together, away from the rest.
+
+   Within an arena, the blocks are managed as in sljitExecAllocator.c:
+     [ arena header ][ block ][ block ] ... [ block ][ block terminator ]
+   Each block header also contains the offset of the executable mapping
+   and the arena of the block.
+
+   A shared executable region is mapped in the same way, but its blocks
+   are only ever appended, and their arena is NULL:
+     [ block ][ block ] ... [ block ][ unused space ]
+   The blocks are never freed on their own, so processes which share the
+   region never write into it, and need no common allocator state.
+
+   Ordinary arenas are shared files too, but the lists of arenas and free
+   blocks are private to each process. When a process forks, the parent
+   and the child therefore both give up the arenas which exist at that
+   point: they are dropped from the lists, nothing more is allocated from
+   them, and freeing a block in them does nothing. Each arena records the
+   fork generation in which it was made, which is how sljit_free_exec
+   tells them apart. Their code keeps running in both processes, and new
+   code goes into new arenas.
+*/
+
+/* --------------------------------------------------------------------- */
+/*  System (OS) functions                                                */
+/* --------------------------------------------------------------------- */
+
+/* 2 MByte, the usual size of a huge page. */
+#define ARENA_SIZE	0x200000
+#define ARENA_MASK	(~(sljit_uw)(ARENA_SIZE - 1))
+
+#define GROUP_DEFAULT	0
+#define GROUP_HOT	1
+#define GROUP_COUNT	2
+
+struct arena_header {
+	void *executable;
+	struct arena_header *next;
+	struct arena_header *prev;
+	sljit_uw size;
+	sljit_uw generation;
+	sljit_s32 fd;
+	sljit_s32 group;
+	sljit_s32 huge;
+};
+
+/* The blocks start at a multiple of 32 bytes. */
+#define ARENA_HEADER_SIZE \
+	((sizeof(struct arena_header) + 31) & ~(sljit_uw)31)
+
+/*
+   alloc_arena / free_arena :
+     * allocate executable system memory arenas
+     * the size is always divisible by ARENA_SIZE
+   allocator_grab_lock / allocator_release_lock :
+     * make the allocator thread safe
+*/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#ifndef MAP_ANON
+#define MAP_ANON MAP_ANONYMOUS
+#endif
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC	0x0001U
+#endif
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB	0x0004U
+#endif
+#ifndef MFD_HUGE_2MB
+#define MFD_HUGE_2MB	(21U << 26)
+#endif
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING	0x0002U
+#endif
+
+#if defined __linux__ && !defined F_ADD_SEALS
+#define F_ADD_SEALS	1033
+#define F_SEAL_SEAL	0x0001
+#define F_SEAL_SHRINK	0x0002
+#define F_SEAL_GROW	0x0004
+#define F_SEAL_WRITE	0x0008
+#endif
+
+static struct arena_header* arenas[GROUP_COUNT];
+
+/* Incremented in both processes by fork(). */
+static sljit_uw arena_generation;
+static sljit_s32 fork_handlers_set;
+
+static SLJIT_INLINE int create_arena_file(int huge, int sealing)
+{
+#if defined SYS_memfd_create
+	return (int)syscall(SYS_memfd_create, "sljit",
+		MFD_CLOEXEC | (huge ? (MFD_HUGETLB | MFD_HUGE_2MB) : 0)
+		| (sealing ? MFD_ALLOW_SEALING : 0));
+#else
+	static unsigned long counter;
+	char name[32];
+	unsigned long value;
+	int i;
+	int fd;
+
+	SLJIT_UNUSED_ARG(sealing);
+
+	if (huge)
+		return -1;
+
+	/* The name is removed at once, it only has to be unique
+	   while the allocator lock is held. */
+	strcpy(name, "/sljit-");
+	value = ((unsigned long)getpid() << 16) ^ counter++;
+	for (i = 7; i < 23; i++) {
+		name[i] = "0123456789abcdef"[value & 0xf];
+		value >>= 4;
+	}
+	name[i] = '\0';
+
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if (fd != -1)
+		shm_unlink(name);
+	return fd;
+#endif
+}
+
+/* Maps the file at an address which is divisible by ARENA_SIZE. */
+static SLJIT_INLINE void* map_aligned(sljit_uw size, int prot, int fd)
+{
+	sljit_u8 *base;
+	sljit_u8 *aligned;
+	void *retval;
+
+	base = (sljit_u8*)mmap(NULL, size + ARENA_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
+	if (base == (sljit_u8*)MAP_FAILED)
+		return MAP_FAILED;
+
+	aligned = (sljit_u8*)(((sljit_uw)base + ARENA_SIZE - 1) & ARENA_MASK);
+	if (aligned > base)
+		munmap(base, aligned - base);
+	munmap(aligned + size, (base + ARENA_SIZE) - aligned);
+
+	retval = mmap(aligned, size, prot, MAP_SHARED | MAP_FIXED, fd, 0);
+	if (retval == MAP_FAILED)
+		munmap(aligned, size);
+	return retval;
+}
+
+/* A file that can be sealed is mapped executable through a read only
+   descriptor, because the system refuses to seal a file against writing
+   while it has a shared mapping which could be made writable. */
+static SLJIT_INLINE int open_read_only(int fd)
+{
+#ifdef __linux__
+	char path[32];
+	char digits[12];
+	int i = 0;
+	int j;
+
+	strcpy(path, "/proc/self/fd/");
+	do {
+		digits[i++] = (char)('0' + fd % 10);
+		fd /= 10;
+	} while (fd > 0);
+	for (j = 14; i > 0; j++)
+		path[j] = digits[--i];
+	path[j] = '\0';
+
+	return open(path, O_RDONLY | O_CLOEXEC);
+#else
+	SLJIT_UNUSED_ARG(fd);
+	return -1;
+#endif
+}
+
+/* Creates a memory file and maps it twice. Returns with the file
+   descriptor, or -1 if unsuccessful. */
+static int map_arena_file(sljit_uw size, int sealing,
+	void **writable, void **executable, sljit_s32 *huge_ptr)
+{
+	int huge;
+	int fd;
+	int exec_fd;
+
+	/* Reserved huge pages are tried first. Mapping them fails
+	   if not enough are left, and normal pages are used instead. */
+	for (huge = 1; huge >= 0; huge--) {
+		fd = create_arena_file(huge, sealing);
+		if (fd == -1)
+			continue;
+
+		if (ftruncate(fd, size) == 0) {
+			*writable = map_aligned(size, PROT_READ | PROT_WRITE, fd);
+			if (*writable != MAP_FAILED) {
+				exec_fd = sealing ? open_read_only(fd) : -1;
+				*executable = map_aligned(size, PROT_READ | PROT_EXEC,
+					(exec_fd != -1) ? exec_fd : fd);
+				if (exec_fd != -1)
+					close(exec_fd);
+				if (*executable != MAP_FAILED)
+					break;
+				munmap(*writable, size);
+			}
+		}
+		close(fd);
+	}
+
+	if (huge < 0)
+		return -1;
+
+#ifdef MADV_HUGEPAGE
+	if (!huge) {
+		madvise(*writable, size, MADV_HUGEPAGE);
+		madvise(*executable, size, MADV_HUGEPAGE);
+	}
+#endif
+
+	*huge_ptr = huge;
+	return fd;
+}
+
+static void disown_arenas(void);
+
+static SLJIT_INLINE struct arena_header* alloc_arena(sljit_uw size, sljit_s32 group)
+{
+	struct arena_header *arena;
+	void *writable;
+	void *executable;
+	sljit_s32 huge;
+	int fd;
+
+	if (!fork_handlers_set) {
+		if (pthread_atfork(allocator_grab_lock, disown_arenas, disown_arenas) != 0)
+			return NULL;
+		fork_handlers_set = 1;
+	}
+
+	fd = map_arena_file(size, 0, &writable, &executable, &huge);
+	if (fd == -1)
+		return NULL;
+
+	arena = (struct arena_header*)writable;
+	arena->executable = executable;
+	arena->size = size;
+	arena->generation = arena_generation;
+	arena->fd = fd;
+	arena->group = group;
+	arena->huge = huge;
+
+	arena->prev = NULL;
+	arena->next = arenas[group];
+	if (arenas[group])
+		arenas[group]->prev = arena;
+	arenas[group] = arena;
+	return arena;
+}
+
+static SLJIT_INLINE void free_arena(struct arena_header *arena)
+{
+	sljit_uw size = arena->size;
+	int fd = arena->fd;
+
+	if (arena->next)
+		arena->next->prev = arena->prev;
+	if (arena->prev)
+		arena->prev->next = arena->next;
+	else
+		arenas[arena->group] = arena->next;
+
+	munmap(arena->executable, size);
+	munmap(arena, size);
+	close(fd);
+}
+
+/* --------------------------------------------------------------------- */
+/*  Common functions                                                     */
+/* --------------------------------------------------------------------- */
+
+struct block_header {
+	sljit_uw size;
+	sljit_uw prev_size;
+	sljit_sw executable_offset;
+	struct arena_header *arena;
+};
+
+struct free_block {
+	struct block_header header;
+	struct free_block *next;
+	struct free_block *prev;
+	sljit_uw size;
+};
+
+#define AS_BLOCK_HEADER(base, offset) \
+	((struct block_header*)(((sljit_u8*)base) + offset))
+#define AS_FREE_BLOCK(base, offset) \
+	((struct free_block*)(((sljit_u8*)base) + offset))
+#define MEM_START(base)		((void*)((base) + 1))
+#define ALIGN_SIZE(size)	(((size) + sizeof(struct block_header) + 31) & ~(sljit_uw)31)
+
+static struct free_block* free_blocks[GROUP_COUNT];
+static sljit_uw allocated_size;
+static sljit_uw total_size;
+
+/* Gives up all arenas after fork() has shared them with another process,
+   in the parent and in the child. The allocator lock is taken before
+   forking, and is released here. */
+static void disown_arenas(void)
+{
+	struct arena_header *arena;
+	struct arena_header *next;
+	sljit_s32 group;
+
+	for (group = 0; group < GROUP_COUNT; group++) {
+		for (arena = arenas[group]; arena; arena = next) {
+			next = arena->next;
+			close(arena->fd);
+		}
+		arenas[group] = NULL;
+		free_blocks[group] = NULL;
+	}
+
+	allocated_size = 0;
+	total_size = 0;
+	arena_generation++;
+	allocator_release_lock();
+}
+
+static SLJIT_INLINE void sljit_insert_free_block(struct free_block *free_block, sljit_uw size)
+{
+	sljit_s32 group = free_block->header.arena->group;
+
+	free_block->header.size = 0;
+	free_block->size = size;
+
+	free_block->next = free_blocks[group];
+	free_block->prev = NULL;
+	if (free_blocks[group])
+		free_blocks[group]->prev = free_block;
+	free_blocks[group] = free_block;
+}
+
+static SLJIT_INLINE void sljit_remove_free_block(struct free_block *free_block)
+{
+	if (free_block->next)
+		free_block->next->prev = free_block->prev;
+
+	if (free_block->prev)
+		free_block->prev->next = free_block->next;
+	else {
+		SLJIT_ASSERT(free_blocks[free_block->header.arena->group] == free_block);
+		free_blocks[free_block->header.arena->group] = free_block->next;
+	}
+}
+
+static void* alloc_from_region(struct sljit_exec_region *region, sljit_uw size)
+{
+	struct block_header *header;
+
+	size = ALIGN_SIZE(size);
+
+	allocator_grab_lock();
+	if (!region->writable || size > region->size - region->allocated_size) {
+		allocator_release_lock();
+		return NULL;
+	}
+
+	header = AS_BLOCK_HEADER(region->writable, region->allocated_size);
+	header->size = size;
+	header->prev_size = 0;
+	header->executable_offset = (sljit_sw)(region->executable - region->writable);
+	header->arena = NULL;
+	region->allocated_size += size;
+	allocator_release_lock();
+	return MEM_START(header);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void* sljit_malloc_exec_group(sljit_uw size, void *exec_allocator_data)
+{
+	struct arena_header *arena;
+	struct block_header *header;
+	struct block_header *next_header;
+	struct free_block *free_block;
+	sljit_uw chunk_size;
+	sljit_sw executable_offset;
+	sljit_s32 group = (exec_allocator_data == SLJIT_EXEC_HOT) ? GROUP_HOT : GROUP_DEFAULT;
+
+	if (exec_allocator_data && exec_allocator_data != SLJIT_EXEC_HOT)
+		return alloc_from_region((struct sljit_exec_region*)exec_allocator_data, size);
+
+	allocator_grab_lock();
+	if (size < (64 - sizeof(struct block_header)))
+		size = (64 - sizeof(struct block_header));
+	size = ALIGN_SIZE(size);
+
+	free_block = free_blocks[group];
+	while (free_block) {
+		if (free_block->size >= size) {
+			chunk_size = free_block->size;
+			if (chunk_size > size + 64) {
+				/* We just cut a block from the end of the free block. */
+				chunk_size -= size;
+				free_block->size = chunk_size;
+				header = AS_BLOCK_HEADER(free_block, chunk_size);
+				header->prev_size = chunk_size;
+				header->executable_offset = free_block->header.executable_offset;
+				header->arena = free_block->header.arena;
+				AS_BLOCK_HEADER(header, size)->prev_size = size;
+			}
+			else {
+				sljit_remove_free_block(free_block);
+				header = (struct block_header*)free_block;
+				size = chunk_size;
+			}
+			allocated_size += size;
+			header->size = size;
+			allocator_release_lock();
+			return MEM_START(header);
+		}
+		free_block = free_block->next;
+	}
+
+	chunk_size = ARENA_HEADER_SIZE + sizeof(struct block_header);
+	chunk_size = (chunk_size + size + ARENA_SIZE - 1) & ARENA_MASK;
+
+	arena = alloc_arena(chunk_size, group);
+	if (!arena) {
+		allocator_release_lock();
+		return NULL;
+	}
+
+	executable_offset = (sljit_sw)((sljit_u8*)arena->executable - (sljit_u8*)arena);
+
+	chunk_size -= ARENA_HEADER_SIZE + sizeof(struct block_header);
+	total_size += chunk_size;
+
+	header = AS_BLOCK_HEADER(arena, ARENA_HEADER_SIZE);
+
+	header->prev_size = 0;
+	header->executable_offset = executable_offset;
+	header->arena = arena;
+	if (chunk_size > size + 64) {
+		/* Cut the allocated space into a free and a used block. */
+		allocated_size += size;
+		header->size = size;
+		chunk_size -= size;
+
+		free_block = AS_FREE_BLOCK(header, size);
+		free_block->header.prev_size = size;
+		free_block->header.executable_offset = executable_offset;
+		free_block->header.arena = arena;
+		sljit_insert_free_block(free_block, chunk_size);
+		next_header = AS_BLOCK_HEADER(free_block, chunk_size);
+	}
+	else {
+		/* All space belongs to this allocation. */
+		allocated_size += chunk_size;
+		header->size = chunk_size;
+		next_header = AS_BLOCK_HEADER(header, chunk_size);
+	}
+	next_header->size = 1;
+	next_header->prev_size = chunk_size;
+	next_header->executable_offset = executable_offset;
+	next_header->arena = arena;
+	allocator_release_lock();
+	return MEM_START(header);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void* sljit_malloc_exec(sljit_uw size)
+{
+	return sljit_malloc_exec_group(size, NULL);
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_free_exec(void* ptr)
+{
+	struct block_header *header;
+	struct free_block* free_block;
+
+	/* The code in a shared region is freed with the region, and the code
+	   in an arena from before the last fork() is left where it is. The
+	   headers are read through the executable mapping, which is never
+	   removed. */
+	header = AS_BLOCK_HEADER(ptr, -(sljit_sw)sizeof(struct block_header));
+	if (!header->arena)
+		return;
+
+	allocator_grab_lock();
+	if (((struct arena_header*)((sljit_u8*)header->arena
+			+ header->executable_offset))->generation != arena_generation) {
+		allocator_release_lock();
+		return;
+	}
+
+	header = AS_BLOCK_HEADER(header, -header->executable_offset);
+	allocated_size -= header->size;
+
+	/* Connecting free blocks together if possible. */
+
+	/* If header->prev_size == 0, free_block will equal to header.
+	   In this case, free_block->header.size will be > 0. */
+	free_block = AS_FREE_BLOCK(header, -(sljit_sw)header->prev_size);
+	if (SLJIT_UNLIKELY(!free_block->header.size)) {
+		free_block->size += header->size;
+		header = AS_BLOCK_HEADER(free_block, free_block->size);
+		header->prev_size = free_block->size;
+	}
+	else {
+		free_block = (struct free_block*)header;
+		sljit_insert_free_block(free_block, header->size);
+	}
+
+	header = AS_BLOCK_HEADER(free_block, free_block->size);
+	if (SLJIT_UNLIKELY(!header->size)) {
+		free_block->size += ((struct free_block*)header)->size;
+		sljit_remove_free_block((struct free_block*)header);
+		header = AS_BLOCK_HEADER(free_block, free_block->size);
+		header->prev_size = free_block->size;
+	}
+
+	/* The whole arena is free. */
+	if (SLJIT_UNLIKELY(!free_block->header.prev_size && header->size == 1)) {
+		/* If this block is freed, we still have (allocated_size / 2) free space. */
+		if (total_size - free_block->size > (allocated_size * 3 / 2)) {
+			total_size -= free_block->size;
+			sljit_remove_free_block(free_block);
+			free_arena(free_block->header.arena);
+		}
+	}
+
+	allocator_release_lock();
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_free_unused_memory_exec(void)
+{
+	struct free_block* free_block;
+	struct free_block* next_free_block;
+	sljit_s32 group;
+
+	allocator_grab_lock();
+
+	for (group = 0; group < GROUP_COUNT; group++) {
+		free_block = free_blocks[group];
+		while (free_block) {
+			next_free_block = free_block->next;
+			if (!free_block->header.prev_size &&
+					AS_BLOCK_HEADER(free_block, free_block->size)->size == 1) {
+				total_size -= free_block->size;
+				sljit_remove_free_block(free_block);
+				free_arena(free_block->header.arena);
+			}
+			free_block = next_free_block;
+		}
+	}
+
+	SLJIT_ASSERT(total_size || (!free_blocks[GROUP_DEFAULT] && !free_blocks[GROUP_HOT]));
+	allocator_release_lock();
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_sw sljit_exec_offset(void* ptr)
+{
+	return ((struct block_header *)(ptr))[-1].executable_offset;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_get_exec_allocator_stats(struct sljit_exec_allocator_stats *stats)
+{
+	struct arena_header *arena;
+	struct free_block *free_block;
+	sljit_s32 group;
+
+	SLJIT_ZEROMEM(stats, sizeof(struct sljit_exec_allocator_stats));
+
+	allocator_grab_lock();
+	for (group = 0; group < GROUP_COUNT; group++) {
+		for (arena = arenas[group]; arena; arena = arena->next) {
+			stats->arenas++;
+			if (group == GROUP_HOT)
+				stats->hot_arenas++;
+			if (arena->huge)
+				stats->huge_arenas++;
+			stats->mapped_size += arena->size;
+		}
+
+		for (free_block = free_blocks[group]; free_block; free_block = free_block->next) {
+			stats->free_blocks++;
+			stats->free_size += free_block->size;
+			if (free_block->size > stats->largest_free_block)
+				stats->largest_free_block = free_block->size;
+		}
+	}
+	stats->allocated_size = allocated_size;
+	allocator_release_lock();
+}
+
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_create_exec_region(struct sljit_exec_region *region, sljit_uw size)
+{
+	void *writable;
+	void *executable;
+
+	size = (size + ARENA_SIZE - 1) & ARENA_MASK;
+	if (!size)
+		size = ARENA_SIZE;
+
+	region->fd = map_arena_file(size, 1, &writable, &executable, &region->huge);
+	if (region->fd == -1)
+		return SLJIT_ERR_ALLOC_FAILED;
+
+	region->writable = (sljit_u8*)writable;
+	region->executable = (sljit_u8*)executable;
+	region->size = size;
+	region->allocated_size = 0;
+	return SLJIT_SUCCESS;
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_seal_exec_region(struct sljit_exec_region *region)
+{
+	allocator_grab_lock();
+	if (region->writable) {
+		munmap(region->writable, region->size);
+		region->writable = NULL;
+#if defined F_ADD_SEALS
+		/* Fails if another process still has a writable mapping. */
+		fcntl(region->fd, F_ADD_SEALS,
+			F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE);
+#endif
+	}
+	allocator_release_lock();
+}
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_free_exec_region(struct sljit_exec_region *region)
+{
+	if (region->writable)
+		munmap(region->writable, region->size);
+	munmap(region->executable, region->size);
+	close(region->fd);
+}
@@ -90,7 +90,9 @@
 
 /* Executable code allocation:
    If SLJIT_EXECUTABLE_ALLOCATOR is not defined, the application should
-   define SLJIT_MALLOC_EXEC, SLJIT_FREE_EXEC, and SLJIT_EXEC_OFFSET. */
+   define SLJIT_MALLOC_EXEC, SLJIT_FREE_EXEC, and SLJIT_EXEC_OFFSET.
+   SLJIT_MALLOC_EXEC receives the size and the exec_allocator_data
+   of the compiler (see sljit_set_exec_allocator_data). */
 #ifndef SLJIT_EXECUTABLE_ALLOCATOR
 /* Enabled by default. */
 #define SLJIT_EXECUTABLE_ALLOCATOR 1
@@ -104,6 +106,16 @@
 #define SLJIT_PROT_EXECUTABLE_ALLOCATOR 0
 #endif
 
+/* When SLJIT_ARENA_EXECUTABLE_ALLOCATOR is enabled SLJIT uses
+   an allocator which packs the code into 2 MByte arenas backed
+   by huge pages where possible, and maps each arena twice like
+   SLJIT_PROT_EXECUTABLE_ALLOCATOR (which it implies). Code that
+   is used often can be kept in arenas of its own. */
+#ifndef SLJIT_ARENA_EXECUTABLE_ALLOCATOR
+/* Disabled by default. */
+#define SLJIT_ARENA_EXECUTABLE_ALLOCATOR 0
+#endif
+
 #endif
 
 /* Force cdecl calling convention even if a better calling
@@ -162,6 +162,12 @@
 #undef SLJIT_EXECUTABLE_ALLOCATOR
 #endif
 
+#if (defined SLJIT_ARENA_EXECUTABLE_ALLOCATOR && SLJIT_ARENA_EXECUTABLE_ALLOCATOR)
+/* The arena allocator never maps memory writable and executable at once. */
+#undef SLJIT_PROT_EXECUTABLE_ALLOCATOR
+#define SLJIT_PROT_EXECUTABLE_ALLOCATOR 1
+#endif
+
 /******************************/
 /* CPU family type detection. */
 /******************************/
@@ -537,7 +543,12 @@ determine the next executed instruction after return. */
 SLJIT_API_FUNC_ATTRIBUTE void* sljit_malloc_exec(sljit_uw size);
 SLJIT_API_FUNC_ATTRIBUTE void sljit_free_exec(void* ptr);
 SLJIT_API_FUNC_ATTRIBUTE void sljit_free_unused_memory_exec(void);
-#define SLJIT_MALLOC_EXEC(size) sljit_malloc_exec(size)
+#if (defined SLJIT_ARENA_EXECUTABLE_ALLOCATOR && SLJIT_ARENA_EXECUTABLE_ALLOCATOR)
+SLJIT_API_FUNC_ATTRIBUTE void* sljit_malloc_exec_group(sljit_uw size, void *exec_allocator_data);
+#define SLJIT_MALLOC_EXEC(size, exec_allocator_data) sljit_malloc_exec_group((size), (exec_allocator_data))
+#else
+#define SLJIT_MALLOC_EXEC(size, exec_allocator_data) sljit_malloc_exec(size)
+#endif
 #define SLJIT_FREE_EXEC(ptr) sljit_free_exec(ptr)
 
 #if (defined SLJIT_PROT_EXECUTABLE_ALLOCATOR && SLJIT_PROT_EXECUTABLE_ALLOCATOR)
@@ -324,6 +324,8 @@ struct sljit_compiler {
 	sljit_uw size;
 	/* Relative offset of the executable mapping from the writable mapping. */
 	sljit_uw executable_offset;
+	/* Passed to the executable allocator. */
+	void *exec_allocator_data;
 	/* Executable size for statistical purposes. */
 	sljit_uw executable_size;
 
@@ -478,6 +480,18 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_free_code(void* code);
 */
 static SLJIT_INLINE sljit_sw sljit_get_executable_offset(struct sljit_compiler *compiler) { return compiler->executable_offset; }
 
+/*
+   The value is passed to the executable allocator when sljit_generate_code
+   allocates the memory for the machine code. It is NULL by default. The
+   arena allocator puts the code that is allocated with SLJIT_EXEC_HOT next
+   to other code allocated with it, away from the rest, and the code that is
+   allocated with a pointer to a struct sljit_exec_region into that region;
+   other allocators ignore the value.
+*/
+#define SLJIT_EXEC_HOT ((void*)1)
+
+static SLJIT_INLINE void sljit_set_exec_allocator_data(struct sljit_compiler *compiler, void *exec_allocator_data) { compiler->exec_allocator_data = exec_allocator_data; }
+
 /*
    The executable memory consumption of the generated code can be retrieved by
    this function. The returned value can be used for statistical purposes.
@@ -511,6 +525,9 @@ static SLJIT_INLINE sljit_uw sljit_get_generated_code_size(struct sljit_compiler
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
 /* [Not emulated] SSE2 support is available on x86. */
 #define SLJIT_HAS_SSE2			100
+/* [Not emulated] AVX2 support is available on x86 (including the operating
+   system support for saving the 256 bit registers). */
+#define SLJIT_HAS_AVX2			101
 #endif
 
 SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type);
@@ -1349,6 +1366,56 @@ SLJIT_API_FUNC_ATTRIBUTE void sljit_set_function_context(void** func_ptr, struct
    it is sometimes desired to free all unused memory regions, e.g.
    before the application terminates. */
 SLJIT_API_FUNC_ATTRIBUTE void sljit_free_unused_memory_exec(void);
+
+#if (defined SLJIT_ARENA_EXECUTABLE_ALLOCATOR && SLJIT_ARENA_EXECUTABLE_ALLOCATOR)
+/* Statistics of the arena allocator. The sizes include the block headers,
+   so allocated_size + free_size is mapped_size minus a small header and
+   terminator in each arena. free_size is fragmented into free_blocks
+   blocks, the largest of which is largest_free_block bytes. */
+struct sljit_exec_allocator_stats {
+	sljit_uw arenas;
+	sljit_uw hot_arenas;
+	sljit_uw huge_arenas;
+	sljit_uw mapped_size;
+	sljit_uw allocated_size;
+	sljit_uw free_size;
+	sljit_uw free_blocks;
+	sljit_uw largest_free_block;
+};
+
+SLJIT_API_FUNC_ATTRIBUTE void sljit_get_exec_allocator_stats(struct sljit_exec_allocator_stats *stats);
+
+/* A shared executable region is a memory file of fixed size, which is
+   mapped writable and executable like an arena. The code generated with
+   the region as exec_allocator_data is put into it one after another, and
+   it is never freed on its own: sljit_free_code does nothing for such
+   code, it is released with the whole region. Since the mappings are
+   shared, processes forked after the code is generated run the same copy
+   of it, and do not copy it when they free it.
+
+   sljit_seal_exec_region unmaps the writable mapping, and seals the file
+   against writing where the system supports it. No more code can be
+   generated into the region after that. It should be called before the
+   processes are forked, so none of them can modify the code.
+
+   The region must not be freed while code in it may still run. */
+
+struct sljit_exec_region {
+	/* These members are read only. */
+	sljit_u8 *writable;
+	sljit_u8 *executable;
+	sljit_uw size;
+	sljit_uw allocated_size;
+	sljit_s32 fd;
+	sljit_s32 huge;
+};
+
+/* The size is rounded up to a multiple of 2 MByte. Returns with
+   SLJIT_SUCCESS or SLJIT_ERR_ALLOC_FAILED. */
+SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_create_exec_region(struct sljit_exec_region *region, sljit_uw size);
+SLJIT_API_FUNC_ATTRIBUTE void sljit_seal_exec_region(struct sljit_exec_region *region);
+SLJIT_API_FUNC_ATTRIBUTE void sljit_free_exec_region(struct sljit_exec_region *region);
+#endif
 #endif
 
 /* --------------------------------------------------------------------- */
@@ -275,6 +275,7 @@ static const sljit_u8 reg_lmap[SLJIT_NUMBER_OF_REGISTERS + 4] = {
 static sljit_s32 cpu_has_sse2 = -1;
 #endif
 static sljit_s32 cpu_has_cmov = -1;
+static sljit_s32 cpu_has_avx2 = -1;
 
 #ifdef _WIN32_WCE
 #include <cmnintrin.h>
@@ -356,6 +357,81 @@ static void get_cpu_features(void)
 	cpu_has_cmov = (features >> 15) & 0x1;
 }
 
+#if !(defined(_MSC_VER) && defined(_MSC_FULL_VER) && _MSC_FULL_VER >= 160040219) \
+	&& (defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__SUNPRO_C))
+
+static void execute_cpuid(sljit_u32 leaf, sljit_u32 *regs)
+{
+	/* AT&T syntax. On x86-32, ebx may hold the GOT pointer,
+	   so it is swapped with esi around the cpuid instruction. */
+	__asm__ (
+#if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
+		"xchgl %%ebx, %%esi\n"
+		"cpuid\n"
+		"xchgl %%ebx, %%esi\n"
+		: "=a" (regs[0]), "=S" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+#else
+		"cpuid\n"
+		: "=a" (regs[0]), "=b" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+#endif
+		: "0" (leaf), "2" (0)
+	);
+}
+
+#endif
+
+static void get_avx2_feature(void)
+{
+	sljit_u32 max_leaf = 0;
+	sljit_u32 features1 = 0;
+	sljit_u32 features7 = 0;
+	sljit_u32 xcr0 = 0;
+
+#if defined(_MSC_VER) && defined(_MSC_FULL_VER) && _MSC_FULL_VER >= 160040219
+
+	int CPUInfo[4];
+	__cpuid(CPUInfo, 0);
+	max_leaf = (sljit_u32)CPUInfo[0];
+	if (max_leaf >= 7) {
+		__cpuid(CPUInfo, 1);
+		features1 = (sljit_u32)CPUInfo[2];
+		__cpuidex(CPUInfo, 7, 0);
+		features7 = (sljit_u32)CPUInfo[1];
+		if ((features1 >> 27) & 0x1)
+			xcr0 = (sljit_u32)_xgetbv(0);
+	}
+
+#elif defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__SUNPRO_C)
+
+	sljit_u32 regs[4];
+	sljit_u32 xcr0_high;
+
+	execute_cpuid(0, regs);
+	max_leaf = regs[0];
+	if (max_leaf >= 7) {
+		execute_cpuid(1, regs);
+		features1 = regs[2];
+		execute_cpuid(7, regs);
+		features7 = regs[1];
+		if ((features1 >> 27) & 0x1) {
+			/* XGETBV with ecx = 0. */
+			__asm__ (
+				".byte 0x0f, 0x01, 0xd0\n"
+				: "=a" (xcr0), "=d" (xcr0_high)
+				: "c" (0)
+			);
+			SLJIT_UNUSED_ARG(xcr0_high);
+		}
+	}
+
+#endif /* _MSC_VER && _MSC_FULL_VER >= 160040219 */
+
+	/* AVX2 is usable when the processor supports AVX and AVX2 and the
+	   operating system saves the XMM and YMM registers (OSXSAVE, XCR0). */
+	cpu_has_avx2 = max_leaf >= 7 && ((features1 >> 28) & 0x1)
+		&& ((features7 >> 5) & 0x1) && (xcr0 & 0x6) == 0x6;
+}
+
 static sljit_u8 get_jump_code(sljit_s32 type)
 {
 	switch (type) {
@@ -492,7 +568,7 @@ SLJIT_API_FUNC_ATTRIBUTE void* sljit_generate_code(struct sljit_compiler *compil
 	reverse_buf(compiler);
 
 	/* Second code generation pass. */
-	code = (sljit_u8*)SLJIT_MALLOC_EXEC(compiler->size);
+	code = (sljit_u8*)SLJIT_MALLOC_EXEC(compiler->size, compiler->exec_allocator_data);
 	PTR_FAIL_WITH_EXEC_IF(code);
 	buf = compiler->buf;
 
@@ -625,6 +701,11 @@ SLJIT_API_FUNC_ATTRIBUTE sljit_s32 sljit_has_cpu_feature(sljit_s32 feature_type)
 		return 1;
 #endif
 
+	case SLJIT_HAS_AVX2:
+		if (cpu_has_avx2 == -1)
+			get_avx2_feature();
+		return cpu_has_avx2;
+
 	default:
 		return 0;
 	}